@@ -4,20 +4,14 @@
 
 #include "global/Utils.h"
 #include "global/Event.h"
+#include "global/StringId.h"
 #include "gfx/Color.h"
 #include "geom/Volume.h"
+#include "math/Curve.h"
+#include "animation/Tween.h"
 
 namespace cs
 {
-	enum AnimationType
-	{
-		AnimationTypeNone = -1,
-		AnimationTypeLoop,
-		AnimationTypeBounce,
-		//...
-		AnimationTypeMAX
-	};
-
 	enum AnimationState
 	{
 		AnimationStateNone = -1,
@@ -74,6 +68,7 @@ namespace cs
 		}
 
 		void setSpeed(float32 s) { this->speed = s; }
+		float32 getSpeed() const { return this->speed; }
 
 	protected:
 
@@ -256,6 +251,43 @@ namespace cs
 		float32 timeWarp;
 	};
 
+	// pow(pct, smooth) for the lerp animators.  Smoothing is fixed for the life of an animation
+	// in practice so it's baked to a table, and rebaked if an edit changes it.  Below 1 the
+	// curve is too steep at the start for the table to follow and pow is kept.
+	class AnimationEase
+	{
+	public:
+
+		static const uint32 kSamples = 64;
+
+		AnimationEase()
+			: bakedSmooth(-1.0f)
+		{ }
+
+		float32 evaluate(float32 pct, float32 smooth)
+		{
+			pct = clamp<float32>(0.0f, 1.0f, pct);
+			if (smooth == 1.0f)
+				return pct;
+
+			if (smooth < 1.0f)
+				return powf(pct, smooth);
+
+			if (smooth != this->bakedSmooth)
+			{
+				this->curve.bake([smooth](float32 t) { return powf(t, smooth); });
+				this->bakedSmooth = smooth;
+			}
+
+			return this->curve.evaluate(pct);
+		}
+
+	private:
+
+		BakedCurve<float32, kSamples> curve;
+		float32 bakedSmooth;
+	};
+
 	template <class T>
 	class DummyAnimator : public AnimatorTyped<T>
 	{
@@ -269,7 +301,7 @@ namespace cs
 
 		virtual void evaluate(T& value, float32& cur_time)
 		{
-			value = clamp(0.0f, 1.0f, pow(cur_time * (1.0f / this->maxTime), smooth));
+			value = this->ease.evaluate(cur_time * (1.0f / this->maxTime), this->smooth);
 		}
 
 		static Animation<T> createAnimation(
@@ -283,6 +315,7 @@ namespace cs
 
 		float32 percent;
 		float32 smooth;
+		AnimationEase ease;
 	};
 
 	template <class T>
@@ -300,7 +333,7 @@ namespace cs
 		virtual T getStartValue() { return this->minValue; }
 		virtual void evaluate(T& value, float32& cur_time)
 		{
-			float32 pct = clamp(0.0f, 1.0f, pow(cur_time * (1.0f / this->maxTime), smooth));
+			float32 pct = this->ease.evaluate(cur_time * (1.0f / this->maxTime), this->smooth);
 			value = lerp(this->minValue, this->maxValue, pct);
 		}
 
@@ -318,12 +351,18 @@ namespace cs
 		T minValue;
 		T maxValue;
 		float32 smooth;
+		AnimationEase ease;
 	};
 
 	class AnimationInstance
 	{
 	public:
 
+		virtual ~AnimationInstance() { }
+
+		// Hands the animation to a batch, the engine must outlive the instance
+		virtual void bindTweens(TweenEngine* engine) { }
+
 		virtual void onBegin() { }
 		virtual void onEnd() { }
 
@@ -341,24 +380,80 @@ namespace cs
 		AnimationInstanceTyped(Animation<T> anim)
 			: AnimationInstance()
 			, animation(anim)
+			, tweens(nullptr)
 		{
 
 		}
 
+		virtual ~AnimationInstanceTyped()
+		{
+			if (this->tweens)
+				this->tweens->remove(this->tween);
+		}
+
+		// Only plain lerps have a batched form, anything else keeps stepping itself
+		virtual void bindTweens(TweenEngine* engine)
+		{
+			if (this->tweens || !engine)
+				return;
+
+			LerpAnimator<T>* lerpAnimator = dynamic_cast<LerpAnimator<T>*>(this->animation.animator.get());
+			if (!lerpAnimator)
+				return;
+
+			this->tween = engine->add<T>(lerpAnimator->minValue, lerpAnimator->maxValue, lerpAnimator->getMaxTime(),
+				lerpAnimator->smooth, this->animation.getType(), this->animation.getSpeed());
+			if (this->tween.isValid())
+				this->tweens = engine;
+		}
+
 		virtual void process(float32 dt)
 		{
-			this->animation.process(dt);
+			this->step(dt);
 		}
 
 		virtual void reset()
 		{
 			this->animation.reset();
 			this->animation.process(0.0f);
+			if (this->tweens)
+			{
+				this->tweens->restart(this->tween);
+				this->animation.value = this->tweens->getValue<T>(this->tween);
+			}
 		}
 
-		virtual bool isActive() const { return !this->animation.isAnimDone(); }
+		virtual bool isActive() const
+		{
+			if (this->tweens)
+				return !this->tweens->isDone(this->tween);
+			return !this->animation.isAnimDone();
+		}
 
 		Animation<T> animation;
+
+	protected:
+
+		// A bound tween is stepped by the engine ahead of the instances, one that wasn't running
+		// yet missed this frame's batch and catches up on its own
+		void step(float32 dt)
+		{
+			if (!this->tweens)
+			{
+				this->animation.process(dt);
+				return;
+			}
+
+			if (!this->tweens->isActive(this->tween))
+			{
+				this->tweens->setActive(this->tween, true);
+				this->tweens->advance(this->tween, dt);
+			}
+			this->animation.value = this->tweens->getValue<T>(this->tween);
+		}
+
+		TweenEngine* tweens;
+		TweenHandle tween;
 	};
 
 	typedef std::shared_ptr<AnimationInstance> AnimationInstancePtr;
@@ -377,7 +472,7 @@ namespace cs
 
 		virtual void process(float32 dt)
 		{
-			this->animation.process(dt);
+			this->step(dt);
 			if (this->ref_ptr)
 			{
 				(*this->ref_ptr) = this->animation.getValue();
@@ -400,10 +495,10 @@ namespace cs
 
 		virtual void process(float32 dt)
 		{
-			this->animation->process(dt);
+			this->step(dt);
 			if (this->callback)
 			{
-				this->callback->invoke(this->animation->getValue());
+				this->callback->invoke(this->animation.getValue());
 			}
 		}
 
@@ -470,7 +565,7 @@ namespace cs
 
 		virtual void process(float32 dt)
 		{
-			this->animation.process(dt);
+			this->step(dt);
 			this->callback.invoke(this->animation.getValue());
 		}
 
@@ -482,7 +577,7 @@ namespace cs
 	class AnimationNamedCallback : public AnimationInstanceTyped<T>
 	{
 	public:
-		AnimationNamedCallback(Animation<T>& anim, const std::string& n, CallbackArg2<void, std::string, T>& call, std::shared_ptr<C>& ptr)
+		AnimationNamedCallback(Animation<T>& anim, const StringId& n, CallbackArg2<void, StringId, T>& call, std::shared_ptr<C>& ptr)
 			: AnimationInstanceTyped<T>(anim)
 			, name(n)
 			, callback(call)
@@ -508,12 +603,12 @@ namespace cs
 
 		virtual void process(float32 dt)
 		{
-			this->animation.process(dt);
+			this->step(dt);
 			this->callback.invoke(this->name, this->animation.getValue());
 		}
 
-		std::string name;
-		CallbackArg2<void, std::string, T> callback;
+		StringId name;
+		CallbackArg2<void, StringId, T> callback;
 		std::shared_ptr<C> object;
 	};
 
@@ -527,10 +622,10 @@ namespace cs
 	}
 
 	template <class T, class C>
-	inline AnimationInstancePtr createNamedAnimationCallback(const std::string& name, Animation<T>& anim, void(C::*func_ptr)(std::string, T), std::shared_ptr<C>& caller_ptr)
+	inline AnimationInstancePtr createNamedAnimationCallback(const StringId& name, Animation<T>& anim, void(C::*func_ptr)(StringId, T), std::shared_ptr<C>& caller_ptr)
 	{
-		typename CallbackArg2<void, std::string, T>::CallbackFunc func = std::bind(func_ptr, caller_ptr.get(), std::placeholders::_1, std::placeholders::_2);
-		CallbackArg2<void, std::string, T> call(func);
+		typename CallbackArg2<void, StringId, T>::CallbackFunc func = std::bind(func_ptr, caller_ptr.get(), std::placeholders::_1, std::placeholders::_2);
+		CallbackArg2<void, StringId, T> call(func);
 		std::shared_ptr<AnimationNamedCallback<T, C>> anim_instance = std::make_shared<AnimationNamedCallback<T, C>>(anim, name, call, caller_ptr);
 		return anim_instance;
 	}
@@ -0,0 +1,505 @@
+#include "PCH.h"
+
+#include "animation/Tween.h"
+#include "animation/Animator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace cs
+{
+	template <uint32 N>
+	TweenHandle TweenPool<N>::add(const float32* from, const float32* to, float32 duration, float32 smooth, AnimationType type, float32 speed)
+	{
+		uint32 handleIndex = 0;
+		if (this->freeHandles.size() > 0)
+		{
+			handleIndex = this->freeHandles.back();
+			this->freeHandles.pop_back();
+		}
+		else
+		{
+			handleIndex = uint32(this->slot.size());
+			this->slot.push_back(0);
+			this->generation.push_back(1);
+		}
+
+		size_t index = this->append();
+		bool linear = (smooth == 1.0f);
+		if (linear)
+		{
+			// first eased tween moves to the back to make room at the end of the linear run
+			if (index != this->numLinear)
+			{
+				this->moveSlot(this->numLinear, index);
+				index = this->numLinear;
+			}
+			this->numLinear++;
+		}
+
+		duration = std::max<float32>(duration, 0.0f);
+
+		this->time[index] = 0.0f;
+		this->duration[index] = duration;
+		this->invDuration[index] = (duration > 0.0f) ? 1.0f / duration : 0.0f;
+		this->speed[index] = speed;
+		this->smooth[index] = smooth;
+		this->active[index] = 0.0f;
+		this->clampMask[index] = (type == AnimationTypeLoop || type == AnimationTypeBounce) ? 0.0f : 1.0f;
+		this->loopMask[index] = (type == AnimationTypeLoop) ? 1.0f : 0.0f;
+		this->bounceMask[index] = (type == AnimationTypeBounce) ? 1.0f : 0.0f;
+		this->percent[index] = 0.0f;
+
+		for (uint32 c = 0; c < N; ++c)
+		{
+			// with no duration there is nothing to blend, sit on the end value
+			this->start[c][index] = (duration > 0.0f) ? from[c] : to[c];
+			this->delta[c][index] = (duration > 0.0f) ? to[c] - from[c] : 0.0f;
+			this->value[c][index] = this->start[c][index];
+		}
+
+		this->owner[index] = handleIndex;
+		this->slot[handleIndex] = uint32(index);
+
+		TweenHandle handle;
+		handle.index = handleIndex;
+		handle.generation = this->generation[handleIndex];
+		handle.channels = uint16(N);
+		return handle;
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::remove(const TweenHandle& handle)
+	{
+		int32 index = this->getSlot(handle);
+		if (index < 0)
+			return;
+
+		size_t last = this->size() - 1;
+		if (size_t(index) < this->numLinear)
+		{
+			// keep the linear run packed, then fill its last slot from the end
+			size_t lastLinear = this->numLinear - 1;
+			this->moveSlot(lastLinear, index);
+			this->moveSlot(last, lastLinear);
+			this->numLinear--;
+		}
+		else
+		{
+			this->moveSlot(last, index);
+		}
+
+		this->pop();
+
+		this->generation[handle.index]++;
+		this->freeHandles.push_back(handle.index);
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::clear()
+	{
+		for (auto& handleIndex : this->owner)
+		{
+			this->generation[handleIndex]++;
+			this->freeHandles.push_back(handleIndex);
+		}
+
+		while (this->size() > 0)
+			this->pop();
+
+		this->numLinear = 0;
+	}
+
+	template <uint32 N>
+	bool TweenPool<N>::isValid(const TweenHandle& handle) const
+	{
+		return this->getSlot(handle) >= 0;
+	}
+
+	template <uint32 N>
+	bool TweenPool<N>::isDone(const TweenHandle& handle) const
+	{
+		int32 index = this->getSlot(handle);
+		if (index < 0)
+			return true;
+
+		return this->clampMask[index] > 0.0f && this->time[index] >= this->duration[index];
+	}
+
+	template <uint32 N>
+	bool TweenPool<N>::isActive(const TweenHandle& handle) const
+	{
+		int32 index = this->getSlot(handle);
+		return index >= 0 && this->active[index] > 0.0f;
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::setActive(const TweenHandle& handle, bool active)
+	{
+		int32 index = this->getSlot(handle);
+		if (index >= 0)
+			this->active[index] = active ? 1.0f : 0.0f;
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::restart(const TweenHandle& handle)
+	{
+		int32 index = this->getSlot(handle);
+		if (index < 0)
+			return;
+
+		this->time[index] = 0.0f;
+		this->active[index] = 0.0f;
+		this->step(index, index + 1, 0.0f);
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::advance(const TweenHandle& handle, float32 dt)
+	{
+		int32 index = this->getSlot(handle);
+		if (index >= 0)
+			this->step(index, index + 1, dt);
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::getValue(const TweenHandle& handle, float32* out) const
+	{
+		int32 index = this->getSlot(handle);
+		if (index < 0)
+			return;
+
+		for (uint32 c = 0; c < N; ++c)
+			out[c] = this->value[c][index];
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::step(size_t begin, size_t end, float32 dt)
+	{
+		if (begin >= end)
+			return;
+
+		float32* t = &this->time[0];
+		const float32* dur = &this->duration[0];
+		const float32* invDur = &this->invDuration[0];
+		const float32* sp = &this->speed[0];
+		const float32* sm = &this->smooth[0];
+		const float32* act = &this->active[0];
+		const float32* clampM = &this->clampMask[0];
+		const float32* loopM = &this->loopMask[0];
+		const float32* bounceM = &this->bounceMask[0];
+		float32* pct = &this->percent[0];
+
+		// Loop and bounce are both read off the unwrapped time, a saw and a triangle wave with
+		// the masks picking one, so every tween runs the same instructions.  Time never goes
+		// negative so truncation stands in for floor and the loop stays free of calls.
+		for (size_t i = begin; i < end; ++i)
+		{
+			float32 cur = std::max<float32>(t[i] + dt * sp[i] * act[i], 0.0f);
+			cur -= clampM[i] * std::max<float32>(cur - dur[i], 0.0f);
+
+			float32 u = cur * invDur[i];
+			float32 periods = float32(int32(u * 0.5f)) * 2.0f;
+			float32 saw = u - float32(int32(u));
+			float32 triangle = 1.0f - fabsf(1.0f - (u - periods));
+
+			pct[i] = clampM[i] * std::min<float32>(u, 1.0f) + loopM[i] * saw + bounceM[i] * triangle;
+
+			// wrap by whole bounce periods, both waves repeat over them, to keep time small
+			t[i] = cur - (1.0f - clampM[i]) * periods * dur[i];
+		}
+
+		for (size_t i = std::max<size_t>(begin, this->numLinear); i < end; ++i)
+			pct[i] = powf(pct[i], sm[i]);
+
+		for (uint32 c = 0; c < N; ++c)
+		{
+			const float32* s = &this->start[c][0];
+			const float32* d = &this->delta[c][0];
+			float32* v = &this->value[c][0];
+			for (size_t i = begin; i < end; ++i)
+				v[i] = s[i] + d[i] * pct[i];
+		}
+	}
+
+	template <uint32 N>
+	size_t TweenPool<N>::append()
+	{
+		size_t index = this->size();
+
+		this->time.push_back(0.0f);
+		this->duration.push_back(0.0f);
+		this->invDuration.push_back(0.0f);
+		this->speed.push_back(0.0f);
+		this->smooth.push_back(1.0f);
+		this->active.push_back(0.0f);
+		this->clampMask.push_back(1.0f);
+		this->loopMask.push_back(0.0f);
+		this->bounceMask.push_back(0.0f);
+		this->percent.push_back(0.0f);
+		for (uint32 c = 0; c < N; ++c)
+		{
+			this->start[c].push_back(0.0f);
+			this->delta[c].push_back(0.0f);
+			this->value[c].push_back(0.0f);
+		}
+		this->owner.push_back(0);
+
+		return index;
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::moveSlot(size_t from, size_t to)
+	{
+		if (from == to)
+			return;
+
+		this->time[to] = this->time[from];
+		this->duration[to] = this->duration[from];
+		this->invDuration[to] = this->invDuration[from];
+		this->speed[to] = this->speed[from];
+		this->smooth[to] = this->smooth[from];
+		this->active[to] = this->active[from];
+		this->clampMask[to] = this->clampMask[from];
+		this->loopMask[to] = this->loopMask[from];
+		this->bounceMask[to] = this->bounceMask[from];
+		this->percent[to] = this->percent[from];
+		for (uint32 c = 0; c < N; ++c)
+		{
+			this->start[c][to] = this->start[c][from];
+			this->delta[c][to] = this->delta[c][from];
+			this->value[c][to] = this->value[c][from];
+		}
+
+		this->owner[to] = this->owner[from];
+		this->slot[this->owner[to]] = uint32(to);
+	}
+
+	template <uint32 N>
+	void TweenPool<N>::pop()
+	{
+		this->time.pop_back();
+		this->duration.pop_back();
+		this->invDuration.pop_back();
+		this->speed.pop_back();
+		this->smooth.pop_back();
+		this->active.pop_back();
+		this->clampMask.pop_back();
+		this->loopMask.pop_back();
+		this->bounceMask.pop_back();
+		this->percent.pop_back();
+		for (uint32 c = 0; c < N; ++c)
+		{
+			this->start[c].pop_back();
+			this->delta[c].pop_back();
+			this->value[c].pop_back();
+		}
+		this->owner.pop_back();
+	}
+
+	template <uint32 N>
+	int32 TweenPool<N>::getSlot(const TweenHandle& handle) const
+	{
+		if (handle.channels != N || handle.index >= this->slot.size() || this->generation[handle.index] != handle.generation)
+			return -1;
+
+		return int32(this->slot[handle.index]);
+	}
+
+	template class TweenPool<1>;
+	template class TweenPool<2>;
+	template class TweenPool<3>;
+	template class TweenPool<4>;
+
+#define TWEEN_POOL_DISPATCH(handle, call) \
+	switch ((handle).channels) \
+	{ \
+		case 1: this->pool1.call; break; \
+		case 2: this->pool2.call; break; \
+		case 3: this->pool3.call; break; \
+		case 4: this->pool4.call; break; \
+		default: break; \
+	}
+
+	TweenHandle TweenEngine::addChannels(uint32 channels, const float32* from, const float32* to, float32 duration, float32 smooth, AnimationType type, float32 speed)
+	{
+		switch (channels)
+		{
+			case 1: return this->pool1.add(from, to, duration, smooth, type, speed);
+			case 2: return this->pool2.add(from, to, duration, smooth, type, speed);
+			case 3: return this->pool3.add(from, to, duration, smooth, type, speed);
+			case 4: return this->pool4.add(from, to, duration, smooth, type, speed);
+			default:
+				break;
+		}
+		return TweenHandle();
+	}
+
+	void TweenEngine::getChannels(const TweenHandle& handle, float32* out) const
+	{
+		TWEEN_POOL_DISPATCH(handle, getValue(handle, out));
+	}
+
+	void TweenEngine::remove(const TweenHandle& handle)
+	{
+		TWEEN_POOL_DISPATCH(handle, remove(handle));
+	}
+
+	void TweenEngine::clear()
+	{
+		this->pool1.clear();
+		this->pool2.clear();
+		this->pool3.clear();
+		this->pool4.clear();
+	}
+
+	bool TweenEngine::isDone(const TweenHandle& handle) const
+	{
+		switch (handle.channels)
+		{
+			case 1: return this->pool1.isDone(handle);
+			case 2: return this->pool2.isDone(handle);
+			case 3: return this->pool3.isDone(handle);
+			case 4: return this->pool4.isDone(handle);
+			default:
+				break;
+		}
+		return true;
+	}
+
+	bool TweenEngine::isActive(const TweenHandle& handle) const
+	{
+		switch (handle.channels)
+		{
+			case 1: return this->pool1.isActive(handle);
+			case 2: return this->pool2.isActive(handle);
+			case 3: return this->pool3.isActive(handle);
+			case 4: return this->pool4.isActive(handle);
+			default:
+				break;
+		}
+		return false;
+	}
+
+	void TweenEngine::setActive(const TweenHandle& handle, bool active)
+	{
+		TWEEN_POOL_DISPATCH(handle, setActive(handle, active));
+	}
+
+	void TweenEngine::restart(const TweenHandle& handle)
+	{
+		TWEEN_POOL_DISPATCH(handle, restart(handle));
+	}
+
+	void TweenEngine::advance(const TweenHandle& handle, float32 dt)
+	{
+		TWEEN_POOL_DISPATCH(handle, advance(handle, dt));
+	}
+
+#undef TWEEN_POOL_DISPATCH
+
+	void TweenEngine::process(float32 dt)
+	{
+		this->pool1.process(dt);
+		this->pool2.process(dt);
+		this->pool3.process(dt);
+		this->pool4.process(dt);
+	}
+
+	size_t TweenEngine::getNumTweens() const
+	{
+		return this->pool1.size() + this->pool2.size() + this->pool3.size() + this->pool4.size();
+	}
+
+	namespace
+	{
+		void benchmarkTweens(uint32 count)
+		{
+			typedef std::chrono::high_resolution_clock BenchClock;
+			auto elapsedMs = [](const BenchClock::time_point& start)
+			{
+				return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+			};
+
+			const int32 kFrames = 60;
+			const float32 kDt = 1.0f / 60.0f;
+			const AnimationType kTypes[] = { AnimationTypeNone, AnimationTypeLoop, AnimationTypeBounce };
+
+			// an even mix of value types, play modes and easing, as a busy UI would have
+			std::vector<FloatAnimation> floats;
+			std::vector<Vec2Animation> vec2s;
+			std::vector<Vec3Animation> vec3s;
+			std::vector<ColorBAnimation> colors;
+
+			TweenEngine engine;
+			std::vector<TweenHandle> handles;
+			handles.reserve(count);
+
+			for (uint32 i = 0; i < count; ++i)
+			{
+				float32 duration = 0.5f + float32(i % 7) * 0.25f;
+				float32 smooth = (i % 3 == 0) ? 1.0f : 2.0f;
+				AnimationType type = kTypes[(i / 4) % 3];
+
+				switch (i % 4)
+				{
+					case 0:
+						floats.push_back(FloatLerpAnimator::createAnimation(0.0f, 1.0f, duration, smooth, type));
+						handles.push_back(engine.add<float32>(0.0f, 1.0f, duration, smooth, type));
+						break;
+					case 1:
+						vec2s.push_back(Vec2LerpAnimator::createAnimation(kZero2, kOne2, duration, smooth, type));
+						handles.push_back(engine.add<vec2>(kZero2, kOne2, duration, smooth, type));
+						break;
+					case 2:
+						vec3s.push_back(Vec3LerpAnimator::createAnimation(kZero3, kOne3, duration, smooth, type));
+						handles.push_back(engine.add<vec3>(kZero3, kOne3, duration, smooth, type));
+						break;
+					default:
+						colors.push_back(ColorBLerpAnimator::createAnimation(ColorB::Black, ColorB::White, duration, smooth, type));
+						handles.push_back(engine.add<ColorB>(ColorB::Black, ColorB::White, duration, smooth, type));
+						break;
+				}
+			}
+
+			for (auto& handle : handles)
+				engine.setActive(handle, true);
+
+			BenchClock::time_point start = BenchClock::now();
+			for (int32 frame = 0; frame < kFrames; ++frame)
+			{
+				for (auto& anim : floats)
+					anim.process(kDt);
+				for (auto& anim : vec2s)
+					anim.process(kDt);
+				for (auto& anim : vec3s)
+					anim.process(kDt);
+				for (auto& anim : colors)
+					anim.process(kDt);
+			}
+			double animationTime = elapsedMs(start) / kFrames;
+
+			start = BenchClock::now();
+			for (int32 frame = 0; frame < kFrames; ++frame)
+				engine.process(kDt);
+			double batchTime = elapsedMs(start) / kFrames;
+
+			// reading every value back is what the animation instances pay on top of the batch
+			float32 checksum = 0.0f;
+			start = BenchClock::now();
+			for (auto& handle : handles)
+				checksum += engine.getValue<float32>(handle);
+			double readTime = elapsedMs(start);
+
+			log::info("Tween benchmark: ", count, " tweens over ", kFrames, " frames");
+			log::info("  Animation<T>::process: ", animationTime, "ms/frame, batched: ", batchTime, "ms/frame, read back: ", readTime, "ms (", checksum, ")");
+		}
+	}
+
+	void TweenEngine::benchmark()
+	{
+		const uint32 kCounts[] = { 10000, 100000 };
+		for (auto& count : kCounts)
+			benchmarkTweens(count);
+	}
+}
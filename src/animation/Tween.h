@@ -0,0 +1,230 @@
+#pragma once
+
+#include "global/Values.h"
+#include "gfx/Color.h"
+#include "math/GLM.h"
+
+#include <vector>
+
+namespace cs
+{
+	enum AnimationType
+	{
+		AnimationTypeNone = -1,
+		AnimationTypeLoop,
+		AnimationTypeBounce,
+		//...
+		AnimationTypeMAX
+	};
+
+	// Stable reference to a tween, survives other tweens being added and removed.  A stale
+	// handle (its tween since removed) is caught by the generation and ignored.
+	struct TweenHandle
+	{
+		TweenHandle()
+			: index(0)
+			, generation(0)
+			, channels(0)
+		{ }
+
+		bool isValid() const { return this->channels != 0; }
+
+		uint32 index;
+		uint16 generation;
+		uint16 channels;
+	};
+
+	// Splits a value into float channels and back, types without a specialisation have no
+	// channels and are left to step themselves
+	template <class T>
+	struct TweenTraits
+	{
+		static const uint32 kChannels = 0;
+		static void toChannels(const T& value, float32* channels) { }
+		static T fromChannels(const float32* channels) { return T(); }
+	};
+
+	template <>
+	struct TweenTraits<float32>
+	{
+		static const uint32 kChannels = 1;
+		static void toChannels(const float32& value, float32* channels) { channels[0] = value; }
+		static float32 fromChannels(const float32* channels) { return channels[0]; }
+	};
+
+	template <>
+	struct TweenTraits<vec2>
+	{
+		static const uint32 kChannels = 2;
+		static void toChannels(const vec2& value, float32* channels)
+		{
+			channels[0] = value.x;
+			channels[1] = value.y;
+		}
+		static vec2 fromChannels(const float32* channels) { return vec2(channels[0], channels[1]); }
+	};
+
+	template <>
+	struct TweenTraits<vec3>
+	{
+		static const uint32 kChannels = 3;
+		static void toChannels(const vec3& value, float32* channels)
+		{
+			channels[0] = value.x;
+			channels[1] = value.y;
+			channels[2] = value.z;
+		}
+		static vec3 fromChannels(const float32* channels) { return vec3(channels[0], channels[1], channels[2]); }
+	};
+
+	template <>
+	struct TweenTraits<ColorB>
+	{
+		static const uint32 kChannels = 4;
+		static void toChannels(const ColorB& value, float32* channels)
+		{
+			channels[0] = float32(value.r);
+			channels[1] = float32(value.g);
+			channels[2] = float32(value.b);
+			channels[3] = float32(value.a);
+		}
+		static ColorB fromChannels(const float32* channels)
+		{
+			return ColorB(
+				uchar(channels[0] + 0.5f),
+				uchar(channels[1] + 0.5f),
+				uchar(channels[2] + 0.5f),
+				uchar(channels[3] + 0.5f));
+		}
+	};
+
+	template <>
+	struct TweenTraits<ColorF>
+	{
+		static const uint32 kChannels = 4;
+		static void toChannels(const ColorF& value, float32* channels)
+		{
+			channels[0] = value.r;
+			channels[1] = value.g;
+			channels[2] = value.b;
+			channels[3] = value.a;
+		}
+		static ColorF fromChannels(const float32* channels) { return ColorF(channels[0], channels[1], channels[2], channels[3]); }
+	};
+
+	// Lerp tweens with N float channels, stored as one array per field so a frame is a few
+	// straight passes over contiguous floats.  Linear tweens are kept ahead of the eased ones
+	// so the pow is only paid by the tweens that use it.
+	template <uint32 N>
+	class TweenPool
+	{
+	public:
+
+		TweenPool()
+			: numLinear(0)
+		{ }
+
+		TweenHandle add(const float32* from, const float32* to, float32 duration, float32 smooth, AnimationType type, float32 speed);
+		void remove(const TweenHandle& handle);
+		void clear();
+
+		size_t size() const { return this->owner.size(); }
+
+		bool isValid(const TweenHandle& handle) const;
+		bool isDone(const TweenHandle& handle) const;
+		bool isActive(const TweenHandle& handle) const;
+		void setActive(const TweenHandle& handle, bool active);
+
+		// Back to the start, inactive until set active again
+		void restart(const TweenHandle& handle);
+
+		// Steps a single tween, for one that missed this frame's batch
+		void advance(const TweenHandle& handle, float32 dt);
+
+		void getValue(const TweenHandle& handle, float32* out) const;
+
+		void process(float32 dt) { this->step(0, this->size(), dt); }
+
+	private:
+
+		void step(size_t begin, size_t end, float32 dt);
+		size_t append();
+		void moveSlot(size_t from, size_t to);
+		void pop();
+		int32 getSlot(const TweenHandle& handle) const;
+
+		// per tween, in slot order
+		std::vector<float32> time;
+		std::vector<float32> duration;
+		std::vector<float32> invDuration;
+		std::vector<float32> speed;
+		std::vector<float32> smooth;
+		std::vector<float32> active;
+		std::vector<float32> clampMask;
+		std::vector<float32> loopMask;
+		std::vector<float32> bounceMask;
+		std::vector<float32> percent;
+		std::vector<float32> start[N];
+		std::vector<float32> delta[N];
+		std::vector<float32> value[N];
+		std::vector<uint32> owner;
+
+		// per handle
+		std::vector<uint32> slot;
+		std::vector<uint16> generation;
+		std::vector<uint32> freeHandles;
+
+		size_t numLinear;
+	};
+
+	// Every batched tween for one owner (a UI animation player), updated together once a frame
+	// before the animation instances read their values back.
+	class TweenEngine
+	{
+	public:
+
+		template <class T>
+		TweenHandle add(const T& from, const T& to, float32 duration, float32 smooth, AnimationType type, float32 speed = 1.0f)
+		{
+			float32 fromChannels[4];
+			float32 toChannels[4];
+			TweenTraits<T>::toChannels(from, fromChannels);
+			TweenTraits<T>::toChannels(to, toChannels);
+			return this->addChannels(TweenTraits<T>::kChannels, fromChannels, toChannels, duration, smooth, type, speed);
+		}
+
+		template <class T>
+		T getValue(const TweenHandle& handle) const
+		{
+			float32 channels[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			this->getChannels(handle, channels);
+			return TweenTraits<T>::fromChannels(channels);
+		}
+
+		void remove(const TweenHandle& handle);
+		void clear();
+
+		bool isDone(const TweenHandle& handle) const;
+		bool isActive(const TweenHandle& handle) const;
+		void setActive(const TweenHandle& handle, bool active);
+		void restart(const TweenHandle& handle);
+		void advance(const TweenHandle& handle, float32 dt);
+
+		void process(float32 dt);
+
+		size_t getNumTweens() const;
+
+		// Logs per frame cost at 10k and 100k tweens, batched against stepping each Animation
+		static void benchmark();
+
+	private:
+
+		TweenHandle addChannels(uint32 channels, const float32* from, const float32* to, float32 duration, float32 smooth, AnimationType type, float32 speed);
+		void getChannels(const TweenHandle& handle, float32* out) const;
+
+		TweenPool<1> pool1;
+		TweenPool<2> pool2;
+		TweenPool<3> pool3;
+		TweenPool<4> pool4;
+	};
+}
@@ -111,6 +111,8 @@ namespace cs
 			this->onComponentRemove(it.first);
 		}
 		this->components.clear();
+		for (auto& slot : this->componentSlots)
+			slot = nullptr;
 		this->clear();
 		this->cxt = nullptr;
 	}
@@ -168,9 +170,13 @@ namespace cs
 
 		BASECLASS::onPostLoad(flags);
 
+		// the name arrives through serialization, bypassing setName
+		this->nameId = StringId(this->name);
+
 		for (auto& it : this->components)
 		{
 			it.second->setParent(this);
+			this->setComponentSlot(it.first, it.second);
 			this->onComponentAdd(it.first, it.second);
 
 			it.second->onPostLoad(flags);
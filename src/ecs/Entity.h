@@ -11,6 +11,7 @@
 #include "global/SerializableHandle.h"
 #include "scripting/LuaState.h"
 #include "global/PropertySet.h"
+#include "global/StringId.h"
 
 #include <string>
 #include <map>
@@ -124,6 +125,7 @@ namespace cs
 		Entity(const std::string& n, ECSContext* entityContext) 
 			: id(gIdCounter++)
 			, name(n)
+			, nameId(n)
 			, enabled(true)
 			, color(ColorB::White)
 			, cxt(entityContext)
@@ -147,7 +149,12 @@ namespace cs
 		unsigned int getId() const { return this->id; }
 
 		const std::string& getName() { return this->name; }
-		void setName(const std::string& n) { this->name = n; }
+		const StringId& getNameId() const { return this->nameId; }
+		void setName(const std::string& n) 
+		{ 
+			this->name = n; 
+			this->nameId = StringId(n);
+		}
 
 		bool getEnabled() const { return this->enabled; }
 		void setEnabled(bool e) { this->enabled = e; }
@@ -171,32 +178,40 @@ namespace cs
 		template <typename T>
 		std::shared_ptr<T> getComponent()
 		{
-			const std::type_index index(typeid(T));
-			return std::static_pointer_cast<T>(this->getComponent(index));
+			// every component type needs registering in initComponentHash
+			assert(ComponentType<T>::slot != kInvalidComponentSlot);
+			if (ComponentType<T>::slot == kInvalidComponentSlot)
+				return std::static_pointer_cast<T>(this->findComponent(getComponentHash(std::type_index(typeid(T)))));
+
+			return std::static_pointer_cast<T>(this->componentSlots[ComponentType<T>::slot]);
 		}
 
 		std::shared_ptr<Component> getComponent(const std::type_index& index)
 		{
 			uint32 hash_index = getComponentHash(index);
-			if (this->components.count(hash_index) != 0)
-				return this->components[hash_index];
-			else
-				return nullptr;	
+			uint32 slot = getComponentSlot(hash_index);
+			if (slot == kInvalidComponentSlot)
+				return this->findComponent(hash_index);
+
+			return this->componentSlots[slot];
 		}
 
 		template <typename T>
 		bool hasComponent() const
 		{
-			const std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
-			return this->components.count(hash_index) != 0;
+			assert(ComponentType<T>::slot != kInvalidComponentSlot);
+			if (ComponentType<T>::slot == kInvalidComponentSlot)
+				return this->findComponent(getComponentHash(std::type_index(typeid(T)))).get() != nullptr;
+
+			return this->componentSlots[ComponentType<T>::slot].get() != nullptr;
 		}
 
 		template <typename T>
 		void removeComponent()
 		{
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
+			// unregistered types have no hash of their own, they're keyed by the looked up one
+			uint32 hash_index = (ComponentType<T>::slot != kInvalidComponentSlot) ?
+				ComponentType<T>::hash : getComponentHash(std::type_index(typeid(T)));
 			this->removeComponent(hash_index);
 		}
 
@@ -206,6 +221,7 @@ namespace cs
 			{
 				components[hash_index]->clearParent();
 				components.erase(hash_index);
+				this->setComponentSlot(hash_index, nullptr);
 
 				this->onComponentRemove(hash_index);
 			}
@@ -216,8 +232,7 @@ namespace cs
 		{
 			assert(cxt);
 
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
+			uint32 hash_index = ComponentType<T>::hash;
 
 			FunctionCallbackKey key((uintptr_t*)cxt, hash_index);
 			if (Entity::callbacks.find(key) == Entity::callbacks.end())
@@ -231,8 +246,7 @@ namespace cs
         template <typename T>
         static void removeComponentSubscription(ECSContext* cxt)
         {
-            std::type_index index(typeid(T));
-            uint32 hash_index = getComponentHash(index);
+            uint32 hash_index = ComponentType<T>::hash;
             
             FunctionCallbackKey key((uintptr_t*)cxt, hash_index);
             FunctionCallbacks::iterator it = Entity::callbacks.find(key);
@@ -251,6 +265,7 @@ namespace cs
 
 			component->setParent(this);
 			components[hash_index] = component;
+			this->setComponentSlot(hash_index, component);
             std::shared_ptr<Component> compPtr = std::static_pointer_cast<Component>(component);
 			this->onComponentAdd(hash_index, compPtr);
 
@@ -351,6 +366,20 @@ namespace cs
 
 		friend class EntitySearchParams;
 
+		// map lookup, for component types without a slot
+		ComponentPtr findComponent(uint32 hash_index) const
+		{
+			ComponentMap::const_iterator it = this->components.find(hash_index);
+			return (it != this->components.end()) ? it->second : ComponentPtr();
+		}
+
+		void setComponentSlot(uint32 hash_index, const ComponentPtr& component)
+		{
+			uint32 slot = getComponentSlot(hash_index);
+			if (slot != kInvalidComponentSlot)
+				this->componentSlots[slot] = component;
+		}
+
 		void onComponentAdd(uint32 hash_index, ComponentPtr& component)
 		{
 			if (!this->cxt)
@@ -387,6 +416,7 @@ namespace cs
 		static FunctionCallbacks callbacks;
 
 		std::string name;
+		StringId nameId;
 
 		int32 id;
 		bool enabled;
@@ -396,6 +426,9 @@ namespace cs
 
 		ColorB color;
 		ComponentMap components;
+
+		// components by ComponentType<T>::slot, mirrors the (serialized) map for O(1) lookups
+		ComponentPtr componentSlots[kMaxComponentTypes + 1];
 		ECSContext* cxt;
 		Collection children;
 		
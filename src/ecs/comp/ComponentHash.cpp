@@ -2,16 +2,28 @@
 
 #include "ecs/comp/ComponentList.h"
 #include "ecs/comp/ComponentHash.h"
+#include "ray/RayMaterialComponent.h"
 
 namespace cs
 {
 	std::unordered_map<size_t, uint32> gComponentHashMap;
 
+	static uint32 gComponentSlotHashes[kMaxComponentTypes];
+	static uint32 gNumComponentTypes = 0;
+
 	template <class T>
 	static void addComponentHash(uint32 adjusted_index)
 	{
 		std::type_index index(typeid(T));
 		gComponentHashMap[index.hash_code()] = adjusted_index;
+
+		if (ComponentType<T>::slot == kInvalidComponentSlot)
+		{
+			assert(gNumComponentTypes < kMaxComponentTypes);
+			ComponentType<T>::slot = gNumComponentTypes;
+			gComponentSlotHashes[gNumComponentTypes++] = adjusted_index;
+		}
+		ComponentType<T>::hash = adjusted_index;
 	}
 
 	void initComponentHash()
@@ -39,6 +51,7 @@ namespace cs
 		addComponentHash<LiquidComponent>(3229050158);
 		addComponentHash<CollisionComponent>(931596328);
 		addComponentHash<AudioComponent>(896335202);
+		addComponentHash<RayMaterialComponent>(3461061621);
 
         /*
 		log::info("gComponentHashMap Initialized!");
@@ -67,4 +80,19 @@ namespace cs
 
 		return 0;
 	}
+
+	uint32 getComponentSlot(uint32 hash)
+	{
+		for (uint32 i = 0; i < gNumComponentTypes; ++i)
+		{
+			if (gComponentSlotHashes[i] == hash)
+				return i;
+		}
+		return kInvalidComponentSlot;
+	}
+
+	uint32 getNumComponentTypes()
+	{
+		return gNumComponentTypes;
+	}
 }
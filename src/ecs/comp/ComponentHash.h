@@ -1,14 +1,40 @@
 #pragma once
 
 #include <typeindex>
+#include <unordered_map>
 #include "global/Values.h"
 
 namespace cs
 {
+	// Upper bound on registered component types, see initComponentHash
+	const uint32 kMaxComponentTypes = 16;
+	const uint32 kInvalidComponentSlot = kMaxComponentTypes;
+
 	extern std::unordered_map<size_t, uint32> gComponentHashMap;
 
+	// Dense slot and serialized hash for a component type, filled in by initComponentHash in
+	// registration order.  Reading them is a plain load, so entities and systems index straight
+	// into arrays instead of hashing a type_index.  Unregistered types keep the invalid slot,
+	// which callers size their arrays to include and never fill.
+	template <class T>
+	struct ComponentType
+	{
+		static uint32 slot;
+		static uint32 hash;
+	};
+
+	template <class T>
+	uint32 ComponentType<T>::slot = kInvalidComponentSlot;
+
+	template <class T>
+	uint32 ComponentType<T>::hash = 0;
+
 	void initComponentHash();
 	uint32 getComponentHash(const std::type_index& index);
 	uint32 getComponentHash(size_t hash_index);
 
-}
\ No newline at end of file
+	// For a hash out of a component map or listener, a scan of the few registered types
+	uint32 getComponentSlot(uint32 hash);
+	uint32 getNumComponentTypes();
+
+}
@@ -59,13 +59,15 @@ namespace cs
 		{
 			model = parent->getWorldTransform().getCurrentMatrix();
 			node.color = toVec4(parent->getColor());
-			node.tag = parent->getName();
+			node.tag = parent->getNameId();
 		}
 
-		this->renderable->queueGeometry(traversal_list.type, node);
-		
+		// set before queueing, renderables may pick their detail from the projection
 		node.objectToWorld = model;
 		node.mvp = projection * view * model;
+
+		this->renderable->queueGeometry(traversal_list.type, node);
+		
 		node.layer = this->renderable->getLayer();
 
 		traversal_list.nodes.push_sort(node, &DisplayListNode::sort);
@@ -108,7 +110,7 @@ namespace cs
 		if (!parent)
 			return;
 
-		const std::string tag = parent->getName();
+		const StringId& tag = parent->getNameId();
 		size_t batch_start = batchDrawList.size();
 
 		BatchRenderableParams params;
@@ -7,6 +7,9 @@
 
 namespace cs
 {
+	// Shared by every component so a recycled component never hands out a version
+	// some other instance already had, main thread only like instance creation
+	static uint32 gScriptInstanceVersion = 0;
 
 	BEGIN_META_CLASS(ScriptComponent)
 		ADD_META_FUNCTION("Reset Script", &ScriptComponent::createInstance);
@@ -28,10 +31,20 @@ namespace cs
 		, scriptLoaded(false)
 		, instanceState(ScriptInstanceStateNone)
 		, instance()
+		, instanceVersion(0)
 	{
 
 	}
 
+	std::string ScriptComponent::getScriptName() const
+	{
+		if (this->scriptHandle && this->scriptHandle->hasReference())
+		{
+			return this->scriptHandle->getName();
+		}
+		return "unknown";
+	}
+
 	void ScriptComponent::process(float32 dt)
 	{
 		if (!this->instance.exists())
@@ -146,6 +159,7 @@ namespace cs
 			if (obj.is_valid())
 			{
 				this->instance = LuaObjectPtr<ScriptComponentInstance>(obj);
+				this->instanceVersion = ++gScriptInstanceVersion;
 				this->populateInstance();
 			}
 		}
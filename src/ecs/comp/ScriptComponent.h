@@ -87,8 +87,15 @@ namespace cs
 		void onPropertyChanged();
 
 		void setLuaState(LuaStatePtr& state) { this->luaState = state; }
+		const LuaStatePtr& getLuaState() const { return this->luaState; }
 
 		ScriptComponentInstancePtr& getScriptComponentInstance() { return this->instance.get(); }
+		luabind::object& getInstanceObject() { return this->instance.luaObject; }
+		bool hasInstance() const { return this->instance.exists(); }
+
+		// unique across all components, changes whenever the Lua instance is recreated so cached references can be refreshed
+		uint32 getInstanceVersion() const { return this->instanceVersion; }
+		std::string getScriptName() const;
 
 		void resetScript();
 
@@ -117,5 +124,6 @@ namespace cs
 		bool scriptLoaded;
 		ScriptInstanceState instanceState;
 		LuaObjectPtr<ScriptComponentInstance> instance;
+		uint32 instanceVersion;
 	};
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace cs
 		virtual ~AnimationSystem();
 
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "AnimationSystem"; }
 		
 	private:
 
@@ -11,6 +11,7 @@ namespace cs
 		virtual ~AudioSystem();
 
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "AudioSystem"; }
 		void stopAll();
 
 	};
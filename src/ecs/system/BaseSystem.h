@@ -5,7 +5,7 @@
 #include "ecs/comp/Component.h"
 #include "ecs/Entity.h"
 #include "ecs/ECS_Context.h"
-#include "global/Timer.h"
+#include "global/Profiler.h"
 #include "ecs/comp/ComponentList.h"
 
 #include <typeindex>
@@ -26,47 +26,34 @@ namespace cs
         virtual~BaseSystem() { }
         
 		typedef std::map<uint32, ComponentPtr> ComponentIdMap;
-		
-	protected:
-
-		typedef std::map<uint32, ComponentIdMap> ComponentCollection;
-
-	public:
 
 		void process(SystemUpdateParams* params)
 		{
-			ScopedTimer timer(&this->updateTime);
+			PROFILE_SCOPE(this->getName());
 			this->processImpl(params);
 		}
 
 		virtual void processImpl(SystemUpdateParams* params) = 0;
+		// static name used for profiler scopes, typeid names are mangled on some compilers
+		virtual const char* getName() const = 0;
 		
 		template <class T>
 		std::shared_ptr<T> getComponent(uint32 id)
 		{
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
-			if (components.count(hash_index) > 0)
-			{
-				ComponentIdMap& comp = this->components[hash_index];
-				if (comp.count(id) != 0)
-					return std::static_pointer_cast<T>(comp[id]);
-			}
+			ComponentIdMap& comp = this->components[ComponentType<T>::slot];
+			ComponentIdMap::iterator it = comp.find(id);
+			if (it != comp.end())
+				return std::static_pointer_cast<T>(it->second);
 			return nullptr;
 		}
 
 		template <class T>
 		size_t getComponentList(SharedList<T>& component_list)
 		{
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
-			if (this->components.count(hash_index) > 0)
+			ComponentIdMap& comp = this->components[ComponentType<T>::slot];
+			for (auto& it : comp)
 			{
-				ComponentIdMap& comp = this->components[hash_index];
-				for (auto& it : comp)
-				{
-					component_list.elements.push_back(std::static_pointer_cast<T>(it.second));
-				}
+				component_list.elements.push_back(std::static_pointer_cast<T>(it.second));
 			}
 			return component_list.size();
 		}
@@ -74,33 +61,27 @@ namespace cs
 		template <class T>
 		ComponentIdMap& getAllComponents()
 		{
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
-			if (components.count(hash_index) > 0)
-				return components[hash_index];
-			return emptyMap;
+			if (ComponentType<T>::slot == kInvalidComponentSlot)
+				return emptyMap;
+			return this->components[ComponentType<T>::slot];
 		}
 
 		template <class T>
 		size_t getEnabledComponents(ComponentIdMap& enabled_components)
 		{
-			std::type_index index(typeid(T));
-			uint32 hash_index = getComponentHash(index);
+			ComponentIdMap& comp = this->components[ComponentType<T>::slot];
+			if (comp.empty())
+				return 0;
 
-			if (this->components.count(hash_index) > 0)
+			for (auto& it : comp)
 			{
-				for (auto& it : this->components[hash_index])
+				Entity* parent = it.second->getParent();
+				if (parent && parent->getEnabled())
 				{
-					Entity* parent = it.second->getParent();
-					if (parent && parent->getEnabled())
-					{
-  						enabled_components[it.first] = it.second;
-					}
+					enabled_components[it.first] = it.second;
 				}
-				return enabled_components.size();
 			}
-
-			return 0;
+			return enabled_components.size();
 		}
 
 		template <class T>
@@ -118,11 +99,10 @@ namespace cs
             Entity::removeComponentSubscription<T>(cxt);
         }
 
-		uint32 getUpdateTime() const { return this->updateTime; }
 		size_t getNumComponents() const 
 		{
 			size_t sz = 0;
-			for (auto it : this->components) sz += it.second.size();
+			for (auto& it : this->components) sz += it.size();
 			return sz;
 		}
 
@@ -140,11 +120,10 @@ namespace cs
 
 		void onComponentAdded(uint32 id, uint32 index, ComponentPtr& component)
 		{
-			if (this->components.count(index) == 0)
-			{
-				this->components[index] = ComponentIdMap();
-			}
-			ComponentIdMap& cmap = this->components[index];
+			uint32 slot = getComponentSlot(index);
+			assert(slot != kInvalidComponentSlot);
+
+			ComponentIdMap& cmap = this->components[slot];
 			cmap[id] = component;
 			this->onComponentSystemAdd(id, component);
 		}
@@ -152,9 +131,10 @@ namespace cs
 
 		void onComponentRemoved(uint32 id, uint32 index)
 		{
-			if (this->components.count(index) > 0)
+			uint32 slot = getComponentSlot(index);
+			if (slot != kInvalidComponentSlot)
 			{
-				ComponentIdMap& cmap = this->components[index];
+				ComponentIdMap& cmap = this->components[slot];
 				ComponentIdMap::iterator it = cmap.find(id);
 				if (it != cmap.end())
 				{
@@ -173,8 +153,8 @@ namespace cs
 		}
 		virtual void onComponentSystemRemove(uint32 id, ComponentPtr& component) { }
 
-		ComponentCollection components;
+		// by ComponentType<T>::slot, the entry past the registered types stays empty
+		ComponentIdMap components[kMaxComponentTypes + 1];
 		ECSContext* parentContext;
-		uint32 updateTime;
 	};
 }
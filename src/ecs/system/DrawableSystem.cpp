@@ -101,7 +101,7 @@ namespace cs
 		{
 			std::vector<DrawableComponentPtr> batchableComponents;
 			RenderTraversal traversalType = static_cast<RenderTraversal>(i);
-			ScopedAccumTimer timer(&Context::updateTimes[ContextSplineUpdate]);
+			PROFILE_SCOPE("Drawable Process");
             
             if (this->batch[i].get())
             {
@@ -128,7 +128,7 @@ namespace cs
 			}
 
 			{
-				ScopedAccumTimer timer(&Context::updateTimes[ContextSceneBatchTraverse]);
+				PROFILE_SCOPE("Batch Traverse");
                 if (batchableComponents.size() > 0 && !this->allocated)
                 {
                     this->allocGeometry();
@@ -178,7 +178,7 @@ namespace cs
 			}
 
 			{
-				ScopedAccumTimer timer(&Context::updateTimes[ContextSceneBatchBuffer]);
+				PROFILE_SCOPE("Batch Buffer Copy");
                 if (this->batch[i].get())
                 {
                     this->batch[i]->update();
@@ -26,6 +26,7 @@ namespace cs
 		virtual ~DrawableSystem();
 	
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "DrawableSystem"; }
 		void flush(DisplayList& display_list);
 
 		void addRenderTarget(RenderTexturePtr ptr); 
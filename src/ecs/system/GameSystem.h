@@ -15,6 +15,7 @@ namespace cs
 		virtual ~GameSystem();
 
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "GameSystem"; }
 
 		void testPoint(const vec3& pos);
 		
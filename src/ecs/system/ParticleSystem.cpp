@@ -4,8 +4,12 @@
 #include "ecs/comp/ParticleComponent.h"
 #include "ecs/ECS_Utils.h"
 
+#include "fx/ParticleBudget.h"
+
 namespace cs
 {
+	const StringId kParticleSystemScope("ParticleSystem");
+
 	ParticleSystem::ParticleSystem(ECSContext* cxt)
 		: BaseSystem(cxt)
 		, heaps(CREATE_CLASS(ParticleHeapCollection))
@@ -53,7 +57,12 @@ namespace cs
 			if (!traversal_list.camera.get())
 				continue;
 
-			RenderInterface::getInstance()->pushDebugScope("ParticleSystem");
+			if (traversal == RenderTraversalMain)
+			{
+				ParticleBudget::getInstance()->setViewer(traversal_list.camera);
+			}
+
+			RenderInterface::getInstance()->pushDebugScope(kParticleSystemScope);
 			for (auto& it : this->heaps->buffers[traversal])
 			{
 				ParticleHeapPtr& heap = it.second;
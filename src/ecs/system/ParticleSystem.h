@@ -17,6 +17,7 @@ namespace cs
 		virtual ~ParticleSystem();
 
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "ParticleSystem"; }
         void clear();
 		void flush(DisplayList& display_list);
 
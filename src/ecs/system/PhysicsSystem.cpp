@@ -57,7 +57,10 @@ namespace cs
 		int32 velocityIterations = 6;
 		int32 positionIterations = 2;
 
+		// contacts are only recorded during the step, the handlers run once bodies are synced
+		this->contactListener.beginStep();
 		world->Step(adjusted_dt, velocityIterations, positionIterations);
+		this->contactListener.endStep();
 		
 		world->ClearForces();
 
@@ -82,6 +85,8 @@ namespace cs
 			}
 		}
 
+		this->contactListener.dispatch();
+
 		BaseSystem::ComponentIdMap particles;
 		this->getEnabledComponents<LiquidComponent>(particles);
 		for (const auto it : particles)
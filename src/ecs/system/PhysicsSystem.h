@@ -16,6 +16,7 @@ namespace cs
 		virtual ~PhysicsSystem();
 
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "PhysicsSystem"; }
 		virtual void draw(CameraPtr& camera) { }
 
 		void setGravity(float xGrav, float yGrav);
@@ -47,8 +47,75 @@ namespace cs
 		return ret;
 	}
 
+	void ScriptSystem::reset()
+	{
+		this->dispatcher = nullptr;
+		this->dispatchState = nullptr;
+		this->batchScripts.clear();
+	}
+
+	std::string ScriptSystem::getScriptProfile() const
+	{
+		if (!this->dispatcher)
+			return std::string();
+		return this->dispatcher->getProfileReport();
+	}
+
+	void ScriptSystem::resetScriptProfile()
+	{
+		if (this->dispatcher)
+			this->dispatcher->resetProfile();
+	}
+
+	bool ScriptSystem::processBatched(float32 dt)
+	{
+		ComponentIdMap& scripts = this->getAllComponents<ScriptComponent>();
+
+		LuaStatePtr state = this->luaState;
+		if (!state && scripts.size() > 0)
+		{
+			state = static_cast<ScriptComponent*>(scripts.begin()->second.get())->getLuaState();
+		}
+
+		if (!state || !state->getParams().batchScriptDispatch)
+		{
+			this->reset();
+			return false;
+		}
+
+		this->batchScripts.clear();
+		for (auto& it : scripts)
+		{
+			Entity* parent = it.second->getParent();
+			if (!parent || !parent->getEnabled())
+				continue;
+
+			ScriptComponent* script = static_cast<ScriptComponent*>(it.second.get());
+			if (script->hasInstance())
+				this->batchScripts.push_back(script);
+		}
+
+		if (!this->dispatcher || this->dispatchState != state)
+		{
+			this->dispatcher = nullptr;
+			this->dispatchState = state;
+			this->dispatcher = CREATE_CLASS(LuaScriptDispatcher, state->getState());
+		}
+
+		if (!this->dispatcher->isValid())
+			return false;
+
+		this->dispatcher->setProfiling(state->getParams().profileScripts);
+		this->dispatcher->update(this->batchScripts);
+		this->dispatcher->dispatch(dt);
+		return true;
+	}
+
 	void ScriptSystem::processImpl(SystemUpdateParams* params)
 	{
+		if (this->processBatched(params->updateDt))
+			return;
+
 		BaseSystem::ComponentIdMap scripts;
 		this->getEnabledComponents<ScriptComponent>(scripts);
 		for (const auto it : scripts)
@@ -4,6 +4,7 @@
 
 #include "ecs/system/BaseSystem.h"
 #include "scripting/LuaState.h"
+#include "scripting/LuaScriptDispatcher.h"
 
 namespace cs
 {
@@ -16,11 +17,25 @@ namespace cs
 
 		bool init(LuaStatePtr& state);
 		virtual void processImpl(SystemUpdateParams* params);
+		virtual const char* getName() const { return "ScriptSystem"; }
 		
 		void setLuaState(LuaStatePtr& ptr) { this->luaState = ptr; }
 
+		virtual void reset();
+
+		// only populated when the Lua state was created with profileScripts
+		std::string getScriptProfile() const;
+		void resetScriptProfile();
+
 	private:
 
+		bool processBatched(float32 dt);
+
 		LuaStatePtr luaState;
+
+		// keeps the state alive for as long as the dispatcher holds references into it
+		LuaStatePtr dispatchState;
+		LuaScriptDispatcherPtr dispatcher;
+		LuaScriptDispatcher::ScriptList batchScripts;
 	};
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ namespace cs
 		, top(0)
 		, x_advance(0)
 		, y_advance(0)
+		, padding(0)
 		, data(nullptr)
 		, atlased(false)
 	{ }
@@ -30,6 +31,8 @@ namespace cs
 		this->top = rhs.top;
 		this->x_advance = rhs.x_advance;
 		this->y_advance = rhs.y_advance;
+		this->padding = rhs.padding;
+		this->uvRect = rhs.uvRect;
 		this->atlased = rhs.atlased;
 		if (rhs.data)
 		{
@@ -47,6 +50,8 @@ namespace cs
 		this->top = rhs.top;
 		this->x_advance = rhs.x_advance;
 		this->y_advance = rhs.y_advance;
+		this->padding = rhs.padding;
+		this->uvRect = rhs.uvRect;
 		this->atlased = rhs.atlased;
 		if (rhs.data)
 		{
@@ -62,17 +67,21 @@ namespace cs
 		}
 	}
 
-	FontAtlas::FontAtlas(const std::string& atlasName, uint32 dimm)
+	FontAtlas::FontAtlas(const std::string& atlasName, uint32 dimm, FontAtlasMode m)
 		: TextureAtlas(atlasName, dimm, kFontAtlasChannels)
-	{ }
+		, mode(m)
+		, numCharacters(0)
+	{
+		memset(this->glyphTable, 0, sizeof(this->glyphTable));
+	}
 
 	FontAtlas::~FontAtlas()
 	{
-		for (auto& it : this->characterMap)
+		for (uint32 i = 0; i < kGlyphTableSize; ++i)
 		{
-			delete it.second;
+			SAFE_FREE(this->glyphTable[i]);
 		}
-		this->characterMap.clear();
+		this->numCharacters = 0;
 	}
 
 	ShaderHandlePtr& FontAtlas::getShader() const
@@ -82,37 +91,42 @@ namespace cs
 
 	bool FontAtlas::getCharacterRect(CharacterPair& pair, RectF& charRect)
 	{
-		std::string pairStr = FontAtlas::getCharPairAsString(pair);
-		return this->getRect(pairStr, charRect);
+		const CharacterData* data = this->getGlyph(pair.first);
+		if (data)
+		{
+			charRect = data->uvRect;
+			return true;
+		}
+
+		static RectF kEmptyCharacterRect;
+		charRect = kEmptyCharacterRect;
+		return false;
 	}
 	
 	bool FontAtlas::shouldAddChar(const CharacterPair& pair)
 	{
-		std::string str = getCharPairAsString(pair);
-		return this->toAddMap.find(str) == this->toAddMap.end();
+		// once a glyph has been handed to the atlas it is either atlased or queued
+		return this->glyphTable[pair.first] == nullptr;
 	}
 
 	CharacterData* FontAtlas::getChar(const CharacterPair& pair)
 	{
-		CharacterMap::iterator it;
-		if ((it = this->characterMap.find(pair)) != this->characterMap.end() && it->second->atlased)
-		{
-			return it->second;
-		}
-		return nullptr;
+		return this->getGlyph(pair.first);
 	}
 
 	void FontAtlas::addChar(const CharacterPair& pair, CharacterData* data)
 	{
-		std::string str = getCharPairAsString(pair);
-		CharacterMap::iterator it;
-		if ((it = this->characterMap.find(pair)) != this->characterMap.end())
+		if (this->glyphTable[pair.first])
 		{
+			delete data;
 			return;
 		}
 
-		this->characterMap[pair] = data;
-		this->addTexture(str, this->characterMap[pair]->data);
+		this->glyphTable[pair.first] = data;
+		++this->numCharacters;
+
+		std::string str = getCharPairAsString(pair);
+		this->addTexture(str, data->data);
 	}
 
 	void FontAtlas::cleanup()
@@ -122,11 +136,14 @@ namespace cs
 
 	void FontAtlas::onTextureUpdated(const std::string& name, TextureAtlasData* data)
 	{
-		CharacterMap::iterator it;
 		CharacterPair pair = FontAtlas::getCharPairForString(name);
-		if ((it = this->characterMap.find(pair)) != this->characterMap.end())
+		CharacterData* charData = this->glyphTable[pair.first];
+		if (charData)
 		{
-			it->second->atlased = true;
+			// cache the uv rect so layout never has to go back through the name map,
+			// a glyph without a rect stays unatlased and is looked up again next update
+			if (this->getRect(name, charData->uvRect))
+				charData->atlased = true;
 		}
 	}
 	
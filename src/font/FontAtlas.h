@@ -7,6 +7,12 @@
 namespace cs
 {
 	typedef std::pair<uchar, uint16> CharacterPair;
+
+	enum FontAtlasMode
+	{
+		FontAtlasBitmap,	// one coverage atlas per pixel size
+		FontAtlasSDF		// one distance field atlas at a reference size, scaled at draw time
+	};
 	
 	struct CharacterData
 	{
@@ -20,13 +26,20 @@ namespace cs
 		int16 top;
 		int16 x_advance;
 		int16 y_advance;
+		int16 padding;
 		TextureAtlasData* data;
+		RectF uvRect;
 		bool atlased;
 	};
 
 	CLASS_DEFINITION_DERIVED(FontAtlas, TextureAtlas)
 	public:
-		FontAtlas(const std::string& atlasName, uint32 dimm);
+
+		// Every atlas holds a single pixel size and CharacterPair keys on a uchar,
+		// so the whole ASCII/Latin-1 range fits in a flat table indexed by character
+		const static uint32 kGlyphTableSize = 256;
+
+		FontAtlas(const std::string& atlasName, uint32 dimm, FontAtlasMode m = FontAtlasBitmap);
 		virtual ~FontAtlas();
 
 		inline static std::string getCharPairAsString(const CharacterPair& pair)
@@ -51,21 +64,30 @@ namespace cs
 		void addChar(const CharacterPair& pair, CharacterData* data);
 		bool getCharacterRect(CharacterPair& pair, RectF& charRect);
 
+		inline CharacterData* getGlyph(uchar c) const
+		{
+			CharacterData* data = this->glyphTable[c];
+			return (data && data->atlased) ? data : nullptr;
+		}
+
+		FontAtlasMode getMode() const { return this->mode; }
+
 		virtual ShaderHandlePtr& getShader() const;
 		virtual bool flipY() const { return false; }
 		
 		static void drawCharacter(const CharacterPair& pair, RectF& atlasRect, TextureHandlePtr& srcTex);
 
 		virtual void cleanup();
-		size_t getNumCharacters() const { return this->characterMap.size(); }
+		size_t getNumCharacters() const { return this->numCharacters; }
 
 	private:
 		
 		void addCharacterToAtlas(const CharacterPair& pair, CharacterData& data);
 		virtual void onTextureUpdated(const std::string& name, TextureAtlasData* data);
 
-		typedef std::map<CharacterPair, CharacterData*> CharacterMap;
-		CharacterMap characterMap;
+		FontAtlasMode mode;
+		CharacterData* glyphTable[kGlyphTableSize];
+		size_t numCharacters;
 
 	};
 }
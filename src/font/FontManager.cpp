@@ -4,6 +4,8 @@
 #include "os/FileManager.h"
 #include "global/Utils.h"
 #include "gfx/RenderInterface.h"
+#include "global/TaskQueue.h"
+#include "font/SDFGenerator.h"
 
 namespace cs
 {
@@ -12,10 +14,27 @@ namespace cs
 		: fileName(name)
 		, dimm(d)
 		, doubleSpace(1.0f)
+		, mode(FontAtlasBitmap)
+		, modeVersion(0)
 	{
 		
 	}
 
+	void Font::setMode(FontAtlasMode m)
+	{
+		if (this->mode == m)
+			return;
+
+		// glyphs are keyed by atlas size which means something different per mode, so start over
+		this->cleanup();
+		this->fontTexture.clear();
+		this->layoutCache.clear();
+		this->requested.clear();
+		this->inFlight.clear();
+		this->mode = m;
+		++this->modeVersion;
+	}
+
 	bool Font::init(FT_Library& ft)
 	{
 		std::string filePath;
@@ -55,7 +74,7 @@ namespace cs
 
     TextureHandlePtr Font::getCharacterHandle(char character, int32 sz)
     {
-        uint16 adjusted_size = (uint16) (sz * RenderInterface::getInstance()->getContentScale());
+        uint16 adjusted_size = this->getAtlasSize((uint16) (sz * RenderInterface::getInstance()->getContentScale()));
         FontAtlasPtr atlas = this->getAtlas(adjusted_size, false);
         if (atlas.get())
         {
@@ -74,7 +93,8 @@ namespace cs
 
 	FontAtlasPtr Font::getAtlas(uint16 sz, bool canCreate)
 	{
-    
+		sz = this->getAtlasSize(sz);
+
         FontTextureSizeMap::iterator it = this->fontTexture.find(sz);
         if (it != this->fontTexture.end())
             return it->second;
@@ -90,7 +110,7 @@ namespace cs
             {
                 atlasSize = this->dimm.fontSmall;
             }
-            FontAtlasPtr atlas = CREATE_CLASS(FontAtlas, this->fileName, atlasSize);
+            FontAtlasPtr atlas = CREATE_CLASS(FontAtlas, this->fileName, atlasSize, this->mode);
             this->fontTexture[sz] = atlas;
             return atlas;
         }
@@ -108,12 +128,14 @@ namespace cs
 		{
 			charCount += atlas.second->getNumCharacters();
 		}
-		infoStr << "Font Name: " << this->fileName << " Atlases: " << this->fontTexture.size() << " Characters: " << charCount << std::endl;
+		infoStr << "Font Name: " << this->fileName << " Atlases: " << this->fontTexture.size() << " Characters: " << charCount;
+		infoStr << " Layouts: " << this->layoutCache.size() << " (" << this->layoutCache.getHits() << " hits / " << this->layoutCache.getMisses() << " misses)" << std::endl;
 		str += infoStr.str();
 	}
 
-	const CharacterData* Font::findChar(const CharacterPair& pair)
+	const CharacterData* Font::findChar(const CharacterPair& charPair)
 	{
+		CharacterPair pair(charPair.first, this->getAtlasSize(charPair.second));
 		if (!this->face)
 		{
 			log::error("Cannot load character - no face defined!");
@@ -127,22 +149,44 @@ namespace cs
 			return nullptr;
 		}
 
-		CharacterData* find_data = fontAtlas->getChar(pair);
+		CharacterData* find_data = fontAtlas->getGlyph(pair.first);
 		if (find_data)
 			return find_data;
 
-		if (!fontAtlas->shouldAddChar(pair))
+		if (!fontAtlas->shouldAddChar(pair) || this->inFlight.count(pair) > 0)
 		{
 			return nullptr;
 		}
 
+		// distance fields are too slow to build mid-frame, FontManager hands these to a worker
+		if (this->mode == FontAtlasSDF)
+		{
+			this->inFlight.insert(pair);
+			this->requested.push_back(pair);
+			return nullptr;
+		}
+
 		static CharacterData kDefaultCharacterTex;
 
+		CharacterData* data = this->rasterizeChar(pair, this->mode);
+		if (!data)
+		{
+			return &kDefaultCharacterTex;
+		}
+
+		fontAtlas->addChar(pair, data);
+		return nullptr;
+	}
+
+	CharacterData* Font::rasterizeChar(const CharacterPair& pair, FontAtlasMode rasterMode)
+	{
+		std::lock_guard<std::mutex> guard(this->faceLock);
+
 		FT_Set_Pixel_Sizes(this->face, 0, pair.second);
 		if (FT_Load_Char(this->face, pair.first, FT_LOAD_RENDER))
 		{
 			log::print(LogError, "Could not load character ", pair.first, ", ", pair.second);
-			return &kDefaultCharacterTex;
+			return nullptr;
 		}
 
 		FT_GlyphSlot g = this->face->glyph;
@@ -154,22 +198,107 @@ namespace cs
 		data->y_advance = uint16(g->advance.y >> 6);
 
 		TextureAtlasData* textureData = new TextureAtlasData();
-		textureData->width = g->bitmap.width;
-		textureData->height = g->bitmap.rows;
-		textureData->bytelen = g->bitmap.width * g->bitmap.rows;
-		textureData->bytes = new uchar[textureData->bytelen];
         textureData->channels = TextureAlpha;
-        
-		memcpy(textureData->bytes, g->bitmap.buffer, textureData->bytelen);
+
+		if (rasterMode == FontAtlasSDF && g->bitmap.width > 0 && g->bitmap.rows > 0)
+		{
+			uint32 spread = kSDFSpread;
+			data->left -= spread;
+			data->top += spread;
+			data->padding = spread;
+
+			textureData->width = SDFGenerator::getPaddedSize(g->bitmap.width, spread);
+			textureData->height = SDFGenerator::getPaddedSize(g->bitmap.rows, spread);
+			textureData->bytelen = textureData->width * textureData->height;
+			textureData->bytes = new uchar[textureData->bytelen];
+
+			SDFGenerator::generate(g->bitmap.buffer, g->bitmap.width, g->bitmap.rows, spread, textureData->bytes);
+		}
+		else
+		{
+			textureData->width = g->bitmap.width;
+			textureData->height = g->bitmap.rows;
+			textureData->bytelen = g->bitmap.width * g->bitmap.rows;
+			textureData->bytes = new uchar[textureData->bytelen];
+
+			memcpy(textureData->bytes, g->bitmap.buffer, textureData->bytelen);
+		}
 
 		data->data = textureData;
+		return data;
+	}
 
-		fontAtlas->addChar(pair, data);
-		return nullptr;
+	void Font::requestChars(const std::string& str, uint16 sz, CharacterPairList& toRasterize)
+	{
+		sz = this->getAtlasSize(sz);
+		FontAtlasPtr fontAtlas = this->getAtlas(sz);
+		if (!fontAtlas)
+		{
+			log::error("Error - no atlas found!");
+			return;
+		}
+
+		for (size_t c = 0; c < str.length(); c++)
+		{
+			CharacterPair charPair(str[c], sz);
+			if (!fontAtlas->shouldAddChar(charPair) || this->inFlight.count(charPair) > 0)
+				continue;
+
+			this->inFlight.insert(charPair);
+			toRasterize.push_back(charPair);
+		}
+	}
+
+	void Font::rasterizeChars(const CharacterPairList& pairs, FontAtlasMode rasterMode, uint32 rasterModeVersion)
+	{
+		for (auto& it : pairs)
+		{
+			RasterizedChar rasterized = { it, this->rasterizeChar(it, rasterMode), rasterModeVersion };
+
+			std::lock_guard<std::mutex> guard(this->rasterizedLock);
+			this->rasterized.push_back(rasterized);
+		}
+	}
+
+	void Font::flushRasterized()
+	{
+		RasterizedList ready;
+		{
+			std::lock_guard<std::mutex> guard(this->rasterizedLock);
+			if (this->rasterized.empty())
+				return;
+			ready.swap(this->rasterized);
+		}
+
+		for (auto& it : ready)
+		{
+			// anything rasterised before a mode switch was made for the other atlas, even if the sizes happen to match
+			if (it.modeVersion != this->modeVersion)
+			{
+				delete it.data;
+				continue;
+			}
+
+			this->inFlight.erase(it.pair);
+			if (!it.data)
+				continue;
+
+			FontAtlasPtr fontAtlas = this->getAtlas(it.pair.second);
+			if (fontAtlas)
+			{
+				fontAtlas->addChar(it.pair, it.data);
+			}
+			else
+			{
+				delete it.data;
+			}
+		}
 	}
 
 	void Font::update()
 	{
+		this->flushRasterized();
+
 		for (auto& it : this->fontTexture)
 		{
 			if (it.second.get())
@@ -208,12 +337,43 @@ namespace cs
 	}
 
 	bool Font::generateVertices(const std::string& str, TextOptions& options, TextLines& lineData, RectF& bounds, std::vector<RectF>& lineBounds, float32* maxWidth, float32 textScale)
+	{
+		TextLayoutKey key(str, options.size, maxWidth, textScale);
+		const TextLayout* cached = this->layoutCache.find(key);
+		if (cached)
+		{
+			lineData.insert(lineData.end(), cached->lines.begin(), cached->lines.end());
+			lineBounds.insert(lineBounds.end(), cached->lineBounds.begin(), cached->lineBounds.end());
+			bounds.combine(cached->bounds);
+			return true;
+		}
+
+		TextLayout layout;
+		bool found_all = this->layoutText(str, options, layout.lines, layout.bounds, layout.lineBounds, maxWidth, textScale);
+
+		lineData.insert(lineData.end(), layout.lines.begin(), layout.lines.end());
+		lineBounds.insert(lineBounds.end(), layout.lineBounds.begin(), layout.lineBounds.end());
+		bounds.combine(layout.bounds);
+
+		// partial layouts are missing glyphs still waiting on the atlas so don't keep them around
+		if (found_all)
+		{
+			this->layoutCache.insert(key, layout);
+		}
+
+		return found_all;
+	}
+
+	bool Font::layoutText(const std::string& str, TextOptions& options, TextLines& lineData, RectF& bounds, std::vector<RectF>& lineBounds, float32* maxWidth, float32 textScale)
 	{
 		bool firstVert = true;
 		float32 x_adv = 0.0f;
 		float32 y_adv = 0.0f;
 
 		bool found_all = true;
+
+		// SDF glyph metrics are stored at the reference size
+		float32 glyphScale = (this->mode == FontAtlasSDF) ? float32(options.size) / float32(kSDFReferenceSize) : 1.0f;
 		
 		// Use 'T' as the max height character
 		CharacterPair heightPair('T', options.size);
@@ -221,7 +381,7 @@ namespace cs
 		size_t use_height = 0;
 		if (height_ptr)
 		{
-			use_height = height_ptr->data->height * 1.2;
+			use_height = size_t((height_ptr->data->height - (height_ptr->padding * 2)) * glyphScale * 1.2);
 		}
 
 		FontAtlasPtr fontAtlas = this->getAtlas(options.size);
@@ -235,8 +395,8 @@ namespace cs
 		RectF vertBounds;
 		FloatExtentCalculator widthCalc;
 		FloatExtentCalculator heightCalc;
-		
-		std::string curLine;
+
+		vertices.reserve(str.length() * 4);
 
 		for (size_t c = 0; c < str.length(); c++)
 		{
@@ -277,7 +437,6 @@ namespace cs
 
 				lineBounds.push_back(vertBounds);
 				
-				curLine = std::string();
 				x_adv = 0.0f;
 				y_adv -= use_height + 1;
 				continue;
@@ -289,7 +448,6 @@ namespace cs
 				continue;
 			}
 
-			curLine.push_back(str[c]);
 			float32 scale = (str[c] == ' ') ? this->getDoubleSpace() : 1.0f;
 
 			CharacterPair charPair(str[c], options.size);
@@ -303,20 +461,25 @@ namespace cs
 
 			if (ptr->data->texture == nullptr)
 			{
-				x_adv += ptr->x_advance * scale;
+				x_adv += ptr->x_advance * glyphScale * scale;
 				found_all = found_all && isspace(str[c]);
 				continue;
 			}
 				
-			RectF charRect;
-			found_all = found_all && fontAtlas->getCharacterRect(charPair, charRect);
+			const RectF& charRect = ptr->uvRect;
 
-			RectF scaleRect(ptr->left, ptr->top - ptr->data->height, ptr->data->width, ptr->data->height);
+			RectF scaleRect(
+				ptr->left * glyphScale, 
+				(ptr->top - ptr->data->height) * glyphScale, 
+				ptr->data->width * glyphScale, 
+				ptr->data->height * glyphScale);
 
-			widthCalc.evaluate(x_adv + scaleRect.getLeft());
-			widthCalc.evaluate(x_adv + scaleRect.getRight());
-			heightCalc.evaluate(y_adv + scaleRect.getTop());
-			heightCalc.evaluate(y_adv + scaleRect.getBottom());
+			// the distance field border is part of the quad but not the text extents
+			float32 pad = ptr->padding * glyphScale;
+			widthCalc.evaluate(x_adv + scaleRect.getLeft() + pad);
+			widthCalc.evaluate(x_adv + scaleRect.getRight() - pad);
+			heightCalc.evaluate(y_adv + scaleRect.getTop() - pad);
+			heightCalc.evaluate(y_adv + scaleRect.getBottom() + pad);
 
 			if (textScale != 1.0f)
 			{
@@ -341,7 +504,7 @@ namespace cs
 				});
 			}
 
-			x_adv += ptr->x_advance;			
+			x_adv += ptr->x_advance * glyphScale;
 		}
 
 		if (vertices.size() > 0)
@@ -395,15 +558,25 @@ namespace cs
             return;
         }
         
-        TextOptions options;
-        options.size = sz;
-        
-        TextLines lines;
-        RectF dummyRect;
-		std::vector<RectF> dummyBounds;
-        
-		font->generateVertices(str, options, lines, dummyRect, dummyBounds, nullptr);
+		// rasterise on a worker, the glyphs are handed to the atlas on the next updateFonts
+		Font::CharacterPairList toRasterize;
+		font->requestChars(str, sz, toRasterize);
+		if (toRasterize.empty())
+			return;
+
+		this->dispatchRasterize(font, toRasterize);
     }
+
+	void FontManager::dispatchRasterize(FontPtr& font, Font::CharacterPairList& toRasterize)
+	{
+		FontPtr fontRef = font;
+		FontAtlasMode rasterMode = font->getMode();
+		uint32 rasterModeVersion = font->getModeVersion();
+		TaskQueue::getInstance()->push([fontRef, toRasterize, rasterMode, rasterModeVersion]()
+		{
+			fontRef->rasterizeChars(toRasterize, rasterMode, rasterModeVersion);
+		});
+	}
     
 	void FontManager::preload(const std::string& fileName, uint16 sz)
 	{
@@ -423,6 +596,19 @@ namespace cs
 		font->setDoubleSpace(doubleSpace);
 	}
 
+	void FontManager::setSDF(const std::string& fontName, bool sdf)
+	{
+		FontPtr& font = this->getFont(fontName);
+		if (!font.get())
+		{
+			log::error("Cannot find font ", fontName);
+			return;
+		}
+
+		// text elements using the font see the mode version change and swap shaders and relayout on their next batch
+		font->setMode((sdf) ? FontAtlasSDF : FontAtlasBitmap);
+	}
+
 	FontPtr& FontManager::getFont(const std::string& fileName)
 	{
 		FontMap::iterator it = this->fonts.find(fileName);
@@ -449,7 +635,16 @@ namespace cs
 	void FontManager::updateFonts()
 	{
 		for (auto& it : this->fonts)
+		{
+			Font::CharacterPairList toRasterize;
+			it.second->takeRequests(toRasterize);
+			if (!toRasterize.empty())
+			{
+				this->dispatchRasterize(it.second, toRasterize);
+			}
+
 			it.second->update();
+		}
 	}
 
 
@@ -4,6 +4,7 @@
 
 #include "global/Singleton.h"
 #include "font/FontAtlas.h"
+#include "font/TextLayoutCache.h"
 
 #include <ft2build.h>
 #include <freetype.h>
@@ -13,6 +14,8 @@
 
 #include <string>
 #include <map>
+#include <set>
+#include <mutex>
 
 #include "gfx/TextureHandle.h"
 
@@ -23,15 +26,6 @@ namespace cs
 
 	class FontManager;
 
-	struct TextVertex
-	{
-		vec3 pos;
-		vec2 uv;
-	};
-
-	typedef std::vector<TextVertex> TextVertices;
-	typedef std::vector<TextVertices> TextLines;
-
 	struct TextOptions
 	{
 		uint16 size;
@@ -49,6 +43,10 @@ namespace cs
 		struct FontLock { };
 
 	public:
+
+		// SDF glyphs are generated once at this pixel size and scaled to whatever size is drawn
+		const static uint16 kSDFReferenceSize = 48;
+		const static uint16 kSDFSpread = 6;
 	
 		Font(FontLock& lock, const std::string& name, const FontAtlasSize& atlasSize);
 		virtual ~Font() { }
@@ -67,15 +65,41 @@ namespace cs
 
 		void getInfo(std::string& str);
 		void preload(const std::string& str, TextOptions& options);
-		void setDoubleSpace(float32 space) { this->doubleSpace = space; }
+		void setDoubleSpace(float32 space) { this->doubleSpace = space; this->layoutCache.clear(); }
 		float32 getDoubleSpace() const { return this->doubleSpace; }
 
+		void setMode(FontAtlasMode m);
+		FontAtlasMode getMode() const { return this->mode; }
+		bool isSDF() const { return this->mode == FontAtlasSDF; }
+
+		// bumped by every mode switch, anything built against an older version is stale
+		uint32 getModeVersion() const { return this->modeVersion; }
+
+		inline uint16 getAtlasSize(uint16 sz) const { return (this->mode == FontAtlasSDF) ? kSDFReferenceSize : sz; }
+
 	private:
 
 		friend class FontManager;
 
+		typedef std::vector<CharacterPair> CharacterPairList;
+		struct RasterizedChar
+		{
+			CharacterPair pair;
+			CharacterData* data;
+			uint32 modeVersion;
+		};
+		typedef std::vector<RasterizedChar> RasterizedList;
+
 		const CharacterData* findChar(const CharacterPair& pair);
+		CharacterData* rasterizeChar(const CharacterPair& pair, FontAtlasMode rasterMode);
+		bool layoutText(const std::string& str, TextOptions& options, TextLines& lines, RectF& bounds, std::vector<RectF>& lineBounds, float32* maxWidth, float32 textScale);
 		bool init(FT_Library& fl);
+
+		// background pre-rasterisation; requestChars runs on the main thread, rasterizeChars on a worker
+		void requestChars(const std::string& str, uint16 sz, CharacterPairList& toRasterize);
+		void rasterizeChars(const CharacterPairList& pairs, FontAtlasMode rasterMode, uint32 rasterModeVersion);
+		void flushRasterized();
+		void takeRequests(CharacterPairList& toRasterize) { toRasterize.swap(this->requested); }
 		
 		std::string fileName;
 		FT_Face face;
@@ -84,6 +108,18 @@ namespace cs
 		FontTextureSizeMap fontTexture;
 		FontAtlasSize dimm;
 		float32 doubleSpace;
+		FontAtlasMode mode;
+		uint32 modeVersion;
+
+		TextLayoutCache layoutCache;
+
+		// FreeType faces are not thread safe
+		std::mutex faceLock;
+
+		std::mutex rasterizedLock;
+		RasterizedList rasterized;
+		std::set<CharacterPair> inFlight;
+		CharacterPairList requested;
 
 	};
 
@@ -100,10 +136,13 @@ namespace cs
         void preloadWithString(const std::string& fileName, uint16 sz, const char* str);
         
 		void setDoubleSpace(const std::string& fontName, float32 doubleSpace);
+		void setSDF(const std::string& fontName, bool sdf);
 
 		std::string getDiagnostics();
 
 	private:
+
+		void dispatchRasterize(FontPtr& font, Font::CharacterPairList& toRasterize);
 		
 		static FT_Library ft;
 
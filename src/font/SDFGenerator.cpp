@@ -0,0 +1,113 @@
+#include "PCH.h"
+
+#include "font/SDFGenerator.h"
+
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <algorithm>
+
+namespace cs
+{
+	const float32 kSDFInfinity = 1e20f;
+	const uchar kSDFCoverageThreshold = 127;
+
+	// Felzenszwalb & Huttenlocher lower envelope of parabolas
+	void SDFGenerator::transform1D(const float32* f, uint32 n, float32* d, int32* v, float32* z)
+	{
+		int32 k = 0;
+		v[0] = 0;
+		z[0] = -kSDFInfinity;
+		z[1] = kSDFInfinity;
+
+		for (int32 q = 1; q < int32(n); ++q)
+		{
+			float32 s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / float32(2 * q - 2 * v[k]);
+			while (s <= z[k])
+			{
+				--k;
+				s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / float32(2 * q - 2 * v[k]);
+			}
+			++k;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = kSDFInfinity;
+		}
+
+		k = 0;
+		for (int32 q = 0; q < int32(n); ++q)
+		{
+			while (z[k + 1] < q)
+			{
+				++k;
+			}
+			float32 dq = float32(q - v[k]);
+			d[q] = dq * dq + f[v[k]];
+		}
+	}
+
+	void SDFGenerator::transform(std::vector<float32>& grid, uint32 width, uint32 height)
+	{
+		uint32 maxDimm = std::max<uint32>(width, height);
+		std::vector<float32> f(maxDimm);
+		std::vector<float32> d(maxDimm);
+		std::vector<float32> z(maxDimm + 1);
+		std::vector<int32> v(maxDimm);
+
+		for (uint32 x = 0; x < width; ++x)
+		{
+			for (uint32 y = 0; y < height; ++y)
+				f[y] = grid[x + y * width];
+
+			transform1D(&f[0], height, &d[0], &v[0], &z[0]);
+
+			for (uint32 y = 0; y < height; ++y)
+				grid[x + y * width] = d[y];
+		}
+
+		for (uint32 y = 0; y < height; ++y)
+		{
+			float32* row = &grid[y * width];
+			memcpy(&f[0], row, width * sizeof(float32));
+
+			transform1D(&f[0], width, &d[0], &v[0], &z[0]);
+
+			memcpy(row, &d[0], width * sizeof(float32));
+		}
+	}
+
+	void SDFGenerator::generate(const uchar* src, uint32 srcWidth, uint32 srcHeight, uint32 spread, uchar* dst)
+	{
+		uint32 width = getPaddedSize(srcWidth, spread);
+		uint32 height = getPaddedSize(srcHeight, spread);
+		size_t numCells = width * height;
+
+		std::vector<float32> outside(numCells, kSDFInfinity);
+		std::vector<float32> inside(numCells, 0.0f);
+
+		for (uint32 y = 0; y < srcHeight; ++y)
+		{
+			for (uint32 x = 0; x < srcWidth; ++x)
+			{
+				if (src[x + y * srcWidth] > kSDFCoverageThreshold)
+				{
+					size_t idx = (x + spread) + (y + spread) * width;
+					outside[idx] = 0.0f;
+					inside[idx] = kSDFInfinity;
+				}
+			}
+		}
+
+		transform(outside, width, height);
+		transform(inside, width, height);
+
+		float32 invRange = 1.0f / float32(spread * 2);
+		for (size_t i = 0; i < numCells; ++i)
+		{
+			float32 dist = sqrtf(inside[i]) - sqrtf(outside[i]);
+			float32 value = 0.5f + dist * invRange;
+			value = std::min<float32>(1.0f, std::max<float32>(0.0f, value));
+			dst[i] = uchar(value * 255.0f);
+		}
+	}
+}
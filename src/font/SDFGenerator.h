@@ -0,0 +1,24 @@
+#pragma once
+
+#include "global/Values.h"
+
+#include <vector>
+
+namespace cs
+{
+	// Builds single channel signed distance fields from 8-bit coverage bitmaps.
+	// Output is (w + 2 * spread) x (h + 2 * spread) bytes where 128 sits on the glyph
+	// edge and 0/255 are spread pixels outside/inside it.
+	struct SDFGenerator
+	{
+		static void generate(const uchar* src, uint32 srcWidth, uint32 srcHeight, uint32 spread, uchar* dst);
+
+		static inline uint32 getPaddedSize(uint32 sz, uint32 spread) { return sz + (spread * 2); }
+
+	private:
+
+		// squared euclidean distance to the nearest zero cell, in place
+		static void transform(std::vector<float32>& grid, uint32 width, uint32 height);
+		static void transform1D(const float32* f, uint32 n, float32* d, int32* v, float32* z);
+	};
+}
@@ -0,0 +1,47 @@
+#include "PCH.h"
+
+#include "font/TextLayoutCache.h"
+
+namespace cs
+{
+	const TextLayout* TextLayoutCache::find(const TextLayoutKey& key)
+	{
+		EntryMap::iterator it = this->lookup.find(key);
+		if (it == this->lookup.end())
+		{
+			++this->misses;
+			return nullptr;
+		}
+
+		// bump to the front so the most recently drawn strings survive eviction
+		this->entries.splice(this->entries.begin(), this->entries, it->second);
+		++this->hits;
+		return &it->second->second;
+	}
+
+	void TextLayoutCache::insert(const TextLayoutKey& key, const TextLayout& layout)
+	{
+		EntryMap::iterator it = this->lookup.find(key);
+		if (it != this->lookup.end())
+		{
+			it->second->second = layout;
+			this->entries.splice(this->entries.begin(), this->entries, it->second);
+			return;
+		}
+
+		while (this->entries.size() >= this->capacity && this->entries.size() > 0)
+		{
+			this->lookup.erase(this->entries.back().first);
+			this->entries.pop_back();
+		}
+
+		this->entries.push_front(Entry(key, layout));
+		this->lookup[key] = this->entries.begin();
+	}
+
+	void TextLayoutCache::clear()
+	{
+		this->lookup.clear();
+		this->entries.clear();
+	}
+}
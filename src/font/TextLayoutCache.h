@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ClassDef.h"
+#include "math/Rect.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace cs
+{
+	struct TextVertex
+	{
+		vec3 pos;
+		vec2 uv;
+	};
+
+	typedef std::vector<TextVertex> TextVertices;
+	typedef std::vector<TextVertices> TextLines;
+
+	struct TextLayoutKey
+	{
+		TextLayoutKey()
+			: size(0)
+			, wrapWidth(-1.0f)
+			, textScale(1.0f)
+		{ }
+
+		TextLayoutKey(const std::string& str, uint16 sz, const float32* maxWidth, float32 scale)
+			: text(str)
+			, size(sz)
+			, wrapWidth((maxWidth) ? *maxWidth : -1.0f)
+			, textScale(scale)
+		{ }
+
+		bool operator==(const TextLayoutKey& rhs) const
+		{
+			return this->size == rhs.size &&
+				this->wrapWidth == rhs.wrapWidth &&
+				this->textScale == rhs.textScale &&
+				this->text == rhs.text;
+		}
+
+		std::string text;
+		uint16 size;
+		float32 wrapWidth;
+		float32 textScale;
+	};
+
+	struct TextLayoutKeyHash
+	{
+		size_t operator()(const TextLayoutKey& key) const
+		{
+			size_t h = std::hash<std::string>()(key.text);
+			h ^= std::hash<uint32>()(key.size) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<float32>()(key.wrapWidth) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<float32>()(key.textScale) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	struct TextLayout
+	{
+		TextLines lines;
+		RectF bounds;
+		std::vector<RectF> lineBounds;
+	};
+
+	// Shaped glyph runs keyed by (size, string, wrap width, scale) with LRU eviction.
+	// Owned per Font so the font is implicit in the key.
+	class TextLayoutCache
+	{
+	public:
+
+		const static size_t kDefaultCapacity = 128;
+
+		TextLayoutCache(size_t cap = kDefaultCapacity)
+			: capacity(cap)
+			, hits(0)
+			, misses(0)
+		{ }
+
+		const TextLayout* find(const TextLayoutKey& key);
+		void insert(const TextLayoutKey& key, const TextLayout& layout);
+		void clear();
+
+		size_t size() const { return this->entries.size(); }
+		size_t getHits() const { return this->hits; }
+		size_t getMisses() const { return this->misses; }
+
+	private:
+
+		typedef std::pair<TextLayoutKey, TextLayout> Entry;
+		typedef std::list<Entry> EntryList;
+		typedef std::unordered_map<TextLayoutKey, EntryList::iterator, TextLayoutKeyHash> EntryMap;
+
+		EntryList entries;
+		EntryMap lookup;
+
+		size_t capacity;
+		size_t hits;
+		size_t misses;
+	};
+}
@@ -16,6 +16,7 @@ namespace cs
 		"Orientation",
 		"Color",
 		"ColorRange",
+		"ColorKeyFrame",
 		"Size",
 		"SizeRange",
 		"Angle",
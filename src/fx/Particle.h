@@ -9,10 +9,12 @@
 #include "global/Callback.h"
 #include "global/Singleton.h"
 #include "math/Transform.h"
+#include "math/Curve.h"
 
 #include <unordered_map>
 
 #define MAX_EMITTER_PARTICLES 256
+#define PARTICLE_CURVE_SAMPLES 16
 
 namespace cs
 {
@@ -42,6 +44,9 @@ namespace cs
 	typedef BitMask<ParticleProperty, ParticlePropertyMAX> ParticlePropertyMask;
 	extern const char* kParticlePropertyStr[];
 
+	// keyed values over a particle's life, stored per particle
+	typedef BakedCurve<ColorB, PARTICLE_CURVE_SAMPLES> ColorBCurveValue;
+
 	struct ParticlePropertyUpdate
 	{
 		template <class T>
@@ -50,6 +55,12 @@ namespace cs
 			RangeValue<T>::applyLerp(pct, range, val);
 		}
 
+		template <class T, class C>
+		static void curveUpdateFunc(float32 dt, float32 pct, C* curve, T* val)
+		{
+			(*val) = curve->evaluate(pct);
+		}
+
 		template <class T>
 		static void eulerUpdateFunc(float32 dt, float32 pct, T* src, T* dst)
 		{
@@ -237,6 +248,9 @@ namespace cs
 			ParticlePropertyDataUpdater<ColorBRangeValue, ColorB>::TypedUpdateFunction callColorUpdateFunc =
 				std::bind(&ParticlePropertyUpdate::lerpUpdateFunc<ColorB>, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
 
+			ParticlePropertyDataUpdater<ColorBCurveValue, ColorB>::TypedUpdateFunction callColorCurveUpdateFunc =
+				std::bind(&ParticlePropertyUpdate::curveUpdateFunc<ColorB, ColorBCurveValue>, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+
 			ParticlePropertyDataUpdater<vec3, vec3>::TypedUpdateFunction callEulerUpdateFunc = 
 				std::bind(&ParticlePropertyUpdate::eulerUpdateFunc<vec3>, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
 
@@ -273,7 +287,7 @@ namespace cs
 				= new ParticlePropertyDataTyped<ColorB>(ParticlePropertyColor);
 
 			this->propertyData[ParticlePropertyColorKeyFrame]
-				= new ParticlePropertyDataTyped<ColorB>(ParticlePropertyColor);
+				= new ParticlePropertyDataUpdater<ColorBCurveValue, ColorB>(callColorCurveUpdateFunc, ParticlePropertyColorKeyFrame, ParticlePropertyColor);
 
 			this->propertyData[ParticlePropertyColorRange]
 				= new ParticlePropertyDataUpdater<ColorBRangeValue, ColorB>(callColorUpdateFunc, ParticlePropertyColorRange, ParticlePropertyColor);
@@ -457,6 +471,16 @@ namespace cs
 			memcpy(this->bufferData + dst, this->bufferData + src, this->currentSize);
 		}
 
+		// both buffers must have been built from the same mask
+		void copyElement(size_t dst_index, const ParticleBuffer& src, size_t src_index)
+		{
+			assert(this->currentSize == src.currentSize);
+			assert(dst_index < this->numElements && src_index < src.numElements);
+			memcpy(this->bufferData + this->currentSize * dst_index, src.bufferData + src.currentSize * src_index, this->currentSize);
+		}
+
+		size_t getNumElements() const { return this->numElements; }
+
 		void print(std::stringstream& oss);
 		void update(float32 dt, float32 pct, size_t index);
 		
@@ -0,0 +1,253 @@
+#include "PCH.h"
+
+#include "fx/ParticleBudget.h"
+#include "fx/ParticleHeap.h"
+#include "fx/ParticleEffect.h"
+
+#include "global/Stats.h"
+#include "global/Random.h"
+
+#include <algorithm>
+
+namespace cs
+{
+	const float32 kParticlePriorityWeight[ParticlePriorityMAX] = { 1.0f, 0.75f, 0.4f, 0.0f };
+	const float32 kParticleVisibilityMargin = 1.1f;
+
+	ParticleBudgetSettings::ParticleBudgetSettings()
+		: maxParticles(16000)
+		, pressureThreshold(0.75f)
+		, lodNearDistance(50.0f)
+		, lodFarDistance(400.0f)
+		, minSpawnScale(0.25f)
+		, offscreenSpawnScale(0.5f)
+		, offscreenUpdateInterval(2)
+		, maxCatchUpTime(0.25f)
+	{
+
+	}
+
+	ParticleBudgetSettings ParticleBudgetSettings::getPlatformDefaults()
+	{
+		ParticleBudgetSettings settings;
+#if defined(CS_IOS) || defined(CS_IPHONE)
+		settings.maxParticles = 4000;
+		settings.minSpawnScale = 0.1f;
+		settings.offscreenUpdateInterval = 4;
+#endif
+		return settings;
+	}
+
+	ParticleBudget::ParticleBudget()
+		: settings(ParticleBudgetSettings::getPlatformDefaults())
+		, hasViewer(false)
+		, viewProjection(1.0f)
+		, viewerPosition(kZero3)
+		, viewerProjection(ProjectionNone)
+	{
+
+	}
+
+	ParticleBudget::~ParticleBudget()
+	{
+		this->collections.clear();
+	}
+
+	void ParticleBudget::registerCollection(ParticleHeapCollection* collection)
+	{
+		if (std::find(this->collections.begin(), this->collections.end(), collection) == this->collections.end())
+		{
+			this->collections.push_back(collection);
+		}
+	}
+
+	void ParticleBudget::unregisterCollection(ParticleHeapCollection* collection)
+	{
+		auto it = std::find(this->collections.begin(), this->collections.end(), collection);
+		if (it != this->collections.end())
+		{
+			this->collections.erase(it);
+		}
+	}
+
+	void ParticleBudget::setViewer(const CameraPtr& camera)
+	{
+		this->hasViewer = camera.get() != nullptr;
+		if (!this->hasViewer)
+			return;
+
+		this->viewProjection = camera->getCurrentProjection() * camera->getCurrentView();
+		this->viewerPosition = camera->getTranslation();
+		this->viewerProjection = camera->getProjectionType();
+	}
+
+	void ParticleBudget::update()
+	{
+		// publish what the last frame did before starting over
+		EngineStats::setStat(StatTypeParticleCount, this->stats.liveParticles);
+		EngineStats::setStat(StatTypeParticleBudget, this->settings.maxParticles);
+		EngineStats::setStat(StatTypeParticleCulled, this->stats.culled);
+
+		this->stats = ParticleBudgetStats();
+
+		for (auto& collection : this->collections)
+		{
+			for (int32 traversal = 0; traversal < RenderTraversalMAX; ++traversal)
+			{
+				for (auto& it : collection->buffers[traversal])
+				{
+					ParticleHeapPtr& heap = it.second;
+					size_t numParticles = heap->getNumParticles();
+
+					bool visible = collection->renderManually || !this->hasViewer || numParticles == 0 ||
+						this->isVisible(heap->getBoundsMin(), heap->getBoundsMax());
+					heap->setVisible(visible);
+
+					this->stats.liveParticles += int32(numParticles);
+					this->stats.heaps++;
+					if (!visible)
+						this->stats.heapsOffscreen++;
+				}
+			}
+		}
+
+		int32 maxParticles = std::max<int32>(1, this->settings.maxParticles);
+		this->stats.pressure = float32(this->stats.liveParticles) / float32(maxParticles);
+
+		if (this->stats.liveParticles > maxParticles)
+		{
+			this->cull(size_t(this->stats.liveParticles - maxParticles));
+		}
+	}
+
+	void ParticleBudget::cull(size_t excess)
+	{
+		std::vector<ParticleHeap*> candidates;
+		for (auto& collection : this->collections)
+		{
+			for (int32 traversal = 0; traversal < RenderTraversalMAX; ++traversal)
+			{
+				for (auto& it : collection->buffers[traversal])
+				{
+					ParticleHeap* heap = it.second.get();
+					if (heap->getNumParticles() > 0 && heap->getPriority() < ParticlePriorityCritical)
+					{
+						candidates.push_back(heap);
+					}
+				}
+			}
+		}
+
+		// lowest priority first, off-screen before on-screen within a priority
+		std::stable_sort(candidates.begin(), candidates.end(), [](const ParticleHeap* a, const ParticleHeap* b)
+		{
+			if (a->getPriority() != b->getPriority())
+				return a->getPriority() < b->getPriority();
+			return !a->isVisible() && b->isVisible();
+		});
+
+		for (auto& heap : candidates)
+		{
+			if (excess == 0)
+				break;
+
+			size_t culled = heap->cullParticles(excess);
+			excess -= culled;
+			this->stats.culled += int32(culled);
+			this->stats.liveParticles -= int32(culled);
+		}
+	}
+
+	bool ParticleBudget::isVisible(const vec3& minb, const vec3& maxb) const
+	{
+		int32 outside[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int32 i = 0; i < 8; ++i)
+		{
+			vec4 corner(
+				(i & 1) ? maxb.x : minb.x,
+				(i & 2) ? maxb.y : minb.y,
+				(i & 4) ? maxb.z : minb.z,
+				1.0f);
+
+			vec4 clip = this->viewProjection * corner;
+			float32 w = fabs(clip.w) * kParticleVisibilityMargin;
+
+			outside[0] += (clip.x < -w) ? 1 : 0;
+			outside[1] += (clip.x > w) ? 1 : 0;
+			outside[2] += (clip.y < -w) ? 1 : 0;
+			outside[3] += (clip.y > w) ? 1 : 0;
+			outside[4] += (clip.z < -w) ? 1 : 0;
+			outside[5] += (clip.z > w) ? 1 : 0;
+		}
+
+		for (int32 plane = 0; plane < 6; ++plane)
+		{
+			if (outside[plane] == 8)
+				return false;
+		}
+		return true;
+	}
+
+	float32 ParticleBudget::getSpawnScale(int32 priority, const vec3& worldPosition) const
+	{
+		if (priority >= ParticlePriorityCritical)
+			return 1.0f;
+
+		float32 threshold = std::min<float32>(this->settings.pressureThreshold, 0.99f);
+		float32 pressureFactor = clamp(0.0f, 1.0f, (this->stats.pressure - threshold) / (1.0f - threshold));
+		float32 scale = 1.0f - pressureFactor * kParticlePriorityWeight[clamp<int32>(0, ParticlePriorityMAX - 1, priority)];
+
+		if (this->hasViewer)
+		{
+			// heap positions have z flipped on the way in, test the emitter in the same space
+			vec3 pos(worldPosition.x, worldPosition.y, -worldPosition.z);
+			if (!this->isVisible(pos, pos))
+			{
+				scale *= this->settings.offscreenSpawnScale;
+			}
+			else if (this->viewerProjection == ProjectionPerspective && this->settings.lodFarDistance > this->settings.lodNearDistance)
+			{
+				float32 dist = glm::length(pos - this->viewerPosition);
+				float32 t = clamp(0.0f, 1.0f, (dist - this->settings.lodNearDistance) / (this->settings.lodFarDistance - this->settings.lodNearDistance));
+				scale *= lerp(1.0f, this->settings.minSpawnScale, t);
+			}
+		}
+
+		return scale;
+	}
+
+	size_t ParticleBudget::scaleSpawn(ParticleEffect* effect, const vec3& worldPosition, size_t requested)
+	{
+		if (requested == 0)
+			return 0;
+
+		this->stats.spawnsRequested += int32(requested);
+
+		ParticleEffectDataPtr& data = effect->getParticleEffectData();
+		int32 priority = (data.get()) ? data->getPriority() : int32(ParticlePriorityNormal);
+
+		float32 scale = this->getSpawnScale(priority, worldPosition);
+		if (scale >= 1.0f)
+			return requested;
+
+		// round stochastically so low rate emitters still spawn on average
+		float32 scaled = float32(requested) * std::max<float32>(0.0f, scale);
+		size_t count = size_t(scaled);
+		if (Random::get().nextFloat() < scaled - float32(count))
+			++count;
+
+		this->stats.spawnsDropped += int32(requested - count);
+		return count;
+	}
+
+	std::string ParticleBudget::getStatsString() const
+	{
+		std::stringstream str;
+		str << "Budget: " << this->stats.liveParticles << "/" << this->settings.maxParticles
+			<< " Pressure: " << this->stats.pressure
+			<< " Culled: " << this->stats.culled
+			<< " Spawns Dropped: " << this->stats.spawnsDropped << "/" << this->stats.spawnsRequested
+			<< " Heaps Off-screen: " << this->stats.heapsOffscreen << "/" << this->stats.heaps;
+		return str.str();
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ClassDef.h"
+
+#include "global/Singleton.h"
+#include "scene/Camera.h"
+
+#include <vector>
+
+namespace cs
+{
+	class ParticleEffect;
+	class ParticleHeap;
+	struct ParticleHeapCollection;
+
+	enum ParticlePriority
+	{
+		ParticlePriorityLow,
+		ParticlePriorityNormal,
+		ParticlePriorityHigh,
+		ParticlePriorityCritical,	// never scaled or culled
+		//...
+		ParticlePriorityMAX
+	};
+
+	struct ParticleBudgetSettings
+	{
+		ParticleBudgetSettings();
+
+		int32 maxParticles;				// across every heap collection
+		float32 pressureThreshold;		// fraction of the budget where spawn scaling starts
+		float32 lodNearDistance;		// full spawn rate inside this distance (perspective only)
+		float32 lodFarDistance;			// spawn rate reaches minSpawnScale here
+		float32 minSpawnScale;
+		float32 offscreenSpawnScale;
+		int32 offscreenUpdateInterval;	// frames between updates of heaps nobody can see
+		float32 maxCatchUpTime;			// most time an off-screen heap can bank before it is forced to update
+
+		static ParticleBudgetSettings getPlatformDefaults();
+	};
+
+	struct ParticleBudgetStats
+	{
+		ParticleBudgetStats()
+			: liveParticles(0)
+			, spawnsRequested(0)
+			, spawnsDropped(0)
+			, culled(0)
+			, heaps(0)
+			, heapsOffscreen(0)
+			, pressure(0.0f) { }
+
+		int32 liveParticles;
+		int32 spawnsRequested;
+		int32 spawnsDropped;
+		int32 culled;
+		int32 heaps;
+		int32 heapsOffscreen;
+		float32 pressure;
+	};
+
+	// Global view over every ParticleHeapCollection.  Once per frame it counts live particles,
+	// flags heaps the main camera can't see (they update at a lower rate and catch up on the
+	// time they skipped) and culls the oldest particles of the lowest priority effects when
+	// over budget.  Emitters ask it to scale their spawn counts by priority, budget pressure
+	// and distance/visibility.
+	class ParticleBudget : public Singleton<ParticleBudget>
+	{
+	public:
+
+		ParticleBudget();
+		~ParticleBudget();
+
+		void setSettings(const ParticleBudgetSettings& s) { this->settings = s; }
+		const ParticleBudgetSettings& getSettings() const { return this->settings; }
+
+		void setMaxParticles(int32 maxParticles) { this->settings.maxParticles = maxParticles; }
+		int32 getMaxParticles() const { return this->settings.maxParticles; }
+
+		void registerCollection(ParticleHeapCollection* collection);
+		void unregisterCollection(ParticleHeapCollection* collection);
+
+		// Camera the visibility and distance LOD is measured against
+		void setViewer(const CameraPtr& camera);
+
+		// Call once per frame before any emitter or heap is processed
+		void update();
+
+		size_t scaleSpawn(ParticleEffect* effect, const vec3& worldPosition, size_t requested);
+
+		const ParticleBudgetStats& getStats() const { return this->stats; }
+		std::string getStatsString() const;
+
+	private:
+
+		bool isVisible(const vec3& minb, const vec3& maxb) const;
+		float32 getSpawnScale(int32 priority, const vec3& worldPosition) const;
+		void cull(size_t excess);
+
+		ParticleBudgetSettings settings;
+		ParticleBudgetStats stats;
+
+		std::vector<ParticleHeapCollection*> collections;
+
+		bool hasViewer;
+		mat4 viewProjection;
+		vec3 viewerPosition;
+		ProjectionType viewerProjection;
+	};
+}
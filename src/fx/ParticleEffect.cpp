@@ -1,6 +1,7 @@
 #include "PCH.h"
 
 #include "fx/ParticleEffect.h"
+#include "fx/ParticleBudget.h"
 #include "gfx/RenderInterface.h"
 #include "global/ResourceFactory.h"
 
@@ -83,6 +84,11 @@ namespace cs
 			SET_MEMBER_NO_SLIDER();
 			SET_MEMBER_CALLBACK_POST(&ParticleEffectData::updateMaxParticles);
 
+		ADD_MEMBER(priority);
+			SET_MEMBER_DEFAULT(int32(ParticlePriorityNormal));
+			SET_MEMBER_MIN(int32(ParticlePriorityLow));
+			SET_MEMBER_MAX(int32(ParticlePriorityCritical));
+
 		ADD_MEMBER(modules);
 			ADD_PARTICLE_MODULES();
 			SET_MEMBER_CALLBACK_POST(&ParticleEffectData::onModuleChanged);
@@ -139,6 +145,7 @@ namespace cs
 		, spawn(CREATE_CLASS(ParticleVec3ValueConstant, kZero3))
 		, maxParticles(0)
 		, maxParticlesOverride(-1)
+		, priority(ParticlePriorityNormal)
 		, mask(kDefaultMaskProperties)
 		, texture(CREATE_CLASS(TextureHandle, RenderInterface::kWhiteTexture))
 		, textureAnimationIndex(false)
@@ -204,12 +211,18 @@ namespace cs
 
 		ColorB frameTint = this->tint->getValue();
 
+		// draw the per particle base values in bulk before the module loop
+		num_particles = std::min<size_t>(num_particles, MAX_EMITTER_PARTICLES - particle_data.numParticles);
+		float32 lifeTimes[MAX_EMITTER_PARTICLES];
+		vec3 positions[MAX_EMITTER_PARTICLES];
+		this->lifeTime->fillValues(lifeTimes, num_particles);
+		this->spawn->fillValues(positions, num_particles);
 
 		for (size_t i = 0; i < num_particles; i++)
 		{
 			ParticleInitProps& data = particle_data.next();
-			data.lifeTime = this->lifeTime->getValue();
-			data.position = this->spawn->getValue();
+			data.lifeTime = lifeTimes[i];
+			data.position = positions[i];
 			data.processTime = this->processTime;
 			data.tint = frameTint;
 
@@ -129,6 +129,7 @@ namespace cs
 		ParticleModuleList modules;
 
 		int32 getMaxParticles() const { return this->maxParticles; }
+		int32 getPriority() const { return this->priority; }
 		
 		void updateMask();
 		void updateMaxParticles();
@@ -149,6 +150,7 @@ namespace cs
 
 		int32 maxParticles;
 		int32 maxParticlesOverride;
+		int32 priority;
 		
 		DrawOptions options;
 		TextureHandlePtr texture;
@@ -1,8 +1,11 @@
 #include "PCH.h"
 
 #include "fx/ParticleEmitter.h"
+#include "fx/ParticleBudget.h"
 #include "ecs/system/ParticleSystem.h"
 #include "global/ResourceFactory.h"
+#include "global/TaskQueue.h"
+#include "global/Profiler.h"
 
 namespace cs
 {
@@ -85,6 +88,53 @@ namespace cs
 		}
 	}
 
+	void ParticlePrewarmJob::run()
+	{
+		const float32 kPrewarmStep = 0.1f;
+
+		RandomStreamScope randomScope(this->random);
+		size_t capacity = this->buffer.getNumElements();
+
+		float32 elapsed = 0.0f;
+		while (elapsed < this->seconds && this->numParticles < capacity)
+		{
+			float32 step = std::min<float32>(kPrewarmStep, this->seconds - elapsed);
+			size_t toSpawn = this->instance.process(this->effect.get(), step);
+			elapsed += step;
+
+			size_t spawned = 0;
+			while (spawned < toSpawn && this->numParticles < capacity)
+			{
+				ParticleInitList particle_list(this->owner);
+				this->effect->createParticles(particle_list, std::min<size_t>(toSpawn - spawned, MAX_EMITTER_PARTICLES));
+				if (particle_list.numParticles == 0)
+					break;
+
+				for (size_t i = 0; i < particle_list.numParticles && this->numParticles < capacity; i++)
+				{
+					// spread spawns across the step so large steps don't emit in clumps
+					float32 age = (this->seconds - elapsed) + step * float32(spawned + i) / float32(toSpawn);
+
+					ParticleInitProps& particle = particle_list.initList[i];
+					if (age >= particle.lifeTime)
+						continue;
+
+					vec3 pos = particle.position * this->contentScale;
+					particle.position = (this->worldRotation * pos) + this->worldPosition;
+					particle.rotation = this->worldRotation;
+
+					ParticleHeap::writeParticle(&this->buffer, this->numParticles, particle, this->owner, this->tint);
+					ParticleHeap::advanceParticle(&this->buffer, this->numParticles, age);
+					this->numParticles++;
+				}
+
+				spawned += particle_list.numParticles;
+			}
+		}
+
+		this->ready.store(true, std::memory_order_release);
+	}
+
 	ParticleEmitter::ParticleEmitter()
 		: particleEffect(CREATE_CLASS(ParticleEffectHandle))
 		, worldPosCallback(nullptr)
@@ -255,7 +305,10 @@ namespace cs
 		}
 
 		ParticleInitList particle_list(this, &this->instance.scriptProperties);
-		effect->createParticles(particle_list, particle_positions.size());
+		{
+			RandomStreamScope randomScope(this->random);
+			effect->createParticles(particle_list, particle_positions.size());
+		}
 
 		particle_list.numParticles =
 			std::min <size_t>(particle_list.numParticles, particle_positions.size());
@@ -296,6 +349,17 @@ namespace cs
 		if (!forceUpdate && (dt < 0.001 || dt > 1.0f))
 			return;
 
+		// emission is held until the prewarmed particles land so the timeline stays continuous
+		if (this->prewarmJob)
+		{
+			if (!this->prewarmJob->ready.load(std::memory_order_acquire))
+			{
+				this->prewarmJob->lag += dt;
+				return;
+			}
+			this->applyPrewarm();
+		}
+
 		vec3 world_pos = kZero3;
 		quat world_rot(Transform::kDefaultRotation);
 		ColorB tint = ColorB::White;
@@ -321,6 +385,8 @@ namespace cs
 			if (effect.get())
 			{
 				size_t particles_to_spawn = std::min<size_t>(this->instance.process(effect.get(), dt), 100);
+				RandomStreamScope randomScope(this->random);
+				particles_to_spawn = ParticleBudget::getInstance()->scaleSpawn(effect.get(), world_pos, particles_to_spawn);
 				if (particles_to_spawn > 0)
 				{
 					ParticleInitList particle_list(this, &this->instance.scriptProperties);
@@ -344,6 +410,94 @@ namespace cs
 		}
 	}
 
+	bool ParticleEmitter::prewarm(float32 seconds, bool async)
+	{
+		if (seconds <= 0.0f)
+			return false;
+
+		ParticleEffectPtr& effect = this->particleEffect->getEffect();
+		if (!effect.get() || !this->heap.get())
+		{
+			log::error("Cannot prewarm an emitter without an effect and heap");
+			return false;
+		}
+
+		if (this->prewarmJob)
+		{
+			log::warning("Emitter is already prewarming");
+			return false;
+		}
+
+		ParticlePrewarmJobPtr job = CREATE_CLASS(ParticlePrewarmJob, this->heap->getMask(), this->heap->getMaxParticles());
+		job->effect = effect;
+		job->instance.type = this->instance.type;
+		job->instance.anim = this->instance.anim;
+		job->instance.emissionCounter = this->instance.emissionCounter;
+
+		if (async)
+		{
+			// the worker gets its own copy of the effect data and emission animator, the live ones stay
+			// with the main thread and the editor (and the emitter again if the prewarm is dropped by a reset)
+			ParticleEffectDataPtr& data = effect->getParticleEffectData();
+			if (!data.get())
+			{
+				log::error("Cannot prewarm an effect without particle data");
+				return false;
+			}
+
+			ParticleEffectDataPtr dataCopy = CREATE_CLASS(ParticleEffectData);
+			data->getMetaData()->copy(dataCopy.get(), data.get());
+			job->effect = CREATE_CLASS(ParticleEffect, effect->getName(), dataCopy);
+
+			if (this->instance.anim.hasAnim())
+			{
+				std::shared_ptr<FloatLerpAnimator> animator = CREATE_CLASS(FloatLerpAnimator, 0.0f, 1.0f, this->instance.anim.animator->getMaxTime());
+				job->instance.anim.animator = std::static_pointer_cast<AnimatorTyped<float32>>(animator);
+			}
+		}
+
+		job->random = this->random;
+		job->owner = this;
+		job->worldPosition = (this->worldPosCallback) ? this->worldPosCallback() : kZero3;
+		job->worldRotation = (this->worldOrientCallback) ? this->worldOrientCallback() : quat(Transform::kDefaultRotation);
+		job->tint = (this->tintCallback) ? this->tintCallback() : ColorB::White;
+		job->contentScale = this->spawnParams.contentScale;
+		job->seconds = seconds;
+		this->prewarmJob = job;
+
+		if (async)
+		{
+			TaskQueue::getInstance()->push([job]()
+			{
+				PROFILE_SCOPE("Particle Prewarm");
+				job->run();
+			});
+		}
+		else
+		{
+			job->run();
+			this->applyPrewarm();
+		}
+
+		return true;
+	}
+
+	void ParticleEmitter::applyPrewarm()
+	{
+		ParticlePrewarmJobPtr job = this->prewarmJob;
+		this->prewarmJob = nullptr;
+
+		if (this->heap)
+		{
+			this->heap->addPrewarmed(job->buffer, job->numParticles, this, job->lag);
+		}
+
+		// carry on emitting from where the prewarm left off
+		this->instance.anim = job->instance.anim;
+		this->instance.emissionCounter = job->instance.emissionCounter;
+		this->random = job->random;
+	}
+
 	void ParticleEmitter::kill()
 	{
 		this->reset();
@@ -359,6 +513,7 @@ namespace cs
 		}
 
 		this->heap->removeParticlesByOwner(this);
+		this->prewarmJob = nullptr;
 		this->setEmitting(true);
 	}
 
@@ -472,6 +627,31 @@ namespace cs
 	}
 
 
+	void ParticleEmitterScope::capture(RenderTraversal traversal)
+	{
+		this->captured.clear();
+		for (auto& heap_collection : this->heaps)
+		{
+			if (heap_collection.second->renderManually)
+				continue;
+
+			for (auto& it : heap_collection.second->buffers[traversal])
+			{
+				DisplayListGeom geom(it.second->geom);
+				geom.freeze();
+				this->captured.push_back(geom);
+			}
+		}
+	}
+
+	void ParticleEmitterScope::drawCaptured()
+	{
+		for (auto& it : this->captured)
+		{
+			it.geom->draw(*it.drawCalls, nullptr);
+		}
+	}
+
 	std::shared_ptr<ParticleHeapCollection> ParticleEmitterScope::getHeap(const std::string& tag, bool renderManually)
 	{
 
@@ -548,6 +728,7 @@ namespace cs
 	{
 		std::stringstream str;
 		str << "Particles: " << ParticleHeap::gTotalParticles << " Heap Size: " << ParticleHeap::gTotalHeapSize;
+		str << " " << ParticleBudget::getInstance()->getStatsString();
 		return str.str();
 	}
 
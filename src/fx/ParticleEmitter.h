@@ -12,6 +12,8 @@
 
 #include "gfx/RenderInterface.h"
 
+#include <atomic>
+
 namespace cs
 {
 	class ParticleEmitter;
@@ -56,6 +58,41 @@ namespace cs
 		ParticleScriptProperties scriptProperties;
 	};
 
+	// Particles simulated ahead of time for ParticleEmitter::prewarm, filled off the main
+	// thread from a copy of the effect and handed to the heap once ready is set
+	struct ParticlePrewarmJob
+	{
+		ParticlePrewarmJob(const ParticlePropertyMask& mask, size_t maxParticles)
+			: buffer(mask, maxParticles)
+			, numParticles(0)
+			, ready(false)
+			, lag(0.0f)
+		{
+			this->buffer.allocate();
+		}
+
+		ParticleBuffer buffer;
+		size_t numParticles;
+
+		ParticleEffectPtr effect;
+		ParticleEmitterInstance instance;
+		RandomStream random;
+		void* owner;
+
+		vec3 worldPosition;
+		quat worldRotation;
+		ColorB tint;
+		float32 contentScale;
+		float32 seconds;
+
+		std::atomic<bool> ready;
+		float32 lag;	// main thread time that passed while the job ran
+
+		void run();
+	};
+
+	typedef std::shared_ptr<ParticlePrewarmJob> ParticlePrewarmJobPtr;
+
 	// why is this forward declared?
 	class ParticleEmitter;
 	CLASS_DEFINITION_DERIVED_REFLECT(ParticleEmitterAnchor, SceneNode)
@@ -142,6 +179,16 @@ namespace cs
 
 		static std::string getStats();
 
+		// Fast-forwards emission and simulation by seconds so the effect starts in progress.  The
+		// simulation runs on a worker when async is set and emission is held until it lands,
+		// call it while loading so the result is in the heap before the first visible frame.
+		bool prewarm(float32 seconds, bool async = true);
+		bool isPrewarming() const { return this->prewarmJob.get() != nullptr; }
+
+		// Everything this emitter spawns draws from its own stream, a fixed seed replays identically
+		void setSeed(uint64 seed) { this->random.seed(seed); }
+		uint64 getSeed() const { return this->random.getSeed(); }
+
 	private:
 		
 		void clearHeap();
@@ -152,6 +199,7 @@ namespace cs
 		
 		void initEffect();
 		void initHeap(const SpawnParams& params);
+		void applyPrewarm();
 
 		RenderTraversalBasePtr traversal;
 		ParticleEffectHandlePtr particleEffect;
@@ -167,6 +215,9 @@ namespace cs
 		bool emitting;
 
 		SpawnParams spawnParams;
+		RandomStream random;
+
+		ParticlePrewarmJobPtr prewarmJob;
 
 	};
 
@@ -185,6 +236,10 @@ namespace cs
 		void process(float32 dt);
 		void draw(RenderTraversal traversal = RenderTraversalMain);
 
+		// Fixes what drawCaptured() issues, so it can run while process() moves the heaps on
+		void capture(RenderTraversal traversal = RenderTraversalMain);
+		void drawCaptured();
+
 		bool exists(const std::string& tag);
 		bool remove(const std::string& tag);
 		void removeAll();
@@ -194,5 +249,7 @@ namespace cs
 
 		ParticleEmitterMap emitters;
 		ParticleHeapMap heaps;
+
+		std::vector<DisplayListGeom> captured;
 	};
 }
\ No newline at end of file
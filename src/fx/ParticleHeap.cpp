@@ -2,12 +2,15 @@
 
 #include "fx/ParticleHeap.h"
 #include "fx/ParticleEmitter.h"
+#include "fx/ParticleBudget.h"
 
 #include "gfx/RenderInterface.h"
 #include "gfx/DrawCall.h"
 
 #include "global/Stats.h"
 
+#include <cfloat>
+
 namespace cs
 {
 
@@ -41,6 +44,11 @@ namespace cs
 		, didResize(0)
 		, lastTick(0)
 		, gracePeriod(5)
+		, visible(true)
+		, pendingTime(0.0f)
+		, skippedFrames(0)
+		, boundsMin(kZero3)
+		, boundsMax(kZero3)
 	{
 		this->effect = eff;
 		GeometryDataPtr data = CREATE_CLASS(cs::GeometryData);
@@ -286,7 +294,7 @@ namespace cs
 		assert(effectData.get());
 
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->tag = this->effect->getName();
+		dc->tag = this->effect->getNameId();
 		dc->type = DrawTriangles;
 		dc->indexType = TypeUnsignedShort;
 		dc->count = uint32(this->numParticles) * 6;
@@ -342,6 +350,12 @@ namespace cs
 		}
 	}
 
+	int32 ParticleHeap::getPriority() const
+	{
+		const ParticleEffectDataPtr& data = this->effect->getParticleEffectData();
+		return (data.get()) ? data->getPriority() : int32(ParticlePriorityNormal);
+	}
+
 	bool ParticleHeap::isExpired() const
 	{
 		return Timer::getCurrentTick() > this->lastTick;
@@ -381,6 +395,22 @@ namespace cs
 			return;
 		}
 
+		// heaps nobody can see bank their time and catch up in one larger step
+		this->pendingTime += dt;
+		if (!this->visible)
+		{
+			const ParticleBudgetSettings& settings = ParticleBudget::getInstance()->getSettings();
+			if (++this->skippedFrames < settings.offscreenUpdateInterval && this->pendingTime < settings.maxCatchUpTime)
+				return;
+		}
+
+		dt = std::min<float32>(this->pendingTime, 1.0f);
+		this->pendingTime = 0.0f;
+		this->skippedFrames = 0;
+
+		this->boundsMin = vec3(FLT_MAX);
+		this->boundsMax = vec3(-FLT_MAX);
+
 		size_t particle_index = 0;
 		while (particle_index < this->numParticles)
 		{
@@ -394,13 +424,7 @@ namespace cs
 
 			if (*time >= *lifeTime)
 			{
-				this->buffer->swap(particle_index, this->numParticles - 1);
-				this->numParticles--;
-
-				void** owner = this->buffer->get<void*>(ParticlePropertyOwner, this->numParticles);
-				assert(owner);
-				this->removeParticleFromOwner(*owner);
-
+				this->removeParticle(particle_index);
 				continue;
 			}
 
@@ -413,14 +437,78 @@ namespace cs
 				float usePct = (shouldUpdate) ? pct : *processTime;
 				this->buffer->update(useDt, usePct, particle_index);
 			}
+
+			this->expandBounds(*this->buffer->get<vec3>(ParticlePropertyPosition, particle_index));
 			
 			particle_index++;
 		}
 
+		if (this->numParticles == 0)
+		{
+			this->boundsMin = kZero3;
+			this->boundsMax = kZero3;
+		}
+
 		if (this->geom)
 			this->geom->update();
 	}
 
+	void ParticleHeap::removeParticle(size_t index)
+	{
+		this->buffer->swap(index, this->numParticles - 1);
+		this->numParticles--;
+
+		void** owner = this->buffer->get<void*>(ParticlePropertyOwner, this->numParticles);
+		assert(owner);
+		this->removeParticleFromOwner(*owner);
+	}
+
+	void ParticleHeap::expandBounds(const vec3& pos)
+	{
+		this->boundsMin = glm::min(this->boundsMin, pos);
+		this->boundsMax = glm::max(this->boundsMax, pos);
+	}
+
+	size_t ParticleHeap::cullParticles(size_t count)
+	{
+		count = std::min<size_t>(count, this->numParticles);
+		if (count == 0)
+			return 0;
+
+		typedef std::pair<float32, size_t> ParticleAge;
+		std::vector<ParticleAge> ages;
+		ages.reserve(this->numParticles);
+		for (size_t i = 0; i < this->numParticles; ++i)
+		{
+			float32* time = this->buffer->get<float32>(ParticlePropertyTime, i);
+			float32* lifeTime = this->buffer->get<float32>(ParticlePropertyLifetime, i);
+			float32 pct = (*lifeTime > 0.0f) ? (*time / *lifeTime) : 1.0f;
+			ages.push_back(ParticleAge(pct, i));
+		}
+
+		std::nth_element(ages.begin(), ages.begin() + (count - 1), ages.end(), [](const ParticleAge& a, const ParticleAge& b)
+		{
+			return a.first > b.first;
+		});
+
+		// remove from the back so the swap never moves a particle that is still to be removed
+		ages.resize(count);
+		std::sort(ages.begin(), ages.end(), [](const ParticleAge& a, const ParticleAge& b)
+		{
+			return a.second > b.second;
+		});
+
+		for (auto& it : ages)
+		{
+			this->removeParticle(it.second);
+		}
+
+		if (this->geom)
+			this->geom->update();
+
+		return count;
+	}
+
 	size_t ParticleHeap::addParticles(ParticleInitList& particle_list)
 	{
 		if (this->numParticles >= this->maxParticles)
@@ -432,61 +520,215 @@ namespace cs
 		size_t particles_created = 0;
 		for (size_t i = 0; i < particle_list.numParticles; i++)
 		{
-			ParticleInitProps& particle = particle_list.initList[i];
 			if (this->numParticles >= this->maxParticles)
 			{
 				break;
 			}
 
-			void** owner = this->buffer->get<void*>(ParticlePropertyOwner, this->numParticles);
-			float32* time = this->buffer->get<float32>(ParticlePropertyTime, this->numParticles);
-			float32* lifeTime = this->buffer->get<float32>(ParticlePropertyLifetime, this->numParticles);
-			float32* processTime = this->buffer->get<float32>(ParticlePropertyProcessTime, this->numParticles);
+			ParticleInitProps& particle = particle_list.initList[i];
+			writeParticle(this->buffer, this->numParticles, particle, particle_list.creator, particle_list.tint);
+
 			vec3* pos = this->buffer->get<vec3>(ParticlePropertyPosition, this->numParticles);
+			if (this->numParticles == 0)
+			{
+				this->boundsMin = *pos;
+				this->boundsMax = *pos;
+			}
+			this->expandBounds(*pos);
 
-			(*time) = 0.0f;
-			(*lifeTime) = particle.lifeTime;
-			(*pos) = particle.position;
-           
-            // Metal Fix Depth
-            (*pos).z = -(*pos).z;
-            
-			(*processTime) = particle.processTime;
-			(*owner) = particle_list.creator;
+			this->addParticleToOwner(particle_list.creator);
+			this->numParticles++;
+		}
 
-			for (auto& prop : particle.propertyMap)
-			{
-				assert(prop.second->getSize() > 0);
-				assert(prop.second->getData() != nullptr);
+		return particles_created;
+	}
+
+	void ParticleHeap::writeParticle(ParticleBuffer* dst, size_t index, const ParticleInitProps& particle, void* owner_ptr, const ColorB& tint)
+	{
+		void** owner = dst->get<void*>(ParticlePropertyOwner, index);
+		float32* time = dst->get<float32>(ParticlePropertyTime, index);
+		float32* lifeTime = dst->get<float32>(ParticlePropertyLifetime, index);
+		float32* processTime = dst->get<float32>(ParticlePropertyProcessTime, index);
+		vec3* pos = dst->get<vec3>(ParticlePropertyPosition, index);
+
+		(*time) = 0.0f;
+		(*lifeTime) = particle.lifeTime;
+		(*pos) = particle.position;
+       
+        // Metal Fix Depth
+        (*pos).z = -(*pos).z;
+        
+		(*processTime) = particle.processTime;
+		(*owner) = owner_ptr;
+
+		for (auto& prop : particle.propertyMap)
+		{
+			assert(prop.second->getSize() > 0);
+			assert(prop.second->getData() != nullptr);
+
+			dst->copy(prop.first, index, prop.second->getData(), prop.second->getSize());
+		}
+
+		if (dst->hasProperty(ParticlePropertyColor))
+		{
+			ColorB* color = dst->get<ColorB>(ParticlePropertyColor, index);
+			(*color) = (*color) * tint * particle.tint;
+		}
 
-				this->buffer->copy(prop.first, this->numParticles, prop.second->getData(), prop.second->getSize());
+		if (dst->hasProperty(ParticlePropertyColorRange))
+		{
+			ColorB* color = dst->get<ColorB>(ParticlePropertyColorRange, index);
+			(*color) = (*color) * tint * particle.tint;
+		}
+
+		if (dst->hasProperty(ParticlePropertyColorKeyFrame))
+		{
+			ColorBCurveValue* curve = dst->get<ColorBCurveValue>(ParticlePropertyColorKeyFrame, index);
+			for (auto& sample : curve->samples)
+				sample = sample * tint * particle.tint;
+		}
+
+		// Rotate velocity if we have a rotation available
+		if (dst->hasProperty(ParticlePropertyVelocity))
+		{
+			vec3* vel = dst->get<vec3>(ParticlePropertyVelocity, index);
+			(*vel) = particle.rotation * (*vel);
+		}
+	}
+
+	void ParticleHeap::advanceParticle(ParticleBuffer* dst, size_t index, float32 dt)
+	{
+		const float32 kFallbackStep = 1.0f / 30.0f;
+
+		float32* time = dst->get<float32>(ParticlePropertyTime, index);
+		float32* lifeTime = dst->get<float32>(ParticlePropertyLifetime, index);
+		float32* processTime = dst->get<float32>(ParticlePropertyProcessTime, index);
+
+		// simulation stops once a particle passes its process time, same as ParticleHeap::process
+		float32 start = *time;
+		float32 end = start + dt;
+		float32 simEnd = end;
+		if (processTime && *processTime >= 0.0f)
+		{
+			simEnd = std::min<float32>(end, *processTime * (*lifeTime));
+		}
+		float32 simDt = std::max<float32>(0.0f, simEnd - start);
+		float32 pct = (*lifeTime > 0.0f) ? std::max<float32>(start, simEnd) / (*lifeTime) : 1.0f;
+		(*time) = end;
+
+		bool closedForm = true;
+		for (int32 i = 0; i < ParticlePropertyMAX && closedForm; ++i)
+		{
+			ParticleProperty prop = static_cast<ParticleProperty>(i);
+			if (!dst->hasProperty(prop) || !ParticlePropertyManager::getInstance()->getUpdateProperty(prop))
+				continue;
+
+			closedForm =
+				prop == ParticlePropertyVelocity ||
+				prop == ParticlePropertyAcceleration ||
+				prop == ParticlePropertyColorRange ||
+				prop == ParticlePropertyColorKeyFrame ||
+				prop == ParticlePropertySizeRange ||
+				prop == ParticlePropertyAngleSpeed;
+		}
+
+		if (!closedForm)
+		{
+			float32 simTime = start;
+			while (simTime < simEnd)
+			{
+				float32 step = std::min<float32>(kFallbackStep, simEnd - simTime);
+				simTime += step;
+				dst->update(step, simTime / (*lifeTime), index);
 			}
+			return;
+		}
 
+		if (simDt <= 0.0f)
+			return;
 
-			if (this->buffer->hasProperty(ParticlePropertyColor))
+		if (dst->hasProperty(ParticlePropertyVelocity))
+		{
+			vec3* pos = dst->get<vec3>(ParticlePropertyPosition, index);
+			vec3* vel = dst->get<vec3>(ParticlePropertyVelocity, index);
+			if (dst->hasProperty(ParticlePropertyAcceleration))
+			{
+				vec3* acc = dst->get<vec3>(ParticlePropertyAcceleration, index);
+				(*pos) += (*vel) * simDt + (*acc) * (0.5f * simDt * simDt);
+				(*vel) += (*acc) * simDt;
+			}
+			else
 			{
-				ColorB* color = this->buffer->get<ColorB>(ParticlePropertyColor, this->numParticles);
-				(*color) = (*color) * particle_list.tint * particle.tint;
+				(*pos) += (*vel) * simDt;
 			}
+		}
+
+		if (dst->hasProperty(ParticlePropertyAngleSpeed))
+		{
+			float32* angle = dst->get<float32>(ParticlePropertyAngle, index);
+			float32* angleSpeed = dst->get<float32>(ParticlePropertyAngleSpeed, index);
+			(*angle) += (*angleSpeed) * simDt;
+		}
 
-			if (this->buffer->hasProperty(ParticlePropertyColorRange))
+		if (dst->hasProperty(ParticlePropertyColorRange))
+		{
+			ColorBRangeValue* range = dst->get<ColorBRangeValue>(ParticlePropertyColorRange, index);
+			ColorBRangeValue::applyLerp(pct, range, dst->get<ColorB>(ParticlePropertyColor, index));
+		}
+
+		if (dst->hasProperty(ParticlePropertyColorKeyFrame))
+		{
+			ColorBCurveValue* curve = dst->get<ColorBCurveValue>(ParticlePropertyColorKeyFrame, index);
+			(*dst->get<ColorB>(ParticlePropertyColor, index)) = curve->evaluate(pct);
+		}
+
+		if (dst->hasProperty(ParticlePropertySizeRange))
+		{
+			Vec2RangeValue* range = dst->get<Vec2RangeValue>(ParticlePropertySizeRange, index);
+			Vec2RangeValue::applyLerp(pct, range, dst->get<vec2>(ParticlePropertySize, index));
+		}
+	}
+
+	size_t ParticleHeap::addPrewarmed(ParticleBuffer& src, size_t count, void* owner_ptr, float32 lag)
+	{
+		if (!(src.getMask() == this->buffer->getMask()))
+		{
+			log::warning("Particle heap changed layout while prewarming - dropping prewarmed particles");
+			return 0;
+		}
+
+		size_t added = 0;
+		for (size_t i = 0; i < count && this->numParticles < this->maxParticles; ++i)
+		{
+			if (lag > 0.0f)
 			{
-				ColorB* color = this->buffer->get<ColorB>(ParticlePropertyColorRange, this->numParticles);
-				(*color) = (*color) * particle_list.tint * particle.tint;
+				advanceParticle(&src, i, lag);
 			}
 
-			// Rotate velocity if we have a rotation available
-			if (this->buffer->hasProperty(ParticlePropertyVelocity))
+			float32* time = src.get<float32>(ParticlePropertyTime, i);
+			float32* lifeTime = src.get<float32>(ParticlePropertyLifetime, i);
+			if (*time >= *lifeTime)
+				continue;
+
+			this->buffer->copyElement(this->numParticles, src, i);
+
+			vec3* pos = this->buffer->get<vec3>(ParticlePropertyPosition, this->numParticles);
+			if (this->numParticles == 0)
 			{
-				vec3* vel = this->buffer->get<vec3>(ParticlePropertyVelocity, this->numParticles);
-				(*vel) = particle.rotation * (*vel);
+				this->boundsMin = *pos;
+				this->boundsMax = *pos;
 			}
+			this->expandBounds(*pos);
 
-			this->addParticleToOwner(particle_list.creator);
+			this->addParticleToOwner(owner_ptr);
 			this->numParticles++;
+			added++;
 		}
 
-		return particles_created;
+		if (this->geom)
+			this->geom->update();
+
+		return added;
 	}
 
 	bool ParticleHeap::hasActiveParticles(void* owner_ptr) const
@@ -551,6 +793,17 @@ namespace cs
 		}
 	}
 
+	ParticleHeapCollection::ParticleHeapCollection()
+		: renderManually(false)
+	{
+		ParticleBudget::getInstance()->registerCollection(this);
+	}
+
+	ParticleHeapCollection::~ParticleHeapCollection()
+	{
+		ParticleBudget::getInstance()->unregisterCollection(this);
+	}
+
 	ParticleHeapPtr ParticleHeapCollection::getHeap(ParticleEffectPtr& effect, RenderTraversal traversal)
 	{
 		ParticleEffectHeapMask mask;
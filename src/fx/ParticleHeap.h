@@ -39,7 +39,16 @@ namespace cs
 
 		size_t getLinks() { return this->links.size(); }
 		size_t getNumParticles() const {return this->numParticles; }
+		size_t getMaxParticles() const { return this->maxParticles; }
 		size_t addParticles(ParticleInitList& particle_list);
+
+		// Takes count particles simulated off-heap (see ParticleEmitter::prewarm) and ages them by lag seconds
+		size_t addPrewarmed(ParticleBuffer& src, size_t count, void* owner_ptr, float32 lag);
+
+		static void writeParticle(ParticleBuffer* dst, size_t index, const ParticleInitProps& particle, void* owner_ptr, const ColorB& tint);
+		// Advances one particle by dt in a single step using the closed form of every known
+		// property updater, falls back to fixed steps when the buffer has an updater it doesn't know
+		static void advanceParticle(ParticleBuffer* dst, size_t index, float32 dt);
 		bool hasGracePeriodExpired() const { return this->gracePeriod <= 0; }
 		void resetGracePeriod() { this->gracePeriod = 5; }
 
@@ -56,9 +65,20 @@ namespace cs
 		size_t removeParticlesByOwner(void* owner_ptr);
 
 		ParticleEffectPtr& getEffect() { return this->effect; }
+		int32 getPriority() const;
 
 		bool isExpired() const;
 
+		// Set by the ParticleBudget each frame, hidden heaps update at a lower rate
+		void setVisible(bool vis) { this->visible = vis; }
+		bool isVisible() const { return this->visible; }
+
+		const vec3& getBoundsMin() const { return this->boundsMin; }
+		const vec3& getBoundsMax() const { return this->boundsMax; }
+
+		// removes up to count of the particles closest to the end of their life
+		size_t cullParticles(size_t count);
+
 		static void resetStats();
 		static int32 gTotalParticles;
 		static int32 gTotalHeapSize;
@@ -74,12 +94,20 @@ namespace cs
 		Timer::Tick lastTick;
 		int32 gracePeriod;
 
+		bool visible;
+		float32 pendingTime;
+		int32 skippedFrames;
+		vec3 boundsMin;
+		vec3 boundsMax;
+
 		ParticleEffectPtr effect;
 		DynamicGeometryPtr geom;
 		ParticleBuffer* buffer;
 
 		void addParticleToOwner(void* owner_ptr);
 		void removeParticleFromOwner(void* owner_ptr);
+		void removeParticle(size_t index);
+		void expandBounds(const vec3& pos);
 	
 		std::list<ParticleEmitter*> links;
 
@@ -93,9 +121,8 @@ namespace cs
 
 	struct ParticleHeapCollection
 	{
-		ParticleHeapCollection()
-			: renderManually(false)
-		{ }
+		ParticleHeapCollection();
+		~ParticleHeapCollection();
 
 		ParticleHeapPtr getHeap(ParticleEffectPtr& effect, RenderTraversal traversal);
 		void clearUnusedHeaps();
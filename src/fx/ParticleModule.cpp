@@ -16,6 +16,20 @@ namespace cs
 	BEGIN_META_MODULE_VALUE_CONSTANT(ParticleModuleValueColor, ADD_PARTICLE_COLOR_OPTIONS);
 	BEGIN_META_MODULE_VALUE_LERP(ParticleModuleValueColorLerp, ADD_PARTICLE_COLOR_OPTIONS);
 
+	BEGIN_META_CLASS(ParticleKeyFrameValueColor)
+		ADD_MEMBER_PTR(value);
+			ADD_PARTICLE_COLOR_OPTIONS();
+		ADD_MEMBER(dt);
+			SET_MEMBER_MIN(0.0f);
+			SET_MEMBER_MAX(1.0f);
+	END_META();
+
+	DEFINE_META_VECTOR_NEW(ParticleKeyFrameColorList, ParticleKeyFrameValueColor, ParticleKeyFrameColorList);
+
+	BEGIN_META_CLASS(ParticleModuleValueColorKeyFrame)
+		ADD_MEMBER(values);
+	END_META();
+
 	BEGIN_META_MODULE_VALUE_CONSTANT(ParticleModuleValueVelocity, ADD_PARTICLE_VEC3_OPTIONS);
 	BEGIN_META_MODULE_VALUE_CONSTANT(ParticleModuleValueAcceleration, ADD_PARTICLE_VEC3_OPTIONS);
 
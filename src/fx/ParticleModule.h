@@ -12,7 +12,8 @@
 
 #define ADD_PARTICLE_MODULE_VALUE_COLOR() \
 	ADD_COMBO_META_LABEL(ParticleModuleValueColor, "Constant Color"); \
-	ADD_COMBO_META_LABEL(ParticleModuleValueColorLerp, "Interpolated Color");
+	ADD_COMBO_META_LABEL(ParticleModuleValueColorLerp, "Interpolated Color"); \
+	ADD_COMBO_META_LABEL(ParticleModuleValueColorKeyFrame, "Keyframed Color");
 
 #define ADD_PARTICLE_MODULE_VALUE_SIZE() \
 	ADD_COMBO_META_LABEL(ParticleModuleValueSize, "Constant Size"); \
@@ -123,38 +124,83 @@ namespace cs
 		std::shared_ptr<V> end_value;
 	};
 
-	template <class T>
-	struct ParticleKeyframeValue
-	{
-		std::shared_ptr<T> value;
+	CLASS_DEFINITION_REFLECT(ParticleKeyFrameValueColor)
+	public:
+		ParticleKeyFrameValueColor()
+			: value(CREATE_CLASS(ParticleColorValueConstant, ColorB::White))
+			, dt(0.0f)
+		{ }
+
+		ParticleColorValuePtr value;
 		float32 dt;
 	};
 
-	typedef ParticleKeyframeValue<ParticleColorValue> ParticleKeyFrameValueColorImpl;
+	typedef std::vector<ParticleKeyFrameValueColorPtr> ParticleKeyFrameColorList;
 
-	CLASS_DEFINITION_DERIVED_REFLECT(ParticleKeyFrameValueColor, ParticleKeyFrameValueColorImpl)
+	// A key's dt is its share of the particle's life after the key before it.  The keys are drawn
+	// once per particle at spawn and baked into a curve, so the per frame update is a single lookup
+	// rather than a search and blend over the keys.
+	template <class T, class C, class K, ParticleProperty Flag, ParticleProperty FlagCurve>
+	class ParticleModuleValueKeyFrame : public ParticleModuleValue
+	{
 	public:
 
-	};
+		enum
+		{
+			MaskFlag = Flag,
+			MaskFlagCurve = FlagCurve,
+			MaxKeyFrames = 16
+		};
 
-	template <class T, class V>
-	class ParticleModuleValueKeyFrame : public ParticleModuleValue
-	{
 		virtual void setMask(ParticlePropertyMask& mask)
 		{
-			// mask.set(static_cast<ParticleProperty>(MaskFlag));
-			// mask.set(static_cast<ParticleProperty>(MaskFlagRange));
+			mask.set(static_cast<ParticleProperty>(MaskFlag));
+			mask.set(static_cast<ParticleProperty>(MaskFlagCurve));
 		}
 
 		virtual void populate(ParticleInitProps& initProps, ParticlePropertyMask ignoreMask)
 		{
-			// RangeValue<T> range(this->start_value->getValue(), this->end_value->getValue());
-			// addProperty(initProps.propertyMap, static_cast<ParticleProperty>(MaskFlag), this->start_value->getValue(), ignoreMask);
-			// addProperty(initProps.propertyMap, static_cast<ParticleProperty>(MaskFlagRange), range, ignoreMask);
+			size_t numKeys = std::min<size_t>(this->values.size(), MaxKeyFrames);
+			if (numKeys == 0)
+				return;
+
+			T keys[MaxKeyFrames];
+			float32 times[MaxKeyFrames];
+			float32 total = 0.0f;
+			for (size_t i = 0; i < numKeys; ++i)
+			{
+				const std::shared_ptr<K>& key = this->values[i];
+				keys[i] = (key.get() && key->value.get()) ? key->value->getValue() : T();
+				total += (key.get() && i > 0) ? std::max<float32>(key->dt, 0.0f) : 0.0f;
+				times[i] = total;
+			}
+
+			// no timing given, spread the keys evenly
+			float32 invTotal = (total > 0.0f) ? 1.0f / total : 0.0f;
+			for (size_t i = 0; i < numKeys; ++i)
+				times[i] = (total > 0.0f) ? times[i] * invTotal : ((numKeys > 1) ? float32(i) / float32(numKeys - 1) : 0.0f);
+
+			C curve;
+			size_t segment = 0;
+			curve.bake([&](float32 pct)
+			{
+				// samples come in order so the segment only ever moves forward
+				while (segment + 1 < numKeys && times[segment + 1] < pct)
+					segment++;
+
+				if (segment + 1 >= numKeys)
+					return keys[numKeys - 1];
+
+				float32 span = times[segment + 1] - times[segment];
+				float32 t = (span > 0.0f) ? clamp<float32>(0.0f, 1.0f, (pct - times[segment]) / span) : 1.0f;
+				return lerp<T>(keys[segment], keys[segment + 1], t);
+			});
+
+			addProperty(initProps.propertyMap, static_cast<ParticleProperty>(MaskFlag), keys[0], ignoreMask);
+			addProperty(initProps.propertyMap, static_cast<ParticleProperty>(MaskFlagCurve), curve, ignoreMask);
 		}
 
-		typedef std::vector<ParticleKeyframeValue<V>> KeyFrameValues;
-		KeyFrameValues values;
+		std::vector<std::shared_ptr<K>> values;
 	};
 
 	typedef ParticleModuleValueConstant<vec2, ParticleVec2Value, ParticleVec2ValueConstant, ParticlePropertySize> ParticleModuleSizeImpl;
@@ -253,6 +299,14 @@ namespace cs
 		{ }
 	};
 
+	typedef ParticleModuleValueKeyFrame<ColorB, ColorBCurveValue, ParticleKeyFrameValueColor, ParticlePropertyColor, ParticlePropertyColorKeyFrame> ParticleModuleColorKeyFrameImpl;
+	CLASS_DEFINITION_DERIVED_REFLECT(ParticleModuleValueColorKeyFrame, ParticleModuleColorKeyFrameImpl)
+	public:
+		ParticleModuleValueColorKeyFrame()
+			: ParticleModuleColorKeyFrameImpl()
+		{ }
+	};
+
 	CLASS_DEFINITION_REFLECT(ParticleModule)
 	public:
 
@@ -40,6 +40,12 @@ namespace cs
 		virtual float32 getValue() const { return 0.0f; }
 		virtual float32 getMaxValue() const { return 0.0f; }
 
+		virtual void fillValues(float32* values, size_t count) const
+		{
+			for (size_t i = 0; i < count; ++i)
+				values[i] = this->getValue();
+		}
+
 		Event onChanged;
 
 		void onValueChanged()
@@ -85,6 +91,11 @@ namespace cs
 		virtual float32 getValue() const { return randomRange<float32>(this->range.x, this->range.y); }
 		virtual float32 getMaxValue() const { return this->range.y; }
 
+		virtual void fillValues(float32* values, size_t count) const
+		{
+			Random::get().fillRange(values, count, this->range.x, this->range.y);
+		}
+
 		virtual bool isConstant() const { return false; }
 
 	private:
@@ -196,6 +207,12 @@ namespace cs
 		virtual vec3 getMaxValue() const { return kZero3; }
 		virtual vec3 getMinValue() const { return kZero3; }
 
+		virtual void fillValues(vec3* values, size_t count) const
+		{
+			for (size_t i = 0; i < count; ++i)
+				values[i] = this->getValue();
+		}
+
 		Event onChanged;
 
 		void onValueChanged()
@@ -246,6 +263,11 @@ namespace cs
 				);
 			}
 
+			virtual void fillValues(vec3* values, size_t count) const
+			{
+				Random::get().fillRange(values, count, this->min_value, this->max_value);
+			}
+
 			virtual vec3 getMaxValue() const { return this->max_value; }
 			virtual vec3 getMinValue() const { return this->min_value; }
 
@@ -283,6 +305,15 @@ namespace cs
 				return val * this->magnitude->getValue();
 			}
 
+			virtual void fillValues(vec3* values, size_t count) const
+			{
+				Random::get().fillRange(values, count, this->min_value, this->max_value);
+				for (size_t i = 0; i < count; ++i)
+				{
+					values[i] = glm::normalize(values[i]) * this->magnitude->getValue();
+				}
+			}
+
 			virtual vec3 getMaxValue() const { return this->max_value; }
 			virtual vec3 getMinValue() const { return this->min_value; }
 
@@ -4,10 +4,14 @@
 
 #include "gfx/RenderInterface.h"
 #include "scene/Camera.h"
-#include "global/Timer.h"
+#include "global/Profiler.h"
 #include "scene/SceneManager.h"
 #include "fx/ParticleHeap.h"
+#include "fx/ParticleBudget.h"
+#include "gfx/Mesh.h"
+#include "gfx/DynamicGeometry.h"
 #include "scripting/ScriptNotification.h"
+#include "global/EventQueue.h"
 #include "physics/PhysicsContact.h"
 
 #if defined(CS_IOS)
@@ -19,30 +23,20 @@ namespace cs
 
 	const std::vector<ClearMode> kFrameBufferClearParams = { ClearColor, ClearDepth };
 	const ColorF kFrameBufferClearColor(0.5f, 0.5f, 0.5f, 1.0f);
-
-	uint32 Context::updateTimes[ContextTimerMAX];
+	const StringId kColorUniform("color");
 
 	UniformPtr Context::accelerometer_x;
 	UniformPtr Context::accelerometer_y;
 	UniformPtr Context::accelerometer_z;
 
-	const char* kContextTimerStr[] =
-	{
-		"Scene Process",
-		"Scene Render",
-		"UI Process",
-		"UI Render",
-		"Batch Traverse",
-		"Batch Buffer Copy",
-		"Spline Update"
-	};
-
 	Context::Context(const std::string& name, const RectI& rect)
 		: uiView(rect)
 		, needsSave(false)
 		, onScriptUpdate(nullptr)
 		, useRenderTarget(false)
 		, isCapturingInTarget(false)
+		, requestedPipelineMode(FramePipelineSingleThreaded)
+		, pipelined(false)
 	{
 		this->contextName = name;
 		this->ui = CREATE_CLASS(UIStack);
@@ -57,6 +51,8 @@ namespace cs
 		if (!Context::accelerometer_x) Context::accelerometer_x = SharedUniform::getInstance().getUniform("accelerometer_x");
 		if (!Context::accelerometer_y) Context::accelerometer_y = SharedUniform::getInstance().getUniform("accelerometer_y");
 		if (!Context::accelerometer_z) Context::accelerometer_z = SharedUniform::getInstance().getUniform("accelerometer_z");
+
+		this->pipeline.setSimulateFunc(std::bind(&Context::simulate, this, std::placeholders::_1));
 	}
 
 	void Context::setForPostProcessing()
@@ -113,11 +109,92 @@ namespace cs
 	
 	void Context::process(float32 dt)
 	{
+		// the simulation is idle from here, and whatever it uploaded goes in before anything draws
+		this->pipeline.wait();
+		DynamicGeometry::flushPendingUpdates();
 
-		ParticleHeap::resetStats();
+		// the worker is idle, so a switch asked for during the last simulation can start or stop it here
+		if (this->requestedPipelineMode != this->pipeline.getMode())
+		{
+			this->pipeline.setMode(this->requestedPipelineMode);
+			this->requestedPipelineMode = this->pipeline.getMode();
+		}
+
+		// the accelerometer uniforms are read while drawing, so they are set here rather than simulated
 		this->updateAccelerometer(dt);
 
-		ScopedTimer timer(&Context::updateTimes[ContextTimerSceneProcess]);
+		this->pipelined = this->pipeline.isThreaded() && !this->hasDebugDraw();
+		if (this->pipelined)
+		{
+			this->pipeline.beginCapture();
+			this->captureFrame();
+			this->pipeline.endCapture();
+			this->pipeline.kick(dt);
+		}
+		else if (this->pipeline.isThreaded())
+		{
+			this->frame.scenes.clear();
+			this->frame.ready = false;
+			this->simulate(dt);
+		}
+		else
+		{
+			this->pipeline.kick(dt);
+		}
+	}
+
+	bool Context::hasDebugDraw() const
+	{
+		for (auto& scene : this->sortedScenes)
+		{
+			if (scene.get() && scene->getHasDebugDraw())
+				return true;
+		}
+		return false;
+	}
+
+	void Context::captureFrame()
+	{
+		PROFILE_SCOPE("Frame Capture");
+
+		if (this->frame.ready)
+			this->pipeline.dropFrame();
+
+		this->frame.scenes.clear();
+		for (auto& scene : this->sortedScenes)
+		{
+			if (scene.get())
+			{
+				bool isMain = (scene.get() == this->mainScene.get());
+				if (isMain)
+					scene->getCamera()->setViewport(this->sceneView);
+
+				ContextFrame::Entry entry;
+				entry.scene = scene;
+				entry.isMain = isMain;
+				this->frame.scenes.push_back(entry);
+				scene->capture(this->frame.scenes.back().frame, true);
+			}
+		}
+
+		if (this->ui)
+		{
+			this->ui->capture(UIBatchPassMain);
+			if (this->useRenderTarget && this->ui->isPassSet(UIBatchPassStencil))
+				this->ui->capture(UIBatchPassStencil);
+		}
+
+		this->frame.ready = true;
+	}
+
+	void Context::simulate(float32 dt)
+	{
+
+		ParticleHeap::resetStats();
+		ParticleBudget::getInstance()->update();
+		EventQueue::getInstance()->markFrame();
+
+		PROFILE_SCOPE("Scene Process");
 		SortedSceneList scenesToProcess = this->sortedScenes;
 
 		for (auto& scene : scenesToProcess)
@@ -129,11 +206,13 @@ namespace cs
 			}
 		}
         
+        // whatever was posted with no scene processing (or by the last scene's audio) goes out here
+        EventQueue::getInstance()->dispatch(EventDispatchPostUpdate);
         ScriptNotification::getInstance()->flushNotifications();
         
 		if (this->ui)
 		{
-			ScopedTimer timer(&Context::updateTimes[ContextTimerUIProcess]);
+			PROFILE_SCOPE("UI Process");
 			this->ui->process(dt, this->uiView);
 		}
 
@@ -143,6 +222,11 @@ namespace cs
 			(*scriptUpdateCallback)(dt);
 		}
 
+		if (this->luaState)
+		{
+			this->luaState->update();
+		}
+
 		if (this->capture.resolveToFront.get() && this->capture.resolveToFront->getParams().isDynamic)
 		{
 			this->capture.resolveToFront->update();
@@ -188,28 +272,47 @@ namespace cs
 		render_interface->setClearColor(kFrameBufferClearColor);
 		render_interface->clear(kFrameBufferClearParams);
 
-		ScopedTimer timer(&Context::updateTimes[ContextTimerSceneRender]);
-		for (auto& scene : this->sortedScenes)
+		PROFILE_SCOPE("Scene Render");
+		MeshHandle::flushStats();
+
+		this->pipeline.beginSubmit();
+
+		if (this->pipelined)
 		{
-			if (scene.get()) //&& scene->getIsActive())
+			for (auto& it : this->frame.scenes)
 			{
-				CameraPtr camera = scene->getCamera();
-				if (scene.get() == this->mainScene.get())
-				{
-					camera->setViewport(this->sceneView);
+				if (it.isMain)
 					RenderInterface::getInstance()->setViewport(this->sceneView);
+
+				it.scene->submit(it.frame);
+			}
+			this->frame.scenes.clear();
+			this->frame.ready = false;
+		}
+		else
+		{
+			for (auto& scene : this->sortedScenes)
+			{
+				if (scene.get()) //&& scene->getIsActive())
+				{
+					CameraPtr camera = scene->getCamera();
+					if (scene.get() == this->mainScene.get())
+					{
+						camera->setViewport(this->sceneView);
+						RenderInterface::getInstance()->setViewport(this->sceneView);
+					}
+					
+					scene->draw();
 				}
-				
-				scene->draw();
 			}
 		}
 
-		cs::UniformPtr color = SharedUniform::getInstance().getUniform("color");
+		cs::UniformPtr color = SharedUniform::getInstance().getUniform(kColorUniform);
 		color->setValue(toVec4(ColorF::White));
 
 		if (this->ui)
 		{
-			ScopedTimer timer(&Context::updateTimes[ContextTimerUIRender]);
+			PROFILE_SCOPE("UI Render");
 			RenderInterface::getInstance()->setViewport(this->uiView);
 			this->ui->draw(this->uiView, UIBatchPassMain);
 		}
@@ -230,6 +333,10 @@ namespace cs
 			RenderInterface::getInstance()->setDefaultFrameBuffer();
 			this->capture.resolveToFront->draw(this->uiView);
 		}
+
+		this->pipeline.endSubmit();
+
+		PROFILE_COUNTER("Particles", ParticleHeap::gTotalParticles);
 	}
 
 	void Context::onActive()
@@ -5,6 +5,7 @@
 #include "ui/UIStack.h"
 #include "scene/Scene.h"
 #include "gfx/Renderer.h"
+#include "global/FramePipeline.h"
 
 #include "scripting/LuaCallback.h"
 
@@ -12,21 +13,6 @@
 
 namespace cs
 {
-	enum ContextTimer
-	{
-		ContextTimerSceneProcess,
-		ContextTimerSceneRender,
-		ContextTimerUIProcess,
-		ContextTimerUIRender,
-		ContextSceneBatchTraverse,
-		ContextSceneBatchBuffer,
-		ContextSplineUpdate,
-		//...
-		ContextTimerMAX
-	};
-
-	extern const char* kContextTimerStr[];
-
 	CLASS_DEFINITION(Context)
 	public:
 
@@ -39,6 +25,17 @@ namespace cs
 		virtual void process(float32 dt);
 		virtual void render();
 
+		// Threaded (builds with CS_FRAME_PIPELINE_THREADED), process() snapshots the last simulated frame
+		// for render() and simulates the next one on a worker until the following process().  Frames with
+		// debug overlays run serially.  The switch happens at the top of the next process(), scripts asking
+		// for it are running on the simulation worker when threaded.
+		void setPipelineMode(FramePipelineMode mode) { this->requestedPipelineMode = mode; }
+		const FramePipeline& getPipeline() const { return this->pipeline; }
+
+		void setPipelineThreaded(bool threaded) { this->setPipelineMode((threaded) ? FramePipelineThreaded : FramePipelineSingleThreaded); }
+		bool isPipelineThreaded() const { return this->pipeline.isThreaded(); }
+		std::string getFrameReport() const { return this->pipeline.getFrameReport(); }
+
 		void setForPostProcessing();
 
 		static void preRender();
@@ -96,8 +93,6 @@ namespace cs
 
 		LuaStatePtr& getLuaState() { return this->luaState; }
 
-		static uint32 updateTimes[ContextTimerMAX];
-
 		void setUseRenderTarget(bool use);
 		void setFinalResolveShader(const std::string& name);
 
@@ -105,6 +100,11 @@ namespace cs
 
 		bool onBindTarget(const RectI& viewport);
 		void updateAccelerometer(float32 dt);
+
+		void simulate(float32 dt);
+		bool hasDebugDraw() const;
+		void captureFrame();
+
 		void addSceneInternal(const std::string& name, SerializableHandle<Scene>& scene);
 		void updateSceneList();
 		void refreshMainScene();
@@ -135,5 +135,28 @@ namespace cs
 		RenderTargetCapture capture;
 
 		RenderTargetCapture stencil;
+
+		// What render() draws for a pipelined frame, the live scenes have moved on by then
+		struct ContextFrame
+		{
+			ContextFrame()
+				: ready(false)
+			{ }
+
+			struct Entry
+			{
+				ScenePtr scene;
+				bool isMain;
+				SceneFrame frame;
+			};
+
+			std::vector<Entry> scenes;
+			bool ready;
+		};
+
+		FramePipeline pipeline;
+		FramePipelineMode requestedPipelineMode;
+		ContextFrame frame;
+		bool pipelined;
 	};
 }
@@ -89,6 +89,13 @@ namespace cs
 		return p;
 	}
 
+	void QuadVolume::getRandomValues(vec2* values, size_t count)
+	{
+		vec2 minv(rect.pos.x, rect.pos.y);
+		vec2 maxv(rect.pos.x + rect.size.w, rect.pos.y + rect.size.h);
+		Random::get().fillRange(values, count, minv, maxv);
+	}
+
 	bool QuadVolume::intersects(const Ray& ray, vec3& hit_pos)
 	{
 		return rectIntersect(ray, this->rect, hit_pos);
@@ -101,10 +108,12 @@ namespace cs
 		return pos.size();
 	}
 
-	size_t QuadVolume::getEdges(std::vector<uint16>& indices)
+	size_t QuadVolume::getEdges(std::vector<uint32>& indices)
 	{
-		indices.clear();
-		QuadShape::generateWireframeImpl(indices);
+		std::vector<uint16> wireframe;
+		QuadShape::generateWireframeImpl(wireframe);
+
+		indices.assign(wireframe.begin(), wireframe.end());
 		return indices.size();
 	}
 
@@ -120,7 +129,7 @@ namespace cs
 		return pos.size();
 	}
 
-	size_t AABBVolume::getEdges(std::vector<uint16>& indices)
+	size_t AABBVolume::getEdges(std::vector<uint32>& indices)
 	{
 		for (uint16 i = 0; i < 4; i++)
 		{
@@ -153,9 +162,9 @@ namespace cs
 		return false;
 	}
 
-	size_t TriangleVolume::getEdges(std::vector<uint16>& indices)
+	size_t TriangleVolume::getEdges(std::vector<uint32>& indices)
 	{
-		const std::vector<uint16> kTriangleIndices = { 0, 1, 1, 2, 2, 0 };
+		const std::vector<uint32> kTriangleIndices = { 0, 1, 1, 2, 2, 0 };
 		indices.insert(indices.begin(), kTriangleIndices.begin(), kTriangleIndices.end());
 		return indices.size();
 	}
@@ -223,12 +232,12 @@ namespace cs
 
 			for (size_t v = 0; v < (it.pos.size() - 1); ++v)
 			{
-				this->index.push_back(uint16(offset + v));
-				this->index.push_back(uint16(offset + v + 1));
+				this->index.push_back(uint32(offset + v));
+				this->index.push_back(uint32(offset + v + 1));
 			}
 
-			this->index.push_back(uint16(offset + (it.pos.size() - 1)));
-			this->index.push_back(uint16(offset));
+			this->index.push_back(uint32(offset + (it.pos.size() - 1)));
+			this->index.push_back(uint32(offset));
 
 			offset += it.pos.size();
 		}
@@ -334,9 +343,9 @@ namespace cs
 		return this->cir.intersects(ray, hit_pos);
 	}
 
-	size_t CircleVolume::getEdges(std::vector<uint16>& indices)
+	size_t CircleVolume::getEdges(std::vector<uint32>& indices)
 	{
-		for (uint16 i = 0; i < this->getNumEdges(); i++)
+		for (uint32 i = 0; i < this->getNumEdges(); i++)
 			indices.push_back(i);
 		return indices.size();
 	}
@@ -386,9 +395,9 @@ namespace cs
 		return (x + y) <= (pow(this->width, 2.0) * pow(this->height, 2.0));
 	}
 
-	size_t EllipseVolume::getEdges(std::vector<uint16>& indices)
+	size_t EllipseVolume::getEdges(std::vector<uint32>& indices)
 	{
-		for (uint16 i = 0; i < this->getNumEdges(); i++)
+		for (uint32 i = 0; i < this->getNumEdges(); i++)
 			indices.push_back(i);
 		return indices.size();
 	}
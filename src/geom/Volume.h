@@ -48,12 +48,17 @@ namespace cs
 		
 		virtual DrawType getDrawType() const { return DrawLines; }
 		virtual vec2 getRandomValue() { return vec2(); }
+		virtual void getRandomValues(vec2* values, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+				values[i] = this->getRandomValue();
+		}
 
 		virtual bool test(const vec3& point) const { return false; }
 		virtual bool intersects(const Ray& ray, vec3& hit_pos) { return false; }
 	
 		virtual size_t getNumEdges() const { return 0; }
-		virtual size_t getEdges(std::vector<uint16>& indices) { return 0; }
+		virtual size_t getEdges(std::vector<uint32>& indices) { return 0; }
 
 		virtual size_t getNumPositions() const { return 0; }
 		virtual size_t getPositions(std::vector<vec3>& pos) { return 0; }
@@ -86,7 +91,7 @@ namespace cs
 		virtual DrawType getDrawType() const { return DrawLines; }
 
 		virtual size_t getNumEdges() const { return 2; }
-		virtual size_t getEdges(std::vector<uint16>& indices)
+		virtual size_t getEdges(std::vector<uint32>& indices)
 		{
 			indices.push_back(0);
 			indices.push_back(1);
@@ -128,10 +133,11 @@ namespace cs
 		virtual DrawType getDrawType() const { return DrawLineLoop; }
 
 		virtual vec2 getRandomValue();
+		virtual void getRandomValues(vec2* values, size_t count);
 		virtual bool intersects(const Ray& ray, vec3& hit_pos);
 
 		virtual size_t getNumEdges() const { return 4; }
-		virtual size_t getEdges(std::vector<uint16>& indices);
+		virtual size_t getEdges(std::vector<uint32>& indices);
 
 		virtual size_t getNumPositions() const { return 4; }
 		virtual size_t getPositions(std::vector<vec3>& pos);
@@ -180,7 +186,7 @@ namespace cs
 		virtual bool intersects(const Ray& ray, vec3& hit_pos);
 
 		virtual size_t getNumEdges() const { return this->granularity; }
-		virtual size_t getEdges(std::vector<uint16>& indices);
+		virtual size_t getEdges(std::vector<uint32>& indices);
 
 		virtual size_t getNumPositions() const { return this->granularity; }
 		virtual size_t getPositions(std::vector<vec3>& pos);
@@ -228,7 +234,7 @@ namespace cs
 		virtual bool test(const vec3& point) const;
 
 		virtual size_t getNumEdges() const { return this->granularity; }
-		virtual size_t getEdges(std::vector<uint16>& indices);
+		virtual size_t getEdges(std::vector<uint32>& indices);
 
 		virtual size_t getNumPositions() const { return this->granularity; }
 		virtual size_t getPositions(std::vector<vec3>& pos);
@@ -277,7 +283,7 @@ namespace cs
 		virtual bool intersects(const Ray& ray, vec3& hit_pos);
 
 		virtual size_t getNumEdges() const { return 6; }
-		virtual size_t getEdges(std::vector<uint16>& indices);
+		virtual size_t getEdges(std::vector<uint32>& indices);
 
 		virtual size_t getNumPositions() const { return 3; }
 		virtual size_t getPositions(std::vector<vec3>& pos);
@@ -306,10 +312,10 @@ namespace cs
 		virtual bool intersects(const Ray& ray, vec3& hit_pos) { return false; }
 
 		virtual size_t getNumEdges() const { return this->positions.size(); }
-		virtual size_t getEdges(std::vector<uint16>& indices)
+		virtual size_t getEdges(std::vector<uint32>& indices)
 		{
 			for (size_t i = 0; i < this->positions.size(); i++)
-				indices.push_back(uint16(i));
+				indices.push_back(uint32(i));
 			return indices.size();
 		}
 
@@ -351,15 +357,15 @@ namespace cs
 		virtual bool intersects(const Ray& ray, vec3& hit_pos);
 
 		virtual size_t getNumEdges() const { return this->positions.size() * 2; }
-		virtual size_t getEdges(std::vector<uint16>& indices)
+		virtual size_t getEdges(std::vector<uint32>& indices)
 		{
 			for (size_t i = 0; i < this->positions.size() - 1; i++)
 			{
-				indices.push_back(uint16(i));
-				indices.push_back(uint16(i) + 1);
+				indices.push_back(uint32(i));
+				indices.push_back(uint32(i) + 1);
 			}
 
-			indices.push_back(uint16(this->positions.size()) - 1);
+			indices.push_back(uint32(this->positions.size()) - 1);
 			indices.push_back(0);
 			return indices.size();
 		}
@@ -404,7 +410,7 @@ namespace cs
 		virtual bool intersects(const Ray& ray, vec3& hit_pos);
 
 		virtual size_t getNumEdges() const { return 24; }
-		virtual size_t getEdges(std::vector<uint16>& indices);
+		virtual size_t getEdges(std::vector<uint32>& indices);
 
 		virtual size_t getNumPositions() const { return 8; }
 		virtual size_t getPositions(std::vector<vec3>& pos);
@@ -441,7 +447,7 @@ namespace cs
 		virtual DrawType getDrawType() const { return DrawLines; }
 
 		virtual size_t getNumEdges() const { return index.size(); }
-		virtual size_t getEdges(std::vector<uint16>& indices)
+		virtual size_t getEdges(std::vector<uint32>& indices)
 		{
 			indices.insert(indices.end(), this->index.begin(), this->index.end());
 			return indices.size();
@@ -463,7 +469,7 @@ namespace cs
 
 		void refresh();
 
-		std::vector<uint16> index;
+		std::vector<uint32> index;
 		Vec3List positions;
 		PolygonList polygonList;
 
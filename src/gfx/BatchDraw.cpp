@@ -2,10 +2,12 @@
 
 #include "gfx/BatchDraw.h"
 #include "gfx/Attribute.h"
+#include "global/Profiler.h"
 
 namespace cs
 {
 	const float32 kLayerOffset = 1000.0f;
+	const StringId kBatchDrawTag("BatchDraw");
 
 	void BatchDraw::init()
 	{
@@ -268,6 +270,8 @@ namespace cs
 				batch->dataIndex.push_back(i);
 		}
 
+		PROFILE_COUNTER("Batch Merges", numDraws - batchList.size());
+
 		// std::sort(batchList.begin(), batchList.end(), DrawBatchSort);
 
 		uint16 indexCtr = 0;
@@ -279,14 +283,13 @@ namespace cs
 			uint16 batchIndexCtr = 0;
  			DrawCallPtr dc = CREATE_CLASS(DrawCall);
 
-			std::string tagName = "BatchDraw";
+			dc->tag = kBatchDrawTag;
 			if (draw_batch.texture[0].get() != nullptr)
 			{
-				tagName = draw_batch.texture[0]->getTextureName();
-				assert(tagName.length() > 0);
+				dc->tag = draw_batch.texture[0]->getTextureTag();
+				assert(!dc->tag.isEmpty());
 			}
 
-			dc->tag = tagName;
 			dc->offset = indexCtr;
 			dc->type = draw_batch.drawType;
 			dc->indexType = TypeUnsignedShort;
@@ -352,6 +355,8 @@ namespace cs
 
 	void BatchDraw::update()
 	{
+		this->frozenDraws = nullptr;
+
         if (this->drawData.size() == 0)
             return;
         
@@ -395,9 +400,22 @@ namespace cs
 
 	void BatchDraw::draw()
 	{
+		if (this->frozenDraws)
+		{
+			this->geom->draw(*this->frozenDraws, nullptr);
+			this->frozenDraws = nullptr;
+			return;
+		}
+
 		this->geom->draw(nullptr);
 	}
 
+	void BatchDraw::freezeDraws()
+	{
+		// updateIndices builds new draw calls every upload, so sharing them is enough
+		this->frozenDraws = std::make_shared<DrawCallList>(this->draws);
+	}
+
 	size_t BatchDraw::getVertexBufferSize()
 	{
 		size_t stride = this->geom->getGeometryData()->decl.getStride();
@@ -136,7 +136,7 @@ namespace cs
 		mat4 transform;
 		RectF bounds;
 		ColorB tint;
-		std::string tag;
+		StringId tag;
 		float32 sortValue;
 		float32 depthValue;
 		int32 layer;
@@ -187,6 +187,10 @@ namespace cs
 		void clear();
 		void update();
 		void draw();
+
+		// Keeps the draw calls of the last update for the next draw(), which then no longer
+		// reads drawData and can run while the batch is refilled
+		void freezeDraws();
 		void sort(BatchDrawList::iterator start, BatchDrawList::iterator end, SortMethod sort);
 
 		void flush(DisplayListTraversal& traversal_list);
@@ -207,6 +211,8 @@ namespace cs
 
 		std::vector<DrawCallPtr> draws;
 		std::vector<int32> flags;
+
+		DrawCallListPtr frozenDraws;
 		
 	};
 }
@@ -428,7 +428,7 @@ namespace cs
 	}
 
 	void BatchRenderable::batch(
-		const std::string& tag,
+		const StringId& tag,
 		BatchDrawList& display_list,
 		const BatchRenderableParams& params,
 		uint32& numVertices, 
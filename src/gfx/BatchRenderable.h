@@ -56,7 +56,7 @@ namespace cs
 		}
 
 		virtual void batch(
-			const std::string& tag,
+			const StringId& tag,
 			BatchDrawList& display_list, 
 			const BatchRenderableParams& params,
 			uint32& numVertices, 
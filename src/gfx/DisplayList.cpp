@@ -21,7 +21,7 @@ namespace cs
 		}
 	}
 
-	std::string gBreakOnTag = "";
+	StringId gBreakOnTag;
 
 	UniformPtr DisplayListNode::objectToWorldMatrix;
 	UniformPtr DisplayListNode::modelViewProjectionMatrix;
@@ -32,22 +32,23 @@ namespace cs
 	UniformPtr DisplayListTraversal::viewportUniform;
 	UniformPtr DisplayListTraversal::viewportInverseUniform;
 	
-	void DisplayListNode::draw(const DisplayListNode& node, void* data)
+	void DisplayListNode::record(const DisplayListNode& node, void* data)
 	{
 
 #if defined(_DEBUG)
-		if (node.tag.length() > 0 && node.tag == gBreakOnTag)
+		if (!node.tag.isEmpty() && node.tag == gBreakOnTag)
 		{
 			log::info("HERE!");
 		}
 #endif
-        RenderInterface::getInstance()->pushDebugScope(node.tag);
-		
-		objectToWorldMatrix->setValue(node.objectToWorld);
-		modelViewProjectionMatrix->setValue(node.mvp);
+		RecordParams* recordParams = reinterpret_cast<RecordParams*>(data);
+		assert(recordParams);
+
+		RenderCommandBuffer& commands = *recordParams->commands;
+		DisplayListUtil::DrawParams* params = recordParams->params;
 
-		DisplayListUtil::DrawParams* params = reinterpret_cast<DisplayListUtil::DrawParams*>(data);
-		assert(data);
+		commands.beginPacket(node.layer);
+		commands.pushScope(node.tag);
 
 		vec4 adj_color = node.color;
 		ColorF global_tint = params->tint;
@@ -65,17 +66,69 @@ namespace cs
 			memcpy(&global_tint, &node.color, sizeof(vec4));
 		}
 
-		globalColor->setValue(adj_color);
+		commands.setNode(node.objectToWorld, node.mvp, adj_color);
 		
+		DrawCallList drawCalls;
 		for (auto& it : node.geomList)
 		{
-			it.geom->draw(it.overrides.get(), it.drawIndex, global_tint);
+			if (it.drawCalls)
+			{
+				commands.addGeometry(it.geom, *it.drawCalls, it.overrides, global_tint);
+			}
+			else
+			{
+				drawCalls.clear();
+				it.geom->getDrawCalls(it.drawIndex, drawCalls);
+				commands.addGeometry(it.geom, drawCalls, it.overrides, global_tint);
+			}
 		}
         
-		RenderInterface::getInstance()->popDebugScope();
+		commands.popScope();
+	}
+
+	void DisplayListGeom::freeze()
+	{
+		DrawCallListPtr frozen = std::make_shared<DrawCallList>();
+		if (this->drawCalls)
+		{
+			*frozen = *this->drawCalls;
+		}
+		else
+		{
+			this->geom->getDrawCalls(this->drawIndex, *frozen);
+		}
+
+		for (auto& it : *frozen)
+		{
+			it = CREATE_CLASS(DrawCall, *it);
+		}
+		this->drawCalls = frozen;
 	}
 
-	void DisplayListTraversal::draw(DisplayListUtil::DrawParams* params, const PassParams& passParams)
+	void DisplayListNode::freeze(DisplayListNode& node, void* data)
+	{
+		for (auto& it : node.geomList)
+		{
+			it.freeze();
+		}
+	}
+
+	void DisplayListTraversal::drawNodes(SharedLinkedList<DisplayListNode>& nodes, DisplayListUtil::DrawParams* params, RenderSortMode sortMode, RenderCommandBuffer& commands)
+	{
+		uint32 firstPacket = commands.getNumPackets();
+
+		DisplayListNode::RecordParams recordParams;
+		recordParams.commands = &commands;
+		recordParams.params = params;
+		nodes.traverse(&DisplayListNode::record, (void*) &recordParams);
+
+		commands.sort(sortMode, firstPacket);
+
+		RenderCommandDevice device;
+		commands.submit(device, firstPacket);
+	}
+
+	void DisplayListTraversal::draw(DisplayListUtil::DrawParams* params, const PassParams& passParams, RenderCommandBuffer& commands)
 	{
 		const Transform& camera_transform = this->camera->getTransform();
 		const RectI viewRect = this->camera->getViewport();
@@ -103,7 +156,7 @@ namespace cs
 		vec2 viewport_inv = vec2(1.0f / viewport.x, 1.0f / viewport.y);
 		viewportInverseUniform->setValue(viewport_inv);
 
-		this->nodes.traverse(&DisplayListNode::draw, (void*) params);
+		DisplayListTraversal::drawNodes(this->nodes, params, passParams.sortMode, commands);
 	}
 
 	void DisplayListPass::draw(DisplayList* display_list, DisplayListUtil::DrawParams* params)
@@ -112,6 +165,7 @@ namespace cs
 		RenderInterface* render_interface = RenderInterface::getInstance();
 		RectI oldViewport = RenderInterface::getInstance()->getViewport();
 		DisplayListTraversal::PassParams passParams;
+		passParams.sortMode = this->sortMode;
 
 		if (this->target)
 		{
@@ -160,7 +214,7 @@ namespace cs
 				if (this->traversalMask.test((RenderTraversal)i))
 				{
 					DisplayListTraversal& traversal = display_list->traversals[i];
-					traversal.draw(params, passParams);
+					traversal.draw(params, passParams, display_list->commands);
 				}
 			}
 		}
@@ -168,7 +222,7 @@ namespace cs
 		if (this->nodes.getSize() > 0)
 		{
 			DisplayListUtil::DrawParams dummyParams;
-			this->nodes.traverse(&DisplayListNode::draw, (void*) &dummyParams);
+			DisplayListTraversal::drawNodes(this->nodes, &dummyParams, this->sortMode, display_list->commands);
 		}
 
 		if (this->postCallback)
@@ -199,20 +253,34 @@ namespace cs
 
 	void DisplayList::draw(DisplayListUtil::DrawParams* params)
 	{
+		this->commands.clear();
 		for (auto& it : this->passes)
 		{
             it->draw(this, params);
         }
 	}
 
-	DisplayListPassPtr DisplayList::addPass(const std::string& passName, RenderTraversal traversal)
+	void DisplayList::freeze()
+	{
+		for (size_t i = 0; i < RenderTraversalMAX; ++i)
+		{
+			this->traversals[i].nodes.traverse(&DisplayListNode::freeze, nullptr);
+		}
+
+		for (auto& it : this->passes)
+		{
+			it->nodes.traverse(&DisplayListNode::freeze, nullptr);
+		}
+	}
+
+	DisplayListPassPtr DisplayList::addPass(const StringId& passName, RenderTraversal traversal)
 	{
 		const uint32 kTraversalOffset = 10;
 		uint32 order = static_cast<int32>(traversal) * kTraversalOffset + this->traversalCount[traversal]++;
 		return this->addPass(passName, order);
 	}
 
-	DisplayListPassPtr DisplayList::addPass(const std::string& passName, uint32 order)
+	DisplayListPassPtr DisplayList::addPass(const StringId& passName, uint32 order)
 	{
 		DisplayListPassPtr newPass = CREATE_CLASS(DisplayListPass, passName, order);
 
@@ -255,7 +323,7 @@ namespace cs
 
 	}
 
-	void DisplayList::addCallback(const std::string& name, DisplayListPass::displayCallbackFunc func, bool pre)
+	void DisplayList::addCallback(const StringId& name, DisplayListPass::displayCallbackFunc func, bool pre)
 	{
 		DisplayListPassList::iterator it = this->passes.begin();
 		while (it != this->passes.end())
@@ -7,7 +7,9 @@
 #include "scene/Camera.h"
 
 #include "global/LinkedList.h"
+#include "global/StringId.h"
 #include "gfx/RenderTexture.h"
+#include "gfx/RenderCommand.h"
 
 namespace cs
 {
@@ -60,6 +62,7 @@ namespace cs
 			: geom(rhs.geom)
 			, drawIndex(rhs.drawIndex)
 			, overrides(rhs.overrides)
+			, drawCalls(rhs.drawCalls)
 		{ }
 
 		void operator=(const DisplayListGeom& rhs)
@@ -67,17 +70,24 @@ namespace cs
 			this->geom = rhs.geom;
 			this->drawIndex = rhs.drawIndex;
 			this->overrides = rhs.overrides;
+			this->drawCalls = rhs.drawCalls;
 		}
 
+		// Resolves the draw calls geom would issue now into private copies
+		void freeze();
+
 		GeometryPtr geom;
 		int32 drawIndex;
 		DrawCallOverridesPtr overrides;
+
+		// draws these against geom in place of its own, e.g. a mesh LOD
+		DrawCallListPtr drawCalls;
 	};
 
 	struct DisplayListNode
 	{
 		DisplayListNode() 
-			: tag("")
+			: tag()
 			, color(1.0f, 1.0f, 1.0f, 1.0f) 
 			, layer(0)
 			, flags(0)
@@ -104,14 +114,22 @@ namespace cs
 			this->flags = rhs.flags;
 		}
 
-		static void draw(const DisplayListNode& node, void* data);
+		// data is a DisplayListNode::RecordParams
+		static void record(const DisplayListNode& node, void* data);
+		static void freeze(DisplayListNode& node, void* data);
+
+		struct RecordParams
+		{
+			RenderCommandBuffer* commands;
+			DisplayListUtil::DrawParams* params;
+		};
 
 		static bool sort(const DisplayListNode& a, const DisplayListNode& b)
 		{
 			return a.layer < b.layer;
 		}
 
-		std::string tag;
+		StringId tag;
 		mat4 mvp;
 		mat4 objectToWorld;
 		vec4 color;
@@ -128,14 +146,22 @@ namespace cs
 	{
 		struct PassParams
 		{
+			PassParams()
+				: sortMode(RenderSortSequence)
+			{ }
+
 			Dimensions targetSize;
+			RenderSortMode sortMode;
 		};
 
 		CameraPtr camera;
 		SharedLinkedList<DisplayListNode> nodes;
 		RenderTraversal type;
 
-		void draw(DisplayListUtil::DrawParams* params, const PassParams& passParams);
+		void draw(DisplayListUtil::DrawParams* params, const PassParams& passParams, RenderCommandBuffer& commands);
+
+		// Records nodes into commands and submits what was recorded to the device
+		static void drawNodes(SharedLinkedList<DisplayListNode>& nodes, DisplayListUtil::DrawParams* params, RenderSortMode sortMode, RenderCommandBuffer& commands);
 
 		static UniformPtr cameraPositionUniform;
 		static UniformPtr cameraDirectionUniform;
@@ -150,12 +176,13 @@ namespace cs
 	{
 		typedef std::function<void(Scene*)> displayCallbackFunc;
 
-		DisplayListPass(const std::string& name, int32 ord)
+		DisplayListPass(const StringId& name, int32 ord)
 			: passName(name)
 			, target(nullptr)
             , zNear(0.01f)
             , zFar(1000.0f)
 			, traversalOrder(ord)
+			, sortMode(RenderSortSequence)
 			, preCallback(nullptr)
 			, postCallback(nullptr)
 		{
@@ -164,7 +191,7 @@ namespace cs
 
 		void draw(DisplayList* display_list, DisplayListUtil::DrawParams* params);
 
-		std::string passName;
+		StringId passName;
 		uint32 traversalOrder;
 
 		RenderTexturePtr target;
@@ -178,6 +205,9 @@ namespace cs
 		RenderTraversalMask traversalMask;
 		SharedLinkedList<DisplayListNode> nodes;
 
+		// RenderSortState only where nothing in the pass relies on draw order (no blending)
+		RenderSortMode sortMode;
+
 		displayCallbackFunc preCallback;
 		displayCallbackFunc postCallback;
 
@@ -195,16 +225,28 @@ namespace cs
 
 		static void initUniforms();
 
-		DisplayListPassPtr addPass(const std::string& passName, RenderTraversal traversal);
-		DisplayListPassPtr addPass(const std::string& passName, uint32 order);
+		DisplayListPassPtr addPass(const StringId& passName, RenderTraversal traversal);
+		DisplayListPassPtr addPass(const StringId& passName, uint32 order);
 
-		void addCallback(const std::string& name, DisplayListPass::displayCallbackFunc func, bool pre = false);
+		void addCallback(const StringId& name, DisplayListPass::displayCallbackFunc func, bool pre = false);
 
+		// Every pass records into commands, kept until the next draw so a frame can be captured
 		void draw(DisplayListUtil::DrawParams* params);
+		const RenderCommandBuffer& getCommands() const { return this->commands; }
+
+		// Resolves every node's draw calls now and keeps private copies, so the list can be drawn
+		// later while the geometry that produced it moves on to the next frame
+		void freeze();
 
 		DisplayListPassList passes;
 		DisplayListTraversal traversals[RenderTraversalMAX];
 		uint32 traversalCount[RenderTraversalMAX];
 
+	private:
+
+		friend class DisplayListPass;
+
+		RenderCommandBuffer commands;
+
 	};
 }
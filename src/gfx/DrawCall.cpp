@@ -5,6 +5,7 @@
 
 namespace cs
 {
+	const StringId kColorUniform("color");
 
 	BEGIN_META_CLASS(DrawCallOverrides)
 		ADD_MEMBER(textureOverrideHandles);
@@ -127,7 +128,7 @@ namespace cs
 	void DrawCall::setUniforms(ColorF tint)
 	{
 
-		cs::UniformPtr color = SharedUniform::getInstance().getUniform("color");
+		cs::UniformPtr color = SharedUniform::getInstance().getUniform(kColorUniform);
 		if (color.get())
 		{
 			vec4 newColor = toVec4(toColorF(this->color));
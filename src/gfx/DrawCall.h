@@ -5,6 +5,7 @@
 #include "gfx/TextureHandle.h"
 #include "gfx/ShaderHandle.h"
 #include "gfx/Color.h"
+#include "global/StringId.h"
 
 #include <unordered_map>
 
@@ -59,7 +60,7 @@ namespace cs
 			return *this;
 		}
 
-		std::string tag;
+		StringId tag;
 		DrawType type;
 		uint32 offset;
 		uint32 count;
@@ -103,4 +104,7 @@ namespace cs
 		static void execute(std::vector<DrawCallPtr>& drawCalls, DrawCallOverrides* overrides, ColorF tint = ColorF::White);
 */
 	};
+
+	typedef std::vector<DrawCallPtr> DrawCallList;
+	typedef std::shared_ptr<DrawCallList> DrawCallListPtr;
 }
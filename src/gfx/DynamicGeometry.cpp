@@ -3,10 +3,19 @@
 #include "gfx/DynamicGeometry.h"
 #include "gfx/RenderInterface.h"
 #include "gfx/Uniform.h"
+#include "gfx/RenderThread.h"
 #include "global/Utils.h"
 
+#include <algorithm>
+#include <mutex>
+
 namespace cs
 {
+	namespace
+	{
+		std::mutex gPendingLock;
+		std::vector<DynamicGeometry*> gPendingUpdates;
+	}
 
 	DynamicGeometry::DynamicGeometry(const GeometryDataPtr& init_data) :
 		Geometry(init_data, true),
@@ -14,13 +23,55 @@ namespace cs
 		indexUpdate(nullptr),
 		adjustDraw(nullptr),
 		vertexBufSize(nullptr),
-		indexBufSize(nullptr)
+		indexBufSize(nullptr),
+		updatePending(false)
 	{ 
 		this->vertexBufSize = std::bind(&DynamicGeometry::getVertexBufferSize, this);
 		this->indexBufSize = std::bind(&DynamicGeometry::getIndexBufferSize, this);
 	}
 
+	DynamicGeometry::~DynamicGeometry()
+	{
+		std::lock_guard<std::mutex> guard(gPendingLock);
+		if (this->updatePending)
+		{
+			gPendingUpdates.erase(std::remove(gPendingUpdates.begin(), gPendingUpdates.end(), this), gPendingUpdates.end());
+		}
+	}
+
 	void DynamicGeometry::update()
+	{
+		if (!RenderThread::isRenderThread())
+		{
+			std::lock_guard<std::mutex> guard(gPendingLock);
+			if (!this->updatePending)
+			{
+				this->updatePending = true;
+				gPendingUpdates.push_back(this);
+			}
+			return;
+		}
+
+		this->upload();
+	}
+
+	void DynamicGeometry::flushPendingUpdates()
+	{
+		assert(RenderThread::isRenderThread());
+
+		std::vector<DynamicGeometry*> pending;
+		{
+			std::lock_guard<std::mutex> guard(gPendingLock);
+			std::swap(pending, gPendingUpdates);
+			for (auto& it : pending)
+				it->updatePending = false;
+		}
+
+		for (auto& it : pending)
+			it->upload();
+	}
+
+	void DynamicGeometry::upload()
 	{
 
 		if (this->doubleBuffered)
@@ -76,13 +127,21 @@ namespace cs
 		}
 	}
 
+	void DynamicGeometry::getDrawCalls(int32 index, std::vector<DrawCallPtr>& drawCalls)
+	{
+		if (this->adjustDraw)
+			this->adjustDraw(index, drawCalls);
+	}
+
 	void DynamicGeometry::draw(DrawCallOverrides* overrides, int32 drawIndex, ColorF tint)
 	{
 		std::vector<DrawCallPtr> drawCalls;
-		if (this->adjustDraw)
-			this->adjustDraw(drawIndex, drawCalls);
-		
+		this->getDrawCalls(drawIndex, drawCalls);
+		this->draw(drawCalls, overrides, tint);
+	}
 
+	void DynamicGeometry::draw(std::vector<DrawCallPtr>& drawCalls, DrawCallOverrides* overrides, ColorF tint)
+	{
 		this->bindAll();
 
 		for (auto& it : drawCalls)
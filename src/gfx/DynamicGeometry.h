@@ -27,9 +27,17 @@ namespace cs
 		typedef std::function<size_t()> GetIndexSizeFunc;
 
 		DynamicGeometry(const GeometryDataPtr& init_data);
+		virtual ~DynamicGeometry();
 		
+		// Off the render thread the upload is deferred until flushPendingUpdates, repeated
+		// updates in between collapse into one
 		virtual void update();
 		virtual void draw(DrawCallOverrides* overrides, int32 index = -1, ColorF tint = ColorF::White);
+		virtual void draw(std::vector<DrawCallPtr>& drawCalls, DrawCallOverrides* overrides, ColorF tint = ColorF::White);
+		virtual void getDrawCalls(int32 index, std::vector<DrawCallPtr>& drawCalls);
+
+		// Render thread only, uploads everything updated off it since the last flush
+		static void flushPendingUpdates();
 
 		void setVertexUpdateFunc(VertexUpdateFunc& func);
 		void setVertexUpdateFunc(vertexUpdateFunc func = nullptr);
@@ -50,11 +58,15 @@ namespace cs
 
 	private:
 
+		void upload();
+
 		VertexUpdateFunc vertexUpdate;
 		IndexUpdateFunc indexUpdate;
 		AdjustDrawCallFunc adjustDraw;
 		GetVertexSizeFunc vertexBufSize;
 		GetIndexSizeFunc indexBufSize;
 
+		bool updatePending;
+
 	};
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "gfx/EnvironmentRenderable.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 
 namespace cs
 {
@@ -11,6 +14,38 @@ namespace cs
 
 	const float32 kOffsetRange = 0.0f;
 
+	const StringId kEnvironmentTag("EnvironmentRenderable");
+
+	// Whether an axis aligned box lies wholly outside one of the clip planes.  Boxes straddling the
+	// camera plane are kept, a little overdraw is cheaper than a hole.
+	bool isOutsideClip(const vec3& minb, const vec3& maxb, const mat4& mvp)
+	{
+		int32 outside[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int32 i = 0; i < 8; ++i)
+		{
+			vec3 corner(
+				(i & 1) ? maxb.x : minb.x,
+				(i & 2) ? maxb.y : minb.y,
+				(i & 4) ? maxb.z : minb.z);
+
+			vec4 clip = mvp * vec4(corner, 1.0f);
+
+			outside[0] += (clip.x < -clip.w) ? 1 : 0;
+			outside[1] += (clip.x >  clip.w) ? 1 : 0;
+			outside[2] += (clip.y < -clip.w) ? 1 : 0;
+			outside[3] += (clip.y >  clip.w) ? 1 : 0;
+			outside[4] += (clip.z < -clip.w) ? 1 : 0;
+			outside[5] += (clip.z >  clip.w) ? 1 : 0;
+		}
+
+		for (int32 i = 0; i < 6; ++i)
+		{
+			if (outside[i] == 8)
+				return true;
+		}
+		return false;
+	}
+
 	typedef BitMask<EnvironmentModificationType, EnvironmentModifyTypeMAX> EnvModifyMask;
 	struct EnvCommand
 	{
@@ -114,6 +149,12 @@ namespace cs
 			SET_MEMBER_DEFAULT(0.0f);
 			SET_MEMBER_MIN(0.0f);
 			SET_MEMBER_MAX(200.0f);
+
+		ADD_MEMBER(chunkSize);
+			SET_MEMBER_CALLBACK_POST(&EnvironmentRenderable::initGeometry);
+			SET_MEMBER_DEFAULT(8);
+			SET_MEMBER_MIN(1);
+			SET_MEMBER_MAX(64);
 		
 		ADD_MEMBER_PTR(modifyType);
 			ADD_COMBO_META_LABEL(EnvironmentModificationTypeDrop, "None");
@@ -126,12 +167,12 @@ namespace cs
 	END_META();
 
 	EnvironmentRenderable::EnvironmentRenderable()
-		: geometry(nullptr)
-		, subdivisions(PointI(5, 4))
+		: subdivisions(PointI(5, 4))
 		, stretch(PointF(100.0f, 100.0f))
 		, size(RectF(-250.0f, -200.0f, 500.0f, 400.0f))
 		, selectSize(RectF(-250.0f, -200.0f, 500.0f, 400.0f))
 		, borderDimm(0.0f)
+		, chunkSize(8)
 		, shaderHandle(CREATE_CLASS(ShaderHandle, RenderInterface::kDefaultTextureColorShader))
 		, mainTextureHandle(CREATE_CLASS(TextureHandle, RenderInterface::kDefaultTexture))
 		, edgeTextureHandle(CREATE_CLASS(TextureHandle, "gradient.png"))
@@ -139,8 +180,7 @@ namespace cs
 		, centerColor(ColorB::White)
 		, volume(nullptr)
 		, modifyType(CREATE_CLASS(EnvironmentModificationTypeDrop))
-		, dirty(false)
-		, visibleIndices(0)
+		, chunksX(0)
 	{
 
 	}
@@ -190,7 +230,6 @@ namespace cs
 
 	void EnvironmentRenderable::onPostLoad(const LoadFlagMask& flags)
 	{
-		this->dirty = true;
 		this->initGeometry();
 
 		if (this->shaderHandle)
@@ -207,15 +246,16 @@ namespace cs
 		this->shaderHandle->ignoreTextureStage(TextureStageDiffuse);
 	}
 
-	size_t EnvironmentRenderable::getVertexBufferSize()
+	size_t EnvironmentRenderable::getVertexBufferSize(size_t chunk)
 	{
-		size_t stride = this->geometry->getGeometryData()->decl.getStride();
-		return this->positions.size() * stride;
+		EnvChunk& env_chunk = this->chunks[chunk];
+		size_t stride = env_chunk.geometry->getGeometryData()->decl.getStride();
+		return env_chunk.vertexIndex.size() * stride;
 	}
 
-	size_t EnvironmentRenderable::getIndexBufferSize()
+	size_t EnvironmentRenderable::getIndexBufferSize(size_t chunk)
 	{
-		return (this->faces.size() + this->stitches.size()) * sizeof(EnvTriangle);
+		return this->chunks[chunk].indices.size() * sizeof(uint16);
 	}
 
 	void EnvironmentRenderable::onModificationTypeChanged()
@@ -233,7 +273,7 @@ namespace cs
 				vertex.color = this->centerColor;
 			}
 		}
-		this->dirty = true;
+		this->markAllDirty();
 	}
 
 	void EnvironmentRenderable::updateEdgeParams()
@@ -243,11 +283,145 @@ namespace cs
 			EnvVertex& vertex = this->positions[it];
 			this->setEdgeParams(vertex);
 		}
-		this->dirty = true;
+		this->markAllDirty();
 	}
 
 	void EnvironmentRenderable::initGeometry()
 	{
+		int32 chunk_size = std::max<int32>(1, this->chunkSize);
+		this->chunksX = std::max<int32>(1, (this->subdivisions.w + chunk_size - 1) / chunk_size);
+		int32 chunksY = std::max<int32>(1, (this->subdivisions.h + chunk_size - 1) / chunk_size);
+
+		this->chunks.clear();
+		this->chunks.resize(size_t(this->chunksX * chunksY));
+
+		this->vertexChunks.clear();
+		this->vertexChunks.resize(this->positions.size());
+
+		for (size_t i = 0; i < this->edges.size(); ++i)
+		{
+			size_t chunk = this->getChunkForEdge(i);
+			this->chunks[chunk].edgeIndex.push_back(uint32(i));
+
+			const EnvQuad& quad = this->edges[i];
+			this->addChunkVertex(chunk, quad.botLeft);
+			this->addChunkVertex(chunk, quad.topLeft);
+			this->addChunkVertex(chunk, quad.topRight);
+			this->addChunkVertex(chunk, quad.botRight);
+		}
+
+		// a stitch closes off a subdivided quad, its chunk is the one holding all three vertices
+		for (size_t i = 0; i < this->stitches.size(); ++i)
+		{
+			const EnvTriangle& stitch = this->stitches[i];
+			const std::vector<uint16>& owners = this->vertexChunks[stitch.f0];
+			const std::vector<uint16>& owners1 = this->vertexChunks[stitch.f1];
+			const std::vector<uint16>& owners2 = this->vertexChunks[stitch.f2];
+
+			size_t chunk = (owners.size() > 0) ? owners[0] : 0;
+			for (auto& it : owners)
+			{
+				if (std::find(owners1.begin(), owners1.end(), it) != owners1.end() &&
+					std::find(owners2.begin(), owners2.end(), it) != owners2.end())
+				{
+					chunk = it;
+					break;
+				}
+			}
+			this->chunks[chunk].stitchIndex.push_back(uint32(i));
+		}
+
+		for (size_t i = 0; i < this->chunks.size(); ++i)
+		{
+			this->rebuildChunk(i);
+		}
+	}
+
+	size_t EnvironmentRenderable::getChunkForEdge(size_t edge_index) const
+	{
+		// subdivided quads stay with the base grid cell they were cut from
+		int32 root = int32(edge_index);
+		while (this->edges[root].parent != -1)
+			root = this->edges[root].parent;
+
+		int32 chunk_size = std::max<int32>(1, this->chunkSize);
+		int32 width = std::max<int32>(1, this->subdivisions.w);
+		int32 cx = (root % width) / chunk_size;
+		int32 cy = (root / width) / chunk_size;
+
+		size_t chunk = size_t(cx + (cy * this->chunksX));
+		return std::min<size_t>(chunk, this->chunks.size() - 1);
+	}
+
+	void EnvironmentRenderable::addChunkVertex(size_t chunk, uint16 vertex)
+	{
+		if (vertex >= this->vertexChunks.size())
+			this->vertexChunks.resize(size_t(vertex) + 1);
+
+		std::vector<uint16>& owners = this->vertexChunks[vertex];
+		if (std::find(owners.begin(), owners.end(), uint16(chunk)) == owners.end())
+			owners.push_back(uint16(chunk));
+	}
+
+	void EnvironmentRenderable::rebuildChunk(size_t chunk)
+	{
+		typedef std::unordered_map<uint16, uint16> LocalVertexMap;
+		struct local
+		{
+			static void addTriangle(const EnvTriangle& triangle, EnvChunk& env_chunk, LocalVertexMap& vertex_map)
+			{
+				const uint16 corners[] = { triangle.f0, triangle.f1, triangle.f2 };
+				for (auto& it : corners)
+				{
+					LocalVertexMap::iterator found = vertex_map.find(it);
+					if (found == vertex_map.end())
+					{
+						found = vertex_map.insert(std::make_pair(it, uint16(env_chunk.vertexIndex.size()))).first;
+						env_chunk.vertexIndex.push_back(it);
+					}
+					env_chunk.indices.push_back(found->second);
+				}
+			}
+		};
+
+		EnvChunk& env_chunk = this->chunks[chunk];
+		env_chunk.vertexIndex.clear();
+		env_chunk.indices.clear();
+
+		LocalVertexMap vertex_map;
+		for (auto& it : env_chunk.edgeIndex)
+		{
+			const EnvQuad& quad = this->edges[it];
+			if (!quad.isVisible)
+				continue;
+
+			if (quad.t0 >= 0)
+			{
+				assert(quad.t0 < int32(this->faces.size()));
+				local::addTriangle(this->faces[quad.t0], env_chunk, vertex_map);
+			}
+
+			if (quad.t1 >= 0)
+			{
+				assert(quad.t1 < int32(this->faces.size()));
+				local::addTriangle(this->faces[quad.t1], env_chunk, vertex_map);
+			}
+		}
+
+		for (auto& it : env_chunk.stitchIndex)
+		{
+			local::addTriangle(this->stitches[it], env_chunk, vertex_map);
+		}
+
+		for (auto& it : env_chunk.vertexIndex)
+		{
+			this->addChunkVertex(chunk, it);
+		}
+
+		env_chunk.dirty = true;
+
+		if (env_chunk.geometry || env_chunk.indices.size() == 0)
+			return;
 
 		cs::GeometryDataPtr data = CREATE_CLASS(GeometryData);
 		data->decl.addAttrib(AttributeType::AttribPosition, { AttributeType::AttribPosition, TypeFloat, 3, 0 });
@@ -255,44 +429,76 @@ namespace cs
 		data->decl.addAttrib(AttributeType::AttribTexCoord1, { AttributeType::AttribTexCoord1, TypeFloat, 2, sizeof(vec3) + sizeof(vec2) });
 		data->decl.addAttrib(AttributeType::AttribColor, { AttributeType::AttribColor, TypeUnsignedByte, 4, sizeof(vec3) + sizeof(vec2) + sizeof(vec2) });
 
-		data->vertexSize = this->getNumVertices();
-		data->indexSize = this->getNumIndices();
+		data->vertexSize = env_chunk.vertexIndex.size();
+		data->indexSize = env_chunk.indices.size();
 		data->storage = BufferStorageDynamic;
 
-		this->geometry = CREATE_CLASS(DynamicGeometry, data);
+		env_chunk.geometry = CREATE_CLASS(DynamicGeometry, data);
 
 		DynamicGeometry::VertexUpdateFunc vfunc;
 		vfunc = std::bind(&EnvironmentRenderable::updateVertices,
 			this,
+			chunk,
 			std::placeholders::_1,
 			std::placeholders::_2,
 			std::placeholders::_3);
-		this->geometry->setVertexUpdateFunc(vfunc);
+		env_chunk.geometry->setVertexUpdateFunc(vfunc);
 
 		DynamicGeometry::IndexUpdateFunc ifunc;
 		ifunc = std::bind(&EnvironmentRenderable::updateIndices,
 			this,
+			chunk,
 			std::placeholders::_1,
 			std::placeholders::_2);
-		this->geometry->setIndexUpdateFunc(ifunc);
-
-		GeometryPtr geoptr = std::static_pointer_cast<Geometry>(this->geometry);
-
+		env_chunk.geometry->setIndexUpdateFunc(ifunc);
 
 		DynamicGeometry::AdjustDrawCallFunc dcfunc;
 		dcfunc = std::bind(&EnvironmentRenderable::setDrawParams,
 			this,
+			chunk,
 			std::placeholders::_1,
 			std::placeholders::_2);
-		this->geometry->setDrawCallAdjustFunc(dcfunc);
+		env_chunk.geometry->setDrawCallAdjustFunc(dcfunc);
 
-		DynamicGeometry::GetVertexSizeFunc numVFunc = std::bind(&EnvironmentRenderable::getVertexBufferSize, this);
-		this->geometry->setVertexBufferSizeFunc(numVFunc);
+		DynamicGeometry::GetVertexSizeFunc numVFunc = std::bind(&EnvironmentRenderable::getVertexBufferSize, this, chunk);
+		env_chunk.geometry->setVertexBufferSizeFunc(numVFunc);
 
-		DynamicGeometry::GetIndexSizeFunc numIFunc = std::bind(&EnvironmentRenderable::getIndexBufferSize, this);
-		this->geometry->setIndexBufferSizeFunc(numIFunc);
+		DynamicGeometry::GetIndexSizeFunc numIFunc = std::bind(&EnvironmentRenderable::getIndexBufferSize, this, chunk);
+		env_chunk.geometry->setIndexBufferSizeFunc(numIFunc);
+	}
 
-		this->geometry->update();
+	void EnvironmentRenderable::refreshChunkBounds(EnvChunk& chunk)
+	{
+		if (chunk.vertexIndex.size() == 0)
+			return;
+
+		chunk.minBounds = this->positions[chunk.vertexIndex[0]].position;
+		chunk.maxBounds = chunk.minBounds;
+		for (auto& it : chunk.vertexIndex)
+		{
+			const vec3& position = this->positions[it].position;
+			chunk.minBounds = glm::min(chunk.minBounds, position);
+			chunk.maxBounds = glm::max(chunk.maxBounds, position);
+		}
+	}
+
+	void EnvironmentRenderable::markVertexDirty(uint16 vertex)
+	{
+		if (vertex >= this->vertexChunks.size())
+			return;
+
+		for (auto& it : this->vertexChunks[vertex])
+		{
+			this->chunks[it].dirty = true;
+		}
+	}
+
+	void EnvironmentRenderable::markAllDirty()
+	{
+		for (auto& it : this->chunks)
+		{
+			it.dirty = true;
+		}
 	}
 
 	void EnvironmentRenderable::addFace(size_t top_left, size_t top_right, size_t bot_left, size_t bot_right, bool flip)
@@ -461,24 +667,52 @@ namespace cs
 
 		if (traversal == RenderTraversalMain && this->getNumVertices() > 0 && this->getNumIndices() > 0)
 		{
-			if (this->dirty)
+			bool moved = false;
+			for (auto& it : this->chunks)
 			{
-				this->geometry->update();
-				this->dirty = false;
+				if (!it.dirty)
+					continue;
 
+				this->refreshChunkBounds(it);
+				it.dirty = false;
+				it.uploadPending = true;
+				moved = true;
+			}
+
+			if (moved)
+			{
 				FloatExtentCalculator xExt, yExt;
-				for (auto& it : this->positions)
+				for (auto& it : this->chunks)
 				{
-					xExt.evaluate(it.position.x);
-					yExt.evaluate(it.position.y);
+					if (it.vertexIndex.size() == 0)
+						continue;
+
+					xExt.evaluate(it.minBounds.x);
+					xExt.evaluate(it.maxBounds.x);
+					yExt.evaluate(it.minBounds.y);
+					yExt.evaluate(it.maxBounds.y);
 				}
 
 				this->selectSize = createRectFromExtents(xExt, yExt);
 			}
 
-			assert(this->geometry != nullptr);
-			
-			display_node.geomList.push_back(std::static_pointer_cast<Geometry>(this->geometry));
+			for (auto& it : this->chunks)
+			{
+				if (!it.geometry || it.indices.size() == 0)
+					continue;
+
+				if (isOutsideClip(it.minBounds, it.maxBounds, display_node.mvp))
+					continue;
+
+				// chunks edited off screen upload once they come back into view
+				if (it.uploadPending)
+				{
+					it.geometry->update();
+					it.uploadPending = false;
+				}
+
+				display_node.geomList.push_back(std::static_pointer_cast<Geometry>(it.geometry));
+			}
 		}
 	}
 
@@ -487,54 +721,39 @@ namespace cs
 
 	}
 
-	size_t EnvironmentRenderable::updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl)
+	size_t EnvironmentRenderable::updateVertices(size_t chunk, uchar* data, size_t bufferSize, VertexDeclaration& decl)
 	{
-		if (this->positions.size() == 0)
+		const EnvChunk& env_chunk = this->chunks[chunk];
+		if (env_chunk.vertexIndex.size() == 0)
 			return 0;
 
-		assert(this->getNumVertices() <= (bufferSize / sizeof(EnvVertex)));
-		memcpy(data, (void*)&this->positions[0], this->positions.size() * sizeof(EnvVertex));
-		return this->getNumVertices();
+		assert(env_chunk.vertexIndex.size() <= (bufferSize / sizeof(EnvVertex)));
+		EnvVertex* vertices = reinterpret_cast<EnvVertex*>(data);
+		for (auto& it : env_chunk.vertexIndex)
+		{
+			*vertices++ = this->positions[it];
+		}
+		return env_chunk.vertexIndex.size();
 	}
 
-	size_t EnvironmentRenderable::updateIndices(uchar* data, size_t bufferSize)
+	size_t EnvironmentRenderable::updateIndices(size_t chunk, uchar* data, size_t bufferSize)
 	{
-		if (this->faces.size() == 0)
+		const EnvChunk& env_chunk = this->chunks[chunk];
+		if (env_chunk.indices.size() == 0)
 			return 0;
 
-		this->visibleIndices = 0;
-		for (auto& it : this->edges)
-		{
-			EnvQuad& quad = it;
-			if (!quad.isVisible)
-				continue;
-
-			assert(quad.t0 >= 0 && quad.t0 < int32(this->faces.size()));
-			memcpy(data + (this->visibleIndices * sizeof(uint16)), (void*) &this->faces[quad.t0], sizeof(EnvTriangle));
-			this->visibleIndices += 3;
-			
-			assert(quad.t1 >= 0 && quad.t1 < int32(this->faces.size()));
-			memcpy(data + (this->visibleIndices * sizeof(uint16)), (void*)&this->faces[quad.t1], sizeof(EnvTriangle));
-			this->visibleIndices += 3;
-			
-		}
-
-		if (this->stitches.size() > 0)
-		{
-			memcpy(data + (this->visibleIndices * sizeof(uint16)), (void*)&this->stitches[0], this->stitches.size() * sizeof(EnvTriangle));
-			this->visibleIndices += this->stitches.size() * 3;
-		}
-
-		return this->visibleIndices;
+		assert(env_chunk.indices.size() <= (bufferSize / sizeof(uint16)));
+		memcpy(data, (void*) &env_chunk.indices[0], env_chunk.indices.size() * sizeof(uint16));
+		return env_chunk.indices.size();
 	}
 
-	void EnvironmentRenderable::setDrawParams(int32 index, std::vector<DrawCallPtr>& dcs)
+	void EnvironmentRenderable::setDrawParams(size_t chunk, int32 index, std::vector<DrawCallPtr>& dcs)
 	{
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->tag = "EnvironmentRenderable";
+		dc->tag = kEnvironmentTag;
 		dc->type = DrawTriangles;
 		dc->indexType = TypeUnsignedShort;
-		dc->count = static_cast<uint32>(this->visibleIndices);
+		dc->count = static_cast<uint32>(this->chunks[chunk].indices.size());
 		dc->offset = 0;
 		dc->shaderHandle = this->shaderHandle;
 		dc->textures[0] = this->mainTextureHandle;
@@ -558,7 +777,7 @@ namespace cs
 		vertex.uv0.x = new_pos.x / this->stretch.w;
 		vertex.uv0.y = new_pos.y / this->stretch.h;
 
-		this->dirty = true;
+		this->markVertexDirty(uint16(index));
 
 	}
 
@@ -591,6 +810,9 @@ namespace cs
 		};
 
 		log::info("subdivide face at index ", index);
+
+		// the new quads are appended below, keep the reference to this one valid
+		this->edges.reserve(this->edges.size() + 4);
 		EnvQuad& quad = this->edges[index];
 		if (quad.t0 == -1 || quad.t1 == -1)
 		{
@@ -621,6 +843,10 @@ namespace cs
 			bot_edge 
 		};
 		
+		size_t chunk = this->getChunkForEdge(index);
+		size_t edgeStart = this->edges.size();
+		size_t stitchStart = this->stitches.size();
+
 		uint16 posSize = static_cast<uint16>(this->positions.size());
         uint16 idx[5];
 		
@@ -704,6 +930,14 @@ namespace cs
 
 		quad.isVisible = false;
 
+		EnvChunk& env_chunk = this->chunks[chunk];
+		for (size_t i = edgeStart; i < this->edges.size(); ++i)
+			env_chunk.edgeIndex.push_back(uint32(i));
+		for (size_t i = stitchStart; i < this->stitches.size(); ++i)
+			env_chunk.stitchIndex.push_back(uint32(i));
+
+		this->rebuildChunk(chunk);
+
 		return true;
 	}
 
@@ -873,7 +1107,7 @@ namespace cs
 		if (quad.isVisible)
 		{
 			quad.isVisible = false;
-			this->dirty = true;
+			this->rebuildChunk(this->getChunkForEdge(index));
 
 			this->adjustEdgeForRemovedFace(index);
 			return true;
@@ -891,15 +1125,15 @@ namespace cs
 			if (quad.t0 == index)
 			{
 				quad.t0 = -1;
+				this->rebuildChunk(this->getChunkForEdge(i));
 			}
 			if (quad.t1 == index)
 			{
 				quad.t1 = -1;
+				this->rebuildChunk(this->getChunkForEdge(i));
 			}		
 		}
 
-		this->dirty = true;
-
 		return true;
 	}
 
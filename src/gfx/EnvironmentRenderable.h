@@ -106,6 +106,38 @@ namespace cs
 	typedef std::set<uint16> EnvBoundaryVertexIndex;
 	typedef std::vector<uint16> EnvBoundaryVertexIndexSerialize;
 
+	// A square block of base grid cells, along with every quad subdivided out of them, drawn as
+	// its own geometry.  Chunks off screen are skipped and an edit only re-uploads its chunks.
+	struct EnvChunk
+	{
+		EnvChunk()
+			: minBounds(kZero3)
+			, maxBounds(kZero3)
+			, dirty(true)
+			, uploadPending(true)
+		{ }
+
+		DynamicGeometryPtr geometry;
+
+		// owned quads and stitches, indexing the renderable's lists
+		std::vector<uint32> edgeIndex;
+		std::vector<uint32> stitchIndex;
+
+		// local vertex -> position, and the visible triangles in local vertices
+		std::vector<uint16> vertexIndex;
+		std::vector<uint16> indices;
+
+		vec3 minBounds;
+		vec3 maxBounds;
+
+		// positions changed, bounds are stale and the buffers need refilling
+		bool dirty;
+		bool uploadPending;
+	};
+
+	typedef std::vector<EnvChunk> EnvChunkList;
+	typedef std::vector<std::vector<uint16>> EnvVertexChunkList;
+
 	enum EnvironmentModificationType
 	{
 		EnvironmentModifyTypeNone = -1,
@@ -152,9 +184,9 @@ namespace cs
 		virtual void draw() const;
 		virtual void queueGeometry(RenderTraversal traversal, DisplayListNode& display_node);
 
-		size_t updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl);
-		size_t updateIndices(uchar* data, size_t bufferSize);
-		void setDrawParams(int32 index, std::vector<DrawCallPtr>& dcs);
+		size_t updateVertices(size_t chunk, uchar* data, size_t bufferSize, VertexDeclaration& decl);
+		size_t updateIndices(size_t chunk, uchar* data, size_t bufferSize);
+		void setDrawParams(size_t chunk, int32 index, std::vector<DrawCallPtr>& dcs);
 
 		void refresh();
 
@@ -170,8 +202,8 @@ namespace cs
 
 		bool removeTriangle(size_t index);
 
-		size_t getVertexBufferSize();
-		size_t getIndexBufferSize();
+		size_t getVertexBufferSize(size_t chunk);
+		size_t getIndexBufferSize(size_t chunk);
 
 		void onModificationTypeChanged();
 
@@ -183,6 +215,13 @@ namespace cs
 
 		void initGeometry();
 		void populateGeometry();
+
+		size_t getChunkForEdge(size_t edge_index) const;
+		void addChunkVertex(size_t chunk, uint16 vertex);
+		void rebuildChunk(size_t chunk);
+		void refreshChunkBounds(EnvChunk& chunk);
+		void markVertexDirty(uint16 vertex);
+		void markAllDirty();
 		void addVolumeCallbacks(size_t index, SelectableVolume& volume);
 
 		void setShaderImpl();
@@ -207,7 +246,6 @@ namespace cs
 		ColorB edgeColor;
 		ColorB centerColor;
 
-		DynamicGeometryPtr geometry;
 		DynamicGeometryPtr shadowGeometry;
 
 		RectF size;
@@ -215,6 +253,7 @@ namespace cs
 		SizeI subdivisions;
 		SizeF stretch;
 		float32 borderDimm;
+		int32 chunkSize;
 
 		EnvVertexList positions;
 		EnvTriangleList faces;
@@ -228,8 +267,9 @@ namespace cs
 		EnvBoundaryVertexIndex boundaryIndex;
 		EnvBoundaryVertexIndexSerialize boundaryIndexSerialize;
 
-		bool dirty;
-		size_t visibleIndices;
+		EnvChunkList chunks;
+		EnvVertexChunkList vertexChunks;
+		int32 chunksX;
 	};
 
 	namespace text
@@ -111,6 +111,19 @@ namespace cs
 		}
 	}
 
+	void Geometry::getDrawCalls(int32 index, std::vector<DrawCallPtr>& drawCalls)
+	{
+		if (index == -1)
+		{
+			drawCalls.insert(drawCalls.end(), this->data->drawCalls.begin(), this->data->drawCalls.end());
+		}
+		else
+		{
+			assert(size_t(index) < this->data->drawCalls.size());
+			drawCalls.push_back(this->data->drawCalls[index]);
+		}
+	}
+
 	void Geometry::swap()
 	{
 		if (this->doubleBuffered)
@@ -128,7 +141,7 @@ namespace cs
 
 			dc->setUniforms(tint);
 			dc->bind(this, overrides);
-			RenderInterface::getInstance()->draw(this, dc);
+			RenderInterface::getInstance()->draw(this, dc, overrides);
 		}
 	}
 
@@ -161,7 +174,7 @@ namespace cs
                     RenderInterface::getInstance()->setBuffer(ibuffer);
                     void* index_data = (void*)(this->ibStagingData) ? (void*) this->ibStagingData : ((this->data->indexData.size() > 0) ? &this->data->indexData[0] : nullptr);
 
-                    ibuffer->alloc(this->data->indexSize * sizeof(uint16), index_data, this->data->storage);
+                    ibuffer->alloc(this->data->indexSize * this->data->getIndexStride(), index_data, this->data->storage);
                     RenderInterface::getInstance()->clearBuffer(BufferTypeIndex);
 
                     this->ibo.push_back(ibuffer);
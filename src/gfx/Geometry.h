@@ -35,6 +35,9 @@ namespace cs
 		virtual void update() { }
 		virtual void swap();
 
+		// The draw calls draw(overrides, index) would issue right now
+		virtual void getDrawCalls(int32 index, std::vector<DrawCallPtr>& drawCalls);
+
 		const GeometryDataPtr& getGeometryData() const { return data; }
 
 		BufferObjectPtr& getVertexBuffer() { return this->vbo[this->index]; }
@@ -43,7 +46,7 @@ namespace cs
 		size_t getIndexBufferSize() { return this->ibo[this->index]->getSize(); }
 
 		size_t getNumVertices() { return this->getVertexBufferSize() / this->data->decl.getStride(); }
-		size_t getNumIndices() { return this->getIndexBufferSize() / sizeof(uint16); }
+		size_t getNumIndices() { return this->getIndexBufferSize() / this->data->getIndexStride(); }
 
 		uchar* getVertexBufferStagingData() { return this->vbStagingData; }
 		uchar* getIndexBufferStagingData() { return this->ibStagingData; }
@@ -19,7 +19,8 @@ namespace cs
 		GeometryData() :
 			storage(BufferStorageStatic),
 			vertexSize(0),
-			indexSize(0) { }
+			indexSize(0),
+			indexType(TypeUnsignedShort) { }
 
 		VertexDeclaration decl;
 		BufferStorage storage;
@@ -59,6 +60,11 @@ namespace cs
 		std::vector<uint16> indexData;
 		size_t indexSize;
 
+		// TypeUnsignedShort or TypeUnsignedInt, staged index data is laid out to match
+		Type indexType;
+
+		inline size_t getIndexStride() const { return (this->indexType == TypeUnsignedInt) ? sizeof(uint32) : sizeof(uint16); }
+
 		std::vector<DrawCallPtr> drawCalls;
 	
 	};
@@ -7,6 +7,14 @@
 
 #include "global/Stats.h"
 
+#include "gfx/MeshCache.h"
+#include "gfx/MeshOptimizer.h"
+#include "gfx/MeshSimplifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
 #define TINYOBJLOADER_IMPLEMENTATION // define this in only *one* .cc
 #include "external/tinyobj/tiny_obj_loader.h"
 
@@ -15,6 +23,18 @@ namespace cs
 	const float32 kMeshOBJScale = 100.0f;
 	const bool kForceUVBuffer = false;
 	const bool kForceNormalBuffer = false;
+	const bool kMeshUseCache = true;
+
+	// each LOD aims for half the triangles of the one before, up to kMeshLodMaxLevels including
+	// full detail, and stops once a level drifts too far or sheds too little to be worth drawing
+	const uint32 kMeshLodMaxLevels = 4;
+	const float32 kMeshLodReduction = 0.5f;
+	const float32 kMeshLodMaxError = 0.05f;
+	const float32 kMeshLodMinReduction = 0.8f;
+	const size_t kMeshLodMinTriangles = 64;
+
+	int32 gMeshTriangles = 0;
+	int32 gMeshTrianglesFull = 0;
 
 	BEGIN_META_RESOURCE(Mesh)
 
@@ -34,6 +54,19 @@ namespace cs
 		ADD_MEMBER(instances);
 			SET_MEMBER_IGNORE_SERIALIZATION();
 
+		ADD_MEMBER(lodEnabled);
+			SET_MEMBER_DEFAULT(true);
+
+		ADD_MEMBER(lodScreenError);
+			SET_MEMBER_DEFAULT(0.002f);
+			SET_MEMBER_MIN(0.0f);
+			SET_MEMBER_MAX(0.1f);
+
+		ADD_MEMBER(lodHysteresis);
+			SET_MEMBER_DEFAULT(0.25f);
+			SET_MEMBER_MIN(0.0f);
+			SET_MEMBER_MAX(0.9f);
+
 	END_META()
 
 	BEGIN_META_CLASS(MeshHandleVolume)
@@ -72,6 +105,40 @@ namespace cs
 		}
 	}
 
+	void MeshShapeInstance::selectLod(float32 coverage, float32 screenError, float32 hysteresis)
+	{
+		const std::vector<MeshShapeLod>& lods = this->shape->lods;
+		if (lods.size() <= 1)
+		{
+			this->lod = 0;
+			return;
+		}
+
+		this->lod = std::min<int32>(this->lod, int32(lods.size()) - 1);
+
+		// the coarsest level whose error stays under the threshold on screen
+		int32 target = 0;
+		for (int32 i = int32(lods.size()) - 1; i > 0; --i)
+		{
+			if (lods[i].error * coverage <= screenError)
+			{
+				target = i;
+				break;
+			}
+		}
+
+		// only drop detail once a level is comfortably under the threshold, so a mesh sitting on
+		// the boundary doesn't flicker between two levels
+		if (target > this->lod)
+		{
+			float32 dropError = screenError * (1.0f - hysteresis);
+			while (target > this->lod && lods[target].error * coverage > dropError)
+				--target;
+		}
+
+		this->lod = target;
+	}
+
 	void MeshHandle::onMeshChanged()
 	{
 		this->onChanged.invoke();
@@ -88,231 +155,295 @@ namespace cs
 		}
 	}
 
-	void populateShape(
-		tinyobj::shape_t& obj_shape,
-		Mesh::MeshShapes& shapes,
-		Mesh::MeshMaterials& materials)
+	size_t getFullDetailIndices(const MeshCacheShape& shape)
 	{
-		GeometryDataPtr data = CREATE_CLASS(GeometryData);
-		MeshAABB aabb;
-		bool hasNormals = obj_shape.mesh.normals.size() > 0 || kForceNormalBuffer;
+		size_t count = 0;
+		for (auto& range : shape.ranges)
+			count += range.count;
+		return count;
+	}
 
-		uint32 offset = 0;
-		data->decl.addAttrib(AttribPosition, { AttribPosition, TypeFloat, 3, 0 });
-		offset += sizeof(vec3);
+	void cookLods(MeshCacheShape& shape, size_t stride)
+	{
+		const std::vector<MeshCacheRange>* previous = &shape.ranges;
+		size_t previousTriangles = getFullDetailIndices(shape) / 3;
+		float32 previousError = 0.0f;
 
-		if (obj_shape.mesh.texcoords.size() > 0 || kForceUVBuffer)
+		for (uint32 level = 1; level < kMeshLodMaxLevels; ++level)
 		{
-			data->decl.addAttrib(AttribTexCoord0, { AttribTexCoord0, TypeFloat, 2, offset });
-			offset += sizeof(vec2);
-		}
+			if (previousTriangles < kMeshLodMinTriangles)
+				break;
 
-		if (hasNormals)
-		{
-			data->decl.addAttrib(AttribNormal, { AttribNormal, TypeFloat, 3, offset });
-			offset += sizeof(vec3);
+			// each level simplifies the one before it, the errors stack
+			MeshCacheLod lod;
+			size_t lodStart = shape.indices.size();
+			size_t lodTriangles = 0;
+			float32 levelError = 0.0f;
+
+			std::vector<uint32> simplified;
+			for (auto& range : *previous)
+			{
+				if (range.count == 0)
+					continue;
+
+				size_t target = size_t(float32(range.count / 3) * kMeshLodReduction) * 3;
+				float32 error = MeshSimplifier::simplify(simplified,
+					&shape.indices[range.offset], range.count,
+					shape.vertexData.data(), stride, shape.numVertices,
+					target, kMeshLodMaxError - previousError);
+
+				MeshOptimizer::optimizeTriangles(simplified.data(), simplified.size(), shape.vertexData.data(), stride, shape.numVertices);
+
+				MeshCacheRange lodRange;
+				lodRange.offset = uint32(shape.indices.size());
+				lodRange.count = uint32(simplified.size());
+				lodRange.material = range.material;
+				lod.ranges.push_back(lodRange);
+
+				shape.indices.insert(shape.indices.end(), simplified.begin(), simplified.end());
+				lodTriangles += simplified.size() / 3;
+				levelError = std::max<float32>(levelError, error);
+			}
+
+			if (lodTriangles == 0 || float32(lodTriangles) > float32(previousTriangles) * kMeshLodMinReduction)
+			{
+				shape.indices.resize(lodStart);
+				break;
+			}
+
+			lod.error = previousError + levelError;
+			shape.lods.push_back(lod);
+
+			previous = &shape.lods.back().ranges;
+			previousTriangles = lodTriangles;
+			previousError = lod.error;
 		}
+	}
+
+	void cookShape(tinyobj::shape_t& obj_shape, MeshCacheShape& shape, bool optimize)
+	{
+		shape.name = obj_shape.name;
+		shape.hasTexCoords = obj_shape.mesh.texcoords.size() > 0 || kForceUVBuffer;
+		shape.hasNormals = obj_shape.mesh.normals.size() > 0 || kForceNormalBuffer;
+		shape.numVertices = uint32(obj_shape.mesh.positions.size() / 3);
 
-		size_t numVertices = obj_shape.mesh.positions.size() / 3;
-		data->vertexSize = numVertices;
-		data->indexSize = obj_shape.mesh.indices.size();
+		size_t texOffset = sizeof(vec3);
+		size_t nmlOffset = texOffset + ((shape.hasTexCoords) ? sizeof(vec2) : 0);
+		size_t stride = nmlOffset + ((shape.hasNormals) ? sizeof(vec3) : 0);
 
-		uchar* vertex_data = (uchar*) new uchar[data->decl.getStride() * data->vertexSize];
-		const Attribute* posAttrib = data->decl.getAttrib(AttribPosition);
-		if (posAttrib)
+		shape.vertexData.assign(stride * shape.numVertices, 0);
+		uchar* vertex_data = shape.vertexData.data();
+
+		for (size_t p = 0; p < shape.numVertices; ++p)
 		{
-			for (size_t p = 0; p < obj_shape.mesh.positions.size() / 3; ++p)
-			{
-				vec3* pos = data->decl.getAttributePointerAtIndex<vec3>(vertex_data, AttributeType::AttribPosition, p);
-				(*pos) = vec3(
-					obj_shape.mesh.positions[3 * p + 0],
-					obj_shape.mesh.positions[3 * p + 1],
-					obj_shape.mesh.positions[3 * p + 2]) * kMeshOBJScale;
+			vec3 pos = vec3(
+				obj_shape.mesh.positions[3 * p + 0],
+				obj_shape.mesh.positions[3 * p + 1],
+				obj_shape.mesh.positions[3 * p + 2]) * kMeshOBJScale;
 
-				aabb.evailuate(*pos);
-			}
+			memcpy(vertex_data + p * stride, &pos, sizeof(vec3));
+			shape.aabb.evailuate(pos);
 		}
 
-		const Attribute* texAttrib = data->decl.getAttrib(AttribTexCoord0);
-		if (texAttrib)
+		if (shape.hasTexCoords)
 		{
-			if (obj_shape.mesh.texcoords.size() == 0 && kForceUVBuffer)
+			size_t numTexCoords = std::min<size_t>(obj_shape.mesh.texcoords.size() / 2, shape.numVertices);
+			for (size_t t = 0; t < numTexCoords; ++t)
 			{
-				for (size_t t = 0; t < obj_shape.mesh.positions.size() / 3; t++)
-				{
-					vec2* tex = data->decl.getAttributePointerAtIndex<vec2>(vertex_data, AttributeType::AttribTexCoord0, t);
-					(*tex) = vec2(0.0f, 0.0f);
-				}
-			}
-			else
-			{
-				//assert(obj_shape.mesh.texcoords.size() / 2 == numVertices);
-				for (size_t t = 0; t < obj_shape.mesh.texcoords.size() / 2; ++t)
-				{
-					vec2* tex = data->decl.getAttributePointerAtIndex<vec2>(vertex_data, AttributeType::AttribTexCoord0, t);
-					(*tex) = vec2(
-						obj_shape.mesh.texcoords[2 * t + 0],
-						1.0f - obj_shape.mesh.texcoords[2 * t + 1]);
-				}
+				vec2 tex = vec2(
+					obj_shape.mesh.texcoords[2 * t + 0],
+					1.0f - obj_shape.mesh.texcoords[2 * t + 1]);
+				memcpy(vertex_data + t * stride + texOffset, &tex, sizeof(vec2));
 			}
 		}
 
-		const Attribute* nmlAttrib = data->decl.getAttrib(AttribNormal);
-		if (nmlAttrib)
+		if (shape.hasNormals)
 		{
-
-			//assert(obj_shape.mesh.normals.size() / 3 == numVertices);
-			for (size_t n = 0; n < obj_shape.mesh.normals.size() / 3; ++n)
+			size_t numNormals = std::min<size_t>(obj_shape.mesh.normals.size() / 3, shape.numVertices);
+			for (size_t n = 0; n < numNormals; ++n)
 			{
-				vec3* nml = data->decl.getAttributePointerAtIndex<vec3>(vertex_data, AttributeType::AttribNormal, n);
-				(*nml) = vec3(
+				vec3 nml = vec3(
 					obj_shape.mesh.normals[3 * n + 0],
 					obj_shape.mesh.normals[3 * n + 1],
 					obj_shape.mesh.normals[3 * n + 2]);
+				memcpy(vertex_data + n * stride + nmlOffset, &nml, sizeof(vec3));
 			}
 		}
 
-		// copy indices
-		uint16* index_data = new uint16[data->indexSize];
-
-		int32 matIndex = obj_shape.mesh.material_ids[0];
-		size_t elementCount = 0;
-		offset = 0;
-
-		MeshMaterialInstance::GeometryType geomType = MeshMaterialInstance::GeometryTypeNone;
-		if (hasNormals)
+		// one contiguous range per material, in the order the materials first appear
+		size_t total_triangles = obj_shape.mesh.indices.size() / 3;
+		std::vector<int32> materialOrder;
+		for (size_t tri = 0; tri < total_triangles; ++tri)
 		{
-			geomType = MeshMaterialInstance::GeometryTypeNormals;
+			int32 matIndex = (tri < obj_shape.mesh.material_ids.size()) ? obj_shape.mesh.material_ids[tri] : -1;
+			if (std::find(materialOrder.begin(), materialOrder.end(), matIndex) == materialOrder.end())
+				materialOrder.push_back(matIndex);
 		}
 
+		shape.indices.clear();
+		shape.indices.reserve(total_triangles * 3);
+		for (auto& matIndex : materialOrder)
+		{
+			MeshCacheRange range;
+			range.offset = uint32(shape.indices.size());
+			range.material = matIndex;
 
-		std::vector<MeshMaterialInstancePtr> materialInstances;
-		MeshMaterialPtr material = (matIndex >= 0 && matIndex < int32(materials.size())) ? materials[matIndex] : MeshMaterial::kDefaultMeshMaterial;
-		MeshMaterialInstancePtr materialInstance = CREATE_CLASS(MeshMaterialInstance, geomType, material);
-		materialInstances.push_back(materialInstance);
-
-		size_t total_indices = obj_shape.mesh.indices.size();
-		size_t total_triangles = total_indices / 3;
-
-		for (size_t index = 0; index < total_triangles; index++)
-		{
-			index_data[(index * 3) + 0] = (uint16)obj_shape.mesh.indices[(index * 3) + 0];
-			index_data[(index * 3) + 1] = (uint16)obj_shape.mesh.indices[(index * 3) + 1];
-			index_data[(index * 3) + 2] = (uint16)obj_shape.mesh.indices[(index * 3) + 2];
-
-			int32 newMatIndex = obj_shape.mesh.material_ids[index];
-			if (newMatIndex != matIndex)
-			{
-				DrawCallPtr dc = CREATE_CLASS(DrawCall);
-				dc->offset = static_cast<uint32>(offset) * 3;
-				dc->type = DrawTriangles;
-				dc->indexType = TypeUnsignedShort;
-				dc->shaderHandle = RenderInterface::kDefaultColorShader;
-				dc->textures[0] = RenderInterface::kWhiteTexture;
-				dc->color = ColorB::White;
-				dc->depthTest = true;
-				dc->depthFunc = DepthLess;
-				dc->count = static_cast<uint32>(elementCount) * 3;
-                dc->frontFace = FrontFaceCCW;
-#if defined(CS_METAL)
-                dc->cullFace = CullNone;
-#endif
-                
-				dc->uniformCallback = std::bind(&MeshMaterialInstance::onBindMesh, materialInstance);
-				materialInstance->populate(dc);
-                
-				data->drawCalls.push_back(dc);
-
-				offset += elementCount;
-				matIndex = newMatIndex;
-				elementCount = 0;
-				material = (matIndex >= 0 && matIndex < materials.size()) ? materials[matIndex] : MeshMaterial::kDefaultMeshMaterial;
-				materialInstance = CREATE_CLASS(MeshMaterialInstance, geomType, material);
-				materialInstances.push_back(materialInstance);
+			for (size_t tri = 0; tri < total_triangles; ++tri)
+			{
+				int32 triMaterial = (tri < obj_shape.mesh.material_ids.size()) ? obj_shape.mesh.material_ids[tri] : -1;
+				if (triMaterial != matIndex)
+					continue;
 
+				shape.indices.push_back(uint32(obj_shape.mesh.indices[(tri * 3) + 0]));
+				shape.indices.push_back(uint32(obj_shape.mesh.indices[(tri * 3) + 1]));
+				shape.indices.push_back(uint32(obj_shape.mesh.indices[(tri * 3) + 2]));
 			}
 
-			elementCount++;
-
+			range.count = uint32(shape.indices.size()) - range.offset;
+			shape.ranges.push_back(range);
 		}
 
-		if (elementCount > 0)
+		if (optimize && shape.indices.size() > 0)
 		{
-			DrawCallPtr dc = CREATE_CLASS(DrawCall);
-			dc->offset = static_cast<uint32>(offset) * 3;
-			dc->type = DrawTriangles;
-			dc->indexType = TypeUnsignedShort;
-			dc->shaderHandle = RenderInterface::kDefaultColorShader;
-			dc->textures[0] = RenderInterface::kWhiteTexture;
-			dc->color = ColorB::White;
-			dc->depthTest = true;
-			dc->depthFunc = DepthLess;
-			dc->count = static_cast<uint32>(elementCount) * 3;
-			dc->uniformCallback = std::bind(&MeshMaterialInstance::onBindMesh, materialInstance);
-            dc->frontFace = FrontFaceCCW;
-#if defined(CS_METAL)
-            dc->cullFace = CullNone;
-#endif
-            
-			materialInstance->populate(dc);
-			data->drawCalls.push_back(dc);
+			for (auto& range : shape.ranges)
+			{
+				MeshOptimizer::optimizeTriangles(&shape.indices[range.offset], range.count, vertex_data, stride, shape.numVertices);
+			}
+			MeshOptimizer::optimizeVertexFetch(vertex_data, stride, shape.numVertices, shape.indices.data(), shape.indices.size());
 
+			cookLods(shape, stride);
 		}
+	}
 
-		GeometryPtr geom = CREATE_CLASS(Geometry, data, vertex_data, (uchar*)index_data, false);
-		MeshShapePtr shape = CREATE_CLASS(MeshShape, obj_shape.name, geom, aabb, materialInstances);
+	DrawCallPtr createDrawCall(const MeshCacheRange& range, Type indexType, MeshMaterialInstancePtr& materialInstance)
+	{
+		DrawCallPtr dc = CREATE_CLASS(DrawCall);
+		dc->offset = range.offset;
+		dc->type = DrawTriangles;
+		dc->indexType = indexType;
+		dc->shaderHandle = RenderInterface::kDefaultColorShader;
+		dc->textures[0] = RenderInterface::kWhiteTexture;
+		dc->color = ColorB::White;
+		dc->depthTest = true;
+		dc->depthFunc = DepthLess;
+		dc->count = range.count;
+		dc->uniformCallback = std::bind(&MeshMaterialInstance::onBindMesh, materialInstance);
+		dc->frontFace = FrontFaceCCW;
+#if defined(CS_METAL)
+		dc->cullFace = CullNone;
+#endif
 
-		shapes.push_back(shape);
+		materialInstance->populate(dc);
+		return dc;
 	}
 
-	void populateShapeTest(tinyobj::shape_t& obj_shape, Mesh::MeshShapes& shapes, Mesh::MeshMaterials& materials)
+	void populateShape(
+		const MeshCacheShape& cached,
+		Mesh::MeshShapes& shapes,
+		Mesh::MeshMaterials& materials)
 	{
-		/*
+		if (cached.needsWideIndices() && !RenderInterface::getInstance()->supportsWideIndices())
+		{
+			log::error("Mesh shape ", cached.name, " needs 32 bit indices, which this device can't draw");
+			return;
+		}
+
 		GeometryDataPtr data = CREATE_CLASS(GeometryData);
-		MeshAABB aabb;
 
-		const static float kTestBuffer[] =
+		uint32 offset = 0;
+		data->decl.addAttrib(AttribPosition, { AttribPosition, TypeFloat, 3, 0 });
+		offset += sizeof(vec3);
+
+		if (cached.hasTexCoords)
 		{
-			-100.0f, -100.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-			-100.0f, 100.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-			100.0f, 100.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-			100.0f, -100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-		};
+			data->decl.addAttrib(AttribTexCoord0, { AttribTexCoord0, TypeFloat, 2, offset });
+			offset += sizeof(vec2);
+		}
 
-		size_t offset = 0;
-		offset = data->decl.addAttrib(AttributeType::AttribPosition, { AttributeType::AttribPosition, TypeFloat, 3, 0 });
-		offset = data->decl.addAttrib(AttributeType::AttribTexCoord0, { AttributeType::AttribTexCoord0, TypeFloat, 2, offset });
-		offset = data->decl.addAttrib(AttributeType::AttribColor, { AttributeType::AttribColor, TypeFloat, 4, offset });
+		if (cached.hasNormals)
+		{
+			data->decl.addAttrib(AttribNormal, { AttribNormal, TypeFloat, 3, offset });
+			offset += sizeof(vec3);
+		}
 
-		data->vertexSize = 4;
-		data->indexSize = 6;
-		GeometryPtr geom = CREATE_CLASS(Geometry, data, (uchar*)kTestBuffer, (uchar*)kStaticQuadIndices, false);
+		data->vertexSize = cached.numVertices;
+		data->indexSize = cached.indices.size();
+		data->indexType = (cached.needsWideIndices()) ? TypeUnsignedInt : TypeUnsignedShort;
 
-		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->offset = 0;
-		dc->type = DrawTriangles;
-		dc->indexType = TypeUnsignedShort;
-		dc->shaderHandle = RenderInterface::kDefaultTextureColorShader;
-		dc->textures[0] = RenderInterface::kWhiteTexture;
-		dc->color = ColorB::White;
-		dc->count = 6;
-		dc->depthTest = false;
-		dc->depthFunc = DepthLess;
+		// the geometry owns and frees its staging copies
+		uchar* vertex_data = new uchar[cached.vertexData.size()];
+		memcpy(vertex_data, cached.vertexData.data(), cached.vertexData.size());
 
-		data->drawCalls.push_back(dc);
+		uchar* index_data = new uchar[data->indexSize * data->getIndexStride()];
+		if (data->indexType == TypeUnsignedInt)
+		{
+			memcpy(index_data, cached.indices.data(), data->indexSize * sizeof(uint32));
+		}
+		else
+		{
+			uint16* indices16 = reinterpret_cast<uint16*>(index_data);
+			for (size_t i = 0; i < data->indexSize; ++i)
+				indices16[i] = uint16(cached.indices[i]);
+		}
+
+		MeshMaterialInstance::GeometryType geomType = MeshMaterialInstance::GeometryTypeNone;
+		if (cached.hasNormals)
+		{
+			geomType = MeshMaterialInstance::GeometryTypeNormals;
+		}
+
+		std::vector<MeshMaterialInstancePtr> materialInstances;
+		std::map<int32, MeshMaterialInstancePtr> instanceByMaterial;
+
+		MeshShapeLod fullDetail;
+		for (auto& range : cached.ranges)
+		{
+			if (range.count == 0)
+				continue;
+
+			MeshMaterialPtr material = (range.material >= 0 && range.material < int32(materials.size())) ? materials[range.material] : MeshMaterial::kDefaultMeshMaterial;
+			MeshMaterialInstancePtr materialInstance = CREATE_CLASS(MeshMaterialInstance, geomType, material);
+			materialInstances.push_back(materialInstance);
+			instanceByMaterial[range.material] = materialInstance;
+
+			data->drawCalls.push_back(createDrawCall(range, data->indexType, materialInstance));
+			fullDetail.numTriangles += range.count / 3;
+		}
+
+		MeshAABB aabb = cached.aabb;
+		GeometryPtr geom = CREATE_CLASS(Geometry, data, vertex_data, index_data, false);
+		MeshShapePtr shape = CREATE_CLASS(MeshShape, cached.name, geom, aabb, materialInstances);
+		shape->lods.push_back(fullDetail);
+
+		// coarser levels index the same buffers and share the full detail material instances
+		for (auto& cachedLod : cached.lods)
+		{
+			MeshShapeLod lod;
+			lod.error = cachedLod.error;
+			lod.drawCalls = std::make_shared<DrawCallList>();
+
+			for (auto& range : cachedLod.ranges)
+			{
+				auto it = instanceByMaterial.find(range.material);
+				if (range.count == 0 || it == instanceByMaterial.end())
+					continue;
+
+				lod.drawCalls->push_back(createDrawCall(range, data->indexType, it->second));
+				lod.numTriangles += range.count / 3;
+			}
+			shape->lods.push_back(lod);
+		}
 
-		MeshShapePtr shape = CREATE_CLASS(MeshShape, "TestShape", geom, aabb);
 		shapes.push_back(shape);
-		*/
 	}
 
-	void populateMaterial(Mesh::MeshMaterials& materials, tinyobj::material_t& obj_material)
+	void cookMaterial(tinyobj::material_t& obj_material, MeshCacheMaterial& material)
 	{
 		struct local
 		{
-			static void toColorB(float* values, ColorB& color, float32 scale = 1.0f)
+			static ColorB toColorB(float* values, float32 scale = 1.0f)
 			{
-				color = ColorB(uchar(values[0] * 255 * scale), uchar(values[1] * 255 * scale), uchar(values[2] * 255 * scale), 255);
+				return ColorB(uchar(values[0] * 255 * scale), uchar(values[1] * 255 * scale), uchar(values[2] * 255 * scale), 255);
 			}
 		};
 		struct MaterialAssoc
@@ -341,22 +472,39 @@ namespace cs
 			},
 		};
 
-		MeshMaterialPtr material = CREATE_CLASS(MeshMaterial, obj_material.name);
+		material.name = obj_material.name;
+
 		const size_t kAssocSize = sizeof(kAssoc) / sizeof(kAssoc[0]);
 		for (size_t i = 0; i < kAssocSize; ++i)
 		{
 			const MaterialAssoc& assoc = kAssoc[i];
 			if (strlen(assoc.name) > 0)
 			{
-				material->addTexture(assoc.name, assoc.stage);
+				MeshCacheTexture texture;
+				texture.stage = uint16(assoc.stage);
+				texture.fileName = assoc.name;
+				material.textures.push_back(texture);
 			}
 		}
 
-		local::toColorB(obj_material.diffuse, material->diffuse);
-		local::toColorB(obj_material.specular, material->specular);
-		local::toColorB(obj_material.diffuse, material->ambient, 0.5f);
-		
-		material->shininess = obj_material.shininess;
+		material.diffuse = local::toColorB(obj_material.diffuse);
+		material.specular = local::toColorB(obj_material.specular);
+		material.ambient = local::toColorB(obj_material.diffuse, 0.5f);
+		material.shininess = obj_material.shininess;
+	}
+
+	void populateMaterial(Mesh::MeshMaterials& materials, const MeshCacheMaterial& cached)
+	{
+		MeshMaterialPtr material = CREATE_CLASS(MeshMaterial, cached.name);
+		for (auto& texture : cached.textures)
+		{
+			material->addTexture(texture.fileName, TextureStage(texture.stage));
+		}
+
+		material->diffuse = cached.diffuse;
+		material->specular = cached.specular;
+		material->ambient = cached.ambient;
+		material->shininess = cached.shininess;
 
 		material->print();
 		materials.push_back(material);
@@ -365,22 +513,38 @@ namespace cs
 	void populateGeometry(
 		Mesh::MeshShapes& shapes,
 		Mesh::MeshMaterials& materials,
-		std::vector<tinyobj::shape_t>& obj_shapes,
-		std::vector<tinyobj::material_t>& obj_materials)
+		const MeshCacheData& data)
 	{
-
-		for (size_t i = 0; i < obj_materials.size(); i++)
+		for (auto& material : data.materials)
 		{
-			populateMaterial(materials, obj_materials[i]);
+			populateMaterial(materials, material);
 		}
 
-		for (size_t i = 0; i < obj_shapes.size(); i++)
+		for (auto& shape : data.shapes)
 		{
-			tinyobj::shape_t& shape = obj_shapes[i];
 			populateShape(shape, shapes, materials);
 		}
 	}
 
+	size_t getCacheMisses(const MeshCacheData& data, uint32 cacheSize, size_t& triangles)
+	{
+		size_t misses = 0;
+		triangles = 0;
+		for (auto& shape : data.shapes)
+		{
+			// full detail only, the LOD chain follows it in the same buffer
+			size_t shapeIndices = getFullDetailIndices(shape);
+			size_t shapeTriangles = shapeIndices / 3;
+			if (shapeTriangles == 0)
+				continue;
+
+			float32 acmr = MeshOptimizer::getACMR(shape.indices.data(), shapeIndices, cacheSize);
+			misses += size_t(acmr * float32(shapeTriangles) + 0.5f);
+			triangles += shapeTriangles;
+		}
+		return misses;
+	}
+
 	MeshMaterialInstance::MeshMaterialInstance(GeometryType gt, MeshMaterialPtr mat)
 		: geomType(gt)
 		, material(mat)
@@ -492,11 +656,17 @@ namespace cs
 
 	MeshHandle::MeshHandle(MeshPtr& m)
 		: mesh(m)
+		, lodEnabled(true)
+		, lodScreenError(0.002f)
+		, lodHysteresis(0.25f)
 	{
 		this->onMeshChanged();
 	}
 
 	MeshHandle::MeshHandle(const std::string& meshName)
+		: lodEnabled(true)
+		, lodScreenError(0.002f)
+		, lodHysteresis(0.25f)
 	{
 		this->mesh = std::static_pointer_cast<Mesh>(ResourceFactory::getInstance()->loadResource<Mesh>(meshName));
 		this->onMeshChanged();
@@ -521,16 +691,16 @@ namespace cs
 		EngineStats::decrementStat(StatTypeMesh);
 	}
 
-	bool Mesh::load(const std::string& fileName, const std::string& filePath)
+	bool Mesh::cookOBJ(const std::string& filePath, MeshCacheData& data, bool optimize)
 	{
-        char s = FileManager::getInstance()->separator();
-        size_t pos = filePath.find_last_of(s);
-        if (pos == std::string::npos)
-        {
-            log::error("material path malformed!");
-        }
+		char s = FileManager::getInstance()->separator();
+		size_t pos = filePath.find_last_of(s);
+		if (pos == std::string::npos)
+		{
+			log::error("material path malformed!");
+		}
 		std::string matPath = filePath.substr(0, pos + 1);
-        std::vector<tinyobj::shape_t> obj_shapes;
+		std::vector<tinyobj::shape_t> obj_shapes;
 		std::vector<tinyobj::material_t> obj_materials;
 
 		std::string err;
@@ -540,34 +710,167 @@ namespace cs
 			log::error("TinyObj: ", err);
 		}
 
-		if (ret)
+		if (!ret)
+			return false;
+
+		data.materials.resize(obj_materials.size());
+		for (size_t i = 0; i < obj_materials.size(); i++)
+		{
+			cookMaterial(obj_materials[i], data.materials[i]);
+		}
+
+		data.shapes.resize(obj_shapes.size());
+		for (size_t i = 0; i < obj_shapes.size(); i++)
+		{
+			cookShape(obj_shapes[i], data.shapes[i], optimize);
+		}
+		return true;
+	}
+
+	bool Mesh::cookCache(const std::string& fileName)
+	{
+		std::string filePath;
+		if (!FileManager::getInstance()->getPathToFile(fileName, filePath))
+		{
+			log::error("Cannot find mesh ", fileName);
+			return false;
+		}
+
+		MeshCacheData data;
+		if (!Mesh::cookOBJ(filePath, data))
+		{
+			log::error("Error - could not cook Mesh ", fileName);
+			return false;
+		}
+
+		// offline cooks go next to the source so they ship with it
+		MeshCache::getSourceInfo(filePath, data.sourceSize, data.sourceTime);
+		std::string cachePath = MeshCache::getSourceCachePath(filePath);
+		if (!MeshCache::write(cachePath, data))
+		{
+			log::error("Could not write mesh cache ", cachePath);
+			return false;
+		}
+
+		log::info("Cooked ", fileName, " to ", cachePath);
+		return true;
+	}
+
+	void Mesh::benchmark(const std::string& fileName)
+	{
+		std::string filePath;
+		if (!FileManager::getInstance()->getPathToFile(fileName, filePath))
+		{
+			log::error("Cannot find mesh ", fileName);
+			return;
+		}
+
+		typedef std::chrono::high_resolution_clock BenchClock;
+		auto elapsedMs = [](const BenchClock::time_point& start)
+		{
+			return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+		};
+
+		const int32 kIterations = 5;
+
+		MeshCacheData raw;
+		BenchClock::time_point start = BenchClock::now();
+		for (int32 i = 0; i < kIterations; ++i)
+		{
+			raw = MeshCacheData();
+			Mesh::cookOBJ(filePath, raw, false);
+		}
+		double objTime = elapsedMs(start) / kIterations;
+
+		MeshCacheData cooked;
+		start = BenchClock::now();
+		Mesh::cookOBJ(filePath, cooked, true);
+		double cookTime = elapsedMs(start);
+
+		std::string cachePath = MeshCache::getSourceCachePath(filePath) + ".bench";
+		if (!MeshCache::write(cachePath, cooked))
+		{
+			log::error("Could not write mesh cache ", cachePath);
+			return;
+		}
+
+		MeshCacheData loaded;
+		start = BenchClock::now();
+		for (int32 i = 0; i < kIterations; ++i)
+		{
+			loaded = MeshCacheData();
+			MeshCache::read(cachePath, loaded);
+		}
+		double cacheTime = elapsedMs(start) / kIterations;
+		remove(cachePath.c_str());
+
+		log::info("Mesh benchmark: ", fileName);
+		log::info("  OBJ parse: ", objTime, "ms, cook + optimise: ", cookTime, "ms, cache read: ", cacheTime, "ms");
+
+		const uint32 kCacheSizes[] = { 16, 32 };
+		for (auto& cacheSize : kCacheSizes)
 		{
-			Mesh::MeshShapes shapes_vec;
-			populateGeometry(shapes_vec, this->materials, obj_shapes, obj_materials);
+			size_t triangles = 0;
+			size_t rawMisses = getCacheMisses(raw, cacheSize, triangles);
+			size_t cookedMisses = getCacheMisses(cooked, cacheSize, triangles);
+			float32 invTriangles = (triangles > 0) ? 1.0f / float32(triangles) : 0.0f;
 
-			// setup AABB bounds
-			for (auto it : shapes_vec)
+			log::info("  ", cacheSize, " entry cache: vertex shader invocations ", rawMisses, " -> ", cookedMisses,
+				" (ACMR ", float32(rawMisses) * invTriangles, " -> ", float32(cookedMisses) * invTriangles, ") over ", triangles, " triangles");
+		}
+
+		for (auto& shape : cooked.shapes)
+		{
+			std::stringstream str;
+			str << getFullDetailIndices(shape) / 3;
+			for (auto& lod : shape.lods)
 			{
-				MeshShapePtr& shape = it;
-				this->aabb.evailuate(shape->aabb.mmax);
-				this->aabb.evailuate(shape->aabb.mmin);
+				size_t lodIndices = 0;
+				for (auto& range : lod.ranges)
+					lodIndices += range.count;
+				str << " -> " << lodIndices / 3 << " (" << lod.error * 100.0f << "%)";
+			}
+			log::info("  LODs for ", shape.name, ": ", str.str());
+		}
+	}
 
-				std::string shapeName = to_lowercase(shape->name);
-				int32 ctr = 1;
-				while (this->shapes.find(shapeName) != this->shapes.end())
-				{
-					log::info("Dupilicate shape ", shapeName, " found in ", fileName);
-					std::stringstream str;
-					str << shape->name << ctr++;
-					shapeName = str.str();
-				}
-				this->shapes[shapeName] = shape;
+	bool Mesh::load(const std::string& fileName, const std::string& filePath)
+	{
+		MeshCacheData data;
+		if (!kMeshUseCache || !MeshCache::load(fileName, filePath, data))
+		{
+			if (!Mesh::cookOBJ(filePath, data))
+			{
+				log::error("Error - could not load Mesh ", fileName);
+				return false;
 			}
-			return true;
+
+			if (kMeshUseCache)
+				MeshCache::store(fileName, filePath, data);
 		}
 
-		log::error("Error - could not load Mesh ", fileName);
-		return false;
+		Mesh::MeshShapes shapes_vec;
+		populateGeometry(shapes_vec, this->materials, data);
+
+		// setup AABB bounds
+		for (auto it : shapes_vec)
+		{
+			MeshShapePtr& shape = it;
+			this->aabb.evailuate(shape->aabb.mmax);
+			this->aabb.evailuate(shape->aabb.mmin);
+
+			std::string shapeName = to_lowercase(shape->name);
+			int32 ctr = 1;
+			while (this->shapes.find(shapeName) != this->shapes.end())
+			{
+				log::info("Dupilicate shape ", shapeName, " found in ", fileName);
+				std::stringstream str;
+				str << shape->name << ctr++;
+				shapeName = str.str();
+			}
+			this->shapes[shapeName] = shape;
+		}
+		return true;
 	}
 
 	void Mesh::draw()
@@ -648,16 +951,72 @@ namespace cs
 		}
 	}
 
+	float32 getScreenCoverage(const MeshAABB& aabb, const vec3& offset, const mat4& mvp)
+	{
+		vec2 minb(FLT_MAX, FLT_MAX);
+		vec2 maxb(-FLT_MAX, -FLT_MAX);
+		for (int32 i = 0; i < 8; ++i)
+		{
+			vec3 corner(
+				(i & 1) ? aabb.mmax.x : aabb.mmin.x,
+				(i & 2) ? aabb.mmax.y : aabb.mmin.y,
+				(i & 4) ? aabb.mmax.z : aabb.mmin.z);
+
+			vec4 clip = mvp * vec4(corner + offset, 1.0f);
+
+			// straddling the camera plane, treat it as filling the screen
+			if (clip.w <= FLT_EPSILON)
+				return FLT_MAX;
+
+			vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+			minb = glm::min(minb, ndc);
+			maxb = glm::max(maxb, ndc);
+		}
+
+		// normalised device coordinates span 2 units across the viewport
+		vec2 extent = (maxb - minb) * 0.5f;
+		return std::max<float32>(extent.x, extent.y);
+	}
+
+	void MeshHandle::flushStats()
+	{
+		EngineStats::setStat(StatTypeMeshTriangles, gMeshTriangles);
+		EngineStats::setStat(StatTypeMeshTrianglesFull, gMeshTrianglesFull);
+
+		gMeshTriangles = 0;
+		gMeshTrianglesFull = 0;
+	}
+
 	void MeshHandle::queueGeometry(RenderTraversal traversal, DisplayListNode& display_node)
 	{
 		for (auto& it : this->instances)
 		{
-			GeometryPtr& geom = it.second->shape->geom;
-			
+			MeshShapeInstancePtr& instance = it.second;
+			MeshShapePtr& shape = instance->shape;
+
+			if (this->lodEnabled && shape->lods.size() > 1)
+			{
+				float32 coverage = getScreenCoverage(shape->aabb, instance->offset, display_node.mvp);
+				instance->selectLod(coverage, this->lodScreenError, this->lodHysteresis);
+			}
+			else
+			{
+				instance->lod = 0;
+			}
+
 			display_node.geomList.push_back(DisplayListGeom());
 			DisplayListGeom& node = display_node.geomList.back();
-			node.geom = geom;
-			node.overrides = it.second->overrides;
+			node.geom = shape->geom;
+			node.overrides = instance->overrides;
+
+			if (shape->lods.size() > 0)
+			{
+				const MeshShapeLod& lod = shape->lods[instance->lod];
+				node.drawCalls = lod.drawCalls;
+
+				gMeshTriangles += int32(lod.numTriangles);
+				gMeshTrianglesFull += int32(shape->lods[0].numTriangles);
+			}
 		}
 	}
 
@@ -807,7 +1166,7 @@ namespace cs
 		this->positions.clear();
 		this->index.clear();
 
-		uint16 offset = 0;
+		uint32 offset = 0;
 		for (auto it : geomToUse)
 		{
 			MeshShapePtr& shape = it;
@@ -831,13 +1190,20 @@ namespace cs
 			}
 
 			this->positions.insert(this->positions.end(), tmpPositions.begin(), tmpPositions.end());
-			uint16 numIndices = static_cast<uint16>(geom->getNumIndices());
-			uint16* ibData = (uint16*)geom->getIndexBufferStagingData();
-			for (uint16 i = 0; i < numIndices / 3; i++)
+			// cached meshes over 64k vertices carry 32 bit indices, LODs follow the full detail ones
+			size_t numIndices = (shape->lods.size() > 0) ? size_t(shape->lods[0].numTriangles) * 3 : geom->getNumIndices();
+			uchar* ibData = geom->getIndexBufferStagingData();
+			bool wideIndices = geom->getGeometryData()->indexType == TypeUnsignedInt;
+			auto getIndex = [ibData, wideIndices](size_t i) -> uint32
+			{
+				return (wideIndices) ? ((uint32*)ibData)[i] : uint32(((uint16*)ibData)[i]);
+			};
+
+			for (size_t i = 0; i < numIndices / 3; i++)
 			{
-				uint16 i0 = offset + ibData[(i * 3) + 0];
-				uint16 i1 = offset + ibData[(i * 3) + 1];
-				uint16 i2 = offset + ibData[(i * 3) + 2];
+				uint32 i0 = offset + getIndex((i * 3) + 0);
+				uint32 i1 = offset + getIndex((i * 3) + 1);
+				uint32 i2 = offset + getIndex((i * 3) + 2);
 
 				// first segment
 				this->index.push_back(i0);
@@ -852,7 +1218,7 @@ namespace cs
 				this->index.push_back(i0);
 			}
 
-			offset += uint16(tmpPositions.size());
+			offset += uint32(tmpPositions.size());
 		}
 	}
     
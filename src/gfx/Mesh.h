@@ -14,6 +14,8 @@
 
 namespace cs
 {
+	struct MeshCacheData;
+
 	enum MeshMaterialType
 	{
 		MeshMaterialTypeNone = -1,
@@ -108,6 +110,18 @@ namespace cs
 		MeshMaterialPtr material;
 	};
 
+	struct MeshShapeLod
+	{
+		MeshShapeLod()
+			: error(0.0f)
+			, numTriangles(0)
+		{ }
+
+		float32 error;			// as a fraction of the shape extent
+		uint32 numTriangles;
+		DrawCallListPtr drawCalls;	// null at full detail, which draws the geometry's own
+	};
+
 	CLASS_DEFINITION(MeshShape)
 	public:
 		MeshShape(const std::string& n) 
@@ -120,6 +134,7 @@ namespace cs
 			, geom(rhs.geom)
 			, aabb(rhs.aabb)
 			, materialInstances(rhs.materialInstances)
+			, lods(rhs.lods)
 		{ }
 
 		MeshShape(const std::string& n, GeometryPtr& g, MeshAABB& meshAABB, std::vector<MeshMaterialInstancePtr>& matInst)
@@ -135,6 +150,9 @@ namespace cs
 		MeshAABB aabb;
 		GeometryPtr geom;
 		std::vector<MeshMaterialInstancePtr> materialInstances;
+
+		// lods[0] is full detail, each level after it is coarser
+		std::vector<MeshShapeLod> lods;
 	};
 
 	CLASS_DEFINITION_DERIVED_REFLECT(Mesh, Resource)
@@ -156,6 +174,16 @@ namespace cs
 		MeshShapePtr getShapeByName(const std::string& shapeName);
 		size_t getAllShapes(MeshShapes& shape_vec);
 
+		// Parses an OBJ into its cooked form, optionally reordered for the vertex cache and
+		// given a chain of simplified LODs
+		static bool cookOBJ(const std::string& filePath, MeshCacheData& data, bool optimize = true);
+
+		// Offline cook, writes the cache next to the source so it ships with it
+		static bool cookCache(const std::string& fileName);
+
+		// Logs parse vs cache load times and vertex cache efficiency before and after optimising
+		static void benchmark(const std::string& fileName);
+
 	private:
 
 		void init();
@@ -173,16 +201,21 @@ namespace cs
 
 	CLASS_DEFINITION_REFLECT(MeshShapeInstance)
 	public:
-		MeshShapeInstance() { }
+		MeshShapeInstance() : lod(0) { }
 		MeshShapeInstance(MeshShapePtr& s, vec3 off = kZero3)
 			: shape(CREATE_CLASS(MeshShape, *(s.get())))
 			, offset(off)
+			, lod(0)
 		{ }
 
 		MeshMaterialType getMeshMaterialType() const;
 
+		// coverage is the projected size as a fraction of the viewport
+		void selectLod(float32 coverage, float32 screenError, float32 hysteresis);
+
 		MeshShapePtr shape;
 		vec3 offset;
+		int32 lod;
 
 		void overrideDrawCalls();
 
@@ -221,12 +254,23 @@ namespace cs
 		int32 getNumShapeInstances() const { return int32(this->instances.size()); }
 		MeshShapeInstancePtr getShapeInstanceAtIndex(int32 index);
 
+		// publishes the triangles queued since the last call to EngineStats
+		static void flushStats();
+
 	private:
 
-		MeshHandle() { }
+		MeshHandle()
+			: lodEnabled(true)
+			, lodScreenError(0.002f)
+			, lodHysteresis(0.25f)
+		{ }
 
 		MeshPtr mesh;
 		MeshShapeInstanceMap instances;
+
+		bool lodEnabled;
+		float32 lodScreenError;
+		float32 lodHysteresis;
 	};
 
 	CLASS_DEFINITION_DERIVED_REFLECT(MeshHandleVolume, PolygonListVolume)
@@ -0,0 +1,464 @@
+#include "PCH.h"
+
+#include "gfx/MeshCache.h"
+#include "os/FileManager.h"
+#include "os/LogManager.h"
+
+#include <fstream>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace cs
+{
+	const uint32 MeshCache::kMagic = 0x434D5343;	// "CSMC"
+	const uint32 MeshCache::kVersion = 2;
+	const char* MeshCache::kExtension = ".csmesh";
+
+	namespace
+	{
+		struct MeshCacheWriter
+		{
+			std::vector<uchar> buffer;
+
+			void writeBytes(const void* data, size_t size)
+			{
+				const uchar* bytes = reinterpret_cast<const uchar*>(data);
+				this->buffer.insert(this->buffer.end(), bytes, bytes + size);
+			}
+
+			template <typename T>
+			void write(const T& value)
+			{
+				this->writeBytes(&value, sizeof(T));
+			}
+
+			void writeString(const std::string& str)
+			{
+				this->write(uint32(str.length()));
+				this->writeBytes(str.c_str(), str.length());
+			}
+
+			void writeColor(const ColorB& color)
+			{
+				uchar rgba[4] = { color.r, color.g, color.b, color.a };
+				this->writeBytes(rgba, sizeof(rgba));
+			}
+		};
+
+		struct MeshCacheReader
+		{
+			MeshCacheReader(const std::vector<uchar>& buf)
+				: buffer(buf)
+				, offset(0)
+				, valid(true)
+			{ }
+
+			const std::vector<uchar>& buffer;
+			size_t offset;
+			bool valid;
+
+			// guards the resizes against counts from a damaged file
+			bool canRead(size_t count, size_t elementSize)
+			{
+				this->valid = this->valid && count * elementSize <= this->buffer.size() - this->offset;
+				return this->valid;
+			}
+
+			bool readBytes(void* data, size_t size)
+			{
+				if (!this->valid || this->offset + size > this->buffer.size())
+				{
+					this->valid = false;
+					return false;
+				}
+
+				if (size > 0)
+					memcpy(data, &this->buffer[this->offset], size);
+				this->offset += size;
+				return true;
+			}
+
+			template <typename T>
+			T read()
+			{
+				T value = T();
+				this->readBytes(&value, sizeof(T));
+				return value;
+			}
+
+			std::string readString()
+			{
+				uint32 len = this->read<uint32>();
+				if (!this->valid || this->offset + len > this->buffer.size())
+				{
+					this->valid = false;
+					return std::string();
+				}
+
+				std::string str(reinterpret_cast<const char*>(&this->buffer[this->offset]), len);
+				this->offset += len;
+				return str;
+			}
+
+			ColorB readColor()
+			{
+				uchar rgba[4] = { 0, 0, 0, 0 };
+				this->readBytes(rgba, sizeof(rgba));
+				return ColorB(rgba[0], rgba[1], rgba[2], rgba[3]);
+			}
+		};
+
+		std::string replaceExtension(const std::string& path, const std::string& ext)
+		{
+			// only look past the last separator, directories may have dots in them
+			size_t start = 0;
+			for (size_t i = 0; i < path.length(); ++i)
+			{
+				if (FileManager::isSeparator(path[i]))
+					start = i + 1;
+			}
+
+			size_t dot = path.find_last_of('.');
+			if (dot == std::string::npos || dot < start)
+				return path + ext;
+			return path.substr(0, dot) + ext;
+		}
+
+		size_t getVertexStride(const MeshCacheShape& shape)
+		{
+			size_t stride = sizeof(vec3);
+			if (shape.hasTexCoords)
+				stride += sizeof(vec2);
+			if (shape.hasNormals)
+				stride += sizeof(vec3);
+			return stride;
+		}
+	}
+
+	bool MeshCache::getSourceInfo(const std::string& filePath, uint64& size, int64& time)
+	{
+#if defined(CS_WINDOWS)
+		struct _stat info;
+		if (_stat(filePath.c_str(), &info) != 0)
+			return false;
+#else
+		struct stat info;
+		if (stat(filePath.c_str(), &info) != 0)
+			return false;
+#endif
+		size = uint64(info.st_size);
+		time = int64(info.st_mtime);
+		return true;
+	}
+
+	std::string MeshCache::getSourceCachePath(const std::string& filePath)
+	{
+		return replaceExtension(filePath, MeshCache::kExtension);
+	}
+
+	std::string MeshCache::getSaveCachePath(const std::string& fileName)
+	{
+		const std::string& savePath = FileManager::getInstance()->getSavePath();
+		if (savePath.length() == 0)
+			return std::string();
+
+		std::string path = savePath;
+		if (!FileManager::isSeparator(path[path.length() - 1]))
+			path += FileManager::getInstance()->separator();
+
+		return path + replaceExtension(fileName, MeshCache::kExtension);
+	}
+
+	bool MeshCache::write(const std::string& path, const MeshCacheData& data)
+	{
+		MeshCacheWriter writer;
+		writer.write(MeshCache::kMagic);
+		writer.write(MeshCache::kVersion);
+		writer.write(data.sourceSize);
+		writer.write(data.sourceTime);
+
+		writer.write(uint32(data.materials.size()));
+		for (auto& material : data.materials)
+		{
+			writer.writeString(material.name);
+			writer.writeColor(material.diffuse);
+			writer.writeColor(material.specular);
+			writer.writeColor(material.ambient);
+			writer.write(material.shininess);
+
+			writer.write(uint32(material.textures.size()));
+			for (auto& texture : material.textures)
+			{
+				writer.write(texture.stage);
+				writer.writeString(texture.fileName);
+			}
+		}
+
+		writer.write(uint32(data.shapes.size()));
+		for (auto& shape : data.shapes)
+		{
+			writer.writeString(shape.name);
+			writer.write(uchar(shape.hasTexCoords ? 1 : 0));
+			writer.write(uchar(shape.hasNormals ? 1 : 0));
+			writer.write(shape.aabb.mmin);
+			writer.write(shape.aabb.mmax);
+
+			writer.write(uint32(shape.ranges.size()));
+			for (auto& range : shape.ranges)
+			{
+				writer.write(range.offset);
+				writer.write(range.count);
+				writer.write(range.material);
+			}
+
+			writer.write(uint32(shape.lods.size()));
+			for (auto& lod : shape.lods)
+			{
+				writer.write(lod.error);
+				writer.write(uint32(lod.ranges.size()));
+				for (auto& range : lod.ranges)
+				{
+					writer.write(range.offset);
+					writer.write(range.count);
+					writer.write(range.material);
+				}
+			}
+
+			writer.write(shape.numVertices);
+			writer.write(uint32(shape.vertexData.size()));
+			writer.writeBytes(shape.vertexData.data(), shape.vertexData.size());
+
+			bool wide = shape.needsWideIndices();
+			writer.write(uint32(shape.indices.size()));
+			writer.write(uchar(wide ? 4 : 2));
+			if (wide)
+			{
+				writer.writeBytes(shape.indices.data(), shape.indices.size() * sizeof(uint32));
+			}
+			else
+			{
+				for (auto& index : shape.indices)
+					writer.write(uint16(index));
+			}
+		}
+
+		std::ofstream out(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+			return false;
+
+		out.write(reinterpret_cast<const char*>(writer.buffer.data()), std::streamsize(writer.buffer.size()));
+		bool ok = out.good();
+		out.close();
+		return ok;
+	}
+
+	bool MeshCache::read(const std::string& path, MeshCacheData& data)
+	{
+		std::ifstream in(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		if (!in.is_open())
+			return false;
+
+		// the whole file in one read, everything after is parsed out of memory
+		std::streamsize fileSize = in.tellg();
+		if (fileSize <= 0)
+			return false;
+
+		std::vector<uchar> buffer(static_cast<size_t>(fileSize));
+		in.seekg(0, std::ios::beg);
+		if (!in.read(reinterpret_cast<char*>(buffer.data()), fileSize))
+			return false;
+		in.close();
+
+		MeshCacheReader reader(buffer);
+		if (reader.read<uint32>() != MeshCache::kMagic || reader.read<uint32>() != MeshCache::kVersion)
+			return false;
+
+		data.sourceSize = reader.read<uint64>();
+		data.sourceTime = reader.read<int64>();
+
+		uint32 numMaterials = reader.read<uint32>();
+		if (!reader.canRead(numMaterials, sizeof(uint32)))
+			return false;
+
+		data.materials.resize(numMaterials);
+		for (auto& material : data.materials)
+		{
+			material.name = reader.readString();
+			material.diffuse = reader.readColor();
+			material.specular = reader.readColor();
+			material.ambient = reader.readColor();
+			material.shininess = reader.read<float32>();
+
+			uint32 numTextures = reader.read<uint32>();
+			if (!reader.canRead(numTextures, sizeof(uint16)))
+				return false;
+
+			material.textures.resize(numTextures);
+			for (auto& texture : material.textures)
+			{
+				texture.stage = reader.read<uint16>();
+				texture.fileName = reader.readString();
+			}
+		}
+
+		uint32 numShapes = reader.read<uint32>();
+		if (!reader.canRead(numShapes, sizeof(uint32)))
+			return false;
+
+		data.shapes.resize(numShapes);
+		for (auto& shape : data.shapes)
+		{
+			shape.name = reader.readString();
+			shape.hasTexCoords = reader.read<uchar>() != 0;
+			shape.hasNormals = reader.read<uchar>() != 0;
+			shape.aabb.mmin = reader.read<vec3>();
+			shape.aabb.mmax = reader.read<vec3>();
+
+			uint32 numRanges = reader.read<uint32>();
+			if (!reader.canRead(numRanges, sizeof(uint32) * 3))
+				return false;
+
+			shape.ranges.resize(numRanges);
+			for (auto& range : shape.ranges)
+			{
+				range.offset = reader.read<uint32>();
+				range.count = reader.read<uint32>();
+				range.material = reader.read<int32>();
+			}
+
+			uint32 numLods = reader.read<uint32>();
+			if (!reader.canRead(numLods, sizeof(float32) + sizeof(uint32)))
+				return false;
+
+			shape.lods.resize(numLods);
+			for (auto& lod : shape.lods)
+			{
+				lod.error = reader.read<float32>();
+
+				uint32 numLodRanges = reader.read<uint32>();
+				if (!reader.canRead(numLodRanges, sizeof(uint32) * 3))
+					return false;
+
+				lod.ranges.resize(numLodRanges);
+				for (auto& range : lod.ranges)
+				{
+					range.offset = reader.read<uint32>();
+					range.count = reader.read<uint32>();
+					range.material = reader.read<int32>();
+				}
+			}
+
+			shape.numVertices = reader.read<uint32>();
+			uint32 vertexBytes = reader.read<uint32>();
+			if (!reader.canRead(vertexBytes, 1) || vertexBytes != shape.numVertices * getVertexStride(shape))
+				return false;
+
+			shape.vertexData.resize(vertexBytes);
+			reader.readBytes(shape.vertexData.data(), vertexBytes);
+
+			uint32 numIndices = reader.read<uint32>();
+			uchar indexStride = reader.read<uchar>();
+			if ((indexStride != 2 && indexStride != 4) || !reader.canRead(numIndices, indexStride))
+				return false;
+
+			shape.indices.resize(numIndices);
+			if (indexStride == 4)
+			{
+				reader.readBytes(shape.indices.data(), numIndices * sizeof(uint32));
+			}
+			else
+			{
+				for (auto& index : shape.indices)
+					index = reader.read<uint16>();
+			}
+
+			if (!reader.valid)
+				return false;
+
+			// and every index has to name a vertex the shape has
+			for (auto& index : shape.indices)
+			{
+				if (index >= shape.numVertices)
+					return false;
+			}
+
+			// every range has to land inside the index data it draws from
+			auto inBounds = [numIndices](const MeshCacheRange& range)
+			{
+				return range.offset <= numIndices && range.count <= numIndices - range.offset;
+			};
+
+			for (auto& range : shape.ranges)
+			{
+				if (!inBounds(range))
+					return false;
+			}
+
+			for (auto& lod : shape.lods)
+			{
+				for (auto& range : lod.ranges)
+				{
+					if (!inBounds(range))
+						return false;
+				}
+			}
+		}
+
+		return reader.valid;
+	}
+
+	bool MeshCache::load(const std::string& fileName, const std::string& filePath, MeshCacheData& data)
+	{
+		uint64 sourceSize = 0;
+		int64 sourceTime = 0;
+		bool hasSource = MeshCache::getSourceInfo(filePath, sourceSize, sourceTime);
+
+		const std::string paths[] =
+		{
+			MeshCache::getSourceCachePath(filePath),
+			MeshCache::getSaveCachePath(fileName)
+		};
+
+		for (auto& path : paths)
+		{
+			if (path.length() == 0)
+				continue;
+
+			data = MeshCacheData();
+			if (!MeshCache::read(path, data))
+				continue;
+
+			// a cache shipped without its source is always current
+			if (hasSource && (data.sourceSize != sourceSize || data.sourceTime != sourceTime))
+			{
+				log::info("Mesh cache ", path, " is out of date");
+				continue;
+			}
+
+			return true;
+		}
+
+		data = MeshCacheData();
+		return false;
+	}
+
+	bool MeshCache::store(const std::string& fileName, const std::string& filePath, MeshCacheData& data)
+	{
+		MeshCache::getSourceInfo(filePath, data.sourceSize, data.sourceTime);
+
+		std::string path = MeshCache::getSaveCachePath(fileName);
+		if (path.length() == 0)
+			path = MeshCache::getSourceCachePath(filePath);
+
+		if (!MeshCache::write(path, data))
+		{
+			log::warning("Could not write mesh cache ", path);
+			return false;
+		}
+
+		log::info("Wrote mesh cache ", path);
+		return true;
+	}
+}
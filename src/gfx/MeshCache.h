@@ -0,0 +1,115 @@
+#pragma once
+
+#include "gfx/Mesh.h"
+
+#include <string>
+#include <vector>
+
+namespace cs
+{
+	struct MeshCacheTexture
+	{
+		uint16 stage;
+		std::string fileName;
+	};
+
+	struct MeshCacheMaterial
+	{
+		MeshCacheMaterial()
+			: diffuse(ColorB::White)
+			, specular(ColorB::White)
+			, ambient(ColorB::Black)
+			, shininess(8.0f)
+		{ }
+
+		std::string name;
+		ColorB diffuse;
+		ColorB specular;
+		ColorB ambient;
+		float32 shininess;
+		std::vector<MeshCacheTexture> textures;
+	};
+
+	// Indices [offset, offset + count) drawn with one material
+	struct MeshCacheRange
+	{
+		uint32 offset;
+		uint32 count;
+		int32 material;
+	};
+
+	// A reduced detail copy of a shape's index data, drawn against the same vertices
+	struct MeshCacheLod
+	{
+		MeshCacheLod()
+			: error(0.0f)
+		{ }
+
+		float32 error;		// as a fraction of the shape extent
+		std::vector<MeshCacheRange> ranges;
+	};
+
+	struct MeshCacheShape
+	{
+		MeshCacheShape()
+			: hasTexCoords(false)
+			, hasNormals(false)
+			, numVertices(0)
+		{ }
+
+		bool needsWideIndices() const { return this->numVertices > 0xFFFF; }
+
+		std::string name;
+		bool hasTexCoords;
+		bool hasNormals;
+
+		uint32 numVertices;
+		std::vector<uchar> vertexData;	// interleaved position, texcoord, normal
+		std::vector<uint32> indices;	// stored as 16 bit on disk when they fit
+		std::vector<MeshCacheRange> ranges;
+		std::vector<MeshCacheLod> lods;	// coarser levels, their ranges follow the full detail indices
+		MeshAABB aabb;
+	};
+
+	struct MeshCacheData
+	{
+		MeshCacheData()
+			: sourceSize(0)
+			, sourceTime(0)
+		{ }
+
+		uint64 sourceSize;
+		int64 sourceTime;
+
+		std::vector<MeshCacheMaterial> materials;
+		std::vector<MeshCacheShape> shapes;
+	};
+
+	// Cooked binary form of a Mesh: everything the OBJ loader produces after parsing and
+	// optimisation, laid out so a load is a single read and a few copies.  Caches are looked
+	// for next to the source (shipped, cooked offline) and then in the save path (cooked on
+	// first load), and are rejected when the source size or modification time changed.
+	class MeshCache
+	{
+	public:
+
+		static const uint32 kMagic;
+		static const uint32 kVersion;
+		static const char* kExtension;
+
+		static bool read(const std::string& path, MeshCacheData& data);
+		static bool write(const std::string& path, const MeshCacheData& data);
+
+		// Finds a cache for filePath that is still current with the source
+		static bool load(const std::string& fileName, const std::string& filePath, MeshCacheData& data);
+
+		// Writes to the save path if there is one, otherwise next to the source
+		static bool store(const std::string& fileName, const std::string& filePath, MeshCacheData& data);
+
+		static std::string getSourceCachePath(const std::string& filePath);
+		static std::string getSaveCachePath(const std::string& fileName);
+
+		// size and modification time of the source, false if it can't be found
+		static bool getSourceInfo(const std::string& filePath, uint64& size, int64& time);
+	};
+}
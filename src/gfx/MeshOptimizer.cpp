@@ -0,0 +1,275 @@
+#include "PCH.h"
+
+#include "gfx/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cs
+{
+	const uint32 kMeshOptimizerUnused = 0xFFFFFFFF;
+
+	static inline vec3 readPosition(const uchar* positions, size_t stride, uint32 index)
+	{
+		vec3 pos;
+		memcpy(&pos, positions + size_t(index) * stride, sizeof(vec3));
+		return pos;
+	}
+
+	void MeshOptimizer::tipsify(const uint32* indices, size_t numTriangles, size_t numVertices, uint32 cacheSize,
+		std::vector<uint32>& outTriangles, std::vector<size_t>& outClusters)
+	{
+		// triangles touching each vertex, packed by vertex
+		std::vector<uint32> liveCount(numVertices, 0);
+		for (size_t i = 0; i < numTriangles * 3; ++i)
+			liveCount[indices[i]]++;
+
+		std::vector<uint32> offsets(numVertices + 1, 0);
+		for (size_t v = 0; v < numVertices; ++v)
+			offsets[v + 1] = offsets[v] + liveCount[v];
+
+		std::vector<uint32> adjacency(numTriangles * 3);
+		std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t t = 0; t < numTriangles; ++t)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				uint32 v = indices[t * 3 + k];
+				adjacency[fill[v]++] = uint32(t);
+			}
+		}
+
+		std::vector<uint32> cacheTime(numVertices, 0);
+		std::vector<bool> emitted(numTriangles, false);
+		std::vector<uint32> deadEnd;
+		std::vector<uint32> candidates;
+
+		outTriangles.clear();
+		outTriangles.reserve(numTriangles);
+		outClusters.clear();
+		outClusters.push_back(0);
+
+		uint32 time = cacheSize + 1;
+		size_t cursor = 0;
+		int64 fanning = (numTriangles > 0) ? int64(indices[0]) : -1;
+
+		while (fanning >= 0)
+		{
+			candidates.clear();
+
+			uint32 f = uint32(fanning);
+			for (uint32 a = offsets[f]; a < offsets[f + 1]; ++a)
+			{
+				uint32 t = adjacency[a];
+				if (emitted[t])
+					continue;
+
+				for (size_t k = 0; k < 3; ++k)
+				{
+					uint32 v = indices[t * 3 + k];
+					deadEnd.push_back(v);
+					candidates.push_back(v);
+					liveCount[v]--;
+
+					if (time - cacheTime[v] > cacheSize)
+					{
+						cacheTime[v] = time;
+						++time;
+					}
+				}
+
+				emitted[t] = true;
+				outTriangles.push_back(t);
+			}
+
+			// prefer the candidate that will still be in the cache once its remaining triangles are emitted
+			fanning = -1;
+			int64 bestPriority = -1;
+			for (auto& v : candidates)
+			{
+				if (liveCount[v] == 0)
+					continue;
+
+				int64 priority = 0;
+				if (int64(time - cacheTime[v]) + 2 * int64(liveCount[v]) <= int64(cacheSize))
+					priority = int64(time - cacheTime[v]);
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					fanning = v;
+				}
+			}
+
+			if (fanning < 0)
+			{
+				// dead end, the cache is as good as flushed so this is where a cluster ends
+				while (deadEnd.size() > 0 && fanning < 0)
+				{
+					uint32 v = deadEnd.back();
+					deadEnd.pop_back();
+					if (liveCount[v] > 0)
+						fanning = v;
+				}
+
+				while (cursor < numVertices && fanning < 0)
+				{
+					if (liveCount[cursor] > 0)
+						fanning = int64(cursor);
+					++cursor;
+				}
+
+				if (fanning >= 0 && outClusters.back() != outTriangles.size())
+					outClusters.push_back(outTriangles.size());
+			}
+		}
+	}
+
+	void MeshOptimizer::optimizeTriangles(
+		uint32* indices, size_t numIndices,
+		const uchar* positions, size_t positionStride, size_t numVertices,
+		uint32 cacheSize)
+	{
+		size_t numTriangles = numIndices / 3;
+		if (numTriangles < 2 || numVertices == 0)
+			return;
+
+		for (size_t i = 0; i < numTriangles * 3; ++i)
+		{
+			if (indices[i] >= numVertices)
+				return;
+		}
+
+		std::vector<uint32> order;
+		std::vector<size_t> clusters;
+		MeshOptimizer::tipsify(indices, numTriangles, numVertices, cacheSize, order, clusters);
+		clusters.push_back(order.size());
+
+		// view independent overdraw: clusters facing away from the middle of the mesh are the
+		// ones most likely to be in front, draw those first
+		size_t numClusters = clusters.size() - 1;
+		std::vector<vec3> clusterCenter(numClusters, kZero3);
+		std::vector<vec3> clusterNormal(numClusters, kZero3);
+		std::vector<float32> clusterArea(numClusters, 0.0f);
+
+		vec3 meshCenter = kZero3;
+		float32 meshArea = 0.0f;
+
+		for (size_t c = 0; c < numClusters; ++c)
+		{
+			for (size_t i = clusters[c]; i < clusters[c + 1]; ++i)
+			{
+				const uint32* tri = &indices[order[i] * 3];
+				vec3 p0 = readPosition(positions, positionStride, tri[0]);
+				vec3 p1 = readPosition(positions, positionStride, tri[1]);
+				vec3 p2 = readPosition(positions, positionStride, tri[2]);
+
+				vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float32 area = glm::length(normal) * 0.5f;
+				vec3 center = (p0 + p1 + p2) * (1.0f / 3.0f);
+
+				clusterNormal[c] += normal;
+				clusterCenter[c] += center * area;
+				clusterArea[c] += area;
+			}
+
+			meshCenter += clusterCenter[c];
+			meshArea += clusterArea[c];
+		}
+
+		if (meshArea > 0.0f)
+			meshCenter *= 1.0f / meshArea;
+
+		std::vector<float32> sortKey(numClusters, 0.0f);
+		for (size_t c = 0; c < numClusters; ++c)
+		{
+			if (clusterArea[c] <= 0.0f)
+				continue;
+
+			vec3 center = clusterCenter[c] * (1.0f / clusterArea[c]);
+			float32 len = glm::length(clusterNormal[c]);
+			if (len > 0.0f)
+				sortKey[c] = glm::dot(center - meshCenter, clusterNormal[c] * (1.0f / len));
+		}
+
+		std::vector<size_t> clusterOrder(numClusters);
+		for (size_t c = 0; c < numClusters; ++c)
+			clusterOrder[c] = c;
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKey](size_t a, size_t b)
+		{
+			return sortKey[a] > sortKey[b];
+		});
+
+		std::vector<uint32> result;
+		result.reserve(numTriangles * 3);
+		for (auto& c : clusterOrder)
+		{
+			for (size_t i = clusters[c]; i < clusters[c + 1]; ++i)
+			{
+				const uint32* tri = &indices[order[i] * 3];
+				result.push_back(tri[0]);
+				result.push_back(tri[1]);
+				result.push_back(tri[2]);
+			}
+		}
+
+		memcpy(indices, &result[0], result.size() * sizeof(uint32));
+	}
+
+	void MeshOptimizer::optimizeVertexFetch(uchar* vertexData, size_t stride, size_t numVertices, uint32* indices, size_t numIndices)
+	{
+		if (numVertices == 0)
+			return;
+
+		std::vector<uint32> remap(numVertices, kMeshOptimizerUnused);
+		uint32 next = 0;
+		for (size_t i = 0; i < numIndices; ++i)
+		{
+			uint32& newIndex = remap[indices[i]];
+			if (newIndex == kMeshOptimizerUnused)
+				newIndex = next++;
+			indices[i] = newIndex;
+		}
+
+		// unreferenced vertices keep their relative order at the end
+		for (auto& newIndex : remap)
+		{
+			if (newIndex == kMeshOptimizerUnused)
+				newIndex = next++;
+		}
+
+		std::vector<uchar> reordered(numVertices * stride);
+		for (size_t v = 0; v < numVertices; ++v)
+		{
+			memcpy(&reordered[remap[v] * stride], vertexData + v * stride, stride);
+		}
+		memcpy(vertexData, &reordered[0], reordered.size());
+	}
+
+	float32 MeshOptimizer::getACMR(const uint32* indices, size_t numIndices, uint32 cacheSize)
+	{
+		size_t numTriangles = numIndices / 3;
+		if (numTriangles == 0)
+			return 0.0f;
+
+		uint32 maxIndex = 0;
+		for (size_t i = 0; i < numIndices; ++i)
+			maxIndex = std::max<uint32>(maxIndex, indices[i]);
+
+		// a vertex is resident while fewer than cacheSize misses happened since it went in
+		std::vector<uint64> inserted(size_t(maxIndex) + 1, 0);
+		uint64 misses = 0;
+		for (size_t i = 0; i < numTriangles * 3; ++i)
+		{
+			uint64& stamp = inserted[indices[i]];
+			if (stamp == 0 || misses - stamp >= cacheSize)
+			{
+				++misses;
+				stamp = misses;
+			}
+		}
+
+		return float32(double(misses) / double(numTriangles));
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "global/Values.h"
+#include "math/GLM.h"
+
+#include <vector>
+
+namespace cs
+{
+	// Offline triangle and vertex reordering for static meshes.  Triangles are ordered with
+	// Tipsify (Sander, Nehab, Barczak 2007) for the post-transform vertex cache, the clusters it
+	// produces are then sorted outside-in so the front most surfaces tend to draw first.
+	// Vertices are renumbered in first use order so fetches walk the buffer forwards.
+	class MeshOptimizer
+	{
+	public:
+
+		static const uint32 kDefaultCacheSize = 16;
+
+		// Reorders the triangles of indices[0, numIndices) in place.  positions point at the
+		// first vertex, each vertex is positionStride bytes apart.
+		static void optimizeTriangles(
+			uint32* indices, size_t numIndices,
+			const uchar* positions, size_t positionStride, size_t numVertices,
+			uint32 cacheSize = kDefaultCacheSize);
+
+		// Renumbers vertices by first use in indices and moves vertexData to match
+		static void optimizeVertexFetch(uchar* vertexData, size_t stride, size_t numVertices, uint32* indices, size_t numIndices);
+
+		// Average vertex shader invocations per triangle for a FIFO cache of cacheSize entries
+		static float32 getACMR(const uint32* indices, size_t numIndices, uint32 cacheSize = kDefaultCacheSize);
+
+	private:
+
+		static void tipsify(const uint32* indices, size_t numTriangles, size_t numVertices, uint32 cacheSize,
+			std::vector<uint32>& outTriangles, std::vector<size_t>& outClusters);
+	};
+}
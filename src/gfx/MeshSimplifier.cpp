@@ -0,0 +1,308 @@
+#include "PCH.h"
+
+#include "gfx/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace cs
+{
+	namespace
+	{
+		// symmetric 4x4 plane quadric, weighted by triangle area
+		struct Quadric
+		{
+			Quadric()
+				: a00(0.0f), a01(0.0f), a02(0.0f), a11(0.0f), a12(0.0f), a22(0.0f)
+				, b0(0.0f), b1(0.0f), b2(0.0f), c(0.0f), w(0.0f)
+			{ }
+
+			Quadric(const vec3& n, float32 d, float32 weight)
+				: a00(n.x * n.x * weight), a01(n.x * n.y * weight), a02(n.x * n.z * weight)
+				, a11(n.y * n.y * weight), a12(n.y * n.z * weight), a22(n.z * n.z * weight)
+				, b0(n.x * d * weight), b1(n.y * d * weight), b2(n.z * d * weight)
+				, c(d * d * weight), w(weight)
+			{ }
+
+			void operator+=(const Quadric& rhs)
+			{
+				this->a00 += rhs.a00; this->a01 += rhs.a01; this->a02 += rhs.a02;
+				this->a11 += rhs.a11; this->a12 += rhs.a12; this->a22 += rhs.a22;
+				this->b0 += rhs.b0; this->b1 += rhs.b1; this->b2 += rhs.b2;
+				this->c += rhs.c;
+				this->w += rhs.w;
+			}
+
+			// squared distance to the accumulated planes, averaged by weight
+			float32 evaluate(const vec3& p) const
+			{
+				float32 rx = this->a00 * p.x + this->a01 * p.y + this->a02 * p.z;
+				float32 ry = this->a01 * p.x + this->a11 * p.y + this->a12 * p.z;
+				float32 rz = this->a02 * p.x + this->a12 * p.y + this->a22 * p.z;
+
+				float32 e = rx * p.x + ry * p.y + rz * p.z;
+				e += 2.0f * (this->b0 * p.x + this->b1 * p.y + this->b2 * p.z) + this->c;
+
+				return (this->w > 0.0f) ? fabsf(e) / this->w : 0.0f;
+			}
+
+			float32 a00, a01, a02, a11, a12, a22;
+			float32 b0, b1, b2, c;
+			float32 w;
+		};
+
+		struct Collapse
+		{
+			uint32 from;
+			uint32 to;
+			float32 error;
+		};
+
+		inline uint64 edgeKey(uint32 a, uint32 b)
+		{
+			return (a < b) ? (uint64(a) << 32) | b : (uint64(b) << 32) | a;
+		}
+
+		struct PositionHash
+		{
+			size_t operator()(const vec3& p) const
+			{
+				uint32 h[3];
+				memcpy(h, &p, sizeof(h));
+				return size_t((h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u));
+			}
+		};
+	}
+
+	float32 MeshSimplifier::simplify(
+		std::vector<uint32>& result,
+		const uint32* indices, size_t numIndices,
+		const uchar* positions, size_t positionStride, size_t numVertices,
+		size_t targetIndices, float32 targetError)
+	{
+		result.assign(indices, indices + (numIndices / 3) * 3);
+		if (result.size() <= targetIndices || numVertices == 0)
+			return 0.0f;
+
+		for (auto& index : result)
+		{
+			if (index >= numVertices)
+				return 0.0f;
+		}
+
+		// positions normalised to the extent so errors are relative
+		std::vector<vec3> pos(numVertices);
+		vec3 minb(FLT_MAX, FLT_MAX, FLT_MAX);
+		vec3 maxb(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (size_t v = 0; v < numVertices; ++v)
+		{
+			memcpy(&pos[v], positions + v * positionStride, sizeof(vec3));
+			minb = glm::min(minb, pos[v]);
+			maxb = glm::max(maxb, pos[v]);
+		}
+
+		vec3 extent = maxb - minb;
+		float32 largest = std::max<float32>(extent.x, std::max<float32>(extent.y, extent.z));
+		float32 invExtent = (largest > 0.0f) ? 1.0f / largest : 1.0f;
+		for (auto& p : pos)
+			p = (p - minb) * invExtent;
+
+		// vertices split on a uv or normal seam share a position, moving one would tear the seam
+		std::vector<bool> locked(numVertices, false);
+		std::vector<uint32> canonical(numVertices);
+		{
+			std::unordered_map<vec3, uint32, PositionHash> unique;
+			unique.reserve(numVertices);
+			for (size_t v = 0; v < numVertices; ++v)
+			{
+				auto it = unique.find(pos[v]);
+				if (it == unique.end())
+				{
+					unique[pos[v]] = uint32(v);
+					canonical[v] = uint32(v);
+				}
+				else
+				{
+					canonical[v] = it->second;
+					locked[v] = true;
+					locked[it->second] = true;
+				}
+			}
+		}
+
+		// edges used by a single triangle are on an open border
+		{
+			std::unordered_map<uint64, uint32> edgeCount;
+			edgeCount.reserve(result.size());
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (size_t k = 0; k < 3; ++k)
+				{
+					uint32 a = canonical[result[i + k]];
+					uint32 b = canonical[result[i + (k + 1) % 3]];
+					edgeCount[edgeKey(a, b)]++;
+				}
+			}
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (size_t k = 0; k < 3; ++k)
+				{
+					uint32 a = result[i + k];
+					uint32 b = result[i + (k + 1) % 3];
+					if (edgeCount[edgeKey(canonical[a], canonical[b])] == 1)
+					{
+						locked[a] = true;
+						locked[b] = true;
+					}
+				}
+			}
+		}
+
+		std::vector<Quadric> quadrics(numVertices);
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const vec3& p0 = pos[result[i + 0]];
+			const vec3& p1 = pos[result[i + 1]];
+			const vec3& p2 = pos[result[i + 2]];
+
+			vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float32 len = glm::length(normal);
+			if (len <= 0.0f)
+				continue;
+
+			normal *= 1.0f / len;
+			Quadric q(normal, -glm::dot(normal, p0), len * 0.5f);
+			for (size_t k = 0; k < 3; ++k)
+				quadrics[result[i + k]] += q;
+		}
+
+		float32 maxErrorSq = targetError * targetError;
+		float32 reachedSq = 0.0f;
+
+		std::vector<uint32> remap(numVertices);
+		std::vector<bool> touched(numVertices);
+		std::vector<uint32> adjOffsets(numVertices + 1);
+		std::vector<uint32> adjacency;
+		std::vector<Collapse> collapses;
+
+		while (result.size() > targetIndices)
+		{
+			size_t numTriangles = result.size() / 3;
+			size_t targetTriangles = targetIndices / 3;
+
+			// triangles around each vertex
+			std::fill(adjOffsets.begin(), adjOffsets.end(), 0);
+			for (auto& index : result)
+				adjOffsets[index + 1]++;
+			for (size_t v = 0; v < numVertices; ++v)
+				adjOffsets[v + 1] += adjOffsets[v];
+
+			adjacency.resize(result.size());
+			std::vector<uint32> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+				adjacency[fill[result[i]]++] = uint32(i / 3);
+
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (size_t k = 0; k < 3; ++k)
+				{
+					uint32 a = result[i + k];
+					uint32 b = result[i + (k + 1) % 3];
+
+					Quadric q = quadrics[a];
+					q += quadrics[b];
+
+					if (!locked[a])
+						collapses.push_back({ a, b, q.evaluate(pos[b]) });
+					if (!locked[b])
+						collapses.push_back({ b, a, q.evaluate(pos[a]) });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y)
+			{
+				return x.error < y.error;
+			});
+
+			for (size_t v = 0; v < numVertices; ++v)
+				remap[v] = uint32(v);
+			std::fill(touched.begin(), touched.end(), false);
+
+			size_t applied = 0;
+			for (auto& collapse : collapses)
+			{
+				if (numTriangles <= targetTriangles || collapse.error > maxErrorSq)
+					break;
+
+				uint32 a = collapse.from;
+				uint32 b = collapse.to;
+				if (touched[a] || touched[b])
+					continue;
+
+				// reject collapses that would flip a face or fold it flat
+				bool valid = true;
+				size_t removed = 0;
+				for (uint32 j = adjOffsets[a]; j < adjOffsets[a + 1] && valid; ++j)
+				{
+					const uint32* tri = &result[adjacency[j] * 3];
+					if (tri[0] == b || tri[1] == b || tri[2] == b)
+					{
+						++removed;
+						continue;
+					}
+
+					uint32 k = (tri[0] == a) ? 0 : ((tri[1] == a) ? 1 : 2);
+					const vec3& p1 = pos[tri[(k + 1) % 3]];
+					const vec3& p2 = pos[tri[(k + 2) % 3]];
+
+					vec3 before = glm::cross(p1 - pos[a], p2 - pos[a]);
+					vec3 after = glm::cross(p1 - pos[b], p2 - pos[b]);
+					valid = glm::dot(before, after) > 0.25f * glm::length(before) * glm::length(after);
+				}
+
+				if (!valid || removed == 0)
+					continue;
+
+				// the ring around a is stale until the indices are rewritten
+				for (uint32 j = adjOffsets[a]; j < adjOffsets[a + 1]; ++j)
+				{
+					const uint32* tri = &result[adjacency[j] * 3];
+					touched[tri[0]] = true;
+					touched[tri[1]] = true;
+					touched[tri[2]] = true;
+				}
+
+				remap[a] = b;
+				quadrics[b] += quadrics[a];
+				reachedSq = std::max<float32>(reachedSq, collapse.error);
+				numTriangles -= removed;
+				++applied;
+			}
+
+			if (applied == 0)
+				break;
+
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				uint32 i0 = remap[result[i + 0]];
+				uint32 i1 = remap[result[i + 1]];
+				uint32 i2 = remap[result[i + 2]];
+				if (i0 == i1 || i1 == i2 || i2 == i0)
+					continue;
+
+				result[write++] = i0;
+				result[write++] = i1;
+				result[write++] = i2;
+			}
+			result.resize(write);
+		}
+
+		return sqrtf(reachedSq);
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "global/Values.h"
+#include "math/GLM.h"
+
+#include <vector>
+
+namespace cs
+{
+	// Quadric error metric edge collapse (Garland, Heckbert 1997) for building index-only LODs.
+	// Vertices are merged into a neighbour rather than moved, so every LOD indexes the same vertex
+	// buffer as the full detail shape.  Open borders and attribute seams (vertices sharing a
+	// position) are locked so the silhouette and texture mapping hold together.
+	class MeshSimplifier
+	{
+	public:
+
+		// Collapses indices[0, numIndices) towards targetIndices, stopping early when the next
+		// collapse would move the surface further than targetError (as a fraction of the mesh
+		// extent).  Returns the largest error introduced, in the same units.
+		static float32 simplify(
+			std::vector<uint32>& result,
+			const uint32* indices, size_t numIndices,
+			const uchar* positions, size_t positionStride, size_t numVertices,
+			size_t targetIndices, float32 targetError);
+	};
+}
@@ -8,6 +8,7 @@ namespace cs
 {
 	PostProcess::PostProcess(const std::string& name, const PostProcessParams& params)
 		: postName(name)
+		, nodeTag("postprocess-" + name)
 		, postParams(params)
 		, textureOutput(nullptr)
 		, orthoOffset(0.0f, 0.0f)
@@ -103,7 +104,7 @@ namespace cs
 		post_pass->clearModes = this->postParams.clearModes;
 
 		DisplayListNode node;
-		node.tag = "postprocess-" + this->postName;
+		node.tag = this->nodeTag;
 		node.mvp = glm::ortho(
 			float32(this->postParams.viewport.pos.x),
 			float32(this->postParams.viewport.pos.x + this->postParams.viewport.size.w),
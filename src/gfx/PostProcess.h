@@ -113,7 +113,8 @@ namespace cs
 
 		GeometryDataPtr initGeometryData();
 		
-		std::string postName;
+		StringId postName;
+		StringId nodeTag;
 
 		TextureStages textureInputs;
 		RenderTexturePtr textureOutput;
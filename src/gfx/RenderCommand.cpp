@@ -0,0 +1,401 @@
+#include "PCH.h"
+
+#include "gfx/RenderCommand.h"
+#include "gfx/DisplayList.h"
+#include "gfx/RenderInterface.h"
+#include "os/LogManager.h"
+
+#include <algorithm>
+
+namespace cs
+{
+	const char* kRenderCommandStr[] =
+	{
+		"PushScope",
+		"PopScope",
+		"SetNode",
+		"BindGeometry",
+		"BindOverrides",
+		"BindShader",
+		"BindTexture",
+		"SetUniforms",
+		"Draw",
+		"PreDraw",
+		"PostDraw"
+	};
+
+	const StringId kColorUniform("color");
+
+	// bumped whenever RenderCommand or RenderCommandNode change layout
+	const uint32 kRenderCaptureMagic = 0x43525343; // "CSRC"
+	const uint32 kRenderCaptureVersion = 1;
+
+	static uint64 makeLayerKey(int32 layer)
+	{
+		// flip the sign bit so negative layers sort first
+		return uint64(uint32(layer) ^ 0x80000000u) << 32;
+	}
+
+	RenderCommandBuffer::RenderCommandBuffer()
+	{
+
+	}
+
+	void RenderCommandBuffer::clear()
+	{
+		this->commands.clear();
+		this->packets.clear();
+		this->nodes.clear();
+		this->colors.clear();
+		this->tags.clear();
+
+		this->geometries.clear();
+		this->drawCalls.clear();
+		this->shaders.clear();
+		this->textures.clear();
+		this->overrides.clear();
+		this->handles.clear();
+	}
+
+	void RenderCommandBuffer::add(RenderCommandType type, uint32 handle, uint32 offset, uint32 count, uint16 arg)
+	{
+		assert(this->packets.size() > 0);
+
+		RenderCommand command;
+		command.type = uint16(type);
+		command.arg = arg;
+		command.handle = handle;
+		command.offset = offset;
+		command.count = count;
+		this->commands.push_back(command);
+
+		this->packets.back().count++;
+	}
+
+	void RenderCommandBuffer::beginPacket(int32 layer)
+	{
+		RenderCommandPacket packet;
+		packet.key = makeLayerKey(layer) | uint64(this->packets.size());
+		packet.first = uint32(this->commands.size());
+		packet.count = 0;
+		this->packets.push_back(packet);
+	}
+
+	void RenderCommandBuffer::pushScope(const StringId& tag)
+	{
+		this->add(RenderCommandPushScope, uint32(this->tags.size()));
+		this->tags.push_back(tag);
+	}
+
+	void RenderCommandBuffer::popScope()
+	{
+		this->add(RenderCommandPopScope);
+	}
+
+	void RenderCommandBuffer::setNode(const mat4& objectToWorld, const mat4& mvp, const vec4& color)
+	{
+		RenderCommandNode node;
+		node.objectToWorld = objectToWorld;
+		node.mvp = mvp;
+		node.color = color;
+
+		this->add(RenderCommandSetNode, 0, uint32(this->nodes.size()));
+		this->nodes.push_back(node);
+	}
+
+	void RenderCommandBuffer::addGeometry(const GeometryPtr& geom, const DrawCallList& drawCalls, const DrawCallOverridesPtr& overridesPtr, const ColorF& tint)
+	{
+		DrawCallOverrides* overrides = overridesPtr.get();
+
+		uint32 geomHandle = this->getHandle(geom, this->geometries);
+		this->add(RenderCommandBindGeometry, geomHandle);
+		this->add(RenderCommandBindOverrides, (overrides) ? this->getHandle(overridesPtr, this->overrides) : RenderCommand::kNoHandle);
+
+		for (auto& dc : drawCalls)
+		{
+			uint32 dcHandle = this->getHandle(dc, this->drawCalls);
+			if (dc->preCallback)
+			{
+				this->add(RenderCommandPreDraw, dcHandle);
+				this->add(RenderCommandBindGeometry, geomHandle);
+			}
+
+			if (dc->count != 0)
+			{
+				vec4 color = toVec4(toColorF(dc->color));
+				color.x *= tint.r;
+				color.y *= tint.g;
+				color.z *= tint.b;
+				color.w *= tint.a;
+				this->add(RenderCommandSetUniforms, dcHandle, uint32(this->colors.size()));
+				this->colors.push_back(color);
+
+				// same choice DrawCall::bind makes, an override shader replaces the draw call's own
+				ShaderHandlePtr shader = dc->shaderHandle;
+				if (overrides && shader)
+				{
+					ShaderResourcePtr& shaderResource = shader->getShader();
+					if (shaderResource)
+					{
+						std::map<std::string, ShaderHandlePtr>::iterator it = overrides->shaderOverrideHandles.find(shaderResource->getName());
+						if (it != overrides->shaderOverrideHandles.end())
+							shader = it->second;
+					}
+					else
+					{
+						shader = nullptr;
+					}
+				}
+
+				if (shader)
+					this->add(RenderCommandBindShader, this->getHandle(shader, this->shaders));
+				else if (!overrides)
+					log::print(LogError, "No Shader Bound to Draw!");
+
+				for (auto& it : dc->textures)
+				{
+					if (it.second)
+						this->add(RenderCommandBindTexture, this->getHandle(it.second, this->textures), 0, 0, uint16(getPhysicalStage((TextureStage) it.first)));
+				}
+
+				if (overrides)
+				{
+					for (auto& it : overrides->textureOverrideHandles)
+					{
+						if (it.second)
+							this->add(RenderCommandBindTexture, this->getHandle(it.second, this->textures), 0, 0, uint16(getPhysicalStage((TextureStage) it.first)));
+					}
+				}
+
+				this->add(RenderCommandDraw, dcHandle, dc->offset, dc->count, uint16(dc->type));
+			}
+
+			if (dc->postCallback)
+			{
+				this->add(RenderCommandPostDraw, dcHandle);
+				this->add(RenderCommandBindGeometry, geomHandle);
+			}
+		}
+	}
+
+	void RenderCommandBuffer::sort(RenderSortMode mode, uint32 firstPacket)
+	{
+		if (firstPacket >= this->packets.size())
+			return;
+
+		if (mode == RenderSortState)
+		{
+			// first shader and texture each packet binds, under the layer
+			for (size_t i = firstPacket; i < this->packets.size(); ++i)
+			{
+				RenderCommandPacket& packet = this->packets[i];
+				uint32 shader = 0xffff;
+				uint32 texture = 0xffff;
+				for (uint32 c = packet.first; c < packet.first + packet.count; ++c)
+				{
+					const RenderCommand& command = this->commands[c];
+					if (command.type == RenderCommandBindShader && shader == 0xffff)
+						shader = std::min<uint32>(command.handle, 0xfffe);
+					else if (command.type == RenderCommandBindTexture && texture == 0xffff)
+						texture = std::min<uint32>(command.handle, 0xfffe);
+				}
+				packet.key = (packet.key & 0xffffffff00000000ull) | (uint64(shader) << 16) | uint64(texture);
+			}
+		}
+
+		std::stable_sort(this->packets.begin() + firstPacket, this->packets.end(), [](const RenderCommandPacket& a, const RenderCommandPacket& b)
+		{
+			return a.key < b.key;
+		});
+	}
+
+	void RenderCommandBuffer::submit(RenderCommandBackend& backend, uint32 firstPacket) const
+	{
+		for (size_t i = firstPacket; i < this->packets.size(); ++i)
+		{
+			const RenderCommandPacket& packet = this->packets[i];
+			for (uint32 c = packet.first; c < packet.first + packet.count; ++c)
+			{
+				backend.execute(*this, this->commands[c]);
+			}
+		}
+	}
+
+	template <class T>
+	static void writeArray(std::ostream& os, const std::vector<T>& values)
+	{
+		uint32 size = uint32(values.size());
+		os.write(reinterpret_cast<const char*>(&size), sizeof(uint32));
+		if (size > 0)
+			os.write(reinterpret_cast<const char*>(&values[0]), size * sizeof(T));
+	}
+
+	template <class T>
+	static bool readArray(std::istream& is, std::vector<T>& values)
+	{
+		uint32 size = 0;
+		if (!is.read(reinterpret_cast<char*>(&size), sizeof(uint32)))
+			return false;
+
+		values.resize(size);
+		if (size > 0)
+			is.read(reinterpret_cast<char*>(&values[0]), size * sizeof(T));
+		return bool(is);
+	}
+
+	void RenderCommandBuffer::write(std::ostream& os) const
+	{
+		os.write(reinterpret_cast<const char*>(&kRenderCaptureMagic), sizeof(uint32));
+		os.write(reinterpret_cast<const char*>(&kRenderCaptureVersion), sizeof(uint32));
+
+		writeArray(os, this->commands);
+		writeArray(os, this->packets);
+		writeArray(os, this->nodes);
+		writeArray(os, this->colors);
+
+		// tags by name, the ids are only meaningful to this process
+		uint32 numTags = uint32(this->tags.size());
+		os.write(reinterpret_cast<const char*>(&numTags), sizeof(uint32));
+		for (auto& it : this->tags)
+		{
+			const std::string& name = it.getString();
+			uint32 length = uint32(name.length());
+			os.write(reinterpret_cast<const char*>(&length), sizeof(uint32));
+			os.write(name.c_str(), length);
+		}
+	}
+
+	bool RenderCommandBuffer::read(std::istream& is)
+	{
+		this->clear();
+
+		uint32 magic = 0;
+		uint32 version = 0;
+		is.read(reinterpret_cast<char*>(&magic), sizeof(uint32));
+		is.read(reinterpret_cast<char*>(&version), sizeof(uint32));
+		if (!is || magic != kRenderCaptureMagic || version != kRenderCaptureVersion)
+		{
+			log::error("Not a render capture, or an old version");
+			return false;
+		}
+
+		if (!readArray(is, this->commands) ||
+			!readArray(is, this->packets) ||
+			!readArray(is, this->nodes) ||
+			!readArray(is, this->colors))
+		{
+			log::error("Truncated render capture");
+			this->clear();
+			return false;
+		}
+
+		uint32 numTags = 0;
+		is.read(reinterpret_cast<char*>(&numTags), sizeof(uint32));
+		for (uint32 i = 0; i < numTags && is; ++i)
+		{
+			uint32 length = 0;
+			is.read(reinterpret_cast<char*>(&length), sizeof(uint32));
+
+			std::string name(length, '\0');
+			if (length > 0)
+				is.read(&name[0], length);
+			this->tags.push_back(StringId(name));
+		}
+
+		if (!is)
+		{
+			log::error("Truncated render capture");
+			this->clear();
+			return false;
+		}
+		return true;
+	}
+
+	RenderCommandDevice::RenderCommandDevice()
+		: geometry(nullptr)
+		, overrides(nullptr)
+	{
+
+	}
+
+	void RenderCommandDevice::execute(const RenderCommandBuffer& buffer, const RenderCommand& command)
+	{
+		assert(buffer.hasResources() || command.type == RenderCommandPushScope || command.type == RenderCommandPopScope);
+		RenderInterface* render = RenderInterface::getInstance();
+
+		switch (command.type)
+		{
+			case RenderCommandPushScope:
+				render->pushDebugScope(buffer.getTag(command.handle));
+				break;
+			case RenderCommandPopScope:
+				render->popDebugScope();
+				break;
+			case RenderCommandSetNode:
+			{
+				const RenderCommandNode& node = buffer.getNode(command.offset);
+				DisplayListNode::objectToWorldMatrix->setValue(node.objectToWorld);
+				DisplayListNode::modelViewProjectionMatrix->setValue(node.mvp);
+				DisplayListNode::globalColor->setValue(node.color);
+				break;
+			}
+			case RenderCommandBindGeometry:
+				this->geometry = buffer.getGeometry(command.handle).get();
+				this->geometry->bindAll();
+				break;
+			case RenderCommandBindOverrides:
+				this->overrides = (command.handle != RenderCommand::kNoHandle) ? buffer.getOverrides(command.handle).get() : nullptr;
+				break;
+			case RenderCommandBindShader:
+			{
+				ShaderBindParams bindParams;
+				bindParams.geom = this->geometry;
+				bindParams.channels = render->getCurrentRenderChannels();
+				bindParams.depth = render->getCurrentDepthChannels();
+				buffer.getShader(command.handle)->bind(bindParams);
+				break;
+			}
+			case RenderCommandBindTexture:
+				buffer.getTexture(command.handle)->bind(command.arg);
+				break;
+			case RenderCommandSetUniforms:
+			{
+				cs::UniformPtr color = SharedUniform::getInstance().getUniform(kColorUniform);
+				if (color.get())
+					color->setValue(buffer.getColor(command.offset));
+
+				const DrawCallPtr& dc = buffer.getDrawCall(command.handle);
+				if (dc->uniformCallback)
+					dc->uniformCallback();
+				break;
+			}
+			case RenderCommandDraw:
+			{
+				DrawCallPtr dc = buffer.getDrawCall(command.handle);
+				render->draw(this->geometry, dc, this->overrides);
+				break;
+			}
+			case RenderCommandPreDraw:
+				buffer.getDrawCall(command.handle)->preCallback();
+				break;
+			case RenderCommandPostDraw:
+				buffer.getDrawCall(command.handle)->postCallback();
+				break;
+			default:
+				assert(false);
+				break;
+		}
+	}
+
+	void RenderCommandNull::execute(const RenderCommandBuffer& buffer, const RenderCommand& command)
+	{
+		assert(command.type < RenderCommandMAX);
+		this->stats.counts[command.type]++;
+
+		if (command.type == RenderCommandDraw)
+		{
+			this->stats.draws++;
+			this->stats.elements += command.count;
+		}
+	}
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "ClassDef.h"
+#include "gfx/DrawCall.h"
+#include "gfx/Geometry.h"
+#include "math/GLM.h"
+
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace cs
+{
+	enum RenderCommandType
+	{
+		RenderCommandNone = -1,
+		RenderCommandPushScope,		// handle: tag
+		RenderCommandPopScope,
+		RenderCommandSetNode,		// offset: node transform and color
+		RenderCommandBindGeometry,	// handle: geometry
+		RenderCommandBindOverrides,	// handle: overrides the draws that follow pass on, or kNoHandle
+		RenderCommandBindShader,	// handle: shader
+		RenderCommandBindTexture,	// handle: texture, arg: physical stage
+		RenderCommandSetUniforms,	// handle: draw call, offset: draw color
+		RenderCommandDraw,			// handle: draw call (render state), arg: draw type, offset/count: range
+		RenderCommandPreDraw,		// handle: draw call whose callback runs
+		RenderCommandPostDraw,		// handle: draw call whose callback runs
+		//...
+		RenderCommandMAX
+	};
+
+	extern const char* kRenderCommandStr[];
+
+	// One recorded step.  Resources are integer handles into the owning buffer's tables so
+	// the stream itself is plain data, copied, sorted and written out as bytes.
+	struct RenderCommand
+	{
+		static const uint32 kNoHandle = 0xffffffff;
+
+		uint16 type;
+		uint16 arg;
+		uint32 handle;
+		uint32 offset;
+		uint32 count;
+	};
+
+	// What DisplayListNode::record sets before the node's geometry
+	struct RenderCommandNode
+	{
+		mat4 objectToWorld;
+		mat4 mvp;
+		vec4 color;
+	};
+
+	// A run of commands kept together when sorting, one per drawn node
+	struct RenderCommandPacket
+	{
+		uint64 key;
+		uint32 first;
+		uint32 count;
+	};
+
+	enum RenderSortMode
+	{
+		RenderSortSequence,		// layer, then recorded order (what the display list always did)
+		RenderSortState,		// layer, then shader and texture to cut state changes, opaque only
+		//...
+		RenderSortMAX
+	};
+
+	class RenderCommandBuffer;
+
+	class RenderCommandBackend
+	{
+	public:
+		virtual ~RenderCommandBackend() { }
+		virtual void execute(const RenderCommandBuffer& buffer, const RenderCommand& command) = 0;
+	};
+
+	// The display list flattened into a command stream.  Recording reads the nodes once; replaying
+	// hands each command to a backend, the device (the render interface) or the null backend.
+	class RenderCommandBuffer
+	{
+	public:
+
+		RenderCommandBuffer();
+
+		void clear();
+
+		// Starts a packet, commands added until the next begin belong to it
+		void beginPacket(int32 layer);
+
+		void pushScope(const StringId& tag);
+		void popScope();
+		void setNode(const mat4& objectToWorld, const mat4& mvp, const vec4& color);
+
+		// Records geom->draw(drawCalls, overrides, tint) as the device would issue it
+		void addGeometry(const GeometryPtr& geom, const DrawCallList& drawCalls, const DrawCallOverridesPtr& overrides, const ColorF& tint);
+
+		// Sorts the packets from firstPacket on, stable for equal keys
+		void sort(RenderSortMode mode, uint32 firstPacket = 0);
+
+		void submit(RenderCommandBackend& backend, uint32 firstPacket = 0) const;
+
+		uint32 getNumPackets() const { return uint32(this->packets.size()); }
+		uint32 getNumCommands() const { return uint32(this->commands.size()); }
+
+		const std::vector<RenderCommand>& getCommands() const { return this->commands; }
+		const RenderCommandNode& getNode(uint32 index) const { return this->nodes[index]; }
+		const vec4& getColor(uint32 index) const { return this->colors[index]; }
+
+		// Resources are only held by a recorded buffer, one read back from a capture has the
+		// handles alone and replays on the null backend
+		bool hasResources() const { return this->geometries.size() > 0 || this->drawCalls.size() > 0; }
+		const GeometryPtr& getGeometry(uint32 handle) const { return this->geometries[handle]; }
+		const DrawCallPtr& getDrawCall(uint32 handle) const { return this->drawCalls[handle]; }
+		const ShaderHandlePtr& getShader(uint32 handle) const { return this->shaders[handle]; }
+		const TextureHandlePtr& getTexture(uint32 handle) const { return this->textures[handle]; }
+		const DrawCallOverridesPtr& getOverrides(uint32 handle) const { return this->overrides[handle]; }
+		const StringId& getTag(uint32 handle) const { return this->tags[handle]; }
+
+		void write(std::ostream& os) const;
+		bool read(std::istream& is);
+
+	private:
+
+		void add(RenderCommandType type, uint32 handle = 0, uint32 offset = 0, uint32 count = 0, uint16 arg = 0);
+
+		template <class T>
+		uint32 getHandle(const std::shared_ptr<T>& ptr, std::vector<std::shared_ptr<T>>& table)
+		{
+			std::unordered_map<const void*, uint32>::iterator it = this->handles.find(ptr.get());
+			if (it != this->handles.end())
+				return it->second;
+
+			uint32 handle = uint32(table.size());
+			table.push_back(ptr);
+			this->handles[ptr.get()] = handle;
+			return handle;
+		}
+
+		std::vector<RenderCommand> commands;
+		std::vector<RenderCommandPacket> packets;
+		std::vector<RenderCommandNode> nodes;
+		std::vector<vec4> colors;
+		std::vector<StringId> tags;
+
+		std::vector<GeometryPtr> geometries;
+		std::vector<DrawCallPtr> drawCalls;
+		std::vector<ShaderHandlePtr> shaders;
+		std::vector<TextureHandlePtr> textures;
+		std::vector<DrawCallOverridesPtr> overrides;
+		std::unordered_map<const void*, uint32> handles;
+	};
+
+	// Issues commands through the render interface, replaying what DisplayListNode::record captured
+	class RenderCommandDevice : public RenderCommandBackend
+	{
+	public:
+		RenderCommandDevice();
+		virtual void execute(const RenderCommandBuffer& buffer, const RenderCommand& command);
+
+	private:
+		Geometry* geometry;
+		DrawCallOverrides* overrides;
+	};
+
+	struct RenderCommandStats
+	{
+		RenderCommandStats()
+			: draws(0)
+			, elements(0)
+		{
+			for (int32 i = 0; i < RenderCommandMAX; ++i)
+				this->counts[i] = 0;
+		}
+
+		uint32 counts[RenderCommandMAX];
+		uint32 draws;
+		uint64 elements;
+	};
+
+	// Touches nothing, only counts what it is handed.  Replays captures and measures a stream
+	// without a device.
+	class RenderCommandNull : public RenderCommandBackend
+	{
+	public:
+		virtual void execute(const RenderCommandBuffer& buffer, const RenderCommand& command);
+
+		const RenderCommandStats& getStats() const { return this->stats; }
+		void reset() { this->stats = RenderCommandStats(); }
+
+	private:
+		RenderCommandStats stats;
+	};
+}
@@ -38,6 +38,7 @@ namespace cs
 	ShaderHandlePtr RenderInterface::kVertexPhongLitTexture = nullptr;
 	ShaderHandlePtr RenderInterface::kDefaultFontShader = nullptr;
 	ShaderHandlePtr RenderInterface::kDefaultFontOutlineShader = nullptr;
+	ShaderHandlePtr RenderInterface::kDefaultFontSDFShader = nullptr;
     ShaderHandlePtr RenderInterface::kMetalTest = nullptr;
 	ShaderHandlePtr RenderInterface::kColorOutline = nullptr;
     ShaderHandlePtr RenderInterface::kSolidColorTest = nullptr;
@@ -222,6 +223,7 @@ namespace cs
 		kDefaultDebugShader.reset();
 		kFontAtkasShader.reset();
 		kDefaultFontShader.reset();
+		kDefaultFontSDFShader.reset();
 		kDefaultTextureColorShader.reset();
 
 		kDefaultTexture.reset();
@@ -14,6 +14,7 @@
 #include "fx/ParticleEffect.h"
 
 #include "math/Rect.h"
+#include "global/StringId.h"
 
 #define USE_DEBUG_SCOPE 1
 
@@ -108,6 +109,15 @@ namespace cs
         
         virtual TextureChannels getCurrentRenderChannels() const { return TextureNone; }
         virtual TextureChannels getCurrentDepthChannels() const { return TextureNone; }
+
+		// Whether cooked blocks in this format can be uploaded without decoding them first
+		virtual bool supportsTextureCompression(TextureCompression compression) const { return false; }
+
+		// Whether 32 bit index buffers can be drawn
+		virtual bool supportsWideIndices() const { return true; }
+
+		// Names the driver program binaries are valid for, empty if they can't be cached
+		virtual std::string getDriverId() const { return std::string(); }
         
 		const ShaderResourcePtr& getCurrentShader() const { return this->shader; }
 
@@ -138,7 +148,7 @@ namespace cs
         int32 getWindowWidth() const { return this->windowWidth; }
         int32 getWindowHeight() const { return this->windowHeight; }
 
-		virtual void pushDebugScope(const std::string& tag) { }
+		virtual void pushDebugScope(const StringId& tag) { }
 		virtual void popDebugScope() { }
 
 		float32 getContentScale() const { return this->contentScale; }
@@ -165,6 +175,7 @@ namespace cs
 		static std::shared_ptr<ShaderHandle> kTextureSingleChannelShader;
 		static std::shared_ptr<ShaderHandle> kTextureAlphaBWShader;
 		static std::shared_ptr<ShaderHandle> kDefaultFontOutlineShader;
+		static std::shared_ptr<ShaderHandle> kDefaultFontSDFShader;
 		static std::shared_ptr<ShaderHandle> kNormalColorLit;
 		static std::shared_ptr<ShaderHandle> kVertexPhongLit;
 		static std::shared_ptr<ShaderHandle> kVertexPhongLitTexture;
@@ -0,0 +1,128 @@
+#include "PCH.h"
+
+#include "gfx/RenderThread.h"
+
+#include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace cs
+{
+	namespace
+	{
+		struct RenderThreadState
+		{
+			RenderThreadState()
+				: bound(false)
+				, numExecuted(0)
+			{ }
+
+			struct PendingTask
+			{
+				const RenderThread::Task* task;
+				bool done;
+			};
+
+			std::atomic<bool> bound;
+			std::atomic<uint32> numExecuted;
+
+			std::mutex lock;
+			std::condition_variable available;
+			std::condition_variable finished;
+			std::deque<PendingTask*> tasks;
+		};
+
+		RenderThreadState& getState()
+		{
+			static RenderThreadState state;
+			return state;
+		}
+
+		thread_local bool gIsRenderThread = false;
+	}
+
+	void RenderThread::bind()
+	{
+		gIsRenderThread = true;
+		getState().bound = true;
+	}
+
+	void RenderThread::unbind()
+	{
+		getState().bound = false;
+		gIsRenderThread = false;
+	}
+
+	bool RenderThread::isBound()
+	{
+		return getState().bound.load(std::memory_order_relaxed);
+	}
+
+	bool RenderThread::isRenderThread()
+	{
+		return gIsRenderThread || !RenderThread::isBound();
+	}
+
+	void RenderThread::execute(const Task& task)
+	{
+		if (RenderThread::isRenderThread())
+		{
+			task();
+			return;
+		}
+
+		RenderThreadState& state = getState();
+
+		RenderThreadState::PendingTask pending;
+		pending.task = &task;
+		pending.done = false;
+
+		std::unique_lock<std::mutex> guard(state.lock);
+		state.tasks.push_back(&pending);
+		state.available.notify_all();
+		state.finished.wait(guard, [&pending]() { return pending.done; });
+	}
+
+	void RenderThread::service(const DoneFunc& done)
+	{
+		assert(RenderThread::isRenderThread());
+
+		RenderThreadState& state = getState();
+		std::unique_lock<std::mutex> guard(state.lock);
+		for (;;)
+		{
+			while (!state.tasks.empty())
+			{
+				RenderThreadState::PendingTask* pending = state.tasks.front();
+				state.tasks.pop_front();
+
+				guard.unlock();
+				(*pending->task)();
+				state.numExecuted++;
+				guard.lock();
+
+				pending->done = true;
+				state.finished.notify_all();
+			}
+
+			if (done())
+				return;
+
+			state.available.wait(guard);
+		}
+	}
+
+	void RenderThread::wake()
+	{
+		RenderThreadState& state = getState();
+		std::unique_lock<std::mutex> guard(state.lock);
+		state.available.notify_all();
+	}
+
+	uint32 RenderThread::getNumExecuted()
+	{
+		return getState().numExecuted.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "global/Values.h"
+
+#include <functional>
+
+namespace cs
+{
+	// The thread that owns the graphics context.  Until bind() is called every thread counts as
+	// the render thread, so the single threaded path never pays for any of this.
+	//
+	// Once bound, GL calls made from any other thread (the pipelined simulation) are handed to the
+	// render thread and block until it runs them.  The render thread only runs them inside
+	// service(), between frames, so a sequence it issues itself (bind then map) is never split.
+	class RenderThread
+	{
+	public:
+
+		typedef std::function<void()> Task;
+		typedef std::function<bool()> DoneFunc;
+
+		// Call from the thread that owns the context
+		static void bind();
+		static void unbind();
+
+		static bool isBound();
+		static bool isRenderThread();
+
+		// Runs task on the render thread, inline if already there
+		static void execute(const Task& task);
+
+		// Render thread only, runs marshalled tasks until done() returns true
+		static void service(const DoneFunc& done);
+
+		// Wakes a thread blocked in service() so it re-checks its done()
+		static void wake();
+
+		static uint32 getNumExecuted();
+	};
+}
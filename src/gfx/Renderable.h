@@ -31,7 +31,7 @@ namespace cs
 		virtual void process(float32 dt);
 		
 		virtual void batch(
-			const std::string& tag,
+			const StringId& tag,
 			BatchDrawList& display_list,
 			const BatchRenderableParams& params,
 			uint32& numVertices,
@@ -6,10 +6,13 @@ namespace cs
 {
 	namespace renderer
 	{
+		const StringId kMVPUniform("mvp");
+		const StringId kUIScope("UI");
+
 		void draw(const mat4& mvp, const ColorB& global_color, GeometryPtr& geom)
 		{
 
-			cs::UniformPtr matrix = SharedUniform::getInstance().getUniform("mvp");
+			cs::UniformPtr matrix = SharedUniform::getInstance().getUniform(kMVPUniform);
 			assert(matrix);
 			matrix->setValue(mvp);
 
@@ -96,7 +99,7 @@ namespace cs
 
 
 			capture.rtt->bind(false, &clearmode);
-			render_interface->pushDebugScope("UI");
+			render_interface->pushDebugScope(kUIScope);
 
 #if !defined(CS_METAL)
 			render_interface->setClearColor(kClearColor);
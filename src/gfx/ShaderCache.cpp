@@ -0,0 +1,290 @@
+#include "PCH.h"
+
+#include "gfx/ShaderCache.h"
+#include "gfx/ShaderResource.h"
+#include "gfx/RenderInterface.h"
+#include "global/ResourceFactory.h"
+#include "global/TaskQueue.h"
+#include "global/Profiler.h"
+#include "os/FileManager.h"
+#include "os/LogManager.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace cs
+{
+	const uint32 ShaderCache::kMagic = 0x47505343;	// "CSPG"
+	const uint32 ShaderCache::kVersion = 1;
+	const char* ShaderCache::kExtension = ".csprog";
+
+	namespace
+	{
+		const uint64 kHashOffset = 0xcbf29ce484222325ULL;
+		const uint64 kHashPrime = 0x100000001b3ULL;
+
+		// FNV-1a, 64 bits so unrelated programs don't share a cache file
+		uint64 hashBytes(const void* data, size_t size, uint64 hash)
+		{
+			const uchar* bytes = reinterpret_cast<const uchar*>(data);
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= uint64(bytes[i]);
+				hash *= kHashPrime;
+			}
+			return hash;
+		}
+
+		uint64 hashString(const std::string& str, uint64 hash)
+		{
+			// the terminator keeps "ab" + "c" apart from "a" + "bc"
+			return hashBytes(str.c_str(), str.length() + 1, hash);
+		}
+
+		std::string toHex(uint64 value)
+		{
+			std::stringstream str;
+			str << std::hex << std::setw(16) << std::setfill('0') << value;
+			return str.str();
+		}
+
+		std::string getSaveDirectory()
+		{
+			std::string path = FileManager::getInstance()->getSavePath();
+			if (path.length() > 0 && !FileManager::isSeparator(path[path.length() - 1]))
+				path += FileManager::getInstance()->separator();
+			return path;
+		}
+
+		// main thread only, like shader resource creation
+		int32 gWarmUpDepth = 0;
+		std::vector<ShaderResource*> gWarmUpQueue;
+	}
+
+	uint64 ShaderCache::hashProgram(const std::string& vertexSource, const std::string& fragmentSource, const UniformNameMap& attributes)
+	{
+		uint64 hash = kHashOffset;
+		hash = hashString(vertexSource, hash);
+		hash = hashString(fragmentSource, hash);
+
+		// attribute locations are baked into the linked program
+		for (const auto& it : attributes)
+		{
+			int32 location = it.first;
+			hash = hashBytes(&location, sizeof(location), hash);
+			hash = hashString(it.second, hash);
+		}
+		return hash;
+	}
+
+	uint64 ShaderCache::getDriverHash()
+	{
+		RenderInterface* render = RenderInterface::getInstance();
+		std::string driverId = (render) ? render->getDriverId() : std::string();
+		if (driverId.length() == 0)
+			return 0;
+		return hashString(driverId, kHashOffset);
+	}
+
+	std::string ShaderCache::getCachePath(uint64 sourceHash)
+	{
+		uint64 driverHash = ShaderCache::getDriverHash();
+		std::string directory = getSaveDirectory();
+		if (driverHash == 0 || directory.length() == 0)
+			return std::string();
+
+		uint64 key = hashBytes(&driverHash, sizeof(driverHash), sourceHash);
+		return directory + "shader_" + toHex(key) + ShaderCache::kExtension;
+	}
+
+	bool ShaderCache::read(uint64 sourceHash, ShaderCacheBinary& binary)
+	{
+		std::string path = ShaderCache::getCachePath(sourceHash);
+		if (path.length() == 0)
+			return false;
+
+		std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+		if (!in.is_open())
+			return false;
+
+		uint32 magic = 0;
+		uint32 version = 0;
+		uint64 fileSourceHash = 0;
+		uint64 fileDriverHash = 0;
+		uint32 format = 0;
+		uint32 size = 0;
+
+		in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		in.read(reinterpret_cast<char*>(&version), sizeof(version));
+		in.read(reinterpret_cast<char*>(&fileSourceHash), sizeof(fileSourceHash));
+		in.read(reinterpret_cast<char*>(&fileDriverHash), sizeof(fileDriverHash));
+		in.read(reinterpret_cast<char*>(&format), sizeof(format));
+		in.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+		// the file name is only a hash of both, make sure it's the program asked for
+		if (!in.good() || magic != ShaderCache::kMagic || version != ShaderCache::kVersion ||
+			fileSourceHash != sourceHash || fileDriverHash != ShaderCache::getDriverHash() || size == 0)
+		{
+			return false;
+		}
+
+		binary.format = format;
+		binary.data.resize(size);
+		in.read(reinterpret_cast<char*>(&binary.data[0]), std::streamsize(size));
+		if (!in.good())
+		{
+			binary = ShaderCacheBinary();
+			return false;
+		}
+		return true;
+	}
+
+	bool ShaderCache::write(uint64 sourceHash, const ShaderCacheBinary& binary)
+	{
+		std::string path = ShaderCache::getCachePath(sourceHash);
+		if (path.length() == 0 || binary.isEmpty())
+			return false;
+
+		std::ofstream out(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+		{
+			log::error("Could not write shader cache ", path);
+			return false;
+		}
+
+		uint64 driverHash = ShaderCache::getDriverHash();
+		uint32 size = uint32(binary.data.size());
+
+		out.write(reinterpret_cast<const char*>(&ShaderCache::kMagic), sizeof(ShaderCache::kMagic));
+		out.write(reinterpret_cast<const char*>(&ShaderCache::kVersion), sizeof(ShaderCache::kVersion));
+		out.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+		out.write(reinterpret_cast<const char*>(&driverHash), sizeof(driverHash));
+		out.write(reinterpret_cast<const char*>(&binary.format), sizeof(binary.format));
+		out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		out.write(reinterpret_cast<const char*>(&binary.data[0]), std::streamsize(size));
+
+		bool ok = out.good();
+		out.close();
+		return ok;
+	}
+
+	void ShaderCache::beginWarmUp()
+	{
+#if !defined(CS_METAL)
+		// Metal shader handles size their uniform buffers from the compiled shaders as soon as they're made
+		++gWarmUpDepth;
+#endif
+	}
+
+	bool ShaderCache::isWarmingUp()
+	{
+		return gWarmUpDepth > 0;
+	}
+
+	void ShaderCache::queue(ShaderResource* resource)
+	{
+		assert(gWarmUpDepth > 0);
+		gWarmUpQueue.push_back(resource);
+	}
+
+	bool ShaderCache::dequeue(ShaderResource* resource)
+	{
+		std::vector<ShaderResource*>::iterator it = std::find(gWarmUpQueue.begin(), gWarmUpQueue.end(), resource);
+		if (it == gWarmUpQueue.end())
+			return false;
+
+		gWarmUpQueue.erase(it);
+		return true;
+	}
+
+	void ShaderCache::endWarmUp()
+	{
+#if !defined(CS_METAL)
+		assert(gWarmUpDepth > 0);
+		if (gWarmUpDepth <= 0 || --gWarmUpDepth > 0)
+			return;
+
+		std::vector<ShaderResource*> pending;
+		std::swap(pending, gWarmUpQueue);
+		if (pending.empty())
+			return;
+
+		PROFILE_SCOPE("Shader Warm Up");
+
+		// Reading, rewriting and hashing the sources and reading any binaries needs no context.
+		// Compiling does, so that stays here.
+		uint64 start = Profiler::now();
+		TaskQueue::getInstance()->parallel(uint32(pending.size()), [&pending](uint32 i)
+		{
+			pending[i]->prepare();
+		});
+		uint64 prepared = Profiler::now();
+
+		uint32 numCached = 0;
+		for (auto& it : pending)
+		{
+			if (!it->cached.isEmpty())
+				++numCached;
+			it->build();
+		}
+		uint64 built = Profiler::now();
+
+		log::info("Shader warm up: ", pending.size(), " programs (", numCached, " cached) prepared in ",
+			float32(prepared - start) / 1000000.0f, "ms, built in ", float32(built - prepared) / 1000000.0f, "ms");
+#endif
+	}
+
+	bool ShaderCache::writeManifest(const std::string& fileName)
+	{
+		struct local
+		{
+			static void gather(ShaderResourcePtr& resource, uintptr_t* data)
+			{
+				reinterpret_cast<std::vector<ShaderResourcePtr>*>(data)->push_back(resource);
+			}
+
+			static bool byName(const ShaderResourcePtr& a, const ShaderResourcePtr& b)
+			{
+				return a->getName() < b->getName();
+			}
+		};
+
+		std::vector<ShaderResourcePtr> resources;
+		ResourceFactory::getInstance()->performOperation<ShaderResource>(&local::gather, (uintptr_t*) &resources);
+		std::sort(resources.begin(), resources.end(), &local::byName);
+
+		std::string directory = getSaveDirectory();
+		std::string manifestPath = directory + fileName;
+
+		std::ofstream manifest(manifestPath.c_str(), std::ios::out | std::ios::trunc);
+		if (!manifest.is_open())
+		{
+			log::error("Could not write shader manifest ", manifestPath);
+			return false;
+		}
+
+		for (auto& it : resources)
+		{
+			std::string vertexSource;
+			std::string fragmentSource;
+			std::string hash = toHex(it->getPreparedSource(vertexSource, fragmentSource));
+
+			manifest << hash << " " << it->getName() << " " << int32(it->getBucket()) << "\n";
+
+			// what the driver is handed, for checking permutations with an offline compiler
+			std::ofstream vertexOut((directory + hash + ".vsh").c_str(), std::ios::out | std::ios::trunc);
+			vertexOut << vertexSource;
+
+			std::ofstream fragmentOut((directory + hash + ".fsh").c_str(), std::ios::out | std::ios::trunc);
+			fragmentOut << fragmentSource;
+		}
+
+		bool ok = manifest.good();
+		manifest.close();
+
+		log::info("Wrote ", resources.size(), " shader permutations to ", manifestPath);
+		return ok;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "global/Values.h"
+#include "gfx/ShaderParams.h"
+
+#include <string>
+#include <vector>
+
+namespace cs
+{
+	class ShaderResource;
+
+	// A linked program as the driver hands it back, only valid for the driver that built it
+	struct ShaderCacheBinary
+	{
+		ShaderCacheBinary()
+			: format(0)
+		{ }
+
+		bool isEmpty() const { return this->data.empty(); }
+
+		uint32 format;
+		std::vector<uchar> data;
+	};
+
+	// Program binaries keyed by a hash of the final source each shader is compiled from
+	// (preprocessors injected, output format and precision rewritten, attribute bindings) and
+	// the driver, stored in the save path.  A program whose source hash and driver match a
+	// cached binary is loaded without compiling anything.
+	//
+	// Shader resources made between beginWarmUp and endWarmUp are held back and built
+	// together: their sources are read, rewritten and hashed and their binaries read on the
+	// task queue, then each program is loaded or compiled on the render thread.
+	class ShaderCache
+	{
+	public:
+
+		static const uint32 kMagic;
+		static const uint32 kVersion;
+		static const char* kExtension;
+
+		static uint64 hashProgram(const std::string& vertexSource, const std::string& fragmentSource, const UniformNameMap& attributes);
+
+		// 0 when the render interface can't hand back program binaries
+		static uint64 getDriverHash();
+
+		static std::string getCachePath(uint64 sourceHash);
+		static bool read(uint64 sourceHash, ShaderCacheBinary& binary);
+		static bool write(uint64 sourceHash, const ShaderCacheBinary& binary);
+
+		static void beginWarmUp();
+		static void endWarmUp();
+		static bool isWarmingUp();
+
+		// Called by shader resources made during a warm up, and when they go away or are needed before
+		// it ends, dequeue returns whether the resource was still waiting
+		static void queue(ShaderResource* resource);
+		static bool dequeue(ShaderResource* resource);
+
+		// Offline: lists every loaded shader resource with the hash of its final source, one
+		// "hash name bucket" line each, next to the preprocessed sources as <hash>.vsh / <hash>.fsh
+		static bool writeManifest(const std::string& fileName);
+	};
+}
@@ -119,7 +119,7 @@ namespace cs
 	}
 
 
-	ShaderUniformPtr ShaderHandle::getUniform(const std::string& uniform_name)
+	ShaderUniformPtr ShaderHandle::getUniform(const StringId& uniform_name)
 	{
 		ShaderUniformMap::iterator it = this->uniformLookup.find(uniform_name);
 		if (it == this->uniformLookup.end())
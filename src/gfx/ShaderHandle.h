@@ -57,10 +57,10 @@ namespace cs
 		void onShaderChanged();
 		Event onChanged;
 
-		ShaderUniformPtr getUniform(const std::string& uniform_name);
+		ShaderUniformPtr getUniform(const StringId& uniform_name);
 
 		template <class T>
-		bool setUniformValue(const std::string& name, const T& value)
+		bool setUniformValue(const StringId& name, const T& value)
 		{
 			ShaderUniformPtr ptr = this->getUniform(name);
 			if (!ptr.get())
@@ -319,7 +319,7 @@ namespace cs
     };
 
     typedef std::vector<ShaderUniformPtr> ShaderUniformList;
-    typedef std::map<std::string, ShaderUniformPtr> ShaderUniformMap;
+    typedef std::unordered_map<StringId, ShaderUniformPtr> ShaderUniformMap;
 
     CLASS_DEFINITION(ShaderParams)
 
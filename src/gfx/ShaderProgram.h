@@ -6,6 +6,7 @@
 #include "gfx/Shader.h"
 #include "gfx/ShaderParams.h"
 #include "gfx/ShaderBinding.h"
+#include "global/StringId.h"
 
 namespace cs
 {
@@ -20,12 +21,12 @@ namespace cs
 
 		virtual ~ShaderProgram() { }
 
-		virtual void setUniformValueArray(const std::string& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr) = 0;
-		virtual void setUniformValueArray(const std::string& name, int32* value, uint32 count = 0, void* dst = nullptr) = 0;
-		virtual void setUniformValueArray(const std::string& name, vec2* value, uint32 count = 0, void* dst = nullptr) = 0;
-		virtual void setUniformValueArray(const std::string& name, vec3* value, uint32 count = 0, void* dst = nullptr) = 0;
-		virtual void setUniformValueArray(const std::string& name, vec4* value, uint32 count = 0, void* dst = nullptr) = 0;
-		virtual void setUniformValueArray(const std::string& name, mat4* value, uint32 count = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, int32* value, uint32 count = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, vec2* value, uint32 count = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, vec3* value, uint32 count = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, vec4* value, uint32 count = 0, void* dst = nullptr) = 0;
+		virtual void setUniformValueArray(const StringId& name, mat4* value, uint32 count = 0, void* dst = nullptr) = 0;
 
 		virtual void addShader(ShaderPtr& shader);
         virtual ShaderPtr getShader(ShaderType type);
@@ -35,6 +36,13 @@ namespace cs
 
         virtual void* getPipelineDescriptor(const ShaderBindParams& bindParams) { return nullptr; }
 
+		// The linked program as a driver specific blob, false where the backend can't provide one
+		virtual bool getBinary(std::vector<uchar>& data, uint32& format) { return false; }
+		// Links from a blob getBinary returned, false if the driver rejects it
+		virtual bool loadBinary(const std::vector<uchar>& data, uint32 format) { return false; }
+
+		bool isLinked() const { return this->linked; }
+
 	protected:
 
 		bool linked;
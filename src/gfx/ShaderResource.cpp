@@ -2,6 +2,7 @@
 
 #include "gfx/ShaderResource.h"
 #include "gfx/Shader.h"
+#include "gfx/ShaderUtils.h"
 #include "gfx/RenderInterface.h"
 
 #if defined(CS_METAL)
@@ -25,13 +26,14 @@ namespace cs
         , bucket(b)
         , program(nullptr)
         , params(shader_params)
+        , sourceHash(0)
     {
         this->init();
     }
     
 	ShaderResource::~ShaderResource()
 	{
-
+		ShaderCache::dequeue(this);
 	}
     
     ShaderPtr ShaderResource::getShader(ShaderType type)
@@ -45,55 +47,131 @@ namespace cs
 
 	void ShaderResource::refresh()
 	{
+		this->prepare();
+		this->build();
+	}
 
-		ShaderPtr vshader = RenderInterface::getInstance()->loadShader(ShaderVertex, "", this->params.printSource);
-        if (vshader.get())
-            vshader->compile(this->getName(), this->params.vertexSource->getSource(), this->params.printSource);
+	uint64 ShaderResource::getPreparedSource(std::string& vertexSource, std::string& fragmentSource) const
+	{
+		vertexSource = (this->params.vertexSource.get()) ? this->params.vertexSource->getSource() : std::string();
+		fragmentSource = (this->params.fragmentSource.get()) ? this->params.fragmentSource->getSource() : std::string();
 
-		ShaderPtr fshader = RenderInterface::getInstance()->loadShader(ShaderFragment, "", this->params.printSource);
-        if (fshader.get())
-            fshader->compile(this->getName(), this->params.fragmentSource->getSource(), this->params.printSource);
+		ShaderUtils::preprocessSource(vertexSource);
+		ShaderUtils::preprocessSource(fragmentSource);
 
-        if (vshader.get() && fshader.get())
-        {
-            this->program = RenderInterface::getInstance()->createShaderProgram();
-            if (this->program.get())
-            {
-                this->program->addShader(vshader);
-                this->program->addShader(fshader);
-
-                for (const auto& it : this->params.attributes)
-                {
-                    const AttributeType type = (AttributeType)it.first;
-                    const std::string& attrib_name = it.second;
-                    if (!this->program->bindAttributeLocation(attrib_name.c_str(), type))
-                    {
-                        log::error("bindAttributeLocation error for shader ", this->getName());
-                    }
-                    else
-                    {
-                        attributes.push_back(type);
-                    }
-                }
-                this->program->link(&params);
-
-				ShaderBindParams bindParams;
-                this->program->bind(bindParams);
-            }
-            else
-            {
-                log::error("Error creating program!");
-            }
-        }
-    }
+		return ShaderCache::hashProgram(vertexSource, fragmentSource, this->params.attributes);
+	}
+
+	void ShaderResource::prepare()
+	{
+		this->sourceHash = this->getPreparedSource(this->vertexText, this->fragmentText);
+
+		this->cached = ShaderCacheBinary();
+		ShaderCache::read(this->sourceHash, this->cached);
+	}
+
+	void ShaderResource::bindAttributes(ShaderProgramPtr& newProgram)
+	{
+		this->attributes.clear();
+		for (const auto& it : this->params.attributes)
+		{
+			const AttributeType type = (AttributeType)it.first;
+			const std::string& attrib_name = it.second;
+			if (!newProgram->bindAttributeLocation(attrib_name.c_str(), type))
+			{
+				log::error("bindAttributeLocation error for shader ", this->getName());
+			}
+			else
+			{
+				this->attributes.push_back(type);
+			}
+		}
+	}
+
+	void ShaderResource::build()
+	{
+		RenderInterface* render = RenderInterface::getInstance();
+
+		ShaderProgramPtr newProgram;
+		if (!this->cached.isEmpty())
+		{
+			// a binary the driver no longer takes falls through to a compile, which replaces it
+			newProgram = render->createShaderProgram();
+			if (newProgram.get())
+			{
+				this->bindAttributes(newProgram);
+				if (!newProgram->loadBinary(this->cached.data, this->cached.format))
+					newProgram = nullptr;
+			}
+		}
+
+		if (!newProgram.get())
+		{
+			ShaderPtr vshader = render->loadShader(ShaderVertex, "", this->params.printSource);
+			if (vshader.get())
+				vshader->compile(this->getName(), this->vertexText, this->params.printSource);
+
+			ShaderPtr fshader = render->loadShader(ShaderFragment, "", this->params.printSource);
+			if (fshader.get())
+				fshader->compile(this->getName(), this->fragmentText, this->params.printSource);
+
+			if (vshader.get() && fshader.get())
+			{
+				newProgram = render->createShaderProgram();
+				if (newProgram.get())
+				{
+					newProgram->addShader(vshader);
+					newProgram->addShader(fshader);
+
+					this->bindAttributes(newProgram);
+					newProgram->link(&params);
+
+					ShaderCacheBinary binary;
+					if (newProgram->isLinked() && ShaderCache::getDriverHash() != 0 && newProgram->getBinary(binary.data, binary.format))
+						ShaderCache::write(this->sourceHash, binary);
+				}
+				else
+				{
+					log::error("Error creating program!");
+				}
+			}
+		}
+
+		if (newProgram.get())
+		{
+			this->program = newProgram;
+
+			ShaderBindParams bindParams;
+			this->program->bind(bindParams);
+		}
+
+		this->vertexText.clear();
+		this->fragmentText.clear();
+		this->cached = ShaderCacheBinary();
+	}
 
 	void ShaderResource::init()
 	{
+		if (ShaderCache::isWarmingUp())
+		{
+			ShaderCache::queue(this);
+			return;
+		}
 		this->refresh();
 	}
 
 	void ShaderResource::bind(const ShaderBindParams& bindParams, ShaderUniformBindParams& uniformParams)
 	{
+		if (!this->program.get())
+		{
+			// drawn before the warm up it was made in has ended, build it now instead
+			if (ShaderCache::dequeue(this))
+				this->refresh();
+
+			if (!this->program.get())
+				return;
+		}
+
 		// Bind the shader
 		this->program->bind(bindParams, this->name.c_str());
 
@@ -124,38 +202,38 @@ namespace cs
 			{
 				case UniformFloat:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<float32*>(uniform->getData()),
 						uniform->getCount(),
                         1, bufferDst);
 					break;
 				case UniformInt:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<int32*>(uniform->getData()),
 						uniform->getCount(), bufferDst);
 					break;
 				case UniformVec2:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<vec2*>(uniform->getData()),
 						uniform->getCount(), bufferDst);
 					break;
 				case UniformVec3:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<vec3*>(uniform->getData()),
 						uniform->getCount(), bufferDst);
 					break;
 				case UniformVec4:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<vec4*>(uniform->getData()),
 						uniform->getCount(), bufferDst);
 					break;
 				case UniformMat4:
 					this->program->setUniformValueArray(
-						uniform->getName().c_str(),
+						uniform->getNameId(),
 						static_cast<mat4*>(uniform->getData()),
 						uniform->getCount(), bufferDst);
 					break;
@@ -179,11 +257,18 @@ namespace cs
 
 	bool ShaderResource::equals(const ShaderResourcePtr& rhs) const
 	{
+		// resources still waiting on a warm up have no program to share yet
+		if (!this->program.get() || !rhs->getProgram().get())
+			return this == rhs.get();
+
 		return this->program.get() == rhs->getProgram().get();
 	}
 
 	void ShaderResource::update(const Uniform::UpdateParams& updateParams)
 	{
+		if (!this->program.get())
+			return;
+
 		for (UniformList::iterator it = this->params.uniforms.begin(); it != this->params.uniforms.end(); ++it)
 		{
 			UniformPtr& uniformPtr = *it;
@@ -6,6 +6,7 @@
 #include "gfx/ShaderProgram.h"
 #include "gfx/ShaderParams.h"
 #include "gfx/ShaderBinding.h"
+#include "gfx/ShaderCache.h"
 
 #include <string>
 #include <unordered_map>
@@ -42,6 +43,10 @@ namespace cs
 		bool equals(const ShaderResourcePtr& rhs) const;
 		void update(const Uniform::UpdateParams& updateParams);
 
+		// The source each stage is compiled from and its program cache hash
+		uint64 getPreparedSource(std::string& vertexSource, std::string& fragmentSource) const;
+		uint64 getSourceHash() const { return this->sourceHash; }
+
 #if defined(CS_METAL)
         const std::map<uint32, uint32>* getTextureRemap();
         void* getPipelineDescriptor(const ShaderBindParams& bindParams);
@@ -49,13 +54,28 @@ namespace cs
 
 	private:
 
+		friend class ShaderCache;
+
 		void init();
 
+		// Reads the sources and any cached binary, safe off the render thread
+		void prepare();
+
+		// Loads the cached binary, or compiles, links and caches one
+		void build();
+		void bindAttributes(ShaderProgramPtr& newProgram);
+
 		ShaderBucket bucket;
 		ShaderProgramPtr program;
 		ShaderParams params;
 
 		std::vector<AttributeType> attributes;
+
+		// held from prepare to build
+		std::string vertexText;
+		std::string fragmentText;
+		ShaderCacheBinary cached;
+		uint64 sourceHash;
 		
 	};
 
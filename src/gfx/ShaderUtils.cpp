@@ -3,6 +3,7 @@
 #include "gfx/ShaderUtils.h"
 #include "gfx/ShaderResource.h"
 #include "gfx/ShaderHandle.h"
+#include "gfx/ShaderCache.h"
 
 #include "gfx/RenderInterface.h"
 #include "gfx/Mesh.h"
@@ -46,9 +47,19 @@ namespace cs
         for (size_t i = 0; i < kNumRemoveWords; i++)
             removeSubstrs(str, std::string(kRemoveWords[i]));
     }
+
+    void ShaderUtils::preprocessSource(std::string& str)
+    {
+#if defined(CS_WINDOWS)
+        ShaderUtils::removePrecisionQualifiers(str);
+#endif
+        ShaderUtils::replaceOutputFormat(str);
+    }
     
     void ShaderUtils::addDefaultShaders()
     {
+        // built together once they're all declared
+        ShaderCache::beginWarmUp();
       
         // MetalTest
         if (ShaderCompile::shouldCompileShaders(ShaderFlagsTest))
@@ -477,6 +488,54 @@ namespace cs
             
         }
         
+        // Font SDF
+        if (ShaderCompile::shouldCompileShaders(ShaderFlagsFont))
+        {
+            ShaderParams params;
+            params.vertexSource = std::static_pointer_cast<ShaderSource>(CREATE_CLASS(ShaderSourceRaw,
+                "attribute highp vec4 pos;\n"
+                "attribute highp vec4 tex0;\n"
+                "attribute highp vec4 col;\n"
+                "varying highp vec4 vtex0;\n"
+                "varying highp vec4 vcol;\n"
+                "uniform highp mat4 mvp;\n"
+                "void main(void)\n"
+                "{\n"
+                "    gl_Position = mvp * pos;\n"
+                "    vtex0 = tex0;\n"
+                "    vcol = col;\n"
+                "}\n"));
+            params.fragmentSource = std::static_pointer_cast<ShaderSource>(CREATE_CLASS(ShaderSourceRaw,
+                "uniform sampler2D texture0;\n"
+                "varying highp vec4 vtex0;\n"
+                "varying highp vec4 vcol;\n"
+                "uniform highp vec4 color;\n"
+                "uniform highp float smoothing;\n"
+                "void main(void)\n"
+                "{\n"
+                "    highp float dist = texture2D(texture0, vtex0.st).a;\n"
+                "    highp float hp = smoothstep(0.5 - smoothing, 0.5 + smoothing, dist);\n"
+                "    gl_FragColor = vec4(color.rgb * vcol.rgb * hp, vcol.a * color.a * hp);\n"
+                "}\n"));
+            
+            params.attributes[AttribPosition] = "pos";
+            params.attributes[AttribTexCoord0] = "tex0";
+            params.attributes[AttribColor] = "col";
+            
+            params.addUniform(SharedUniform::getInstance().getUniform("mvp"));
+            params.addUniform(SharedUniform::getInstance().getUniform("color"));
+            params.addUniform(CREATE_CLASS(UniformDataFloat, "smoothing", 0.1f, true, ShaderFragment));
+            
+            params.addUniform(CREATE_CLASS(UniformDataTexture, "texture0", TextureStageDiffuse));
+            
+            ShaderResourcePtr shader = CREATE_CLASS(ShaderResource, "defaultFontSDF", ShaderBucketGeometry, params);
+            shader->setFlushable(false);
+            
+            RenderInterface::kDefaultFontSDFShader = CREATE_CLASS(ShaderHandle, shader);
+            ResourceFactory::getInstance()->addResource<ShaderResource>(shader);
+            
+        }
+        
         // Font Outline
         {
             ShaderParams params;
@@ -998,5 +1057,7 @@ namespace cs
 			RenderInterface::kColorOutline = CREATE_CLASS(ShaderHandle, shader);
 			ResourceFactory::getInstance()->addResource<ShaderResource>(shader);
 		}
+
+        ShaderCache::endWarmUp();
     }
 }
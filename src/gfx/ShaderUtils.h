@@ -18,6 +18,9 @@ namespace cs
 
         void replaceOutputFormat(std::string& str);
         void removePrecisionQualifiers(std::string& str);
+
+        // The rewrites a source gets before it's compiled, safe to run twice
+        void preprocessSource(std::string& str);
         void addDefaultShaders();
     }
 }
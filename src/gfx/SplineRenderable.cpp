@@ -10,6 +10,8 @@
 
 namespace cs
 {
+	const StringId kSplineTag("Spline");
+
 	BEGIN_META_CLASS(SplineRenderable)
 		ADD_MEMBER(p0);
 			SET_MEMBER_CALLBACK_POST(&SplineRenderable::updateVolume);
@@ -191,7 +193,7 @@ namespace cs
 	void SplineRenderable::setDrawParams(int32 index, std::vector<DrawCallPtr>& dcs)
 	{
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->tag = "Spline";
+		dc->tag = kSplineTag;
 		dc->type = DrawTriangleStrip;
 		dc->indexType = TypeUnsignedShort;
 		dc->count = static_cast<uint32>(this->maxSize) * 2;
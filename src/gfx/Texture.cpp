@@ -2,6 +2,9 @@
 
 #include "gfx/Texture.h"
 #include "global/ResourceFactory.h"
+#include "gfx/TextureLoader.h"
+#include "os/FileManager.h"
+#include "os/LogManager.h"
 
 namespace cs
 {
@@ -48,6 +51,18 @@ namespace cs
 		return texture.get() != nullptr;
 	}
 
+	bool Texture::cook(const std::string& fileName, TextureCompression compression, bool mips)
+	{
+		std::string filePath;
+		if (!FileManager::getInstance()->getPathToFile(fileName, filePath))
+		{
+			log::error("Cannot find texture ", fileName);
+			return false;
+		}
+
+		return tex::cookTexture(filePath, tex::getCookedPath(filePath), compression, mips);
+	}
+
 
 	uint32 Texture::getWidth() const 
 	{ 
@@ -26,6 +26,9 @@ namespace cs
 
 		static bool preload(const std::string& fileName);
 
+		// Writes fileName's .cstex next to it, picked up by later loads in place of the source
+		static bool cook(const std::string& fileName, TextureCompression compression, bool mips);
+
 	protected:
 
 		Texture(const std::string& name) : Resource(name), textureResource(nullptr) { }
@@ -0,0 +1,834 @@
+#include "PCH.h"
+
+#include "gfx/TextureCompression.h"
+#include "global/TaskQueue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace cs
+{
+	namespace tex
+	{
+		const uint32 kBlockDim = 4;
+		const uint32 kBlockPixels = kBlockDim * kBlockDim;
+
+		const int32 kEtcModifiers[8][4] =
+		{
+			{ 2, 8, -2, -8 },
+			{ 5, 17, -5, -17 },
+			{ 9, 29, -9, -29 },
+			{ 13, 42, -13, -42 },
+			{ 18, 60, -18, -60 },
+			{ 24, 80, -24, -80 },
+			{ 33, 106, -33, -106 },
+			{ 47, 183, -47, -183 }
+		};
+
+		const int32 kEtcDistances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+		const int32 kEacModifiers[16][8] =
+		{
+			{ -3, -6, -9, -15, 2, 5, 8, 14 },
+			{ -3, -7, -10, -13, 2, 6, 9, 12 },
+			{ -2, -5, -8, -13, 1, 4, 7, 12 },
+			{ -2, -4, -6, -13, 1, 3, 5, 12 },
+			{ -3, -6, -8, -12, 2, 5, 7, 11 },
+			{ -3, -7, -9, -11, 2, 6, 8, 10 },
+			{ -4, -7, -8, -11, 3, 6, 7, 10 },
+			{ -3, -5, -8, -11, 2, 4, 7, 10 },
+			{ -2, -6, -8, -10, 1, 5, 7, 9 },
+			{ -2, -5, -8, -10, 1, 4, 7, 9 },
+			{ -2, -4, -8, -10, 1, 3, 7, 9 },
+			{ -2, -5, -7, -10, 1, 4, 6, 9 },
+			{ -3, -4, -7, -10, 2, 3, 6, 9 },
+			{ -1, -2, -3, -10, 0, 1, 2, 9 },
+			{ -4, -6, -8, -9, 3, 5, 7, 8 },
+			{ -3, -5, -7, -9, 2, 4, 6, 8 }
+		};
+
+		static inline int32 clampByte(int32 value)
+		{
+			return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+		}
+
+		static inline int32 colorError(const int32* a, const uchar* b)
+		{
+			int32 dr = a[0] - int32(b[0]);
+			int32 dg = a[1] - int32(b[1]);
+			int32 db = a[2] - int32(b[2]);
+			return dr * dr + dg * dg + db * db;
+		}
+
+		static inline uint64 readBigEndian(const uchar* block)
+		{
+			uint64 bits = 0;
+			for (int32 i = 0; i < 8; ++i)
+				bits = (bits << 8) | block[i];
+			return bits;
+		}
+
+		static inline void writeBigEndian(uint64 bits, uchar* block)
+		{
+			for (int32 i = 7; i >= 0; --i)
+			{
+				block[i] = uchar(bits & 0xFF);
+				bits >>= 8;
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// BC1 / BC3
+
+		static inline uint16 packRGB565(const float32* rgb)
+		{
+			int32 r = clamp<int32>(0, 31, int32(rgb[0] * 31.0f / 255.0f + 0.5f));
+			int32 g = clamp<int32>(0, 63, int32(rgb[1] * 63.0f / 255.0f + 0.5f));
+			int32 b = clamp<int32>(0, 31, int32(rgb[2] * 31.0f / 255.0f + 0.5f));
+			return uint16((r << 11) | (g << 5) | b);
+		}
+
+		static inline void unpackRGB565(uint16 c, int32* rgb)
+		{
+			int32 r = (c >> 11) & 31;
+			int32 g = (c >> 5) & 63;
+			int32 b = c & 31;
+			rgb[0] = (r << 3) | (r >> 2);
+			rgb[1] = (g << 2) | (g >> 4);
+			rgb[2] = (b << 3) | (b >> 2);
+		}
+
+		static void encodeColorBC(const uchar* rgba, uchar* block)
+		{
+			// endpoints at the extremes of the principal axis of the block's colours
+			float32 mean[3] = { 0.0f, 0.0f, 0.0f };
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				for (int32 c = 0; c < 3; ++c)
+					mean[c] += rgba[i * 4 + c];
+			}
+			for (int32 c = 0; c < 3; ++c)
+				mean[c] /= float32(kBlockPixels);
+
+			float32 cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				float32 r = rgba[i * 4 + 0] - mean[0];
+				float32 g = rgba[i * 4 + 1] - mean[1];
+				float32 b = rgba[i * 4 + 2] - mean[2];
+				cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+				cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+			}
+
+			float32 axis[3] = { 1.0f, 1.0f, 1.0f };
+			for (int32 iter = 0; iter < 8; ++iter)
+			{
+				float32 x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+				float32 y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+				float32 z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+				float32 len = std::max<float32>(fabsf(x), std::max<float32>(fabsf(y), fabsf(z)));
+				if (len <= FLT_EPSILON)
+					break;
+
+				axis[0] = x / len;
+				axis[1] = y / len;
+				axis[2] = z / len;
+			}
+
+			float32 minT = FLT_MAX;
+			float32 maxT = -FLT_MAX;
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				float32 t =
+					(rgba[i * 4 + 0] - mean[0]) * axis[0] +
+					(rgba[i * 4 + 1] - mean[1]) * axis[1] +
+					(rgba[i * 4 + 2] - mean[2]) * axis[2];
+				minT = std::min<float32>(minT, t);
+				maxT = std::max<float32>(maxT, t);
+			}
+
+			float32 lenSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			float32 scale = (lenSq > FLT_EPSILON) ? 1.0f / lenSq : 0.0f;
+
+			float32 hi[3];
+			float32 lo[3];
+			for (int32 c = 0; c < 3; ++c)
+			{
+				hi[c] = mean[c] + axis[c] * maxT * scale;
+				lo[c] = mean[c] + axis[c] * minT * scale;
+			}
+
+			uint16 c0 = packRGB565(hi);
+			uint16 c1 = packRGB565(lo);
+			if (c0 < c1)
+				std::swap(c0, c1);
+
+			// c0 > c1 keeps the four colour mode
+			uint32 indices = 0;
+			if (c0 != c1)
+			{
+				int32 palette[4][3];
+				unpackRGB565(c0, palette[0]);
+				unpackRGB565(c1, palette[1]);
+				for (int32 c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+
+				for (uint32 i = 0; i < kBlockPixels; ++i)
+				{
+					uint32 best = 0;
+					int32 bestError = INT32_MAX;
+					for (uint32 p = 0; p < 4; ++p)
+					{
+						int32 error = colorError(palette[p], &rgba[i * 4]);
+						if (error < bestError)
+						{
+							bestError = error;
+							best = p;
+						}
+					}
+					indices |= best << (i * 2);
+				}
+			}
+
+			block[0] = uchar(c0 & 0xFF);
+			block[1] = uchar(c0 >> 8);
+			block[2] = uchar(c1 & 0xFF);
+			block[3] = uchar(c1 >> 8);
+			for (int32 i = 0; i < 4; ++i)
+				block[4 + i] = uchar((indices >> (i * 8)) & 0xFF);
+		}
+
+		static void decodeColorBC(const uchar* block, uchar* rgba, bool punchThrough)
+		{
+			uint16 c0 = uint16(block[0] | (block[1] << 8));
+			uint16 c1 = uint16(block[2] | (block[3] << 8));
+
+			int32 palette[4][4];
+			unpackRGB565(c0, palette[0]);
+			unpackRGB565(c1, palette[1]);
+			palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+			if (c0 > c1 || !punchThrough)
+			{
+				for (int32 c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+			}
+			else
+			{
+				for (int32 c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+					palette[3][c] = 0;
+				}
+				palette[3][3] = 0;
+			}
+
+			uint32 indices = uint32(block[4]) | (uint32(block[5]) << 8) | (uint32(block[6]) << 16) | (uint32(block[7]) << 24);
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				const int32* color = palette[(indices >> (i * 2)) & 3];
+				for (int32 c = 0; c < 4; ++c)
+					rgba[i * 4 + c] = uchar(color[c]);
+			}
+		}
+
+		static void getAlphaPaletteBC(int32 a0, int32 a1, int32* palette)
+		{
+			palette[0] = a0;
+			palette[1] = a1;
+			if (a0 > a1)
+			{
+				for (int32 i = 2; i < 8; ++i)
+					palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+			}
+			else
+			{
+				for (int32 i = 2; i < 6; ++i)
+					palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		static void encodeAlphaBC(const uchar* rgba, uchar* block)
+		{
+			int32 a0 = 0;
+			int32 a1 = 255;
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				a0 = std::max<int32>(a0, rgba[i * 4 + 3]);
+				a1 = std::min<int32>(a1, rgba[i * 4 + 3]);
+			}
+
+			int32 palette[8];
+			getAlphaPaletteBC(a0, a1, palette);
+
+			uint64 indices = 0;
+			if (a0 != a1)
+			{
+				for (uint32 i = 0; i < kBlockPixels; ++i)
+				{
+					uint64 best = 0;
+					int32 bestError = INT32_MAX;
+					for (uint32 p = 0; p < 8; ++p)
+					{
+						int32 error = abs(palette[p] - int32(rgba[i * 4 + 3]));
+						if (error < bestError)
+						{
+							bestError = error;
+							best = p;
+						}
+					}
+					indices |= best << (i * 3);
+				}
+			}
+
+			block[0] = uchar(a0);
+			block[1] = uchar(a1);
+			for (int32 i = 0; i < 6; ++i)
+				block[2 + i] = uchar((indices >> (i * 8)) & 0xFF);
+		}
+
+		static void decodeAlphaBC(const uchar* block, uchar* rgba)
+		{
+			int32 palette[8];
+			getAlphaPaletteBC(block[0], block[1], palette);
+
+			uint64 indices = 0;
+			for (int32 i = 0; i < 6; ++i)
+				indices |= uint64(block[2 + i]) << (i * 8);
+
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+				rgba[i * 4 + 3] = uchar(palette[(indices >> (i * 3)) & 7]);
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+		// ETC2 / EAC
+		//
+		// The encoder only emits the individual and differential modes (plain ETC1, which every
+		// ETC2 decoder accepts); the decoder handles the full format including T, H and planar.
+
+		static inline bool inSubBlock(uint32 pixel, bool flip, uint32 sub)
+		{
+			// pixels are numbered down the columns
+			uint32 x = pixel / kBlockDim;
+			uint32 y = pixel % kBlockDim;
+			return ((flip) ? (y >= 2) : (x >= 2)) == (sub == 1);
+		}
+
+		static inline const uchar* columnPixel(const uchar* rgba, uint32 pixel)
+		{
+			uint32 x = pixel / kBlockDim;
+			uint32 y = pixel % kBlockDim;
+			return &rgba[(y * kBlockDim + x) * 4];
+		}
+
+		static int32 fitEtcSubBlock(const uchar* rgba, bool flip, uint32 sub, const int32* base, uint32& table, uint32& msb, uint32& lsb)
+		{
+			int32 bestError = INT32_MAX;
+			for (uint32 t = 0; t < 8; ++t)
+			{
+				int32 error = 0;
+				uint32 tableMsb = 0;
+				uint32 tableLsb = 0;
+				for (uint32 p = 0; p < kBlockPixels; ++p)
+				{
+					if (!inSubBlock(p, flip, sub))
+						continue;
+
+					const uchar* pixel = columnPixel(rgba, p);
+					int32 pixelBest = INT32_MAX;
+					uint32 pixelIndex = 0;
+					for (uint32 m = 0; m < 4; ++m)
+					{
+						int32 color[3] =
+						{
+							clampByte(base[0] + kEtcModifiers[t][m]),
+							clampByte(base[1] + kEtcModifiers[t][m]),
+							clampByte(base[2] + kEtcModifiers[t][m])
+						};
+						int32 e = colorError(color, pixel);
+						if (e < pixelBest)
+						{
+							pixelBest = e;
+							pixelIndex = m;
+						}
+					}
+
+					error += pixelBest;
+					tableMsb |= ((pixelIndex >> 1) & 1) << p;
+					tableLsb |= (pixelIndex & 1) << p;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					table = t;
+					msb = tableMsb;
+					lsb = tableLsb;
+				}
+			}
+			return bestError;
+		}
+
+		static void encodeETC2RGB(const uchar* rgba, uchar* block)
+		{
+			uint64 bestBits = 0;
+			int32 bestError = INT32_MAX;
+
+			for (uint32 f = 0; f < 2; ++f)
+			{
+				bool flip = f == 1;
+
+				float32 avg[2][3] = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+				for (uint32 p = 0; p < kBlockPixels; ++p)
+				{
+					uint32 sub = inSubBlock(p, flip, 1) ? 1 : 0;
+					const uchar* pixel = columnPixel(rgba, p);
+					for (int32 c = 0; c < 3; ++c)
+						avg[sub][c] += pixel[c] / 8.0f;
+				}
+
+				// differential: 555 base and a 333 signed offset for the second half
+				int32 q5[2][3];
+				bool canDiff = true;
+				for (int32 c = 0; c < 3; ++c)
+				{
+					q5[0][c] = clamp<int32>(0, 31, int32(avg[0][c] * 31.0f / 255.0f + 0.5f));
+					q5[1][c] = clamp<int32>(0, 31, int32(avg[1][c] * 31.0f / 255.0f + 0.5f));
+					int32 d = q5[1][c] - q5[0][c];
+					canDiff = canDiff && d >= -4 && d <= 3;
+				}
+
+				for (uint32 mode = 0; mode < 2; ++mode)
+				{
+					bool diff = mode == 1;
+					if (diff && !canDiff)
+						continue;
+
+					int32 base[2][3];
+					uint64 bits = 0;
+					if (diff)
+					{
+						for (int32 c = 0; c < 3; ++c)
+						{
+							base[0][c] = (q5[0][c] << 3) | (q5[0][c] >> 2);
+							base[1][c] = (q5[1][c] << 3) | (q5[1][c] >> 2);
+
+							uint64 d = uint64((q5[1][c] - q5[0][c]) & 7);
+							bits |= uint64(q5[0][c]) << (59 - c * 8);
+							bits |= d << (56 - c * 8);
+						}
+						bits |= uint64(1) << 33;
+					}
+					else
+					{
+						for (int32 c = 0; c < 3; ++c)
+						{
+							int32 q0 = clamp<int32>(0, 15, int32(avg[0][c] * 15.0f / 255.0f + 0.5f));
+							int32 q1 = clamp<int32>(0, 15, int32(avg[1][c] * 15.0f / 255.0f + 0.5f));
+							base[0][c] = (q0 << 4) | q0;
+							base[1][c] = (q1 << 4) | q1;
+
+							bits |= uint64(q0) << (60 - c * 8);
+							bits |= uint64(q1) << (56 - c * 8);
+						}
+					}
+
+					uint32 table[2];
+					uint32 msb[2];
+					uint32 lsb[2];
+					int32 error =
+						fitEtcSubBlock(rgba, flip, 0, base[0], table[0], msb[0], lsb[0]) +
+						fitEtcSubBlock(rgba, flip, 1, base[1], table[1], msb[1], lsb[1]);
+
+					if (error < bestError)
+					{
+						bits |= uint64(table[0]) << 37;
+						bits |= uint64(table[1]) << 34;
+						bits |= uint64(flip ? 1 : 0) << 32;
+						bits |= uint64(msb[0] | msb[1]) << 16;
+						bits |= uint64(lsb[0] | lsb[1]);
+
+						bestError = error;
+						bestBits = bits;
+					}
+				}
+			}
+
+			writeBigEndian(bestBits, block);
+		}
+
+		static inline int32 signExtend3(int32 value)
+		{
+			return (value & 4) ? value - 8 : value;
+		}
+
+		static inline int32 extend4(int32 value) { return (value << 4) | value; }
+		static inline int32 extend5(int32 value) { return (value << 3) | (value >> 2); }
+		static inline int32 extend6(int32 value) { return (value << 2) | (value >> 4); }
+		static inline int32 extend7(int32 value) { return (value << 1) | (value >> 6); }
+
+		static inline void writeColumnPixel(uchar* rgba, uint32 pixel, const int32* color)
+		{
+			uchar* dst = const_cast<uchar*>(columnPixel(rgba, pixel));
+			dst[0] = uchar(clampByte(color[0]));
+			dst[1] = uchar(clampByte(color[1]));
+			dst[2] = uchar(clampByte(color[2]));
+			dst[3] = 255;
+		}
+
+		static void decodeETC2Paint(uint64 bits, const int32 paint[4][3], uchar* rgba)
+		{
+			for (uint32 p = 0; p < kBlockPixels; ++p)
+			{
+				uint32 index = uint32(((bits >> (16 + p)) & 1) << 1) | uint32((bits >> p) & 1);
+				writeColumnPixel(rgba, p, paint[index]);
+			}
+		}
+
+		static void decodeETC2RGB(const uchar* block, uchar* rgba)
+		{
+			uint64 bits = readBigEndian(block);
+			bool diff = ((bits >> 33) & 1) != 0;
+			bool flip = ((bits >> 32) & 1) != 0;
+
+			int32 base[2][3];
+			if (!diff)
+			{
+				for (int32 c = 0; c < 3; ++c)
+				{
+					base[0][c] = extend4(int32((bits >> (60 - c * 8)) & 15));
+					base[1][c] = extend4(int32((bits >> (56 - c * 8)) & 15));
+				}
+			}
+			else
+			{
+				int32 q0[3];
+				int32 q1[3];
+				for (int32 c = 0; c < 3; ++c)
+				{
+					q0[c] = int32((bits >> (59 - c * 8)) & 31);
+					q1[c] = q0[c] + signExtend3(int32((bits >> (56 - c * 8)) & 7));
+				}
+
+				if (q1[0] < 0 || q1[0] > 31)
+				{
+					// T mode
+					int32 paint[4][3];
+					int32 c1[3] =
+					{
+						extend4(int32((((bits >> 59) & 3) << 2) | ((bits >> 56) & 3))),
+						extend4(int32((bits >> 52) & 15)),
+						extend4(int32((bits >> 48) & 15))
+					};
+					int32 c2[3] =
+					{
+						extend4(int32((bits >> 44) & 15)),
+						extend4(int32((bits >> 40) & 15)),
+						extend4(int32((bits >> 36) & 15))
+					};
+					int32 d = kEtcDistances[(((bits >> 34) & 3) << 1) | ((bits >> 32) & 1)];
+					for (int32 c = 0; c < 3; ++c)
+					{
+						paint[0][c] = c1[c];
+						paint[1][c] = c2[c] + d;
+						paint[2][c] = c2[c];
+						paint[3][c] = c2[c] - d;
+					}
+					decodeETC2Paint(bits, paint, rgba);
+					return;
+				}
+
+				if (q1[1] < 0 || q1[1] > 31)
+				{
+					// H mode
+					int32 paint[4][3];
+					int32 c1[3] =
+					{
+						extend4(int32((bits >> 59) & 15)),
+						extend4(int32((((bits >> 56) & 7) << 1) | ((bits >> 52) & 1))),
+						extend4(int32((((bits >> 51) & 1) << 3) | ((bits >> 47) & 7)))
+					};
+					int32 c2[3] =
+					{
+						extend4(int32((bits >> 43) & 15)),
+						extend4(int32((bits >> 39) & 15)),
+						extend4(int32((bits >> 35) & 15))
+					};
+					int32 v1 = (c1[0] << 16) | (c1[1] << 8) | c1[2];
+					int32 v2 = (c2[0] << 16) | (c2[1] << 8) | c2[2];
+					int32 d = kEtcDistances[(((bits >> 34) & 1) << 2) | (((bits >> 32) & 1) << 1) | ((v1 >= v2) ? 1 : 0)];
+					for (int32 c = 0; c < 3; ++c)
+					{
+						paint[0][c] = c1[c] + d;
+						paint[1][c] = c1[c] - d;
+						paint[2][c] = c2[c] + d;
+						paint[3][c] = c2[c] - d;
+					}
+					decodeETC2Paint(bits, paint, rgba);
+					return;
+				}
+
+				if (q1[2] < 0 || q1[2] > 31)
+				{
+					// planar, a gradient from three corner colours
+					int32 o[3] =
+					{
+						extend6(int32((bits >> 57) & 63)),
+						extend7(int32((((bits >> 56) & 1) << 6) | ((bits >> 49) & 63))),
+						extend6(int32((((bits >> 48) & 1) << 5) | (((bits >> 43) & 3) << 3) | ((bits >> 39) & 7)))
+					};
+					int32 h[3] =
+					{
+						extend6(int32((((bits >> 34) & 31) << 1) | ((bits >> 32) & 1))),
+						extend7(int32((bits >> 25) & 127)),
+						extend6(int32((bits >> 19) & 63))
+					};
+					int32 v[3] =
+					{
+						extend6(int32((bits >> 13) & 63)),
+						extend7(int32((bits >> 6) & 127)),
+						extend6(int32(bits & 63))
+					};
+
+					for (uint32 p = 0; p < kBlockPixels; ++p)
+					{
+						int32 x = int32(p / kBlockDim);
+						int32 y = int32(p % kBlockDim);
+						int32 color[3];
+						for (int32 c = 0; c < 3; ++c)
+							color[c] = (x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2;
+						writeColumnPixel(rgba, p, color);
+					}
+					return;
+				}
+
+				for (int32 c = 0; c < 3; ++c)
+				{
+					base[0][c] = extend5(q0[c]);
+					base[1][c] = extend5(q1[c]);
+				}
+			}
+
+			uint32 table[2] = { uint32((bits >> 37) & 7), uint32((bits >> 34) & 7) };
+			for (uint32 p = 0; p < kBlockPixels; ++p)
+			{
+				uint32 sub = inSubBlock(p, flip, 1) ? 1 : 0;
+				uint32 index = uint32(((bits >> (16 + p)) & 1) << 1) | uint32((bits >> p) & 1);
+				int32 modifier = kEtcModifiers[table[sub]][index];
+
+				int32 color[3] = { base[sub][0] + modifier, base[sub][1] + modifier, base[sub][2] + modifier };
+				writeColumnPixel(rgba, p, color);
+			}
+		}
+
+		static int32 fitEAC(const uchar* rgba, int32 base, int32 mult, uint32 table, uint64& indices)
+		{
+			int32 error = 0;
+			indices = 0;
+			for (uint32 p = 0; p < kBlockPixels; ++p)
+			{
+				int32 alpha = columnPixel(rgba, p)[3];
+				int32 best = INT32_MAX;
+				uint64 bestIndex = 0;
+				for (uint32 m = 0; m < 8; ++m)
+				{
+					int32 e = abs(clampByte(base + kEacModifiers[table][m] * mult) - alpha);
+					if (e < best)
+					{
+						best = e;
+						bestIndex = m;
+					}
+				}
+				error += best * best;
+				indices |= bestIndex << (45 - p * 3);
+			}
+			return error;
+		}
+
+		static void encodeEAC(const uchar* rgba, uchar* block)
+		{
+			int32 minA = 255;
+			int32 maxA = 0;
+			for (uint32 i = 0; i < kBlockPixels; ++i)
+			{
+				minA = std::min<int32>(minA, rgba[i * 4 + 3]);
+				maxA = std::max<int32>(maxA, rgba[i * 4 + 3]);
+			}
+
+			// per table, stretch the modifiers across the block's range and try the neighbours
+			uint64 bestBits = 0;
+			int32 bestError = INT32_MAX;
+			for (uint32 t = 0; t < 16 && bestError > 0; ++t)
+			{
+				int32 low = kEacModifiers[t][3];
+				int32 span = kEacModifiers[t][7] - low;
+				int32 fit = std::max<int32>(1, (maxA - minA + span - 1) / span);
+
+				for (int32 mult = std::max<int32>(1, fit - 1); mult <= std::min<int32>(15, fit + 1); ++mult)
+				{
+					int32 base = clampByte(minA - low * mult);
+					uint64 indices = 0;
+					int32 error = fitEAC(rgba, base, mult, t, indices);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestBits = (uint64(base) << 56) | (uint64(mult) << 52) | (uint64(t) << 48) | indices;
+					}
+				}
+			}
+
+			writeBigEndian(bestBits, block);
+		}
+
+		static void decodeEAC(const uchar* block, uchar* rgba)
+		{
+			uint64 bits = readBigEndian(block);
+			int32 base = int32(bits >> 56);
+			int32 mult = int32((bits >> 52) & 15);
+			uint32 table = uint32((bits >> 48) & 15);
+
+			for (uint32 p = 0; p < kBlockPixels; ++p)
+			{
+				uint32 index = uint32((bits >> (45 - p * 3)) & 7);
+				uchar* dst = const_cast<uchar*>(columnPixel(rgba, p));
+				dst[3] = uchar(clampByte(base + kEacModifiers[table][index] * mult));
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////
+
+		bool hasAlpha(TextureCompression compression)
+		{
+			return compression == TextureCompressionBC3 || compression == TextureCompressionETC2RGBA;
+		}
+
+		size_t getCompressedSize(TextureCompression compression, uint32 width, uint32 height)
+		{
+			size_t blocksX = (width + kBlockDim - 1) / kBlockDim;
+			size_t blocksY = (height + kBlockDim - 1) / kBlockDim;
+			return blocksX * blocksY * getTextureBlockSize(compression);
+		}
+
+		void encodeBlock(TextureCompression compression, const uchar* rgba, uchar* block)
+		{
+			switch (compression)
+			{
+				case TextureCompressionBC1:
+					encodeColorBC(rgba, block);
+					break;
+				case TextureCompressionBC3:
+					encodeAlphaBC(rgba, block);
+					encodeColorBC(rgba, block + 8);
+					break;
+				case TextureCompressionETC2RGB:
+					encodeETC2RGB(rgba, block);
+					break;
+				case TextureCompressionETC2RGBA:
+					encodeEAC(rgba, block);
+					encodeETC2RGB(rgba, block + 8);
+					break;
+				default:
+					assert(false);
+			}
+		}
+
+		void decodeBlock(TextureCompression compression, const uchar* block, uchar* rgba)
+		{
+			switch (compression)
+			{
+				case TextureCompressionBC1:
+					decodeColorBC(block, rgba, true);
+					break;
+				case TextureCompressionBC3:
+					decodeColorBC(block + 8, rgba, false);
+					decodeAlphaBC(block, rgba);
+					break;
+				case TextureCompressionETC2RGB:
+					decodeETC2RGB(block, rgba);
+					break;
+				case TextureCompressionETC2RGBA:
+					decodeETC2RGB(block + 8, rgba);
+					decodeEAC(block, rgba);
+					break;
+				default:
+					assert(false);
+			}
+		}
+
+		void compressImage(TextureCompression compression, const uchar* rgba, uint32 width, uint32 height, std::vector<uchar>& out)
+		{
+			uint32 blocksX = (width + kBlockDim - 1) / kBlockDim;
+			uint32 blocksY = (height + kBlockDim - 1) / kBlockDim;
+			size_t blockSize = getTextureBlockSize(compression);
+			out.resize(getCompressedSize(compression, width, height));
+
+			// rows of blocks are independent, partial blocks repeat their edge pixels
+			auto encodeRow = [&](uint32 by)
+			{
+				uchar pixels[kBlockPixels * 4];
+				for (uint32 bx = 0; bx < blocksX; ++bx)
+				{
+					for (uint32 y = 0; y < kBlockDim; ++y)
+					{
+						uint32 sy = std::min<uint32>(by * kBlockDim + y, height - 1);
+						for (uint32 x = 0; x < kBlockDim; ++x)
+						{
+							uint32 sx = std::min<uint32>(bx * kBlockDim + x, width - 1);
+							memcpy(&pixels[(y * kBlockDim + x) * 4], &rgba[(size_t(sy) * width + sx) * 4], 4);
+						}
+					}
+					encodeBlock(compression, pixels, &out[(size_t(by) * blocksX + bx) * blockSize]);
+				}
+			};
+
+			if (blocksY > 1)
+			{
+				TaskQueue::getInstance()->parallel(blocksY, encodeRow);
+			}
+			else
+			{
+				encodeRow(0);
+			}
+		}
+
+		void decompressImage(TextureCompression compression, const uchar* data, uint32 width, uint32 height, uchar* out)
+		{
+			uint32 blocksX = (width + kBlockDim - 1) / kBlockDim;
+			uint32 blocksY = (height + kBlockDim - 1) / kBlockDim;
+			size_t blockSize = getTextureBlockSize(compression);
+			uint32 channels = hasAlpha(compression) ? 4 : 3;
+
+			uchar pixels[kBlockPixels * 4];
+			for (uint32 by = 0; by < blocksY; ++by)
+			{
+				for (uint32 bx = 0; bx < blocksX; ++bx)
+				{
+					decodeBlock(compression, &data[(size_t(by) * blocksX + bx) * blockSize], pixels);
+
+					uint32 maxY = std::min<uint32>(kBlockDim, height - by * kBlockDim);
+					uint32 maxX = std::min<uint32>(kBlockDim, width - bx * kBlockDim);
+					for (uint32 y = 0; y < maxY; ++y)
+					{
+						uchar* dst = &out[((size_t(by * kBlockDim + y) * width) + bx * kBlockDim) * channels];
+						for (uint32 x = 0; x < maxX; ++x)
+						{
+							memcpy(dst + x * channels, &pixels[(y * kBlockDim + x) * 4], channels);
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "global/Values.h"
+#include "gfx/TypesGlobal.h"
+
+#include <vector>
+
+namespace cs
+{
+	namespace tex
+	{
+		// Bytes taken by a width x height image, partial blocks round up
+		size_t getCompressedSize(TextureCompression compression, uint32 width, uint32 height);
+
+		// Whether the decoded image carries alpha
+		bool hasAlpha(TextureCompression compression);
+
+		// rgba is width x height, 4 bytes a pixel.  Encoding is for the offline cooker, it favours
+		// a predictable result over the slower exhaustive searches.
+		void compressImage(TextureCompression compression, const uchar* rgba, uint32 width, uint32 height, std::vector<uchar>& out);
+
+		// Decodes to 4 bytes a pixel when the format has alpha, 3 otherwise
+		void decompressImage(TextureCompression compression, const uchar* data, uint32 width, uint32 height, uchar* out);
+
+		// A single 4x4 block, rgba holds 16 pixels in rows
+		void encodeBlock(TextureCompression compression, const uchar* rgba, uchar* block);
+		void decodeBlock(TextureCompression compression, const uchar* block, uchar* rgba);
+	}
+}
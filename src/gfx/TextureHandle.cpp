@@ -361,6 +361,15 @@ namespace cs
 		return this->texture->getName();
 	}
 
+	const StringId& TextureHandle::getTextureTag() const
+	{
+		static const StringId kEmptyTextureTag("empty_texture");
+		if (!this->texture)
+			return kEmptyTextureTag;
+
+		return this->texture->getNameId();
+	}
+
 	void TextureHandle::onTextureChanged()
 	{
 		this->onChanged.invoke();
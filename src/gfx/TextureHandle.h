@@ -107,6 +107,7 @@ namespace cs
 		virtual ~TextureHandle();
 
 		const std::string getTextureName() const;
+		const StringId& getTextureTag() const;
 		const TexturePtr& getTexture() { return this->texture; }
 		bool hasTexture() { return this->texture != nullptr; }
 
@@ -1,15 +1,92 @@
 #include "PCH.h"
 
 #include "gfx/TextureLoader.h"
+#include "gfx/TextureCompression.h"
+#include "global/Utils.h"
+#include "os/FileManager.h"
 #include "os/LogManager.h"
 
 #include <SDL.h>
 #include <SDL_image.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
 namespace cs
 {
 	namespace tex
 	{
+		const uint32 kCookedMagic = 0x58545343;	// "CSTX"
+		const uint32 kCookedVersion = 1;
+		const char* kCookedExtension = ".cstex";
+
+		namespace
+		{
+			bool getSourceInfo(const std::string& filePath, uint64& size, int64& time)
+			{
+#if defined(CS_WINDOWS)
+				struct _stat info;
+				if (_stat(filePath.c_str(), &info) != 0)
+					return false;
+#else
+				struct stat info;
+				if (stat(filePath.c_str(), &info) != 0)
+					return false;
+#endif
+				size = uint64(info.st_size);
+				time = int64(info.st_mtime);
+				return true;
+			}
+
+			template <typename T>
+			void writeValue(std::vector<uchar>& buffer, const T& value)
+			{
+				const uchar* bytes = reinterpret_cast<const uchar*>(&value);
+				buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+			}
+
+			template <typename T>
+			bool readValue(const std::vector<uchar>& buffer, size_t& offset, T& value)
+			{
+				if (offset + sizeof(T) > buffer.size())
+					return false;
+
+				memcpy(&value, &buffer[offset], sizeof(T));
+				offset += sizeof(T);
+				return true;
+			}
+
+			// 2x2 box filter, a dimension already at 1 is only filtered along the other
+			void downsample(const uchar* src, uint32 srcWidth, uint32 srcHeight, uchar* dst, uint32 channels)
+			{
+				uint32 dstWidth = std::max<uint32>(1, srcWidth / 2);
+				uint32 dstHeight = std::max<uint32>(1, srcHeight / 2);
+				for (uint32 y = 0; y < dstHeight; ++y)
+				{
+					uint32 y0 = std::min<uint32>(y * 2, srcHeight - 1);
+					uint32 y1 = std::min<uint32>(y * 2 + 1, srcHeight - 1);
+					for (uint32 x = 0; x < dstWidth; ++x)
+					{
+						uint32 x0 = std::min<uint32>(x * 2, srcWidth - 1);
+						uint32 x1 = std::min<uint32>(x * 2 + 1, srcWidth - 1);
+						for (uint32 c = 0; c < channels; ++c)
+						{
+							uint32 sum =
+								src[(y0 * srcWidth + x0) * channels + c] +
+								src[(y0 * srcWidth + x1) * channels + c] +
+								src[(y1 * srcWidth + x0) * channels + c] +
+								src[(y1 * srcWidth + x1) * channels + c];
+							dst[(y * dstWidth + x) * channels + c] = uchar((sum + 2) / 4);
+						}
+					}
+				}
+			}
+		}
+
 		uchar* loadImage(const std::string& filePath, uint32& width, uint32& height, TextureChannels& channels)
 		{
 			SDL_Surface* surface = IMG_Load(filePath.c_str());
@@ -43,5 +120,274 @@ namespace cs
 
 			return data;
 		}
+
+		std::string getCookedPath(const std::string& filePath)
+		{
+			// only look past the last separator, directories may have dots in them
+			size_t start = 0;
+			for (size_t i = 0; i < filePath.length(); ++i)
+			{
+				if (FileManager::isSeparator(filePath[i]))
+					start = i + 1;
+			}
+
+			size_t dot = filePath.find_last_of('.');
+			if (dot == std::string::npos || dot < start)
+				return filePath + kCookedExtension;
+			return filePath.substr(0, dot) + kCookedExtension;
+		}
+
+		bool writeCooked(const std::string& path, const TextureImage& image)
+		{
+			std::vector<uchar> buffer;
+			buffer.reserve(image.data.size() + 128);
+
+			writeValue(buffer, kCookedMagic);
+			writeValue(buffer, kCookedVersion);
+			writeValue(buffer, image.sourceSize);
+			writeValue(buffer, image.sourceTime);
+			writeValue(buffer, image.width);
+			writeValue(buffer, image.height);
+			writeValue(buffer, image.contentWidth);
+			writeValue(buffer, image.contentHeight);
+			writeValue(buffer, int32(image.channels));
+			writeValue(buffer, int32(image.compression));
+
+			writeValue(buffer, uint32(image.mips.size()));
+			for (auto& mip : image.mips)
+			{
+				writeValue(buffer, mip.width);
+				writeValue(buffer, mip.height);
+				writeValue(buffer, mip.offset);
+				writeValue(buffer, mip.size);
+			}
+
+			writeValue(buffer, uint64(image.data.size()));
+			buffer.insert(buffer.end(), image.data.begin(), image.data.end());
+
+			std::ofstream out(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out.is_open())
+				return false;
+
+			out.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size()));
+			bool ok = out.good();
+			out.close();
+			return ok;
+		}
+
+		bool readCooked(const std::string& path, TextureImage& image)
+		{
+			std::ifstream in(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+			if (!in.is_open())
+				return false;
+
+			std::streamsize fileSize = in.tellg();
+			if (fileSize <= 0)
+				return false;
+
+			std::vector<uchar> buffer(static_cast<size_t>(fileSize));
+			in.seekg(0, std::ios::beg);
+			if (!in.read(reinterpret_cast<char*>(buffer.data()), fileSize))
+				return false;
+			in.close();
+
+			size_t offset = 0;
+			uint32 magic = 0;
+			uint32 version = 0;
+			if (!readValue(buffer, offset, magic) || magic != kCookedMagic ||
+				!readValue(buffer, offset, version) || version != kCookedVersion)
+				return false;
+
+			int32 channels = TextureNone;
+			int32 compression = TextureCompressionNone;
+			uint32 numMips = 0;
+			bool ok =
+				readValue(buffer, offset, image.sourceSize) &&
+				readValue(buffer, offset, image.sourceTime) &&
+				readValue(buffer, offset, image.width) &&
+				readValue(buffer, offset, image.height) &&
+				readValue(buffer, offset, image.contentWidth) &&
+				readValue(buffer, offset, image.contentHeight) &&
+				readValue(buffer, offset, channels) &&
+				readValue(buffer, offset, compression) &&
+				readValue(buffer, offset, numMips);
+
+			if (!ok || numMips == 0 || numMips > 32 ||
+				(channels != TextureRGB && channels != TextureRGBA) ||
+				compression < TextureCompressionNone || compression >= TextureCompressionMAX)
+				return false;
+
+			image.channels = TextureChannels(channels);
+			image.compression = TextureCompression(compression);
+
+			image.mips.resize(numMips);
+			for (auto& mip : image.mips)
+			{
+				ok = ok &&
+					readValue(buffer, offset, mip.width) &&
+					readValue(buffer, offset, mip.height) &&
+					readValue(buffer, offset, mip.offset) &&
+					readValue(buffer, offset, mip.size);
+			}
+
+			uint64 dataSize = 0;
+			if (!ok || !readValue(buffer, offset, dataSize) || dataSize != buffer.size() - offset)
+				return false;
+
+			// every mip has to sit inside the data and be the size its format says
+			for (auto& mip : image.mips)
+			{
+				uint64 expected = (image.compression != TextureCompressionNone) ?
+					getCompressedSize(image.compression, mip.width, mip.height) :
+					uint64(mip.width) * mip.height * getTextureSize(image.channels);
+				if (mip.size != expected || mip.offset > dataSize || mip.size > dataSize - mip.offset)
+					return false;
+			}
+
+			image.data.assign(buffer.begin() + offset, buffer.end());
+			return true;
+		}
+
+		bool loadCooked(const std::string& filePath, TextureImage& image)
+		{
+			if (FileManager::getExtension(filePath) == std::string(kCookedExtension + 1))
+				return readCooked(filePath, image);
+
+			std::string cookedPath = getCookedPath(filePath);
+			if (!readCooked(cookedPath, image))
+				return false;
+
+			uint64 sourceSize = 0;
+			int64 sourceTime = 0;
+			if (getSourceInfo(filePath, sourceSize, sourceTime) &&
+				(sourceSize != image.sourceSize || sourceTime != image.sourceTime))
+			{
+				log::warning("Ignoring stale cooked texture ", cookedPath);
+				image = TextureImage();
+				return false;
+			}
+
+			return true;
+		}
+
+		void decompress(TextureImage& image)
+		{
+			if (image.compression == TextureCompressionNone)
+				return;
+
+			uint32 channels = hasAlpha(image.compression) ? 4 : 3;
+
+			std::vector<TextureMip> mips = image.mips;
+			std::vector<uchar> data;
+			for (auto& mip : mips)
+			{
+				uint64 size = uint64(mip.width) * mip.height * channels;
+				size_t offset = data.size();
+				data.resize(offset + size_t(size));
+				decompressImage(image.compression, &image.data[size_t(mip.offset)], mip.width, mip.height, &data[offset]);
+
+				mip.offset = offset;
+				mip.size = size;
+			}
+
+			image.mips.swap(mips);
+			image.data.swap(data);
+			image.channels = (channels == 4) ? TextureRGBA : TextureRGB;
+			image.compression = TextureCompressionNone;
+		}
+
+		bool cookTexture(const std::string& srcPath, const std::string& dstPath, TextureCompression compression, bool mips)
+		{
+			SDL_Surface* surface = IMG_Load(srcPath.c_str());
+			if (!surface)
+			{
+				log::print(LogError, "Failed to load: ", srcPath);
+				return false;
+			}
+
+			bool sourceAlpha = SDL_ISPIXELFORMAT_ALPHA(surface->format->format) || surface->format->Amask != 0;
+			SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+			SDL_FreeSurface(surface);
+			if (!converted)
+			{
+				log::print(LogError, "Failed to convert: ", srcPath);
+				return false;
+			}
+
+			if (sourceAlpha && compression != TextureCompressionNone && !hasAlpha(compression))
+				log::warning("Cooking ", srcPath, " drops its alpha channel");
+
+			TextureImage image;
+			getSourceInfo(srcPath, image.sourceSize, image.sourceTime);
+			image.contentWidth = uint32(converted->w);
+			image.contentHeight = uint32(converted->h);
+			image.width = checkPow2(image.contentWidth) ? image.contentWidth : nextPow2(image.contentWidth);
+			image.height = checkPow2(image.contentHeight) ? image.contentHeight : nextPow2(image.contentHeight);
+			image.compression = compression;
+			image.channels = (compression == TextureCompressionNone) ?
+				((sourceAlpha) ? TextureRGBA : TextureRGB) :
+				((hasAlpha(compression)) ? TextureRGBA : TextureRGB);
+
+			// the padding repeats the edge so filtering and mips don't bleed black in
+			std::vector<uchar> level(size_t(image.width) * image.height * 4);
+			SDL_LockSurface(converted);
+			for (uint32 y = 0; y < image.height; ++y)
+			{
+				const uchar* row = static_cast<const uchar*>(converted->pixels) +
+					size_t(std::min<uint32>(y, image.contentHeight - 1)) * converted->pitch;
+				uchar* dst = &level[size_t(y) * image.width * 4];
+				memcpy(dst, row, image.contentWidth * 4);
+				for (uint32 x = image.contentWidth; x < image.width; ++x)
+					memcpy(dst + x * 4, row + (image.contentWidth - 1) * 4, 4);
+			}
+			SDL_UnlockSurface(converted);
+			SDL_FreeSurface(converted);
+
+			uint32 mipWidth = image.width;
+			uint32 mipHeight = image.height;
+			std::vector<uchar> block;
+			std::vector<uchar> next;
+			for (;;)
+			{
+				TextureMip mip;
+				mip.width = mipWidth;
+				mip.height = mipHeight;
+				mip.offset = image.data.size();
+
+				if (compression != TextureCompressionNone)
+				{
+					compressImage(compression, level.data(), mipWidth, mipHeight, block);
+					image.data.insert(image.data.end(), block.begin(), block.end());
+				}
+				else
+				{
+					uint32 channels = getTextureSize(image.channels);
+					for (size_t p = 0; p < size_t(mipWidth) * mipHeight; ++p)
+						image.data.insert(image.data.end(), &level[p * 4], &level[p * 4] + channels);
+				}
+
+				mip.size = image.data.size() - mip.offset;
+				image.mips.push_back(mip);
+
+				if (!mips || (mipWidth == 1 && mipHeight == 1))
+					break;
+
+				next.resize(size_t(std::max<uint32>(1, mipWidth / 2)) * std::max<uint32>(1, mipHeight / 2) * 4);
+				downsample(level.data(), mipWidth, mipHeight, next.data(), 4);
+				level.swap(next);
+
+				mipWidth = std::max<uint32>(1, mipWidth / 2);
+				mipHeight = std::max<uint32>(1, mipHeight / 2);
+			}
+
+			if (!writeCooked(dstPath, image))
+			{
+				log::error("Could not write cooked texture ", dstPath);
+				return false;
+			}
+
+			log::info("Cooked ", srcPath, " to ", dstPath, " (", image.mips.size(), " mips, ", image.data.size(), " bytes)");
+			return true;
+		}
 	}
 }
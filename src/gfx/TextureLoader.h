@@ -4,11 +4,67 @@
 #include "gfx/Types.h"
 
 #include <string>
+#include <vector>
 
 namespace cs
 {
 	namespace tex
 	{
 		uchar* loadImage(const std::string& filePath, uint32& width, uint32& height, TextureChannels& channels);
+
+		struct TextureMip
+		{
+			uint32 width;
+			uint32 height;
+			uint64 offset;
+			uint64 size;
+		};
+
+		// A cooked texture: a power of two mip chain, compressed or raw RGB/RGBA
+		struct TextureImage
+		{
+			TextureImage()
+				: width(0)
+				, height(0)
+				, contentWidth(0)
+				, contentHeight(0)
+				, channels(TextureNone)
+				, compression(TextureCompressionNone)
+				, sourceSize(0)
+				, sourceTime(0)
+			{ }
+
+			uint32 width;
+			uint32 height;
+			uint32 contentWidth;	// the source image inside mip 0, the rest is edge padding
+			uint32 contentHeight;
+			TextureChannels channels;	// once decoded, TextureRGB or TextureRGBA
+			TextureCompression compression;
+
+			uint64 sourceSize;
+			int64 sourceTime;
+
+			std::vector<TextureMip> mips;
+			std::vector<uchar> data;
+		};
+
+		// Cooked textures (.cstex) are looked for next to the source image and used in place of
+		// it when present and current.  Blocks are uploaded as they are, decompress() is the
+		// fallback for a format the device can't sample.
+		extern const char* kCookedExtension;
+
+		std::string getCookedPath(const std::string& filePath);
+
+		bool readCooked(const std::string& path, TextureImage& image);
+		bool writeCooked(const std::string& path, const TextureImage& image);
+
+		// filePath is either a .cstex or a source image with a cooked sibling
+		bool loadCooked(const std::string& filePath, TextureImage& image);
+
+		// Expands every mip to raw RGB/RGBA in place
+		void decompress(TextureImage& image);
+
+		// Offline: pads to a power of two, builds the mip chain (when mips is set) and compresses
+		bool cookTexture(const std::string& srcPath, const std::string& dstPath, TextureCompression compression, bool mips = true);
 	}
-}
\ No newline at end of file
+}
@@ -10,6 +10,8 @@
 
 namespace cs
 {
+	const StringId kTrailTag("Spline");
+
 	BEGIN_META_CLASS(TrailRenderable)
 	
 	END_META()
@@ -159,7 +161,7 @@ namespace cs
 	void TrailRenderable::setDrawParams(int32 index, std::vector<DrawCallPtr>& dcs)
 	{
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->tag = "Spline";
+		dc->tag = kTrailTag;
 		dc->type = DrawTriangleStrip;
 		dc->indexType = TypeUnsignedShort;
 		dc->count = static_cast<uint32>(this->curSize) * 2;
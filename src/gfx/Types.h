@@ -52,6 +52,7 @@ namespace cs
 
 	extern uint32 kTextureConvertSrc[];
 	extern uint32 kTextureConvertDst[];
+	extern uint32 kTextureCompressionConvert[];
 
 	enum TextureStageNum
 	{
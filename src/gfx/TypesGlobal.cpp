@@ -50,6 +50,20 @@ unsigned getTextureSize(TextureChannels channels)
 	return kTextureSize[channels];
 }
 
+unsigned kTextureBlockSize[] =
+{
+    8,  // TextureCompressionBC1
+    16, // TextureCompressionBC3
+    8,  // TextureCompressionETC2RGB
+    16, // TextureCompressionETC2RGBA
+};
+
+unsigned getTextureBlockSize(TextureCompression compression)
+{
+	assert(sizeof(kTextureBlockSize) / sizeof(kTextureBlockSize[0]) == TextureCompressionMAX);
+	return kTextureBlockSize[compression];
+}
+
 int getTypeSize(Type type)
 {
     switch(type)
@@ -119,6 +119,17 @@ enum TextureChannels
     TextureMAX
 };
 
+// 4x4 block formats carried by cooked textures, see tex::loadCooked
+enum TextureCompression
+{
+    TextureCompressionNone = -1,
+    TextureCompressionBC1,
+    TextureCompressionBC3,
+    TextureCompressionETC2RGB,
+    TextureCompressionETC2RGBA,
+    TextureCompressionMAX
+};
+
 enum ClearMode
 {
     ClearNone = -1,
@@ -137,11 +148,19 @@ enum StatType
     StatTypeFXHeap,
     StatTypeBufferSize,
     StatTypeTextureSize,
+    StatTypeLuaHeapSize,
+    StatTypeLuaAllocRate,
+    StatTypeParticleCount,
+    StatTypeParticleBudget,
+    StatTypeParticleCulled,
+    StatTypeMeshTriangles,
+    StatTypeMeshTrianglesFull,
     //...
     StatTypeMAX
 };
 
 unsigned getTextureSize(TextureChannels channels);
+unsigned getTextureBlockSize(TextureCompression compression);
 
 struct ShaderCompile
 {
@@ -22,6 +22,7 @@ namespace cs
 
 	Uniform::Uniform(const std::string& nname, UniformType ttype, int ccount, ShaderType st, bool allocate)
 		: name(nname)
+		, nameId(nname)
 		, type(ttype)
 		, count(ccount)
 		, userData(nullptr)
@@ -74,16 +75,16 @@ namespace cs
 			return;
 		}
 
-		if (this->getUniform(uniform->getName())) 
+		if (this->getUniform(uniform->getNameId())) 
 		{
 			log::print(LogError, "Duplicate uniform found in SharedUniforms");
 			return;
 		}
 
-		this->uniforms[uniform->getName()] = uniform;
+		this->uniforms[uniform->getNameId()] = uniform;
 	}
 
-	UniformPtr SharedUniform::getUniform(const std::string& name)
+	UniformPtr SharedUniform::getUniform(const StringId& name)
 	{
 		auto it = uniforms.find(name);
 		if (it != uniforms.end())
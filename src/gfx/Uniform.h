@@ -5,6 +5,7 @@
 #include "math/GLM.h"
 #include "gfx/Types.h"
 #include "gfx/TextureHandle.h"
+#include "global/StringId.h"
 
 #include <unordered_map>
 #include <assert.h>
@@ -52,6 +53,7 @@ namespace cs
 		void dealloc();
 
 		const std::string& getName() const { return name; }
+		const StringId& getNameId() const { return nameId; }
 		UniformType getType() const { return type; }
 		void* getData() const { return value.value_raw; }
 		int getCount() const { return count; }
@@ -100,6 +102,7 @@ namespace cs
 	protected:
 
 		std::string name;
+		StringId nameId;
 		UniformType type;
 		int count;
 		bool dirty;
@@ -234,7 +237,7 @@ namespace cs
 		}
 
 		void addUniform(UniformPtr uniform);
-		UniformPtr getUniform(const std::string& name);
+		UniformPtr getUniform(const StringId& name);
 		
 	private:
 
@@ -242,7 +245,7 @@ namespace cs
 		SharedUniform(SharedUniform const&) = delete;
 		void operator=(SharedUniform const&) = delete;
 	
-		typedef std::unordered_map<std::string, UniformPtr> UniformMap;
+		typedef std::unordered_map<StringId, UniformPtr> UniformMap;
 		UniformMap uniforms;
 	
 	};
@@ -26,6 +26,7 @@ namespace cs
 		data->storage = BufferStorageDynamic;
 
 		this->geom = CREATE_CLASS(DynamicGeometry, data);
+		this->refreshIndexType();
 
 		DynamicGeometry::VertexUpdateFunc vfunc;
 		vfunc = std::bind(&VolumeDraw::updateVertices,
@@ -67,7 +68,14 @@ namespace cs
 
 	size_t VolumeDraw::getIndexBufferSize()
 	{
-		return this->volume->getNumEdges() * sizeof(uint16);
+		return this->volume->getNumEdges() * this->geom->getGeometryData()->getIndexStride();
+	}
+
+	void VolumeDraw::refreshIndexType()
+	{
+		// polygon lists built from large meshes can pass what 16 bit indices reach
+		bool wideIndices = this->volume->getNumPositions() > size_t(0xFFFF);
+		this->geom->getGeometryData()->indexType = (wideIndices) ? TypeUnsignedInt : TypeUnsignedShort;
 	}
 
 	size_t VolumeDraw::updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl)
@@ -93,13 +101,24 @@ namespace cs
 	size_t VolumeDraw::updateIndices(uchar* data, size_t bufferSize)
 	{
 		uint32 indexCtr = 0;
-		uint16* indices = reinterpret_cast<uint16*>(data);
 
-		std::vector<uint16> wireframe;
+		std::vector<uint32> wireframe;
 		size_t ni = this->volume->getEdges(wireframe);
-		for (size_t i = 0; i < ni; i++)
+		if (this->geom->getGeometryData()->indexType == TypeUnsignedInt)
+		{
+			uint32* indices = reinterpret_cast<uint32*>(data);
+			for (size_t i = 0; i < ni; i++)
+			{
+				indices[indexCtr++] = wireframe[i];
+			}
+		}
+		else
 		{
-			indices[indexCtr++] = wireframe[i];
+			uint16* indices = reinterpret_cast<uint16*>(data);
+			for (size_t i = 0; i < ni; i++)
+			{
+				indices[indexCtr++] = uint16(wireframe[i]);
+			}
 		}
 		return indexCtr;
 	}
@@ -108,7 +127,7 @@ namespace cs
 	{
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
 		dc->type = this->volume->getDrawType();
-		dc->indexType = TypeUnsignedShort;
+		dc->indexType = this->geom->getGeometryData()->indexType;
 		dc->count = static_cast<uint32>(this->volume->getNumEdges());
 		dc->offset = 0;
 		dc->shaderHandle = RenderInterface::kDefaultColorShader;
@@ -122,6 +141,7 @@ namespace cs
 		if (!this->geom)
 			return;
 
+		this->refreshIndexType();
 		this->geom->update();
 	}
 
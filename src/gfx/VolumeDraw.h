@@ -37,6 +37,8 @@ namespace cs
 		
 	private:
 
+		void refreshIndexType();
+
 		ColorB color;
 		VolumePtr volume;
 		DynamicGeometryPtr geom;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "os/LogManager.h"
+#include "gfx/RenderThread.h"
 
 #if defined(WIN32)
 
@@ -57,16 +58,24 @@
 
 #endif
 
+// Calls made off the render thread (the pipelined simulation) are run there and waited on
 #ifdef _DEBUG
 #define GL_CHECK(stmt) do { \
-            stmt; \
-            CheckOpenGLError(#stmt, __FILE__, __LINE__); \
+            if (cs::RenderThread::isRenderThread()) { \
+                stmt; \
+                CheckOpenGLError(#stmt, __FILE__, __LINE__); \
+            } else { \
+                cs::RenderThread::execute([&]() { stmt; CheckOpenGLError(#stmt, __FILE__, __LINE__); }); \
+            } \
 		        } while (0)
 
 void CheckOpenGLError(const char* stmt, const char* fname, int line);
 
 #else
-	#define GL_CHECK(stmt) stmt
+	#define GL_CHECK(stmt) do { \
+            if (cs::RenderThread::isRenderThread()) { stmt; } \
+            else { cs::RenderThread::execute([&]() { stmt; }); } \
+        } while (0)
 #endif
 
 inline void glInit()
@@ -19,6 +19,7 @@
 #include "gfx/gl/VertexArrayObject_OpenGL.h"
 #include "gfx/ShaderUtils.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace cs
@@ -26,7 +27,8 @@ namespace cs
 	RenderInterface_OpenGL::RenderInterface_OpenGL()
 		: defaultFrameBuffer(0)
 	{
-
+		for (uint32 i = 0; i < TextureCompressionMAX; i++)
+			compressionFormats[i] = false;
 	}
 
 #if !defined(CS_METAL)
@@ -96,10 +98,11 @@ namespace cs
 			SharedUniform::getInstance().addUniform(texture);
 		}
 
-        ShaderUtils::addDefaultShaders();
-
+		// before any shader is built, program binaries are looked up by the driver
 		this->checkExtensions();
 
+        ShaderUtils::addDefaultShaders();
+
 	}
 
 	void RenderInterface_OpenGL::setClearColorImpl()
@@ -133,17 +136,17 @@ namespace cs
 
 	void RenderInterface_OpenGL::setViewportImpl()
 	{
-		glViewport(
+		GL_CHECK(glViewport(
 			this->currentViewport.pos.x,
 			this->currentViewport.pos.y,
 			this->currentViewport.size.w,
-			this->currentViewport.size.h);
+			this->currentViewport.size.h));
 	}
 
     
     void RenderInterface_OpenGL::clearTextureStage(uint32 stage)
     {
-        glBindTexture(GL_TEXTURE_2D + stage, 0);
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D + stage, 0));
     }
     
 	void RenderInterface_OpenGL::draw(Geometry* geom, DrawCallPtr& dc, DrawCallOverrides* overrides)
@@ -280,9 +283,62 @@ namespace cs
 		GL_CHECK(glDisable(kStateConvert[type]));
 	}
 
+	bool RenderInterface_OpenGL::supportsTextureCompression(TextureCompression compression) const
+	{
+		return compression > TextureCompressionNone && compression < TextureCompressionMAX && compressionFormats[compression];
+	}
+
+	bool RenderInterface_OpenGL::supportsWideIndices() const
+	{
+#if defined(CS_IOS) || defined(CS_IPHONE)
+		// GLES2 only has 32 bit indices through the extension
+		return this->extensions[ExElementIndexUint];
+#else
+		return true;
+#endif
+	}
+
 	void RenderInterface_OpenGL::checkExtensions()
 	{
         
+        // the driver lists every block format it will take in glCompressedTexImage2D
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numFormats);
+        if (numFormats > 0)
+        {
+            std::vector<GLint> formats(numFormats);
+            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &formats[0]);
+            for (int i = 0; i < TextureCompressionMAX; ++i)
+            {
+                compressionFormats[i] = std::find(formats.begin(), formats.end(), GLint(kTextureCompressionConvert[i])) != formats.end();
+            }
+        }
+
+#if defined(GL_NUM_PROGRAM_BINARY_FORMATS)
+        // a binary is only good for the driver that built it, so that's what it's keyed on
+        GLint numBinaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+#if defined(USING_GLEW)
+        // the enum comes from the header, the entry points only exist on drivers that have them
+        if (!glProgramParameteri || !glGetProgramBinary || !glProgramBinary)
+        {
+            numBinaryFormats = 0;
+        }
+#endif
+        if (numBinaryFormats > 0)
+        {
+            const GLubyte* vendor = glGetString(GL_VENDOR);
+            const GLubyte* renderer = glGetString(GL_RENDERER);
+            const GLubyte* version = glGetString(GL_VERSION);
+            if (vendor && renderer && version)
+            {
+                std::stringstream driverStr;
+                driverStr << (const char*) vendor << "|" << (const char*) renderer << "|" << (const char*) version;
+                this->driverId = driverStr.str();
+            }
+        }
+#endif
+        
         const GLubyte* str = glGetString(GL_EXTENSIONS);
         if (!str)
         {
@@ -295,7 +351,8 @@ namespace cs
         const char* kCheckExt[] =
         {
             "GL_EXT_debug_label",    // ExDebugLabel
-            "GL_EXT_debug_marker"    // ExDebugMarker
+            "GL_EXT_debug_marker",   // ExDebugMarker
+            "GL_OES_element_index_uint" // ExElementIndexUint
         };
         
         for (int i = 0; i < ExMAX; ++i)
@@ -312,23 +369,32 @@ namespace cs
             }
         }
         
+        // core profiles may leave S3TC out of the format list while still exposing it
+        if (std::find(extensionList.begin(), extensionList.end(), "GL_EXT_texture_compression_s3tc") != extensionList.end())
+        {
+            compressionFormats[TextureCompressionBC1] = true;
+            compressionFormats[TextureCompressionBC3] = true;
+        }
+        
 	}
 
-	void RenderInterface_OpenGL::pushDebugScope(const std::string& tag)
+	void RenderInterface_OpenGL::pushDebugScope(const StringId& tag)
 	{
         
-        if (!extensions[ExDebugMarker])
+        // markers pushed by the pipelined simulation would land between unrelated render calls
+        if (!extensions[ExDebugMarker] || !RenderThread::isRenderThread())
             return;
         
 #if defined(CS_IOS)
-        glPushGroupMarkerEXT(tag.length() + 1, tag.c_str());
+        const std::string& name = tag.getString();
+        glPushGroupMarkerEXT(name.length() + 1, name.c_str());
 #endif
         
 	}
 
 	void RenderInterface_OpenGL::popDebugScope()
 	{
-        if (!extensions[ExDebugMarker])
+        if (!extensions[ExDebugMarker] || !RenderThread::isRenderThread())
             return;
         
 #if defined(CS_IOS)
@@ -32,7 +32,7 @@ namespace cs
 
         virtual void clearTextureStage(uint32 stage);
         
-		virtual void pushDebugScope(const std::string& tag);
+		virtual void pushDebugScope(const StringId& tag);
 		virtual void popDebugScope();
         
         enum Extension
@@ -40,10 +40,15 @@ namespace cs
             ExNone = -1,
             ExDebugLabel,
             ExDebugMarker,
+            ExElementIndexUint,
             ExMAX
         };
         
         bool extensions[ExMAX];
+
+		virtual bool supportsTextureCompression(TextureCompression compression) const;
+		virtual bool supportsWideIndices() const;
+		virtual std::string getDriverId() const { return this->driverId; }
         
 	protected:
 
@@ -66,6 +71,9 @@ namespace cs
 	private:
         
         int defaultFrameBuffer;
+		bool compressionFormats[TextureCompressionMAX];
+		std::string driverId;
+
 		void checkExtensions();
 	};
 
@@ -2,6 +2,9 @@
 
 #include "gfx/gl/ShaderProgram_OpenGL.h"
 #include "gfx/gl/Shader_OpenGL.h"
+#include "gfx/RenderInterface.h"
+
+#include <vector>
 
 // #define CHECK_UNIFORM_VALIDITY 1
 #if defined(CHECK_UNIFORM_VALIDITY) 
@@ -12,6 +15,15 @@
 
 namespace cs
 {
+	namespace
+	{
+		// the render interface only reports a driver id once it has found program binary support
+		inline bool hasProgramBinary()
+		{
+			RenderInterface* render = RenderInterface::getInstance();
+			return render && render->getDriverId().length() > 0;
+		}
+	}
 
 	void ShaderProgram_OpenGL::init()
 	{
@@ -35,6 +47,7 @@ namespace cs
 		
 		this->program = 0;
 		this->linked = false;
+		this->uniforms.clear();
 	}
 
 	bool ShaderProgram_OpenGL::valid() const
@@ -52,20 +65,48 @@ namespace cs
         return true;
 	}
 
-	GLint ShaderProgram_OpenGL::getUniformLocation(const std::string& name)
+	GLint ShaderProgram_OpenGL::getUniformLocation(const StringId& name) const
 	{
-		UniformLocations::iterator it;
+		UniformLocations::const_iterator it;
 		if ((it = this->uniforms.find(name)) != this->uniforms.end())
 			return it->second;
 
-		GLint loc;
-		GL_CHECK(loc = glGetUniformLocation(this->program, name.c_str()));
-		this->uniforms[name] = loc;
+		// not active in this program, GL ignores uploads to -1
+		return -1;
+	}
 
-		return loc;
+	void ShaderProgram_OpenGL::gatherUniformLocations()
+	{
+		this->uniforms.clear();
+
+		GLint numUniforms = 0;
+		GLint maxLength = 0;
+		GL_CHECK(glGetProgramiv(this->program, GL_ACTIVE_UNIFORMS, &numUniforms));
+		GL_CHECK(glGetProgramiv(this->program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+		if (numUniforms <= 0 || maxLength <= 0)
+			return;
+
+		std::vector<GLchar> nameBuffer(maxLength);
+		for (GLint i = 0; i < numUniforms; ++i)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			GL_CHECK(glGetActiveUniform(this->program, GLuint(i), maxLength, &length, &size, &type, &nameBuffer[0]));
+
+			// arrays are reported as "name[0]", uniforms are looked up by their bare name
+			std::string name(&nameBuffer[0], length);
+			size_t bracket = name.find('[');
+			if (bracket != std::string::npos)
+				name = name.substr(0, bracket);
+
+			GLint loc;
+			GL_CHECK(loc = glGetUniformLocation(this->program, name.c_str()));
+			this->uniforms[StringId(name)] = loc;
+		}
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, float32* value, uint32 count, uint32 precision, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, float32* value, uint32 count, uint32 precision, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -75,7 +116,7 @@ namespace cs
 		GL_CHECK(glUniform1fv(location, count, reinterpret_cast<GLfloat*>(value)));
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, int32* value, uint32 count, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, int32* value, uint32 count, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -85,7 +126,7 @@ namespace cs
 		GL_CHECK(glUniform1iv(location, count, reinterpret_cast<GLint*>(value)));
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, vec2* value, uint32 count, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, vec2* value, uint32 count, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -95,7 +136,7 @@ namespace cs
 		GL_CHECK(glUniform2fv(location, count, reinterpret_cast<GLfloat*>(value)));
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, vec3* value, uint32 count, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, vec3* value, uint32 count, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -105,7 +146,7 @@ namespace cs
 		GL_CHECK(glUniform3fv(location, count, reinterpret_cast<GLfloat*>(value)));
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, vec4* value, uint32 count, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, vec4* value, uint32 count, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -115,7 +156,7 @@ namespace cs
 		GL_CHECK(glUniform4fv(location, count, reinterpret_cast<GLfloat*>(value)));
 	}
 
-	void ShaderProgram_OpenGL::setUniformValueArray(const std::string& name, mat4* value, uint32 count, void* dst)
+	void ShaderProgram_OpenGL::setUniformValueArray(const StringId& name, mat4* value, uint32 count, void* dst)
 	{
 		if (!this->valid())
 			return;
@@ -132,6 +173,14 @@ namespace cs
 			GL_CHECK(glAttachShader(this->program, shader->getHandle()));
 		}
 
+#if defined(GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+		// lets the driver keep what getBinary needs
+		if (hasProgramBinary())
+		{
+			GL_CHECK(glProgramParameteri(this->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+		}
+#endif
+
 		// link
 		GLint success = 0;
 		GL_CHECK(glLinkProgram(this->program));
@@ -157,7 +206,54 @@ namespace cs
                 log::print(LogError, "Unknown Shader Linking Error!");
             }
 			this->free();
+			return;
 		}
+
+		this->gatherUniformLocations();
+	}
+
+	bool ShaderProgram_OpenGL::getBinary(std::vector<uchar>& data, uint32& format)
+	{
+#if defined(GL_PROGRAM_BINARY_LENGTH)
+		if (!this->valid() || !hasProgramBinary())
+			return false;
+
+		GLint length = 0;
+		GL_CHECK(glGetProgramiv(this->program, GL_PROGRAM_BINARY_LENGTH, &length));
+		if (length <= 0)
+			return false;
+
+		data.resize(length);
+		GLsizei written = 0;
+		GLenum binaryFormat = 0;
+		GL_CHECK(glGetProgramBinary(this->program, GLsizei(length), &written, &binaryFormat, &data[0]));
+		data.resize(written);
+
+		format = uint32(binaryFormat);
+		return written > 0;
+#else
+		return false;
+#endif
+	}
+
+	bool ShaderProgram_OpenGL::loadBinary(const std::vector<uchar>& data, uint32 format)
+	{
+#if defined(GL_PROGRAM_BINARY_LENGTH)
+		if (this->program <= 0 || data.empty() || !hasProgramBinary())
+			return false;
+
+		GLint success = 0;
+		GL_CHECK(glProgramBinary(this->program, GLenum(format), &data[0], GLsizei(data.size())));
+		GL_CHECK(glGetProgramiv(this->program, GL_LINK_STATUS, &success));
+		if (success == GL_FALSE)
+			return false;
+
+		this->linked = true;
+		this->gatherUniformLocations();
+		return true;
+#else
+		return false;
+#endif
 	}
 
 	void ShaderProgram_OpenGL::bind(const ShaderBindParams& bindParams, const char* tag)
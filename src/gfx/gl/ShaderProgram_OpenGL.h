@@ -15,31 +15,36 @@ namespace cs
 		ShaderProgram_OpenGL() : ShaderProgram() { this->init(); }
 		virtual ~ShaderProgram_OpenGL() { this->free(); }
 
-		virtual void setUniformValueArray(const std::string& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, int32* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec2* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec3* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec4* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, mat4* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, int32* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec2* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec3* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec4* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, mat4* value, uint32 count = 0, void* dst = nullptr);
 
 		virtual bool bindAttributeLocation(const std::string& name, AttributeType type);
 		virtual void link(const ShaderParams* params);
 		virtual void bind(const ShaderBindParams& params, const char* tag = nullptr);
 
+		virtual bool getBinary(std::vector<uchar>& data, uint32& format);
+		virtual bool loadBinary(const std::vector<uchar>& data, uint32 format);
+
 	private:
 
 		void init();
 		void free();
 		bool valid() const;
 
-		GLint getUniformLocation(const std::string& name);
+		GLint getUniformLocation(const StringId& name) const;
+		void gatherUniformLocations();
 
 		GLuint program;
 
 		typedef std::map<int32, std::string> AttributeLocations;
 		AttributeLocations attributes;
 
-		typedef std::unordered_map<std::string, GLint> UniformLocations;
+		// Filled once the program links, names are hashed so a lookup by id needs no string
+		typedef std::unordered_map<StringId, GLint> UniformLocations;
 		UniformLocations uniforms;
 	};
 }
@@ -46,11 +46,8 @@ namespace cs
 	{
 		std::string adjustedString = str;
         
-#if defined(CS_WINDOWS)
-        ShaderUtils::removePrecisionQualifiers(adjustedString);
-#endif
-        
-        ShaderUtils::replaceOutputFormat(adjustedString);
+        // already done for sources coming through ShaderResource, a no-op then
+        ShaderUtils::preprocessSource(adjustedString);
 
 #if defined(TEST_METAL)
 		gOptContext = glslopt_initialize(kTargetVersion);
@@ -2,6 +2,7 @@
 
 #include "gfx/gl/TextureResource_OpenGL.h"
 #include "gfx/TextureLoader.h"
+#include "gfx/RenderInterface.h"
 #include "os/FileManager.h"
 #include "global/Stats.h"
 
@@ -72,13 +73,13 @@ namespace cs
 
 		if (gSamplerStateU[stage] != sample_u || forceStateChange)
 		{
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, kTextureSampleConvert[sample_u]);
+			GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, kTextureSampleConvert[sample_u]));
             gSamplerStateU[stage] = sample_u;
 		}
 
 		if (gSamplerStateV[stage] != sample_v || forceStateChange)
 		{
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, kTextureSampleConvert[sample_v]);
+			GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, kTextureSampleConvert[sample_v]));
             gSamplerStateV[stage] = sample_v;
 		}
 	}
@@ -97,6 +98,12 @@ namespace cs
 
 	void TextureResource_OpenGL::loadFromFile(const std::string& filePath)
 	{
+		tex::TextureImage image;
+		if (tex::loadCooked(filePath, image))
+		{
+			this->loadCooked(image);
+			return;
+		}
 		
 		this->bytes = tex::loadImage(filePath, this->width, this->height, this->channels);
 		if (!this->bytes)
@@ -110,6 +117,49 @@ namespace cs
 		EngineStats::incrementStatBy(StatTypeTextureSize, this->sizeInBytes);
 	}
 
+	void TextureResource_OpenGL::loadCooked(tex::TextureImage& image)
+	{
+		if (image.compression != TextureCompressionNone &&
+			!RenderInterface::getInstance()->supportsTextureCompression(image.compression))
+		{
+			log::info("Texture compression ", image.compression, " unsupported, decoding on the CPU");
+			tex::decompress(image);
+		}
+
+		// the mips go straight to the driver, no copy is kept
+		this->bytes = nullptr;
+		this->width = image.width;
+		this->height = image.height;
+		this->channels = image.channels;
+		this->fitWidth = image.contentWidth / float32(image.width);
+		this->fitHeight = image.contentHeight / float32(image.height);
+
+		GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		for (size_t level = 0; level < image.mips.size(); ++level)
+		{
+			const tex::TextureMip& mip = image.mips[level];
+			const uchar* data = &image.data[size_t(mip.offset)];
+			if (image.compression != TextureCompressionNone)
+			{
+				GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, GLint(level), kTextureCompressionConvert[image.compression], mip.width, mip.height, 0, GLsizei(mip.size), data));
+			}
+			else
+			{
+				GLenum format = (image.channels == TextureRGBA) ? GL_RGBA : GL_RGB;
+				GL_CHECK(glTexImage2D(GL_TEXTURE_2D, GLint(level), format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, data));
+			}
+			this->sizeInBytes += size_t(mip.size);
+		}
+		GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+		if (image.mips.size() > 1)
+		{
+			GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+		}
+
+		EngineStats::incrementStatBy(StatTypeTextureSize, this->sizeInBytes);
+	}
+
 	void TextureResource_OpenGL::loadData()
 	{
 		assert(this->width > 0);
@@ -3,6 +3,7 @@
 #include "ClassDef.h"
 #include "global/Values.h"
 #include "gfx/TextureResource.h"
+#include "gfx/TextureLoader.h"
 #include "gfx/gl/OpenGL.h"
 
 #include <string>
@@ -30,6 +31,7 @@ namespace cs
 		virtual void init();
 		virtual void loadFromFile(const std::string& fileName);
 		virtual void loadData();
+		void loadCooked(tex::TextureImage& image);
 
 		GLuint textureHandle;
 
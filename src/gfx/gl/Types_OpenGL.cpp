@@ -128,6 +128,30 @@ namespace cs
     };
 #endif
 
+#if !defined(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+	#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#if !defined(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#if !defined(GL_COMPRESSED_RGB8_ETC2)
+	#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+#if !defined(GL_COMPRESSED_RGBA8_ETC2_EAC)
+	#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+	uint32 kTextureCompressionConvert[] =
+	{
+		GL_COMPRESSED_RGB_S3TC_DXT1_EXT,	// TextureCompressionBC1
+		GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,	// TextureCompressionBC3
+		GL_COMPRESSED_RGB8_ETC2,			// TextureCompressionETC2RGB
+		GL_COMPRESSED_RGBA8_ETC2_EAC,		// TextureCompressionETC2RGBA
+	};
+
 #if defined(CS_WINDOWS)
 	uint32 kDepthComponentConvert[] =
 	{
@@ -12,7 +12,7 @@ namespace cs
 
 	VertexArrayObject_OpenGL::~VertexArrayObject_OpenGL()
 	{
-		glDeleteVertexArrays(1, &this->vao);
+		GL_CHECK(glDeleteVertexArrays(1, &this->vao));
 	}
 
 	void VertexArrayObject_OpenGL::bind()
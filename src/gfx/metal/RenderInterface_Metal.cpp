@@ -43,6 +43,12 @@ namespace cs
             }
             return currentClear;
         }
+
+        // MTLIndexType, Metal only draws 16 and 32 bit indices
+        int getMetalIndexType(Type type)
+        {
+            return (type == TypeUnsignedInt) ? 1 /* MTLIndexTypeUInt32 */ : 0 /* MTLIndexTypeUInt16 */;
+        }
     }
 
 	RenderInterface_Metal::RenderInterface_Metal()
@@ -230,8 +236,8 @@ namespace cs
             {
                 indexBufferData = indexBufferMtl->getBufferObject();
                 indexCount = dc->count;
-                indexType = dc->indexType;
-                offset = dc->offset * sizeof(uint16);
+                indexType = RenderInterface_MetalUtils::getMetalIndexType(dc->indexType);
+                offset = dc->offset * kTypeSize[dc->indexType];
             }
         }
         
@@ -560,7 +566,7 @@ namespace cs
         
 	}
 
-	void RenderInterface_Metal::pushDebugScope(const std::string& tag)
+	void RenderInterface_Metal::pushDebugScope(const StringId& tag)
 	{
          if (this->currentEncoder)
          {
@@ -33,7 +33,7 @@ namespace cs
         
         virtual void clearTextureStage(uint32 stage);
         
-		virtual void pushDebugScope(const std::string& tag);
+		virtual void pushDebugScope(const StringId& tag);
 		virtual void popDebugScope();
         
         virtual void beginFrame();
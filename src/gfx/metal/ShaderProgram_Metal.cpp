@@ -46,32 +46,32 @@ namespace cs
         return false;
     }
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, float32* value, uint32 count, uint32 precision, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, float32* value, uint32 count, uint32 precision, void* dst)
 	{
         memcpy(dst, value, count * sizeof(float32));
 	}
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, int32* value, uint32 count, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, int32* value, uint32 count, void* dst)
 	{
         memcpy(dst, value, count * sizeof(int32));
 	}
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, vec2* value, uint32 count, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, vec2* value, uint32 count, void* dst)
 	{
         memcpy(dst, value, count * sizeof(vec2));
 	}
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, vec3* value, uint32 count, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, vec3* value, uint32 count, void* dst)
 	{
         memcpy(dst, value, count * sizeof(vec3));
 	}
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, vec4* value, uint32 count, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, vec4* value, uint32 count, void* dst)
 	{
         memcpy(dst, value, count * sizeof(vec4));
 	}
 
-	void ShaderProgram_Metal::setUniformValueArray(const std::string& name, mat4* value, uint32 count, void* dst)
+	void ShaderProgram_Metal::setUniformValueArray(const StringId& name, mat4* value, uint32 count, void* dst)
 	{
         memcpy(dst, value, count * sizeof(mat4));
 	}
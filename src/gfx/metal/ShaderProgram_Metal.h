@@ -21,12 +21,12 @@ namespace cs
             this->free();
         }
 
-		virtual void setUniformValueArray(const std::string& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, int32* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec2* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec3* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, vec4* value, uint32 count = 0, void* dst = nullptr);
-		virtual void setUniformValueArray(const std::string& name, mat4* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, float32* value, uint32 count = 0, uint32 precision = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, int32* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec2* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec3* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, vec4* value, uint32 count = 0, void* dst = nullptr);
+		virtual void setUniformValueArray(const StringId& name, mat4* value, uint32 count = 0, void* dst = nullptr);
 
 		virtual bool bindAttributeLocation(const std::string& name, AttributeType type);
 		virtual void link(const ShaderParams* params);
@@ -47,7 +47,26 @@ namespace cs
 
 	void TextureResource_Metal::loadFromFile(const std::string& filePath)
 	{
-		
+		// no compressed upload path here yet, cooked textures are decoded and take mip 0
+		tex::TextureImage image;
+		if (tex::loadCooked(filePath, image))
+		{
+			tex::decompress(image);
+
+			const tex::TextureMip& mip = image.mips[0];
+			this->bytes = new uchar[size_t(mip.size)];
+			memcpy(this->bytes, &image.data[size_t(mip.offset)], size_t(mip.size));
+
+			this->width = mip.width;
+			this->height = mip.height;
+			this->channels = (image.channels == TextureRGBA) ? TextureBGRA : TextureBGR;
+			this->loadData();
+
+			this->fitWidth = image.contentWidth / float32(image.width);
+			this->fitHeight = image.contentHeight / float32(image.height);
+			return;
+		}
+
 		this->bytes = tex::loadImage(filePath, this->width, this->height, this->channels);
 		if (!this->bytes)
 			return;
@@ -0,0 +1,231 @@
+#include "PCH.h"
+
+#include "global/EventQueue.h"
+#include "global/Profiler.h"
+#include "os/LogManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace cs
+{
+	static const char* kEventDispatchPointStr[] =
+	{
+		"pre-update",	 // EventDispatchPreUpdate
+		"post-physics",	 // EventDispatchPostPhysics
+		"post-update"	 // EventDispatchPostUpdate
+	};
+
+	EventRing::EventRing()
+		: slots(new Slot[kCapacity])
+		, writePos(0)
+		, readPos(0)
+	{
+		for (uint32 i = 0; i < kCapacity; ++i)
+			this->slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	EventRing::~EventRing()
+	{
+		delete[] this->slots;
+	}
+
+	bool EventRing::push(const QueuedEvent& evt)
+	{
+		uint32 pos = this->writePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = this->slots[pos & (kCapacity - 1)];
+			uint32 sequence = slot.sequence.load(std::memory_order_acquire);
+			int32 diff = int32(sequence - pos);
+			if (diff == 0)
+			{
+				// claim the slot, then publish it once written
+				if (this->writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					slot.event = evt;
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// a lap ahead of the reader, full
+				return false;
+			}
+			else
+			{
+				pos = this->writePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	EventQueue::EventQueue()
+		: dropped(0)
+		, droppedReported(0)
+		, dispatching(false)
+	{
+
+	}
+
+	EventQueue::EventType& EventQueue::getType(const StringId& type)
+	{
+		EventTypeIndex::iterator it = this->typeIndex.find(type);
+		if (it != this->typeIndex.end())
+			return this->types[it->second];
+
+		this->typeIndex[type] = uint32(this->types.size());
+		this->types.push_back(EventType());
+
+		EventType& newType = this->types.back();
+		newType.type = type;
+		newType.point = EventDispatchPostUpdate;
+		newType.coalesce = false;
+		return newType;
+	}
+
+	void EventQueue::registerType(const StringId& type, EventDispatchPoint point, bool coalesce)
+	{
+		EventType& eventType = this->getType(type);
+		eventType.point = point;
+		eventType.coalesce = coalesce;
+	}
+
+	void EventQueue::addHandler(const StringId& type, const EventHandler& handler)
+	{
+		this->getType(type).handlers.push_back(handler);
+	}
+
+	void EventQueue::clearHandlers(const StringId& type)
+	{
+		EventTypeIndex::iterator it = this->typeIndex.find(type);
+		if (it != this->typeIndex.end())
+			this->types[it->second].handlers.clear();
+	}
+
+	bool EventQueue::postRaw(const StringId& type, const void* data, uint32 size)
+	{
+		assert(size <= QueuedEvent::kMaxPayload);
+
+		QueuedEvent evt;
+		evt.type = type;
+		evt.size = std::min<uint32>(size, QueuedEvent::kMaxPayload);
+		if (data && evt.size > 0)
+			memcpy(evt.payload, data, evt.size);
+
+		if (!this->ring.push(evt))
+		{
+			this->dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	void EventQueue::drain()
+	{
+		this->ring.drain([this](const QueuedEvent& evt)
+		{
+			EventType& eventType = this->getType(evt.type);
+			eventType.stats.posted++;
+			eventType.stats.framePosted++;
+
+			// coalesced types only ever hold the latest
+			if (eventType.coalesce && !eventType.pending.empty())
+			{
+				eventType.pending.back() = evt;
+				eventType.stats.coalesced++;
+				return;
+			}
+			eventType.pending.push_back(evt);
+		});
+
+		uint32 numDropped = this->dropped.load(std::memory_order_relaxed);
+		if (numDropped != this->droppedReported)
+		{
+			log::error("Event queue full, ", numDropped - this->droppedReported, " events dropped");
+			this->droppedReported = numDropped;
+		}
+	}
+
+	void EventQueue::dispatch(EventDispatchPoint point)
+	{
+		// a handler dispatching would reorder events around the one it's handling
+		assert(!this->dispatching);
+		if (this->dispatching)
+			return;
+
+		PROFILE_SCOPE("Event Dispatch");
+
+		this->drain();
+
+		this->dispatching = true;
+		for (size_t i = 0; i < this->types.size(); ++i)
+		{
+			if (this->types[i].point > point || this->types[i].pending.empty())
+				continue;
+
+			// Handlers may post, register types or add handlers, which can move this->types.
+			// Anything posted now waits in the ring for the next dispatch point.
+			this->dispatchEvents.clear();
+			std::swap(this->dispatchEvents, this->types[i].pending);
+			this->dispatchHandlers = this->types[i].handlers;
+
+			uint64 start = Profiler::now();
+			for (auto& evt : this->dispatchEvents)
+			{
+				for (auto& handler : this->dispatchHandlers)
+					handler(evt);
+			}
+			uint64 elapsed = Profiler::now() - start;
+
+			EventTypeStats& stats = this->types[i].stats;
+			stats.dispatched += this->dispatchEvents.size();
+			stats.frameDispatched += uint32(this->dispatchEvents.size());
+			stats.totalTime += elapsed;
+			stats.frameTime += elapsed;
+		}
+		this->dispatching = false;
+	}
+
+	void EventQueue::markFrame()
+	{
+		for (auto& it : this->types)
+		{
+			it.stats.framePosted = 0;
+			it.stats.frameDispatched = 0;
+			it.stats.frameTime = 0;
+		}
+	}
+
+	const EventTypeStats* EventQueue::getStats(const StringId& type) const
+	{
+		EventTypeIndex::const_iterator it = this->typeIndex.find(type);
+		if (it == this->typeIndex.end())
+			return nullptr;
+		return &this->types[it->second].stats;
+	}
+
+	std::string EventQueue::getFrameReport() const
+	{
+		std::stringstream str;
+		str << std::fixed << std::setprecision(3);
+		for (auto& it : this->types)
+		{
+			if (it.stats.framePosted == 0 && it.stats.frameDispatched == 0)
+				continue;
+
+			str << it.type << " [" << kEventDispatchPointStr[it.point] << "]"
+				<< " posted " << it.stats.framePosted
+				<< " dispatched " << it.stats.frameDispatched
+				<< " " << (float32(it.stats.frameTime) / 1000000.0f) << "ms"
+				<< " (total " << it.stats.posted << " posted, " << it.stats.coalesced << " coalesced)\n";
+		}
+
+		if (this->getNumDropped() > 0)
+			str << "dropped " << this->getNumDropped() << "\n";
+
+		return str.str();
+	}
+}
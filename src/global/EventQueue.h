@@ -0,0 +1,182 @@
+#pragma once
+
+#include "global/Values.h"
+#include "global/Singleton.h"
+#include "global/StringId.h"
+
+#include <assert.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace cs
+{
+	// Where in Scene::process a type's queued events are handed to its handlers
+	enum EventDispatchPoint
+	{
+		EventDispatchPreUpdate,		// before scripts and systems step
+		EventDispatchPostPhysics,	// once the physics step (and its contacts) is done
+		EventDispatchPostUpdate,	// after every system, also flushed at the end of the frame
+		//...
+		EventDispatchMAX
+	};
+
+	// A posted event, the payload is copied through the queue byte for byte so it must be plain data
+	struct QueuedEvent
+	{
+		static const uint32 kMaxPayload = 32;
+
+		QueuedEvent()
+			: size(0)
+		{ }
+
+		template <class T>
+		const T& get() const
+		{
+			static_assert(sizeof(T) <= kMaxPayload, "Event payload too large");
+			assert(sizeof(T) == this->size);
+			return *reinterpret_cast<const T*>(this->payload);
+		}
+
+		StringId type;
+		uint32 size;
+		alignas(16) uchar payload[kMaxPayload];
+	};
+
+	// Bounded multi producer, single consumer ring.  Any thread may push, only the main thread pops.
+	class EventRing
+	{
+	public:
+
+		static const uint32 kCapacity = 4096;
+
+		EventRing();
+		~EventRing();
+
+		// false when the ring is full, the event is dropped
+		bool push(const QueuedEvent& evt);
+
+		// Pops everything published before the call, events pushed meanwhile wait for the next drain
+		template <class F>
+		uint32 drain(const F& func)
+		{
+			uint32 end = this->writePos.load(std::memory_order_acquire);
+			uint32 count = 0;
+			while (this->readPos != end)
+			{
+				Slot& slot = this->slots[this->readPos & (kCapacity - 1)];
+				if (slot.sequence.load(std::memory_order_acquire) != this->readPos + 1)
+					break; // claimed but not yet written, picked up next time
+
+				func(slot.event);
+				slot.sequence.store(this->readPos + kCapacity, std::memory_order_release);
+				++this->readPos;
+				++count;
+			}
+			return count;
+		}
+
+	private:
+
+		struct Slot
+		{
+			std::atomic<uint32> sequence;
+			QueuedEvent event;
+		};
+
+		Slot* slots;
+		std::atomic<uint32> writePos;
+		uint32 readPos;
+	};
+
+	struct EventTypeStats
+	{
+		EventTypeStats()
+			: posted(0)
+			, dispatched(0)
+			, coalesced(0)
+			, totalTime(0)
+			, framePosted(0)
+			, frameDispatched(0)
+			, frameTime(0)
+		{ }
+
+		uint64 posted;
+		uint64 dispatched;
+		uint64 coalesced;
+		uint64 totalTime;		// nanoseconds spent in handlers
+
+		uint32 framePosted;
+		uint32 frameDispatched;
+		uint64 frameTime;
+	};
+
+	// Deferred event bus.  Events are posted from anywhere (worker threads included, posting takes
+	// no lock) and handed out at fixed points of the frame, so a handler never runs inside the
+	// physics step or an input callback that raised it.  Handlers and type settings are main thread only.
+	class EventQueue : public Singleton<EventQueue>
+	{
+	public:
+
+		typedef std::function<void(const QueuedEvent&)> EventHandler;
+
+		EventQueue();
+
+		// Coalesced types hand only the latest event of a dispatch to their handlers
+		void registerType(const StringId& type, EventDispatchPoint point, bool coalesce = false);
+		void addHandler(const StringId& type, const EventHandler& handler);
+		void clearHandlers(const StringId& type);
+
+		bool post(const StringId& type) { return this->postRaw(type, nullptr, 0); }
+
+		template <class T>
+		bool post(const StringId& type, const T& payload)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Event payloads are copied as bytes");
+			static_assert(sizeof(T) <= QueuedEvent::kMaxPayload, "Event payload too large");
+			return this->postRaw(type, &payload, uint32(sizeof(T)));
+		}
+
+		bool postRaw(const StringId& type, const void* data, uint32 size);
+
+		// Hands out every pending event whose type dispatches at or before point
+		void dispatch(EventDispatchPoint point);
+
+		// Resets the per frame counters, call once at the top of the frame
+		void markFrame();
+
+		const EventTypeStats* getStats(const StringId& type) const;
+		uint32 getNumDropped() const { return this->dropped.load(std::memory_order_relaxed); }
+		std::string getFrameReport() const;
+
+	private:
+
+		struct EventType
+		{
+			StringId type;
+			EventDispatchPoint point;
+			bool coalesce;
+			std::vector<EventHandler> handlers;
+			std::vector<QueuedEvent> pending;
+			EventTypeStats stats;
+		};
+
+		EventType& getType(const StringId& type);
+		void drain();
+
+		EventRing ring;
+		std::atomic<uint32> dropped;
+		uint32 droppedReported;
+
+		typedef std::unordered_map<StringId, uint32> EventTypeIndex;
+		EventTypeIndex typeIndex;
+		std::vector<EventType> types;
+
+		std::vector<QueuedEvent> dispatchEvents;
+		std::vector<EventHandler> dispatchHandlers;
+		bool dispatching;
+	};
+}
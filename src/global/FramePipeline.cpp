@@ -0,0 +1,240 @@
+#include "PCH.h"
+
+#include "global/FramePipeline.h"
+#include "global/Profiler.h"
+#include "gfx/RenderThread.h"
+#include "os/LogManager.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace cs
+{
+	namespace
+	{
+		std::mutex gPipelineLock;
+		std::vector<FramePipeline*> gPipelines;
+
+		float32 toMs(uint64 ns)
+		{
+			return float32(ns) / 1000000.0f;
+		}
+	}
+
+	FramePipeline::FramePipeline()
+		: mode(FramePipelineSingleThreaded)
+		, simulate(nullptr)
+		, running(false)
+		, hasWork(false)
+		, pendingDt(0.0f)
+		, busy(false)
+		, kickTime(0)
+		, capturedTime(0)
+		, stageStart(0)
+		, marshalledAtKick(0)
+	{
+		std::lock_guard<std::mutex> guard(gPipelineLock);
+		gPipelines.push_back(this);
+	}
+
+	FramePipeline::~FramePipeline()
+	{
+		this->setMode(FramePipelineSingleThreaded);
+
+		std::lock_guard<std::mutex> guard(gPipelineLock);
+		gPipelines.erase(std::remove(gPipelines.begin(), gPipelines.end(), this), gPipelines.end());
+	}
+
+	void FramePipeline::setMode(FramePipelineMode mode)
+	{
+		// stopping from the simulation would wait on, then join, the thread doing the stopping
+		if (RenderThread::isBound() && !RenderThread::isRenderThread())
+		{
+			log::error("Frame pipeline mode can only be changed on the render thread");
+			return;
+		}
+
+#if defined(CS_METAL)
+		// the Metal backend records into per frame command buffers owned by the main thread
+		if (mode == FramePipelineThreaded)
+		{
+			log::info("Threaded frame pipeline not supported on Metal, staying single threaded");
+			mode = FramePipelineSingleThreaded;
+		}
+#elif !defined(CS_FRAME_PIPELINE_THREADED)
+		// submit still reads shader handle and shared uniform values, draw call overrides and draw
+		// callbacks live, while the worker writes the next frame's, so it's opt in at build time
+		if (mode == FramePipelineThreaded)
+		{
+			log::info("Threaded frame pipeline not enabled in this build (CS_FRAME_PIPELINE_THREADED), staying single threaded");
+			mode = FramePipelineSingleThreaded;
+		}
+#endif
+		if (this->mode == mode)
+			return;
+
+		if (mode == FramePipelineThreaded)
+		{
+			this->start();
+		}
+		else
+		{
+			this->stop();
+		}
+		this->mode = mode;
+	}
+
+	void FramePipeline::start()
+	{
+		RenderThread::bind();
+
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->running = true;
+		this->hasWork = false;
+		this->worker = std::thread(&FramePipeline::run, this);
+	}
+
+	void FramePipeline::stop()
+	{
+		if (!this->worker.joinable())
+			return;
+
+		this->wait();
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->running = false;
+		}
+		this->kicked.notify_all();
+		this->worker.join();
+
+		RenderThread::unbind();
+	}
+
+	void FramePipeline::kick(float32 dt)
+	{
+		assert(this->simulate);
+		assert(!this->isSimulating());
+
+		this->kickTime = Profiler::now();
+		this->marshalledAtKick = RenderThread::getNumExecuted();
+
+		if (this->mode == FramePipelineSingleThreaded)
+		{
+			this->simulate(dt);
+			this->stats.simulateTime = Profiler::now() - this->kickTime;
+			this->stats.framesSimulated++;
+			this->capturedTime = this->kickTime;
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->pendingDt = dt;
+			this->hasWork = true;
+			this->busy.store(true, std::memory_order_release);
+		}
+		this->kicked.notify_all();
+	}
+
+	void FramePipeline::wait()
+	{
+		uint64 start = Profiler::now();
+		if (this->isSimulating())
+		{
+			PROFILE_SCOPE("Wait Simulation");
+			RenderThread::service([this]() { return !this->isSimulating(); });
+		}
+		this->stats.waitTime = Profiler::now() - start;
+		this->stats.marshalledCalls = RenderThread::getNumExecuted() - this->marshalledAtKick;
+	}
+
+	void FramePipeline::run()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		for (;;)
+		{
+			this->kicked.wait(guard, [this]() { return this->hasWork || !this->running; });
+			if (!this->running)
+				return;
+
+			float32 dt = this->pendingDt;
+			this->hasWork = false;
+			guard.unlock();
+
+			uint64 start = Profiler::now();
+			{
+				PROFILE_SCOPE("Simulate");
+				this->simulate(dt);
+			}
+			this->stats.simulateTime = Profiler::now() - start;
+			this->stats.framesSimulated++;
+
+			this->busy.store(false, std::memory_order_release);
+			RenderThread::wake();
+
+			guard.lock();
+		}
+	}
+
+	void FramePipeline::beginCapture()
+	{
+		this->stageStart = Profiler::now();
+	}
+
+	void FramePipeline::endCapture()
+	{
+		uint64 now = Profiler::now();
+		this->stats.captureTime = now - this->stageStart;
+		this->capturedTime = this->kickTime;
+	}
+
+	void FramePipeline::beginSubmit()
+	{
+		this->stageStart = Profiler::now();
+	}
+
+	void FramePipeline::endSubmit()
+	{
+		uint64 now = Profiler::now();
+		this->stats.submitTime = now - this->stageStart;
+		this->stats.latency = now - this->capturedTime;
+		this->stats.framesSubmitted++;
+
+		PROFILE_COUNTER("Frame Latency (us)", this->stats.latency / 1000);
+		PROFILE_COUNTER("Simulation Wait (us)", this->stats.waitTime / 1000);
+		PROFILE_COUNTER("Marshalled GL Calls", this->stats.marshalledCalls);
+	}
+
+	std::string FramePipeline::getFrameReport() const
+	{
+		std::stringstream str;
+		str << std::fixed << std::setprecision(3);
+		str << ((this->mode == FramePipelineThreaded) ? "threaded" : "single threaded")
+			<< " simulate " << toMs(this->stats.simulateTime) << "ms"
+			<< " wait " << toMs(this->stats.waitTime) << "ms"
+			<< " capture " << toMs(this->stats.captureTime) << "ms"
+			<< " submit " << toMs(this->stats.submitTime) << "ms"
+			<< " latency " << toMs(this->stats.latency) << "ms"
+			<< " marshalled " << this->stats.marshalledCalls
+			<< " (" << this->stats.framesSimulated << " simulated, " << this->stats.framesSubmitted << " submitted, "
+			<< this->stats.framesDropped << " dropped)\n";
+		return str.str();
+	}
+
+	void FramePipeline::waitForSimulation()
+	{
+		if (!RenderThread::isBound() || !RenderThread::isRenderThread())
+			return;
+
+		std::lock_guard<std::mutex> guard(gPipelineLock);
+		for (auto& it : gPipelines)
+		{
+			FramePipeline* pipeline = it;
+			if (pipeline->isThreaded() && pipeline->isSimulating())
+				RenderThread::service([pipeline]() { return !pipeline->isSimulating(); });
+		}
+	}
+}
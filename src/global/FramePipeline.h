@@ -0,0 +1,120 @@
+#pragma once
+
+#include "global/Values.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace cs
+{
+	enum FramePipelineMode
+	{
+		FramePipelineSingleThreaded,	// simulate then render on the calling thread
+		FramePipelineThreaded,			// simulate frame N+1 on a worker while frame N is rendered
+		//...
+		FramePipelineMAX
+	};
+
+	struct FramePipelineStats
+	{
+		FramePipelineStats()
+			: framesSimulated(0)
+			, framesSubmitted(0)
+			, framesDropped(0)
+			, simulateTime(0)
+			, waitTime(0)
+			, captureTime(0)
+			, submitTime(0)
+			, latency(0)
+			, marshalledCalls(0)
+		{ }
+
+		uint64 framesSimulated;
+		uint64 framesSubmitted;
+		uint64 framesDropped;		// captured but replaced before they were submitted
+
+		// last frame, nanoseconds
+		uint64 simulateTime;
+		uint64 waitTime;			// render thread blocked on the simulation
+		uint64 captureTime;
+		uint64 submitTime;
+		uint64 latency;				// simulation start to the end of its submit
+
+		uint32 marshalledCalls;		// graphics calls the simulation handed to the render thread
+	};
+
+	// Runs a frame's simulation on its own thread so it overlaps with submitting the frame
+	// before it.  The render thread (the one that switched the pipeline on) drives it:
+	//
+	//   wait()		blocks until the kicked frame is simulated, running its graphics calls meanwhile
+	//   capture	(caller) snapshots what the simulation left for rendering
+	//   kick(dt)	starts simulating the next frame
+	//   submit		(caller) draws the snapshot
+	//
+	// so at most one frame is in simulation and one waiting to be drawn.  Single threaded,
+	// kick(dt) simulates inline and wait() returns straight away.
+	//
+	// Threaded needs CS_FRAME_PIPELINE_THREADED: uniform values, draw call overrides and draw
+	// callbacks aren't part of the captured frame yet, so submit reads them while they change.
+	class FramePipeline
+	{
+	public:
+
+		typedef std::function<void(float32)> SimulateFunc;
+
+		FramePipeline();
+		~FramePipeline();
+
+		void setSimulateFunc(const SimulateFunc& func) { this->simulate = func; }
+
+		void setMode(FramePipelineMode mode);
+		FramePipelineMode getMode() const { return this->mode; }
+		bool isThreaded() const { return this->mode == FramePipelineThreaded; }
+
+		void kick(float32 dt);
+		void wait();
+		bool isSimulating() const { return this->busy.load(std::memory_order_acquire); }
+
+		// Timing hooks for the caller's capture and submit
+		void beginCapture();
+		void endCapture();
+		void beginSubmit();
+		void endSubmit();
+		void dropFrame() { this->stats.framesDropped++; }
+
+		const FramePipelineStats& getStats() const { return this->stats; }
+		std::string getFrameReport() const;
+
+		// Waits out every threaded pipeline's simulation, for callers (input) that must not run
+		// alongside it.  Does nothing off the render thread.
+		static void waitForSimulation();
+
+	private:
+
+		void start();
+		void stop();
+		void run();
+
+		FramePipelineMode mode;
+		SimulateFunc simulate;
+
+		std::thread worker;
+		std::mutex lock;
+		std::condition_variable kicked;
+		bool running;
+		bool hasWork;
+		float32 pendingDt;
+		std::atomic<bool> busy;
+
+		uint64 kickTime;		// start of the frame in simulation
+		uint64 capturedTime;	// start of the frame waiting for submit
+		uint64 stageStart;
+		uint32 marshalledAtKick;
+
+		FramePipelineStats stats;
+	};
+}
@@ -118,6 +118,16 @@ namespace cs
 			assert(counter == numNodes);
 		}
 
+		void traverse(void(*traverseFunc)(T&, void*), void* data)
+		{
+			SharedNodePtr current = this->head;
+			while (current != nullptr)
+			{
+				traverseFunc(current->value, data);
+				current = current->next;
+			}
+		}
+
 		void empty()
 		{
 			SharedNodePtr cur = this->head; 
@@ -5,7 +5,7 @@
 namespace cs
 {
 
-	void NotificationCenter::addNotification(const std::string& name, CallbackPtr& callback)
+	void NotificationCenter::addNotification(const StringId& name, CallbackPtr& callback)
 	{
 		NotificationMap::iterator it = this->notifications.find(name);
 		Event* notification = nullptr;
@@ -14,6 +14,13 @@ namespace cs
 			this->notifications[name] = Event();
 			it = this->notifications.find(name);
 			notification = &(it)->second;
+
+			EventQueue* queue = EventQueue::getInstance();
+			queue->registerType(name, EventDispatchPostUpdate, true);
+			queue->addHandler(name, [name](const QueuedEvent&)
+			{
+				NotificationCenter::getInstance()->triggerNotification(name);
+			});
 		}
 		else
 		{
@@ -22,7 +29,7 @@ namespace cs
 		it->second.addCallback(callback);
 	}
 
-	bool NotificationCenter::triggerNotification(const std::string& name)
+	bool NotificationCenter::triggerNotification(const StringId& name)
 	{
 		NotificationMap::iterator it = this->notifications.find(name);
 		if (it == this->notifications.end())
@@ -32,4 +39,9 @@ namespace cs
 		it->second.invoke();
 		return true;
 	}
+
+	bool NotificationCenter::postNotification(const StringId& name)
+	{
+		return EventQueue::getInstance()->post(name);
+	}
 }
\ No newline at end of file
@@ -2,9 +2,10 @@
 
 #include "global/Singleton.h"
 #include "global/Event.h"
+#include "global/StringId.h"
+#include "global/EventQueue.h"
 
-#include <map>
-#include <string>
+#include <unordered_map>
 
 namespace cs
 {
@@ -13,12 +14,18 @@ namespace cs
 	public:
 
 		NotificationCenter() { }
-		void addNotification(const std::string& name, CallbackPtr& callback);
-		bool triggerNotification(const std::string& name);
+		void addNotification(const StringId& name, CallbackPtr& callback);
+
+		// Invokes the callbacks immediately, main thread only
+		bool triggerNotification(const StringId& name);
+
+		// Queues the notification for the next dispatch point, safe from any thread.  Repeats
+		// within a frame coalesce into a single trigger.
+		bool postNotification(const StringId& name);
 	
 	private:
 
-		typedef std::map<std::string, Event> NotificationMap;
+		typedef std::unordered_map<StringId, Event> NotificationMap;
 		NotificationMap notifications;
 
 	};
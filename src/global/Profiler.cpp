@@ -0,0 +1,299 @@
+#include "PCH.h"
+
+#include "global/Profiler.h"
+#include "os/LogManager.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace cs
+{
+	std::atomic<bool> Profiler::enabled(false);
+
+	static thread_local ProfileThreadBuffer* tThreadBuffer = nullptr;
+
+	static const std::chrono::steady_clock::time_point kProfilerEpoch = std::chrono::steady_clock::now();
+
+	static void writeJsonString(std::ostream& out, const char* str)
+	{
+		out << '"';
+		for (const char* c = str; c && *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				out << '\\';
+			if (uchar(*c) >= 0x20)
+				out << *c;
+		}
+		out << '"';
+	}
+
+	Profiler::Profiler()
+		: mainBuffer(nullptr)
+		, frameCount(0)
+		, frameStart(0)
+		, frameStartIndex(0)
+		, frameTime(0.0f)
+		, spikeThreshold(0.0f)
+	{
+
+	}
+
+	Profiler::~Profiler()
+	{
+		Profiler::enabled = false;
+		for (auto& buffer : this->buffers)
+		{
+			delete buffer;
+		}
+		this->buffers.clear();
+	}
+
+	void Profiler::setEnabled(bool enable)
+	{
+		Profiler::enabled.store(enable, std::memory_order_relaxed);
+	}
+
+	uint64 Profiler::now()
+	{
+		return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kProfilerEpoch).count());
+	}
+
+	ProfileThreadBuffer* Profiler::getThreadBuffer()
+	{
+		if (!tThreadBuffer)
+		{
+			tThreadBuffer = Profiler::getInstance()->registerThread();
+		}
+		return tThreadBuffer;
+	}
+
+	ProfileThreadBuffer* Profiler::registerThread()
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		ProfileThreadBuffer* buffer = new ProfileThreadBuffer(uint32(this->buffers.size()));
+
+		std::stringstream str;
+		str << "Thread " << buffer->threadIndex;
+		buffer->threadName = str.str();
+
+		this->buffers.push_back(buffer);
+		return buffer;
+	}
+
+	void Profiler::setThreadName(const std::string& name)
+	{
+		ProfileThreadBuffer* buffer = Profiler::getThreadBuffer();
+		std::lock_guard<std::mutex> guard(this->lock);
+		buffer->threadName = name;
+	}
+
+	void Profiler::counter(const char* name, int64 value)
+	{
+		ProfileThreadBuffer* buffer = Profiler::getThreadBuffer();
+
+		ProfileEvent evt;
+		evt.name = name;
+		evt.start = Profiler::now();
+		evt.duration = 0;
+		evt.value = value;
+		evt.depth = buffer->depth;
+		evt.type = ProfileEventCounter;
+		buffer->push(evt);
+	}
+
+	void ProfileScope::begin(const char* scopeName)
+	{
+		this->buffer = Profiler::getThreadBuffer();
+		this->name = scopeName;
+		this->depth = this->buffer->depth++;
+		this->start = Profiler::now();
+	}
+
+	void ProfileScope::end()
+	{
+		ProfileEvent evt;
+		evt.name = this->name;
+		evt.start = this->start;
+		evt.duration = Profiler::now() - this->start;
+		evt.value = 0;
+		evt.depth = this->depth;
+		evt.type = ProfileEventScope;
+
+		this->buffer->depth = this->depth;
+		this->buffer->push(evt);
+	}
+
+	void Profiler::markFrame()
+	{
+		uint64 timestamp = Profiler::now();
+		if (!Profiler::isEnabled())
+		{
+			// the first enabled frame starts fresh
+			this->frameStart = 0;
+			this->frameSamples.clear();
+			return;
+		}
+
+		ProfileThreadBuffer* buffer = Profiler::getThreadBuffer();
+		this->mainBuffer = buffer;
+
+		uint64 writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+		if (this->frameStart > 0)
+		{
+			ProfileEvent evt;
+			evt.name = "Frame";
+			evt.start = this->frameStart;
+			evt.duration = timestamp - this->frameStart;
+			evt.value = int64(this->frameCount);
+			evt.depth = 0;
+			evt.type = ProfileEventFrame;
+			buffer->push(evt);
+
+			this->frameTime = float32(double(evt.duration) / 1000000.0);
+			this->collectFrame(buffer, this->frameStartIndex, writeIndex);
+
+			if (this->spikeThreshold > 0.0f && this->frameTime > this->spikeThreshold)
+			{
+				std::stringstream path;
+				path << this->spikePath << "_" << this->frameCount << ".json";
+				log::info("Profiler: frame ", this->frameCount, " took ", this->frameTime, "ms, writing ", path.str());
+				this->writeChromeTrace(path.str(), this->frameStart, timestamp);
+			}
+		}
+
+		++this->frameCount;
+		this->frameStart = timestamp;
+		this->frameStartIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+	}
+
+	void Profiler::collectFrame(ProfileThreadBuffer* buffer, uint64 fromIndex, uint64 toIndex)
+	{
+		this->frameSamples.clear();
+
+		uint64 oldest = (toIndex > ProfileThreadBuffer::kCapacity) ? toIndex - ProfileThreadBuffer::kCapacity : 0;
+		for (uint64 i = std::max<uint64>(fromIndex, oldest); i < toIndex; ++i)
+		{
+			const ProfileEvent& evt = buffer->events[i & (ProfileThreadBuffer::kCapacity - 1)];
+			ProfileSample& sample = this->frameSamples[evt.name];
+			if (evt.type == ProfileEventCounter)
+			{
+				sample.value += evt.value;
+			}
+			else
+			{
+				sample.time += evt.duration;
+			}
+			sample.calls++;
+		}
+	}
+
+	float32 Profiler::getScopeTime(const char* name) const
+	{
+		SampleMap::const_iterator it = this->frameSamples.find(name);
+		if (it == this->frameSamples.end())
+			return 0.0f;
+		return float32(double(it->second.time) / 1000000.0);
+	}
+
+	std::string Profiler::getFrameReport() const
+	{
+		typedef std::pair<const char*, ProfileSample> SampleEntry;
+		std::vector<SampleEntry> sorted(this->frameSamples.begin(), this->frameSamples.end());
+		std::sort(sorted.begin(), sorted.end(), [](const SampleEntry& a, const SampleEntry& b)
+		{
+			return a.second.time > b.second.time;
+		});
+
+		std::stringstream str;
+		str << std::fixed << std::setprecision(3);
+		str << "Frame " << this->frameCount << ": " << this->frameTime << "ms" << std::endl;
+		for (auto& it : sorted)
+		{
+			if (it.second.time > 0)
+			{
+				str << it.first << ": " << double(it.second.time) / 1000000.0 << "ms, " << it.second.calls << " calls" << std::endl;
+			}
+			else
+			{
+				str << it.first << ": " << it.second.value << std::endl;
+			}
+		}
+		return str.str();
+	}
+
+	void Profiler::setSpikeCapture(float32 thresholdMs, const std::string& pathPrefix)
+	{
+		this->spikeThreshold = thresholdMs;
+		this->spikePath = pathPrefix;
+	}
+
+	bool Profiler::writeChromeTrace(const std::string& path, uint64 from, uint64 to)
+	{
+		std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+		if (!out.is_open())
+		{
+			log::error("Profiler: could not open ", path, " for writing");
+			return false;
+		}
+
+		std::vector<ProfileThreadBuffer*> snapshot;
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			snapshot = this->buffers;
+		}
+
+		out << std::fixed << std::setprecision(3);
+		out << "{\"traceEvents\":[" << std::endl;
+
+		bool first = true;
+		for (auto& buffer : snapshot)
+		{
+			if (!first)
+				out << "," << std::endl;
+			first = false;
+
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex << ",\"args\":{\"name\":";
+				writeJsonString(out, buffer->threadName.c_str());
+				out << "}}";
+			}
+
+			// stay clear of the slots the owning thread may be overwriting right now
+			uint64 writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+			uint64 window = ProfileThreadBuffer::kCapacity - ProfileThreadBuffer::kReadGuard;
+			uint64 oldest = (writeIndex > window) ? writeIndex - window : 0;
+
+			for (uint64 i = oldest; i < writeIndex; ++i)
+			{
+				const ProfileEvent& evt = buffer->events[i & (ProfileThreadBuffer::kCapacity - 1)];
+				if (evt.start < from || evt.start > to)
+					continue;
+
+				out << "," << std::endl << "{\"name\":";
+				writeJsonString(out, evt.name);
+				out << ",\"pid\":1,\"tid\":" << buffer->threadIndex << ",\"ts\":" << double(evt.start) / 1000.0;
+
+				switch (evt.type)
+				{
+					case ProfileEventScope:
+						out << ",\"ph\":\"X\",\"dur\":" << double(evt.duration) / 1000.0 << "}";
+						break;
+					case ProfileEventCounter:
+						out << ",\"ph\":\"C\",\"args\":{\"value\":" << evt.value << "}}";
+						break;
+					case ProfileEventFrame:
+						out << ",\"ph\":\"X\",\"cat\":\"frame\",\"dur\":" << double(evt.duration) / 1000.0 << ",\"args\":{\"frame\":" << evt.value << "}}";
+						break;
+				}
+			}
+		}
+
+		out << std::endl << "]}" << std::endl;
+		out.close();
+		return true;
+	}
+}
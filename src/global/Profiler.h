@@ -0,0 +1,173 @@
+#pragma once
+
+#include "global/Values.h"
+#include "global/Singleton.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+// Define CS_PROFILER_DISABLED to compile every profile macro out entirely
+#if !defined(CS_PROFILER_DISABLED)
+	#define CS_PROFILE_CONCAT_IMPL(a, b) a##b
+	#define CS_PROFILE_CONCAT(a, b) CS_PROFILE_CONCAT_IMPL(a, b)
+	#define PROFILE_SCOPE(name) cs::ProfileScope CS_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define PROFILE_COUNTER(name, value) do { if (cs::Profiler::isEnabled()) { cs::Profiler::counter(name, int64(value)); } } while (0)
+	#define PROFILE_FRAME() cs::Profiler::getInstance()->markFrame()
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_COUNTER(name, value) do { } while (0)
+	#define PROFILE_FRAME()
+#endif
+
+namespace cs
+{
+	enum ProfileEventType
+	{
+		ProfileEventScope,
+		ProfileEventCounter,
+		ProfileEventFrame
+	};
+
+	// Names are stored by pointer and must outlive the profiler, use string literals
+	struct ProfileEvent
+	{
+		const char* name;
+		uint64 start;		// nanoseconds since the profiler started
+		uint64 duration;	// nanoseconds, scopes and frames only
+		int64 value;		// counters only
+		uint16 depth;
+		uint16 type;
+	};
+
+	struct ProfileSample
+	{
+		ProfileSample()
+			: time(0)
+			, calls(0)
+			, value(0) { }
+
+		uint64 time;
+		uint32 calls;
+		int64 value;
+	};
+
+	// Written only by its owning thread, the write index is published with release
+	// ordering so readers on other threads see complete events
+	struct ProfileThreadBuffer
+	{
+		static const uint32 kCapacity = 8192;
+		static const uint32 kReadGuard = 256;
+
+		ProfileThreadBuffer(uint32 idx)
+			: writeIndex(0)
+			, depth(0)
+			, threadIndex(idx) { }
+
+		void push(const ProfileEvent& evt)
+		{
+			uint64 idx = this->writeIndex.load(std::memory_order_relaxed);
+			this->events[idx & (kCapacity - 1)] = evt;
+			this->writeIndex.store(idx + 1, std::memory_order_release);
+		}
+
+		ProfileEvent events[kCapacity];
+		std::atomic<uint64> writeIndex;
+		uint16 depth;
+		uint32 threadIndex;
+		std::string threadName;
+	};
+
+	// Hierarchical instrumentation: nested scopes with nanosecond timestamps, counters and
+	// frame markers, recorded into per-thread ring buffers and exportable as Chrome trace
+	// JSON (chrome://tracing or Perfetto).  Disabled it costs one relaxed atomic load per scope.
+	class Profiler : public Singleton<Profiler>
+	{
+	public:
+
+		typedef std::unordered_map<const char*, ProfileSample> SampleMap;
+
+		Profiler();
+		~Profiler();
+
+		static inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+		void setEnabled(bool enable);
+
+		static uint64 now();
+		static void counter(const char* name, int64 value);
+
+		static ProfileThreadBuffer* getThreadBuffer();
+		void setThreadName(const std::string& name);
+
+		// Closes the previous frame and opens the next, call once at the top of the main loop
+		void markFrame();
+
+		uint64 getFrameCount() const { return this->frameCount; }
+		float32 getFrameTime() const { return this->frameTime; }
+
+		// Main thread scope and counter totals for the previous frame
+		const SampleMap& getFrameSamples() const { return this->frameSamples; }
+		float32 getScopeTime(const char* name) const;
+		std::string getFrameReport() const;
+
+		// Any frame slower than thresholdMs is written to <pathPrefix>_<frame>.json, 0 turns it off
+		void setSpikeCapture(float32 thresholdMs, const std::string& pathPrefix);
+
+		// Everything still in the buffers between [from, to], timestamps in nanoseconds
+		bool writeChromeTrace(const std::string& path, uint64 from = 0, uint64 to = ~uint64(0));
+
+	private:
+
+		ProfileThreadBuffer* registerThread();
+		void collectFrame(ProfileThreadBuffer* buffer, uint64 fromIndex, uint64 toIndex);
+
+		static std::atomic<bool> enabled;
+
+		std::mutex lock;
+		std::vector<ProfileThreadBuffer*> buffers;
+
+		ProfileThreadBuffer* mainBuffer;
+		uint64 frameCount;
+		uint64 frameStart;
+		uint64 frameStartIndex;
+		float32 frameTime;
+		SampleMap frameSamples;
+
+		float32 spikeThreshold;
+		std::string spikePath;
+	};
+
+	class ProfileScope
+	{
+	public:
+
+		ProfileScope(const char* name)
+			: buffer(nullptr)
+		{
+			if (Profiler::isEnabled())
+			{
+				this->begin(name);
+			}
+		}
+
+		~ProfileScope()
+		{
+			if (this->buffer)
+			{
+				this->end();
+			}
+		}
+
+	private:
+
+		void begin(const char* name);
+		void end();
+
+		ProfileThreadBuffer* buffer;
+		const char* name;
+		uint64 start;
+		uint16 depth;
+	};
+}
@@ -0,0 +1,363 @@
+#include "PCH.h"
+
+#include "global/Random.h"
+
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define CS_RANDOM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define CS_RANDOM_NEON
+#endif
+
+namespace cs
+{
+	const float32 RandomStream::kToFloat = 1.0f / 16777216.0f;
+
+	const float32 kRandomTwoPi = float32(3.14159265358979323846 * 2.0);
+	const size_t kRandomChunkSize = 64;
+
+	static std::atomic<uint64> sRandomBaseSeed(0x2545F4914F6CDD1DULL);
+	static std::atomic<uint64> sRandomStreamCount(0);
+
+	static inline uint64 splitMix64(uint64& x)
+	{
+		uint64 z = (x += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	static inline uint32 rotl32(uint32 x, int32 k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+
+	RandomStream::RandomStream()
+	{
+		this->seed(Random::nextStreamSeed());
+	}
+
+	RandomStream::RandomStream(uint64 s)
+	{
+		this->seed(s);
+	}
+
+	void RandomStream::seed(uint64 s)
+	{
+		this->seedValue = s;
+		this->bufferIndex = kLanes;
+
+		uint64 x = s;
+		for (uint32 lane = 0; lane < kLanes; ++lane)
+		{
+			uint64 a = splitMix64(x);
+			uint64 b = splitMix64(x);
+			this->state[0][lane] = uint32(a);
+			this->state[1][lane] = uint32(a >> 32);
+			this->state[2][lane] = uint32(b);
+			this->state[3][lane] = uint32(b >> 32);
+
+			// the all zero state is the one xoshiro can't leave
+			if ((this->state[0][lane] | this->state[1][lane] | this->state[2][lane] | this->state[3][lane]) == 0)
+			{
+				this->state[0][lane] = 1;
+			}
+		}
+	}
+
+#if defined(CS_RANDOM_SSE2)
+
+	#define CS_RANDOM_STEP(result) \
+		__m128i s0 = _mm_loadu_si128((const __m128i*) this->state[0]); \
+		__m128i s1 = _mm_loadu_si128((const __m128i*) this->state[1]); \
+		__m128i s2 = _mm_loadu_si128((const __m128i*) this->state[2]); \
+		__m128i s3 = _mm_loadu_si128((const __m128i*) this->state[3]); \
+		__m128i result = _mm_add_epi32(s0, s3); \
+		__m128i t = _mm_slli_epi32(s1, 9); \
+		s2 = _mm_xor_si128(s2, s0); \
+		s3 = _mm_xor_si128(s3, s1); \
+		s1 = _mm_xor_si128(s1, s2); \
+		s0 = _mm_xor_si128(s0, s3); \
+		s2 = _mm_xor_si128(s2, t); \
+		s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21)); \
+		_mm_storeu_si128((__m128i*) this->state[0], s0); \
+		_mm_storeu_si128((__m128i*) this->state[1], s1); \
+		_mm_storeu_si128((__m128i*) this->state[2], s2); \
+		_mm_storeu_si128((__m128i*) this->state[3], s3);
+
+	void RandomStream::step(uint32* out)
+	{
+		CS_RANDOM_STEP(result);
+		_mm_storeu_si128((__m128i*) out, result);
+	}
+
+	void RandomStream::stepFloat(float32* out)
+	{
+		CS_RANDOM_STEP(result);
+		__m128 values = _mm_cvtepi32_ps(_mm_srli_epi32(result, 8));
+		_mm_storeu_ps(out, _mm_mul_ps(values, _mm_set1_ps(kToFloat)));
+	}
+
+	#undef CS_RANDOM_STEP
+
+#elif defined(CS_RANDOM_NEON)
+
+	#define CS_RANDOM_STEP(result) \
+		uint32x4_t s0 = vld1q_u32(this->state[0]); \
+		uint32x4_t s1 = vld1q_u32(this->state[1]); \
+		uint32x4_t s2 = vld1q_u32(this->state[2]); \
+		uint32x4_t s3 = vld1q_u32(this->state[3]); \
+		uint32x4_t result = vaddq_u32(s0, s3); \
+		uint32x4_t t = vshlq_n_u32(s1, 9); \
+		s2 = veorq_u32(s2, s0); \
+		s3 = veorq_u32(s3, s1); \
+		s1 = veorq_u32(s1, s2); \
+		s0 = veorq_u32(s0, s3); \
+		s2 = veorq_u32(s2, t); \
+		s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21)); \
+		vst1q_u32(this->state[0], s0); \
+		vst1q_u32(this->state[1], s1); \
+		vst1q_u32(this->state[2], s2); \
+		vst1q_u32(this->state[3], s3);
+
+	void RandomStream::step(uint32* out)
+	{
+		CS_RANDOM_STEP(result);
+		vst1q_u32(out, result);
+	}
+
+	void RandomStream::stepFloat(float32* out)
+	{
+		CS_RANDOM_STEP(result);
+		float32x4_t values = vcvtq_f32_u32(vshrq_n_u32(result, 8));
+		vst1q_f32(out, vmulq_n_f32(values, kToFloat));
+	}
+
+	#undef CS_RANDOM_STEP
+
+#else
+
+	void RandomStream::step(uint32* out)
+	{
+		for (uint32 lane = 0; lane < kLanes; ++lane)
+		{
+			uint32 s0 = this->state[0][lane];
+			uint32 s1 = this->state[1][lane];
+			uint32 s2 = this->state[2][lane];
+			uint32 s3 = this->state[3][lane];
+
+			out[lane] = s0 + s3;
+
+			uint32 t = s1 << 9;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = rotl32(s3, 11);
+
+			this->state[0][lane] = s0;
+			this->state[1][lane] = s1;
+			this->state[2][lane] = s2;
+			this->state[3][lane] = s3;
+		}
+	}
+
+	void RandomStream::stepFloat(float32* out)
+	{
+		uint32 values[kLanes];
+		this->step(values);
+		for (uint32 lane = 0; lane < kLanes; ++lane)
+		{
+			out[lane] = float32(values[lane] >> 8) * kToFloat;
+		}
+	}
+
+#endif
+
+	void RandomStream::fillUInt(uint32* values, size_t count)
+	{
+		size_t i = 0;
+		for (; i + kLanes <= count; i += kLanes)
+		{
+			this->step(values + i);
+		}
+
+		for (; i < count; ++i)
+		{
+			values[i] = this->nextUInt();
+		}
+	}
+
+	void RandomStream::fillUniform(float32* values, size_t count)
+	{
+		size_t i = 0;
+		for (; i + kLanes <= count; i += kLanes)
+		{
+			this->stepFloat(values + i);
+		}
+
+		for (; i < count; ++i)
+		{
+			values[i] = this->nextFloat();
+		}
+	}
+
+	void RandomStream::fillRange(float32* values, size_t count, float32 min, float32 max)
+	{
+		this->fillUniform(values, count);
+
+		float32 range = max - min;
+		for (size_t i = 0; i < count; ++i)
+		{
+			values[i] = min + range * values[i];
+		}
+	}
+
+	void RandomStream::fillRange(vec2* values, size_t count, const vec2& min, const vec2& max)
+	{
+		static_assert(sizeof(vec2) == sizeof(float32) * 2, "vec2 must be tightly packed");
+		this->fillUniform(&values[0].x, count * 2);
+
+		vec2 range = max - min;
+		for (size_t i = 0; i < count; ++i)
+		{
+			values[i] = min + range * values[i];
+		}
+	}
+
+	void RandomStream::fillRange(vec3* values, size_t count, const vec3& min, const vec3& max)
+	{
+		static_assert(sizeof(vec3) == sizeof(float32) * 3, "vec3 must be tightly packed");
+		this->fillUniform(&values[0].x, count * 3);
+
+		vec3 range = max - min;
+		for (size_t i = 0; i < count; ++i)
+		{
+			values[i] = min + range * values[i];
+		}
+	}
+
+	vec2 RandomStream::nextUnitVector2()
+	{
+		float32 angle = this->nextFloat() * kRandomTwoPi;
+		return vec2(cosf(angle), sinf(angle));
+	}
+
+	vec3 RandomStream::nextUnitVector3()
+	{
+		float32 z = this->nextFloat() * 2.0f - 1.0f;
+		float32 angle = this->nextFloat() * kRandomTwoPi;
+		float32 r = sqrtf(std::max<float32>(0.0f, 1.0f - z * z));
+		return vec3(r * cosf(angle), r * sinf(angle), z);
+	}
+
+	vec3 RandomStream::nextCone(const vec3& direction, float32 angle)
+	{
+		vec3 value;
+		this->fillCone(&value, 1, direction, angle);
+		return value;
+	}
+
+	void RandomStream::fillUnitVector2(vec2* values, size_t count)
+	{
+		float32 angles[kRandomChunkSize];
+		for (size_t start = 0; start < count; start += kRandomChunkSize)
+		{
+			size_t num = std::min<size_t>(kRandomChunkSize, count - start);
+			this->fillUniform(angles, num);
+
+			for (size_t i = 0; i < num; ++i)
+			{
+				float32 angle = angles[i] * kRandomTwoPi;
+				values[start + i] = vec2(cosf(angle), sinf(angle));
+			}
+		}
+	}
+
+	void RandomStream::fillUnitVector3(vec3* values, size_t count)
+	{
+		float32 samples[kRandomChunkSize * 2];
+		for (size_t start = 0; start < count; start += kRandomChunkSize)
+		{
+			size_t num = std::min<size_t>(kRandomChunkSize, count - start);
+			this->fillUniform(samples, num * 2);
+
+			for (size_t i = 0; i < num; ++i)
+			{
+				float32 z = samples[i * 2] * 2.0f - 1.0f;
+				float32 angle = samples[i * 2 + 1] * kRandomTwoPi;
+				float32 r = sqrtf(std::max<float32>(0.0f, 1.0f - z * z));
+				values[start + i] = vec3(r * cosf(angle), r * sinf(angle), z);
+			}
+		}
+	}
+
+	void RandomStream::fillCone(vec3* values, size_t count, const vec3& direction, float32 angle)
+	{
+		vec3 axis = glm::normalize(direction);
+		vec3 helper = (fabsf(axis.x) > 0.9f) ? vec3(0.0f, 1.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f);
+		vec3 tangent = glm::normalize(glm::cross(helper, axis));
+		vec3 bitangent = glm::cross(axis, tangent);
+
+		float32 minCos = cosf(angle);
+
+		float32 samples[kRandomChunkSize * 2];
+		for (size_t start = 0; start < count; start += kRandomChunkSize)
+		{
+			size_t num = std::min<size_t>(kRandomChunkSize, count - start);
+			this->fillUniform(samples, num * 2);
+
+			for (size_t i = 0; i < num; ++i)
+			{
+				float32 cosTheta = 1.0f - samples[i * 2] * (1.0f - minCos);
+				float32 sinTheta = sqrtf(std::max<float32>(0.0f, 1.0f - cosTheta * cosTheta));
+				float32 phi = samples[i * 2 + 1] * kRandomTwoPi;
+				values[start + i] =
+					tangent * (sinTheta * cosf(phi)) +
+					bitangent * (sinTheta * sinf(phi)) +
+					axis * cosTheta;
+			}
+		}
+	}
+
+	static thread_local RandomStream* tCurrentStream = nullptr;
+
+	static RandomStream& getThreadDefaultStream()
+	{
+		static thread_local RandomStream stream;
+		return stream;
+	}
+
+	RandomStream& Random::get()
+	{
+		if (tCurrentStream)
+			return *tCurrentStream;
+		return getThreadDefaultStream();
+	}
+
+	RandomStream* Random::setCurrent(RandomStream* stream)
+	{
+		RandomStream* prev = tCurrentStream;
+		tCurrentStream = stream;
+		return prev;
+	}
+
+	void Random::setGlobalSeed(uint64 s)
+	{
+		sRandomBaseSeed = s;
+		sRandomStreamCount = 0;
+		getThreadDefaultStream().seed(Random::nextStreamSeed());
+	}
+
+	uint64 Random::nextStreamSeed()
+	{
+		uint64 x = sRandomBaseSeed.load() + sRandomStreamCount.fetch_add(1);
+		return splitMix64(x);
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "global/Values.h"
+#include "math/GLM.h"
+
+namespace cs
+{
+	// Four interleaved xoshiro128+ generators stepped together, one SIMD register per state
+	// word.  Single draws are served from the last step's four outputs, the fill functions
+	// write whole blocks of four at a time.  A stream is plain data and can be copied to
+	// snapshot it or reseeded to replay a sequence.
+	class RandomStream
+	{
+	public:
+
+		static const uint32 kLanes = 4;
+
+		RandomStream();
+		explicit RandomStream(uint64 seed);
+
+		void seed(uint64 seed);
+		uint64 getSeed() const { return this->seedValue; }
+
+		// restart the sequence from the current seed
+		void reset() { this->seed(this->seedValue); }
+
+		inline uint32 nextUInt()
+		{
+			if (this->bufferIndex >= kLanes)
+			{
+				this->step(this->buffer);
+				this->bufferIndex = 0;
+			}
+			return this->buffer[this->bufferIndex++];
+		}
+
+		// [0, bound)
+		inline uint32 nextUInt(uint32 bound)
+		{
+			return uint32((uint64(this->nextUInt()) * uint64(bound)) >> 32);
+		}
+
+		// [0, 1) with 24 bits of precision
+		inline float32 nextFloat()
+		{
+			return float32(this->nextUInt() >> 8) * kToFloat;
+		}
+
+		inline float32 nextRange(float32 min, float32 max)
+		{
+			return min + (max - min) * this->nextFloat();
+		}
+
+		vec2 nextUnitVector2();
+		vec3 nextUnitVector3();
+		vec3 nextCone(const vec3& direction, float32 angle);
+
+		// Bulk generation
+		void fillUInt(uint32* values, size_t count);
+		void fillUniform(float32* values, size_t count);
+		void fillRange(float32* values, size_t count, float32 min, float32 max);
+		void fillRange(vec2* values, size_t count, const vec2& min, const vec2& max);
+		void fillRange(vec3* values, size_t count, const vec3& min, const vec3& max);
+		void fillUnitVector2(vec2* values, size_t count);
+		void fillUnitVector3(vec3* values, size_t count);
+		// uniform over the spherical cap of half angle (radians) around direction
+		void fillCone(vec3* values, size_t count, const vec3& direction, float32 angle);
+
+	private:
+
+		static const float32 kToFloat;
+
+		void step(uint32* out);
+		void stepFloat(float32* out);
+
+		// state[word][lane]
+		uint32 state[4][kLanes];
+		uint32 buffer[kLanes];
+		uint32 bufferIndex;
+		uint64 seedValue;
+	};
+
+	class Random
+	{
+	public:
+
+		// The calling thread's current stream, never shared between threads
+		static RandomStream& get();
+
+		// Reseeds the calling thread and every stream created after this from a fixed base
+		static void setGlobalSeed(uint64 seed);
+
+		// A fresh seed for a new independent stream
+		static uint64 nextStreamSeed();
+
+	private:
+
+		friend class RandomStreamScope;
+
+		static RandomStream* setCurrent(RandomStream* stream);
+	};
+
+	// Routes Random::get() on this thread to the given stream for the lifetime of the scope,
+	// used by emitters so everything they spawn draws from their own seeded stream
+	class RandomStreamScope
+	{
+	public:
+
+		RandomStreamScope(RandomStream& stream)
+			: prev(Random::setCurrent(&stream))
+		{ }
+
+		~RandomStreamScope()
+		{
+			Random::setCurrent(this->prev);
+		}
+
+	private:
+
+		RandomStream* prev;
+	};
+}
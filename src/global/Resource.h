@@ -5,6 +5,7 @@
 #include <string>
 #include <fstream>
 #include "os/LogManager.h"
+#include "global/StringId.h"
 
 
 namespace cs
@@ -15,6 +16,7 @@ namespace cs
 
 		Resource(const std::string& nname) 
 			: name(nname)
+			, nameId(nname)
 			, flushable(true)
 		{ 
 #if defined(LOG_RESOURCE_CREATION)
@@ -30,13 +32,18 @@ namespace cs
 		}
 
 		const std::string& getName() const { return this->name; }
+		const StringId& getNameId() const { return this->nameId; }
 		void setFlushable(bool flush) { this->flushable = flush; }
 
 	protected:
 
-		Resource() : name("error") { }
+		Resource() 
+			: name("error")
+			, nameId("error")
+		{ }
 
 		std::string name;
+		StringId nameId;
 		bool flushable;
 	
 	};
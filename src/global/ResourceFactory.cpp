@@ -106,6 +106,7 @@ namespace cs
 		if (!initialized)
 		{
 			LoadersByExtension["png"] = [](const std::string& fileName) { return ResourceFactory::getInstance()->loadResource<Texture>(fileName); };
+			LoadersByExtension["cstex"] = [](const std::string& fileName) { return ResourceFactory::getInstance()->loadResource<Texture>(fileName); };
 			LoadersByExtension["obj"] = [](const std::string& fileName) { return ResourceFactory::getInstance()->loadResource<Mesh>(fileName); };
 			LoadersByExtension["prop"] = [](const std::string& fileName) { return ResourceFactory::getInstance()->loadResource<PropertySetResource>(fileName); };
 			LoadersByExtension["entity"] = [](const std::string& fileName) { return ResourceFactory::getInstance()->loadResource<SceneReference>(fileName); };
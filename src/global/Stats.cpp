@@ -22,6 +22,11 @@ namespace cs
 		gStatKeeper[type] += sz;
 	}
 
+	void EngineStats::setStat(StatType type, int32 value)
+	{
+		gStatKeeper[type] = value;
+	}
+
 	void EngineStats::decrementStat(StatType type)
 	{
 		--gStatKeeper[type];
@@ -43,7 +48,14 @@ namespace cs
 			"Texture",
 			"Particle Heap",
 			"Buffer Size",
-			"Texture Size"
+			"Texture Size",
+			"Lua Heap Size",
+			"Lua Alloc Rate",
+			"Particles",
+			"Particle Budget",
+			"Particles Culled",
+			"Mesh Triangles",
+			"Mesh Triangles (Full Detail)"
 		};
 
 		return kStatTag[type];
@@ -52,7 +64,9 @@ namespace cs
 	bool EngineStats::isSize(StatType type)
 	{
 		if (type == StatTypeBufferSize ||
-			type == StatTypeTextureSize)
+			type == StatTypeTextureSize ||
+			type == StatTypeLuaHeapSize ||
+			type == StatTypeLuaAllocRate)
 		{
 			return true;
 		}
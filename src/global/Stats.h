@@ -12,6 +12,7 @@ namespace cs
 		static void incrementStat(StatType type);
 		static void decrementStat(StatType type);
 		static void incrementStatBy(StatType type, int32 sz);
+		static void setStat(StatType type, int32 value);
 		static int32 getStat(StatType type);
 		static const char* getTag(StatType type);
 		static bool isSize(StatType type);
@@ -0,0 +1,108 @@
+#include "PCH.h"
+
+#include "global/StringId.h"
+#include "os/LogManager.h"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace cs
+{
+
+#if defined(CS_STRING_ID_LOOKUP)
+
+	typedef std::unordered_map<uint32, std::string> StringIdTable;
+
+	// ids get built during static initialisation elsewhere, so the table can't be a plain global
+	static StringIdTable& getStringIdTable()
+	{
+		static StringIdTable table;
+		return table;
+	}
+
+	static std::mutex& getStringIdMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+#endif
+
+	StringId::StringId(const char* str)
+		: hash(0)
+	{
+		if (str)
+			this->intern(str, strlen(str));
+	}
+
+	StringId::StringId(const std::string& str)
+		: hash(0)
+	{
+		this->intern(str.c_str(), str.length());
+	}
+
+	uint32 StringId::hashString(const char* str, size_t length)
+	{
+		if (length == 0)
+			return 0;
+
+		// FNV-1a
+		uint32 value = 2166136261u;
+		for (size_t i = 0; i < length; ++i)
+		{
+			value ^= uint32(uchar(str[i]));
+			value *= 16777619u;
+		}
+
+		// zero is kept for the empty string
+		return (value != 0) ? value : 1;
+	}
+
+	void StringId::intern(const char* str, size_t length)
+	{
+		this->hash = StringId::hashString(str, length);
+
+#if defined(CS_STRING_ID_LOOKUP)
+		if (this->hash == 0)
+			return;
+
+		std::lock_guard<std::mutex> lock(getStringIdMutex());
+		StringIdTable& table = getStringIdTable();
+		StringIdTable::iterator it = table.find(this->hash);
+		if (it == table.end())
+		{
+			table[this->hash] = std::string(str, length);
+		}
+		else if (it->second.compare(0, std::string::npos, str, length) != 0)
+		{
+			log::error("String id collision between ", it->second, " and ", std::string(str, length));
+		}
+#endif
+	}
+
+	const std::string& StringId::getString() const
+	{
+		static const std::string kNoString;
+
+#if defined(CS_STRING_ID_LOOKUP)
+		std::lock_guard<std::mutex> lock(getStringIdMutex());
+		StringIdTable& table = getStringIdTable();
+		StringIdTable::const_iterator it = table.find(this->hash);
+		if (it != table.end())
+			return it->second;
+#endif
+
+		return kNoString;
+	}
+
+	std::ostream& operator<<(std::ostream& os, const StringId& rhs)
+	{
+#if defined(CS_STRING_ID_LOOKUP)
+		os << rhs.getString();
+#else
+		os << "#" << rhs.getHash();
+#endif
+		return os;
+	}
+}
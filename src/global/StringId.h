@@ -0,0 +1,61 @@
+#pragma once
+
+#include "global/Values.h"
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Keeps the text behind every id for logs, debug scopes and the tag breakpoint.  Shipping
+// builds carry the hash alone.
+#if defined(_DEBUG) || defined(CS_EDITOR)
+	#define CS_STRING_ID_LOOKUP
+#endif
+
+namespace cs
+{
+	// A name interned as a 32 bit hash, as cheap to copy, compare and key a map with as an int.
+	// Hashing still walks the string, so fixed names are best built once (a static or a member)
+	// and the id passed around the frame instead.
+	class StringId
+	{
+	public:
+
+		StringId() 
+			: hash(0) 
+		{ }
+
+		StringId(const char* str);
+		StringId(const std::string& str);
+
+		uint32 getHash() const { return this->hash; }
+		bool isEmpty() const { return this->hash == 0; }
+
+		// The interned text, empty when the lookup is compiled out
+		const std::string& getString() const;
+		const char* c_str() const { return this->getString().c_str(); }
+
+		bool operator==(const StringId& rhs) const { return this->hash == rhs.hash; }
+		bool operator!=(const StringId& rhs) const { return this->hash != rhs.hash; }
+		bool operator<(const StringId& rhs) const { return this->hash < rhs.hash; }
+
+		static uint32 hashString(const char* str, size_t length);
+
+	private:
+
+		void intern(const char* str, size_t length);
+
+		uint32 hash;
+	};
+
+	std::ostream& operator<<(std::ostream& os, const StringId& rhs);
+}
+
+namespace std
+{
+	template <>
+	struct hash<cs::StringId>
+	{
+		size_t operator()(const cs::StringId& id) const { return size_t(id.getHash()); }
+	};
+}
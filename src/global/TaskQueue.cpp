@@ -0,0 +1,147 @@
+#include "PCH.h"
+
+#include "global/TaskQueue.h"
+#include "global/Profiler.h"
+
+#include <algorithm>
+
+namespace cs
+{
+	TaskQueue::TaskQueue()
+		: active(0)
+		, running(true)
+	{
+		uint32 numThreads = std::thread::hardware_concurrency();
+		numThreads = (numThreads > 1) ? numThreads - 1 : 1;
+
+		for (uint32 i = 0; i < numThreads; ++i)
+		{
+			this->workers.push_back(std::thread(&TaskQueue::run, this));
+		}
+	}
+
+	TaskQueue::~TaskQueue()
+	{
+		{
+			std::unique_lock<std::mutex> guard(this->lock);
+			this->running = false;
+		}
+		this->available.notify_all();
+
+		for (auto& it : this->workers)
+		{
+			it.join();
+		}
+	}
+
+	void TaskQueue::push(const Task& task)
+	{
+		{
+			std::unique_lock<std::mutex> guard(this->lock);
+			this->tasks.push_back(task);
+		}
+		this->available.notify_one();
+	}
+
+	void TaskQueue::parallel(uint32 count, const IndexedTask& func)
+	{
+		if (count == 0)
+			return;
+
+		if (count == 1)
+		{
+			func(0);
+			return;
+		}
+
+		// helpers may be popped after we return, so they only hold shared state
+		struct ParallelState
+		{
+			ParallelState(uint32 n, const IndexedTask& f) : next(0), remaining(n), count(n), func(f) { }
+
+			void drain()
+			{
+				uint32 idx;
+				while ((idx = this->next++) < this->count)
+				{
+					this->func(idx);
+					--this->remaining;
+				}
+			}
+
+			std::atomic<uint32> next;
+			std::atomic<uint32> remaining;
+			uint32 count;
+			IndexedTask func;
+		};
+
+		std::shared_ptr<ParallelState> state = std::make_shared<ParallelState>(count, func);
+
+		uint32 numHelpers = std::min<uint32>(count - 1, this->getNumWorkers());
+		for (uint32 i = 0; i < numHelpers; ++i)
+		{
+			this->push([state]() { state->drain(); });
+		}
+
+		state->drain();
+
+		while (state->remaining > 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	void TaskQueue::flush()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		this->idle.wait(guard, [this]() { return this->tasks.empty() && this->active == 0; });
+	}
+
+	size_t TaskQueue::getNumPending()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		return this->tasks.size() + this->active;
+	}
+
+	bool TaskQueue::popTask(Task& task, bool wait)
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		if (wait)
+		{
+			this->available.wait(guard, [this]() { return !this->tasks.empty() || !this->running; });
+		}
+
+		if (this->tasks.empty())
+			return false;
+
+		task = this->tasks.front();
+		this->tasks.pop_front();
+		++this->active;
+		return true;
+	}
+
+	void TaskQueue::run()
+	{
+		Profiler::getInstance()->setThreadName("TaskQueue Worker");
+
+		Task task;
+		while (this->running)
+		{
+			if (!this->popTask(task, true))
+				continue;
+
+			{
+				PROFILE_SCOPE("Task");
+				task();
+			}
+			task = nullptr;
+
+			std::unique_lock<std::mutex> guard(this->lock);
+			--this->active;
+			if (this->tasks.empty() && this->active == 0)
+			{
+				this->idle.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "global/Values.h"
+#include "global/Singleton.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+namespace cs
+{
+	// Small fixed pool of worker threads for fire-and-forget jobs (glyph rasterisation,
+	// asset cooking, etc).  Tasks must not touch the render interface - hand results
+	// back to the main thread and upload them there.
+	class TaskQueue : public Singleton<TaskQueue>
+	{
+	public:
+
+		typedef std::function<void()> Task;
+		typedef std::function<void(uint32)> IndexedTask;
+
+		TaskQueue();
+		~TaskQueue();
+
+		void push(const Task& task);
+
+		// Runs func(0..count-1) across the workers and the calling thread, returns when all are done
+		void parallel(uint32 count, const IndexedTask& func);
+
+		// Blocks until every queued task has finished
+		void flush();
+
+		uint32 getNumWorkers() const { return uint32(this->workers.size()); }
+		size_t getNumPending();
+
+	private:
+
+		void run();
+		bool popTask(Task& task, bool wait);
+
+		std::vector<std::thread> workers;
+		std::deque<Task> tasks;
+
+		std::mutex lock;
+		std::condition_variable available;
+		std::condition_variable idle;
+
+		uint32 active;
+		std::atomic<bool> running;
+	};
+}
@@ -70,31 +70,4 @@ namespace cs
 	{
 		return this->started;
 	}
-
-	ScopedTimer::ScopedTimer(uint32* dst)
-		: updateTime(dst)
-		, ticks(0)
-	{
-		this->ticks = SDL_GetTicks();
-	}
-
-	void ScopedTimer::stop()
-	{
-		*this->updateTime = SDL_GetTicks() - this->ticks;
-	}
-
-	ScopedTimer::~ScopedTimer()
-	{
-		this->stop();
-	}
-
-	ScopedAccumTimer::~ScopedAccumTimer()
-	{
-		this->stop();
-	}
-
-	void ScopedAccumTimer::stop()
-	{
-		*this->updateTime += SDL_GetTicks() - this->ticks;
-	}
 }
@@ -39,32 +39,6 @@ namespace cs
 		bool started;
 	};
 
-	class ScopedTimer
-	{
-	public:
-
-		ScopedTimer(uint32* dst);
-		~ScopedTimer(); // intentionally non-virtual
-
-	protected:
-
-		virtual void stop();
-
-		uint32* updateTime;
-		uint32 ticks;
-		
-	};
-
-	class ScopedAccumTimer : public ScopedTimer
-	{
-	public:
-		ScopedAccumTimer(uint32* dst) : ScopedTimer(dst) { }
-		~ScopedAccumTimer();
-
-	protected:
-		virtual void stop();
-	};
-
 	class HighPrecisionTimer
 	{
 	public:
@@ -81,36 +55,4 @@ namespace cs
 		char* frequency;
         
 	};
-
-	class TimerCache : public Singleton<TimerCache>
-	{
-		typedef std::unordered_map<std::string, float32> TimeSampleMap;
-
-	public:
-
-		void reset()
-		{
-			for (auto& it : this->timeSamples)
-			{
-				it.second = 0.0f;
-			}
-		}
-
-		void accumulate(std::string name, float32 accum)
-		{
-			TimeSampleMap::iterator it = this->timeSamples.find(name);
-			if (it == this->timeSamples.end())
-			{
-				this->timeSamples[name] = accum;
-				return;
-			}
-
-			it->second += accum;
-		}
-
-	private:
-
-		TimeSampleMap timeSamples;
-
-	};
 }
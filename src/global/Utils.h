@@ -10,6 +10,7 @@
 #include <cctype>
 
 #include "global/Values.h"
+#include "global/Random.h"
 #include "math/GLM.h"
 #include "gfx/Color.h"
 
@@ -90,13 +91,13 @@ namespace cs
     
     inline float32 randomFloat()
     {
-        return static_cast<float32>(rand()) / static_cast<float32>(RAND_MAX);
+        return Random::get().nextFloat();
     }
 
 	template<typename T>
 	T randomRange(T min, T max)
 	{
-		float t = static_cast<int32>(std::rand()) / static_cast<float32>(RAND_MAX);
+		float t = Random::get().nextFloat();
 		return static_cast<T>((t * min) + ((1.0f - t) * max));
 	}
 
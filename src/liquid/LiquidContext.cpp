@@ -28,6 +28,23 @@ namespace cs
 			SET_MEMBER_MAX(2.0f);
 			SET_MEMBER_CALLBACK_POST(&LiquidContext::setGravityScaleImpl);
 		
+		ADD_MEMBER(renderMode);
+			SET_MEMBER_DEFAULT(int32(LiquidRenderModeParticles));
+			SET_MEMBER_MIN(int32(LiquidRenderModeParticles));
+			SET_MEMBER_MAX(int32(LiquidRenderModeSurface));
+		ADD_MEMBER(surfaceCellSize);
+			SET_MEMBER_DEFAULT(0.0f);
+			SET_MEMBER_MIN(0.0f);
+			SET_MEMBER_MAX(50.0f);
+		ADD_MEMBER(surfaceInfluence);
+			SET_MEMBER_DEFAULT(2.0f);
+			SET_MEMBER_MIN(1.0f);
+			SET_MEMBER_MAX(4.0f);
+		ADD_MEMBER(surfaceIsoLevel);
+			SET_MEMBER_DEFAULT(0.5f);
+			SET_MEMBER_MIN(0.05f);
+			SET_MEMBER_MAX(4.0f);
+
 		ADD_MEMBER_PTR(textureHandle);
 		
 		ADD_MEMBER(options);
@@ -41,6 +58,10 @@ namespace cs
 		, radius(1.0f)
 		, gravityScale(1.0f)
 		, maxParticles(kMaxParticles)
+		, renderMode(LiquidRenderModeParticles)
+		, surfaceCellSize(0.0f)
+		, surfaceInfluence(2.0f)
+		, surfaceIsoLevel(0.5f)
 		, shaderHandle(CREATE_CLASS(ShaderHandle, RenderInterface::kDefaultColorShader))
 	{
 		this->init();
@@ -53,6 +74,10 @@ namespace cs
 		, radius(1.0f)
 		, gravityScale(1.0f)
 		, maxParticles(kMaxParticles)
+		, renderMode(LiquidRenderModeParticles)
+		, surfaceCellSize(0.0f)
+		, surfaceInfluence(2.0f)
+		, surfaceIsoLevel(0.5f)
 		, shaderHandle(RenderInterface::kDefaultTextureShader)
 	{
 		this->init();
@@ -100,19 +125,47 @@ namespace cs
 		fx_velocity[index] = PhysicsConst::worldToBox2D(vel);
 	}
 
-	void LiquidContext::updateParticlePositions(ParticlePositionMap& positions)
+	void LiquidContext::updateParticlePositions(const int32* indices, const vec2* positions, size_t count, const vec2& offset)
 	{
+		if (!this->ps || count == 0)
+			return;
+
 		b2Vec2* fx_positions = this->ps->GetPositionBuffer();
 		int32 fx_count = this->ps->GetParticleCount();
-		for (auto it : positions)
+
+		const float32 scale = PhysicsConst::kInvBox2DScale;
+		const float32 offsetX = offset.x * scale;
+		const float32 offsetY = offset.y * scale;
+
+		// groups are created in one go and Box2D compacts without reordering, so a group
+		// usually still owns one unbroken run of the buffer
+		int32 first = indices[0];
+		bool contiguous = first >= 0 && first + int32(count) <= fx_count;
+		for (size_t i = 1; contiguous && i < count; ++i)
+			contiguous = indices[i] == first + int32(i);
+
+		if (contiguous)
 		{
-			const b2ParticleHandle* handle = it.first;
-			int32 index = handle->GetIndex();
-			if (index < 0 || index >= this->maxParticles)
+			static_assert(sizeof(b2Vec2) == sizeof(float32) * 2, "b2Vec2 must be tightly packed");
+			static_assert(sizeof(vec2) == sizeof(float32) * 2, "vec2 must be tightly packed");
+
+			float32* dst = &fx_positions[first].x;
+			const float32* src = &positions[0].x;
+			for (size_t i = 0; i < count * 2; i += 2)
+			{
+				dst[i] = src[i] * scale + offsetX;
+				dst[i + 1] = src[i + 1] * scale + offsetY;
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			int32 index = indices[i];
+			if (index < 0 || index >= fx_count)
 				continue;
 
-			b2Vec2& fx_pos = fx_positions[index];
-			fx_pos = PhysicsConst::worldToBox2D(it.second.x, it.second.y);
+			fx_positions[index].Set(positions[i].x * scale + offsetX, positions[i].y * scale + offsetY);
 		}
 	}
 
@@ -209,11 +262,34 @@ namespace cs
 			std::placeholders::_2);
 		this->particleGeometry->setDrawCallAdjustFunc(dcfunc);
 
+		DynamicGeometry::GetVertexSizeFunc numVFunc = std::bind(&LiquidContext::getVertexBufferSize, this);
+		this->particleGeometry->setVertexBufferSizeFunc(numVFunc);
+
+		DynamicGeometry::GetIndexSizeFunc numIFunc = std::bind(&LiquidContext::getIndexBufferSize, this);
+		this->particleGeometry->setIndexBufferSizeFunc(numIFunc);
+
+	}
+
+	size_t LiquidContext::getVertexBufferSize()
+	{
+		size_t stride = this->particleGeometry->getGeometryData()->decl.getStride();
+		if (this->isSurfaceMode())
+			return LiquidSurface::getMaxVertices() * stride;
+		return this->maxParticles * 4 * stride;
+	}
+
+	size_t LiquidContext::getIndexBufferSize()
+	{
+		if (this->isSurfaceMode())
+			return LiquidSurface::getMaxIndices() * sizeof(uint16);
+		return this->maxParticles * 6 * sizeof(uint16);
 	}
 
 	size_t LiquidContext::updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl)
 	{
-		
+		if (this->isSurfaceMode())
+			return this->updateSurfaceVertices(data, bufferSize, decl);
+
 		uint32 vertexCtr = 0;
 		assert(this->ps);
 
@@ -261,6 +337,42 @@ namespace cs
 		return vertexCtr;
 	}
 
+	size_t LiquidContext::updateSurfaceVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl)
+	{
+		assert(this->ps);
+		this->surface.build(this->ps->GetPositionBuffer(), this->ps->GetParticleCount(),
+			this->radius, this->surfaceCellSize, this->surfaceInfluence, this->surfaceIsoLevel);
+
+		// the texture is stretched over the surface bounds
+		vec2 uvMin = this->textureHandle->getUVByIndex(0);
+		vec2 uvMax = this->textureHandle->getUVByIndex(2);
+		vec2 minb = this->surface.getBoundsMin();
+		vec2 extent = this->surface.getBoundsMax() - minb;
+		vec2 invExtent(
+			(extent.x > 0.0f) ? 1.0f / extent.x : 0.0f,
+			(extent.y > 0.0f) ? 1.0f / extent.y : 0.0f);
+
+		char* pos_ptr = decl.getAttributePointerAtIndex<char>(data, AttributeType::AttribPosition, 0);
+		char* uv_ptr = decl.getAttributePointerAtIndex<char>(data, AttributeType::AttribTexCoord0, 0);
+		size_t stride = decl.getStride();
+
+		const std::vector<vec2>& vertices = this->surface.getVertices();
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			const vec2& vert = vertices[i];
+
+			vec3* pos = reinterpret_cast<vec3*>(PTR_ADD(pos_ptr, i * stride));
+			assert(size_t(pos) - size_t(data) < bufferSize);
+			*pos = vec3(vert.x, vert.y, 0.0f);
+
+			vec2* uv = reinterpret_cast<vec2*>(PTR_ADD(uv_ptr, i * stride));
+			assert(size_t(uv) - size_t(data) < bufferSize);
+			*uv = uvMin + (uvMax - uvMin) * ((vert - minb) * invExtent);
+		}
+
+		return vertices.size();
+	}
+
 	void LiquidContext::setRadius(float32 rad)
 	{
 		if (this->radius != rad)
@@ -291,6 +403,15 @@ namespace cs
 	{
 		uint32 indexCtr = 0;
 		uint16* indices = reinterpret_cast<uint16*>(data);
+
+		if (this->isSurfaceMode())
+		{
+			const std::vector<uint16>& surfaceIndices = this->surface.getIndices();
+			assert(surfaceIndices.size() * sizeof(uint16) <= bufferSize);
+			if (surfaceIndices.size() > 0)
+				memcpy(indices, &surfaceIndices[0], surfaceIndices.size() * sizeof(uint16));
+			return surfaceIndices.size();
+		}
 		int32 particleCount = this->ps->GetParticleCount();
 		for (int32 i = 0; i < particleCount; i++)
 		{
@@ -327,7 +448,7 @@ namespace cs
 		pd.userData = group;
 		
 		int32 index = this->ps->CreateParticle(pd);
-		if (index > 0)
+		if (index != b2_invalidParticleIndex)
 		{
 			const b2ParticleHandle* handle = this->ps->GetParticleHandleFromIndex(index);
 			return handle;
@@ -348,10 +469,10 @@ namespace cs
 	void LiquidContext::setDrawParams(int32 index, std::vector<DrawCallPtr>& dcs)
 	{
 		DrawCallPtr dc = CREATE_CLASS(DrawCall);
-		dc->tag = this->getName();
+		dc->tag = this->getNameId();
 		dc->type = DrawTriangles;
 		dc->indexType = TypeUnsignedShort;
-		dc->count = this->ps->GetParticleCount() * 6;
+		dc->count = (this->isSurfaceMode()) ? uint32(this->surface.getIndices().size()) : this->ps->GetParticleCount() * 6;
 		dc->offset = 0;
 		dc->shaderHandle = this->shaderHandle;
 		dc->textures[0] = this->textureHandle;
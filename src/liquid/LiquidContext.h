@@ -11,6 +11,7 @@
 #include "gfx/DrawOptions.h"
 
 #include "liquid/LiquidGenerator.h"
+#include "liquid/LiquidSurface.h"
 
 #include "math/Ray.h"
 #include "math/Transform.h"
@@ -24,9 +25,16 @@ namespace cs
 	class SceneData;
 	class LiquidGroup;
 
-	typedef std::map<const b2ParticleHandle*, vec2> ParticlePositionMap;
 	typedef std::vector<const b2ParticleHandle*> ParticleList;
 
+	enum LiquidRenderMode
+	{
+		LiquidRenderModeParticles,	// one blended quad per particle
+		LiquidRenderModeSurface,	// marching squares mesh over the particle density
+		//...
+		LiquidRenderModeMAX
+	};
+
 	CLASS_DEFINITION_DERIVED_REFLECT(LiquidContext, Entity)
 	public:
 
@@ -39,15 +47,23 @@ namespace cs
 
 		size_t updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl);
 		size_t updateIndices(uchar* data, size_t bufferSize);
+		size_t getVertexBufferSize();
+		size_t getIndexBufferSize();
 		void setDrawParams(int32 index, std::vector<DrawCallPtr>& dc);
 		
 		bool canAddParticles() const { return this->ps->GetParticleCount() < this->maxParticles; }
 
 		void updateParticleDelta(const vec2& offset);
-		void updateParticlePositions(ParticlePositionMap& positions);
+
+		// Writes positions[i] + offset (world units) to buffer index indices[i] for count particles.
+		// A run of consecutive indices is written as one straight block over the raw buffer.
+		void updateParticlePositions(const int32* indices, const vec2* positions, size_t count, const vec2& offset);
 
 		void setRadius(float32 rad);
 
+		void setRenderMode(LiquidRenderMode mode) { this->renderMode = int32(mode); }
+		LiquidRenderMode getRenderMode() const { return LiquidRenderMode(this->renderMode); }
+
 		DynamicGeometryPtr& getParticleGeometry() { return this->particleGeometry; }
 		bool getParticlePosition(const b2ParticleHandle* handle, b2Vec2& position);
 
@@ -74,6 +90,10 @@ namespace cs
 		LiquidContext() 
 			: gravityScale(1.0f)
 			, radius(1.0f) 
+			, renderMode(LiquidRenderModeParticles)
+			, surfaceCellSize(0.0f)
+			, surfaceInfluence(2.0f)
+			, surfaceIsoLevel(0.5f)
 		{ }
 
 		LiquidContext(ECSContext* entityContext);
@@ -85,12 +105,21 @@ namespace cs
 		void setGravityScaleImpl();
 		void onMaxParticlesChanged();
 
+		size_t updateSurfaceVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl);
+		bool isSurfaceMode() const { return this->renderMode == LiquidRenderModeSurface; }
+
 		b2ParticleSystem* ps;
 		float32 radius;
 		float32 gravityScale;
 		
 		int32 maxParticles;
 
+		int32 renderMode;
+		float32 surfaceCellSize;	// world units, 0 uses the particle radius
+		float32 surfaceInfluence;	// kernel radius in particle radii
+		float32 surfaceIsoLevel;
+		LiquidSurface surface;
+
 		DrawOptions options;
 
 		ShaderHandlePtr shaderHandle;
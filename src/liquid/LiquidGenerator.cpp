@@ -48,9 +48,11 @@ namespace cs
 		if (!this->volume)
 			return;
 
-		for (uint32 i = 0; i < requested; i++)
+		size_t start = positions.size();
+		positions.resize(start + requested);
+		if (requested > 0)
 		{
-			positions.push_back(this->volume->getRandomValue());
+			this->volume->getRandomValues(&positions[start], requested);
 		}
 	}
 
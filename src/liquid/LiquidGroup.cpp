@@ -61,7 +61,7 @@ namespace cs
 	void LiquidGroup::reset(bool active)
 	{
 		BASECLASS::reset(active);
-		this->particles.clear();
+		this->clearSlots();
 		this->generateParticles();
 	}
 
@@ -118,50 +118,127 @@ namespace cs
 		if (!this->context)
 			return;
 		
-		for (auto it : this->particles)
-			this->context->removeParticle(it.first);
+		for (auto& handle : this->handles)
+			this->context->removeParticle(handle);
+
+		this->clearSlots();
+	}
 
-		this->particles.clear();
+	void LiquidGroup::clearSlots()
+	{
+		this->handles.clear();
+		this->restPositions.clear();
+		this->indices.clear();
+		this->warpSlots.clear();
+		this->slots.clear();
+		this->toDelete.clear();
+		this->warps.clear();
 		this->numParticles = 0;
 	}
 
-	void LiquidGroup::updateParticles(float32 dt)
+	int32 LiquidGroup::findSlot(const b2ParticleHandle* handle) const
 	{
-		for (auto it : this->toDelete)
+		ParticleSlotMap::const_iterator it = this->slots.find(handle);
+		return (it != this->slots.end()) ? it->second : -1;
+	}
+
+	void LiquidGroup::removeWarp(int32 warpIndex)
+	{
+		int32 slot = this->findSlot(this->warps[warpIndex].handle);
+		if (slot >= 0)
+			this->warpSlots[slot] = -1;
+
+		int32 last = int32(this->warps.size()) - 1;
+		if (warpIndex != last)
 		{
-			const b2ParticleHandle* handle = it;
-			this->particles.erase(handle);
-			this->context->removeParticle(handle);
+			this->warps[warpIndex] = std::move(this->warps[last]);
+
+			int32 movedSlot = this->findSlot(this->warps[warpIndex].handle);
+			if (movedSlot >= 0)
+				this->warpSlots[movedSlot] = warpIndex;
 		}
+		this->warps.pop_back();
+	}
 
-		ParticleWarpList::iterator it = this->toWarp.begin();
-		while (it != this->toWarp.end())
+	void LiquidGroup::compactSlots()
+	{
+		// removed slots have a null handle, close the gaps without reordering
+		size_t write = 0;
+		for (size_t read = 0; read < this->handles.size(); ++read)
 		{
-			it->second.curTime += dt;
-			if (it->second.curTime > it->second.maxTime)
+			const b2ParticleHandle* handle = this->handles[read];
+			if (!handle)
+				continue;
+
+			if (write != read)
 			{
-				const b2ParticleHandle* handle = it->first;
-				b2Vec2 b2NewSpawn = it->second.getSpawn();
+				this->handles[write] = handle;
+				this->restPositions[write] = this->restPositions[read];
+				this->warpSlots[write] = this->warpSlots[read];
+				this->slots[handle] = int32(write);
+			}
+			++write;
+		}
 
-				// "warp" the particle to it's destination
-				this->context->setParticlePosition(handle, b2NewSpawn);
+		this->handles.resize(write);
+		this->restPositions.resize(write);
+		this->warpSlots.resize(write);
+		this->numParticles = int32(write);
+	}
+
+	void LiquidGroup::refreshIndices()
+	{
+		// Box2D moves particles down the buffers when it compacts, the handles follow them
+		size_t count = this->handles.size();
+		this->indices.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			this->indices[i] = this->handles[i]->GetIndex();
+	}
+
+	void LiquidGroup::updateParticles(float32 dt)
+	{
+		if (this->toDelete.size() > 0)
+		{
+			for (auto& handle : this->toDelete)
+			{
+				// collisions can report the same particle more than once
+				int32 slot = this->findSlot(handle);
+				if (slot < 0)
+					continue;
 
-				b2Vec2 b2NewVelocity = it->second.getVelocity();
-				this->context->setParticleVelocity(handle, b2NewVelocity);
+				if (this->warpSlots[slot] >= 0)
+					this->removeWarp(this->warpSlots[slot]);
 
-				// remove the ownership over this movement
-				++it;
-				this->toWarp.erase(handle);
+				this->context->removeParticle(handle);
+				this->slots.erase(handle);
+				this->handles[slot] = nullptr;
+			}
+
+			this->toDelete.clear();
+			this->compactSlots();
+		}
+
+		size_t i = 0;
+		while (i < this->warps.size())
+		{
+			WarpToVolume& warp = this->warps[i];
+			warp.curTime += dt;
+			if (warp.curTime > warp.maxTime)
+			{
+				// "warp" the particle to it's destination
+				this->context->setParticlePosition(warp.handle, warp.getSpawn());
+				this->context->setParticleVelocity(warp.handle, warp.getVelocity());
+
+				// remove the ownership over this movement, the last warp takes this entry
+				this->removeWarp(int32(i));
 			}
 			else 
 			{
-				b2Vec2 tmpPos(it->second.tempPosition.x, it->second.tempPosition.y);
-				this->context->setParticlePosition(it->first, tmpPos);
-				++it;
+				b2Vec2 tmpPos(warp.tempPosition.x, warp.tempPosition.y);
+				this->context->setParticlePosition(warp.handle, tmpPos);
+				++i;
 			}
 		}
-
-		this->toDelete.clear();
 	}
 
 	void LiquidGroup::removeParticle(const b2ParticleHandle* handle)
@@ -186,8 +263,11 @@ namespace cs
 		const b2ParticleHandle* handle = this->context->addParticle(pos + offset, this);
 		if (handle != 0)
 		{
+			this->slots[handle] = int32(this->handles.size());
+			this->handles.push_back(handle);
+			this->restPositions.push_back(pos);
+			this->warpSlots.push_back(-1);
 			this->numParticles++;
-			this->particles[handle] = pos;
 		}
 	}
 
@@ -209,17 +289,12 @@ namespace cs
 		if (!this->context)
 			return;
 
-		vec2 offset_vec2(pos.x, pos.y);
-		ParticlePositionMap updateMap;
-
-		for (auto it : this->particles)
+		if (this->handles.size() > 0)
 		{
-			const b2ParticleHandle* handle = it.first;
-			updateMap[handle] = it.second + offset_vec2;
+			this->refreshIndices();
+			this->context->updateParticlePositions(&this->indices[0], &this->restPositions[0], this->handles.size(), vec2(pos.x, pos.y));
 		}
 
-		this->context->updateParticlePositions(updateMap);
-
 		BASECLASS::onPositionChanged(pos, transform, type);
 	}	
 
@@ -264,12 +339,8 @@ namespace cs
 		
 
 		LiquidGeneratorPresetPtr presetPtr = CREATE_CLASS(LiquidGeneratorPreset);
-		for (auto it : this->particles)
-			this->context->removeParticle(it.first);
-
-		for (auto it : this->particles)
+		for (auto& handle : this->handles)
 		{
-			const b2ParticleHandle* handle = it.first;
 			b2Vec2 position;
 			if (this->context->getParticlePosition(handle, position))
 			{
@@ -277,6 +348,8 @@ namespace cs
 			}
 		}
 
+		this->removeAllParticles();
+
 		this->generator = presetPtr;
 	}
 
@@ -291,11 +364,12 @@ namespace cs
 
 	void LiquidGroup::warpParticle(const b2ParticleHandle* handle, float32 time, const VolumePtr& onEnd, const TransformPtr& transform, const vec2& onEndVelocity)
 	{
-		ParticleWarpList::iterator it = this->toWarp.find(handle);
-		if (it != this->toWarp.end())
+		int32 slot = this->findSlot(handle);
+		if (slot < 0 || this->warpSlots[slot] >= 0)
 			return;
 
 		WarpToVolume warpTo;
+		warpTo.handle = handle;
 		warpTo.curTime = 0.0f;
 		warpTo.maxTime = time;
 		warpTo.onEndSpawn = onEnd;
@@ -303,7 +377,8 @@ namespace cs
 		warpTo.tempPosition = vec2(randomRange(-1000.0f, 1000.0f), 10000.0f);
 		warpTo.onEndTransform = transform;
 
-		this->toWarp[handle] = warpTo;
+		this->warpSlots[slot] = int32(this->warps.size());
+		this->warps.push_back(warpTo);
 	}
 
 }
@@ -12,6 +12,8 @@
 
 #include "ecs/comp/LiquidComponent.h"
 
+#include <unordered_map>
+
 namespace cs
 {
 	CLASS_DEFINITION_DERIVED_REFLECT(LiquidGroup, Entity)
@@ -51,7 +53,8 @@ namespace cs
 		struct WarpToVolume
 		{
 			WarpToVolume()
-				: curTime(0.0f)
+				: handle(nullptr)
+				, curTime(0.0f)
 				, maxTime(0.0f)
 				, onEndSpawn(nullptr)
 				, onEndTransform(nullptr)
@@ -74,6 +77,7 @@ namespace cs
 				return b2Vec2(newVelocity.x, newVelocity.y);
 			}
 
+			const b2ParticleHandle* handle;
 			float32 curTime;
 			float32 maxTime;
 			VolumePtr onEndSpawn;
@@ -99,6 +103,12 @@ namespace cs
 		void generateParticles();
 		void addParticle(const vec2 pos, const vec2 offset);
 
+		void clearSlots();
+		int32 findSlot(const b2ParticleHandle* handle) const;
+		void removeWarp(int32 warpIndex);
+		void compactSlots();
+		void refreshIndices();
+
 		LiquidGeneratorPtr generator;
 
 		LiquidContextPtr context;
@@ -106,11 +116,18 @@ namespace cs
 		int32 numParticles;
 		int32 maxParticles;
 
-		ParticlePositionMap particles;
-		ParticleList toDelete;
+		// Dense per particle state, entry i of every array describes the same particle and the
+		// arrays stay in creation order so they line up with runs of the Box2D buffers
+		ParticleList handles;
+		std::vector<vec2> restPositions;	// generator position relative to the group
+		std::vector<int32> indices;			// position/velocity buffer index, refreshed before bulk writes
+		std::vector<int32> warpSlots;		// entry in warps or -1
 
-		typedef std::map<const b2ParticleHandle*, WarpToVolume> ParticleWarpList;
-		ParticleWarpList toWarp;
+		typedef std::unordered_map<const b2ParticleHandle*, int32> ParticleSlotMap;
+		ParticleSlotMap slots;
+
+		ParticleList toDelete;
+		std::vector<WarpToVolume> warps;
 	};
 
 
@@ -0,0 +1,262 @@
+#include "PCH.h"
+
+#include "liquid/LiquidSurface.h"
+#include "physics/PhysicsGlobals.h"
+#include "global/TaskQueue.h"
+#include "global/Profiler.h"
+#include "global/Utils.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace cs
+{
+	const size_t kTileMaxPoints = (LiquidSurface::kTileCells + 1) * (LiquidSurface::kTileCells + 1);
+	const size_t kTileMaxEdges = LiquidSurface::kTileCells * (LiquidSurface::kTileCells + 1);
+	const size_t kMaxTiles = (LiquidSurface::kMaxGridCells / LiquidSurface::kTileCells) * (LiquidSurface::kMaxGridCells / LiquidSurface::kTileCells);
+
+	// a cell polygon has at most 6 vertices (the saddle cases), fanned into 4 triangles
+	const size_t kMaxCellPolygon = 6;
+
+	LiquidSurface::LiquidSurface()
+		: origin(kZero2)
+		, cellSize(1.0f)
+		, kernelRadius(1.0f)
+		, isoLevel(0.5f)
+		, cellsX(0)
+		, cellsY(0)
+		, tilesX(0)
+		, tilesY(0)
+		, boundsMin(kZero2)
+		, boundsMax(kZero2)
+	{
+
+	}
+
+	size_t LiquidSurface::getMaxVertices()
+	{
+		return kMaxTiles * (kTileMaxPoints + kTileMaxEdges * 2);
+	}
+
+	size_t LiquidSurface::getMaxIndices()
+	{
+		return size_t(kMaxGridCells * kMaxGridCells) * (kMaxCellPolygon - 2) * 3;
+	}
+
+	void LiquidSurface::build(const b2Vec2* positions, int32 count, float32 particleRadius, float32 size, float32 influence, float32 iso)
+	{
+		PROFILE_SCOPE("Liquid Surface");
+
+		this->vertices.clear();
+		this->indices.clear();
+
+		if (count <= 0)
+			return;
+
+		this->kernelRadius = std::max<float32>(0.001f, particleRadius * std::max<float32>(1.0f, influence));
+		this->isoLevel = std::max<float32>(0.001f, iso);
+
+		this->particlePositions.resize(count);
+		vec2 minb(FLT_MAX, FLT_MAX);
+		vec2 maxb(-FLT_MAX, -FLT_MAX);
+		for (int32 i = 0; i < count; ++i)
+		{
+			vec2 pos(PhysicsConst::box2DToWorld(positions[i].x), PhysicsConst::box2DToWorld(positions[i].y));
+			this->particlePositions[i] = pos;
+			minb = glm::min(minb, pos);
+			maxb = glm::max(maxb, pos);
+		}
+
+		// one kernel radius of padding keeps the surface closed at the grid border
+		minb -= vec2(this->kernelRadius, this->kernelRadius);
+		maxb += vec2(this->kernelRadius, this->kernelRadius);
+		vec2 extent = maxb - minb;
+
+		float32 largest = std::max<float32>(extent.x, extent.y);
+		this->cellSize = std::max<float32>((size > 0.0f) ? size : particleRadius, largest / float32(kMaxGridCells));
+		this->cellsX = clamp<int32>(1, kMaxGridCells, int32(ceilf(extent.x / this->cellSize)));
+		this->cellsY = clamp<int32>(1, kMaxGridCells, int32(ceilf(extent.y / this->cellSize)));
+		this->origin = minb;
+
+		this->boundsMin = minb;
+		this->boundsMax = minb + vec2(float32(this->cellsX), float32(this->cellsY)) * this->cellSize;
+
+		this->tilesX = (this->cellsX + kTileCells - 1) / kTileCells;
+		this->tilesY = (this->cellsY + kTileCells - 1) / kTileCells;
+		this->tiles.resize(this->tilesX * this->tilesY);
+
+		for (int32 ty = 0; ty < this->tilesY; ++ty)
+		{
+			for (int32 tx = 0; tx < this->tilesX; ++tx)
+			{
+				Tile& tile = this->tiles[ty * this->tilesX + tx];
+				tile.firstCellX = tx * kTileCells;
+				tile.firstCellY = ty * kTileCells;
+				tile.cellsX = std::min<int32>(kTileCells, this->cellsX - tile.firstCellX);
+				tile.cellsY = std::min<int32>(kTileCells, this->cellsY - tile.firstCellY);
+				tile.particles.clear();
+			}
+		}
+
+		// bin each particle into every tile its kernel reaches, tiles share their border points
+		float32 invCell = 1.0f / this->cellSize;
+		for (int32 i = 0; i < count; ++i)
+		{
+			const vec2& pos = this->particlePositions[i];
+			int32 x0 = int32(floorf((pos.x - this->kernelRadius - this->origin.x) * invCell));
+			int32 y0 = int32(floorf((pos.y - this->kernelRadius - this->origin.y) * invCell));
+			int32 x1 = int32(ceilf((pos.x + this->kernelRadius - this->origin.x) * invCell));
+			int32 y1 = int32(ceilf((pos.y + this->kernelRadius - this->origin.y) * invCell));
+
+			int32 tx0 = clamp<int32>(0, this->tilesX - 1, (x0 - 1) / kTileCells);
+			int32 ty0 = clamp<int32>(0, this->tilesY - 1, (y0 - 1) / kTileCells);
+			int32 tx1 = clamp<int32>(0, this->tilesX - 1, x1 / kTileCells);
+			int32 ty1 = clamp<int32>(0, this->tilesY - 1, y1 / kTileCells);
+
+			for (int32 ty = ty0; ty <= ty1; ++ty)
+			{
+				for (int32 tx = tx0; tx <= tx1; ++tx)
+				{
+					this->tiles[ty * this->tilesX + tx].particles.push_back(i);
+				}
+			}
+		}
+
+		uint32 numTiles = uint32(this->tiles.size());
+		if (numTiles > 1)
+		{
+			TaskQueue::getInstance()->parallel(numTiles, [this](uint32 index)
+			{
+				this->buildTile(this->tiles[index]);
+			});
+		}
+		else
+		{
+			this->buildTile(this->tiles[0]);
+		}
+
+		for (auto& tile : this->tiles)
+		{
+			uint16 base = uint16(this->vertices.size());
+			this->vertices.insert(this->vertices.end(), tile.vertices.begin(), tile.vertices.end());
+			for (auto& index : tile.indices)
+			{
+				this->indices.push_back(base + index);
+			}
+		}
+	}
+
+	void LiquidSurface::buildTile(Tile& tile) const
+	{
+		int32 pointsX = tile.cellsX + 1;
+		int32 pointsY = tile.cellsY + 1;
+
+		tile.density.assign(pointsX * pointsY, 0.0f);
+		tile.vertices.clear();
+		tile.indices.clear();
+
+		if (tile.particles.size() == 0)
+			return;
+
+		// splat (1 - d^2/r^2)^2 from every particle onto the grid points it reaches
+		float32 radiusSq = this->kernelRadius * this->kernelRadius;
+		float32 invRadiusSq = 1.0f / radiusSq;
+		float32 invCell = 1.0f / this->cellSize;
+		for (auto& index : tile.particles)
+		{
+			const vec2& pos = this->particlePositions[index];
+			vec2 local = (pos - this->origin) * invCell - vec2(float32(tile.firstCellX), float32(tile.firstCellY));
+			float32 reach = this->kernelRadius * invCell;
+
+			int32 x0 = std::max<int32>(0, int32(ceilf(local.x - reach)));
+			int32 y0 = std::max<int32>(0, int32(ceilf(local.y - reach)));
+			int32 x1 = std::min<int32>(pointsX - 1, int32(floorf(local.x + reach)));
+			int32 y1 = std::min<int32>(pointsY - 1, int32(floorf(local.y + reach)));
+
+			for (int32 y = y0; y <= y1; ++y)
+			{
+				float32 dy = (float32(y) - local.y) * this->cellSize;
+				float32* row = &tile.density[y * pointsX];
+				for (int32 x = x0; x <= x1; ++x)
+				{
+					float32 dx = (float32(x) - local.x) * this->cellSize;
+					float32 w = 1.0f - (dx * dx + dy * dy) * invRadiusSq;
+					if (w > 0.0f)
+						row[x] += w * w;
+				}
+			}
+		}
+
+		tile.pointVerts.assign(pointsX * pointsY, -1);
+		tile.edgeVertsX.assign(tile.cellsX * pointsY, -1);
+		tile.edgeVertsY.assign(pointsX * tile.cellsY, -1);
+
+		const float32 iso = this->isoLevel;
+		auto density = [&](int32 x, int32 y) { return tile.density[y * pointsX + x]; };
+
+		auto pointVertex = [&](int32 x, int32 y) -> uint16
+		{
+			int32& vert = tile.pointVerts[y * pointsX + x];
+			if (vert < 0)
+			{
+				vert = int32(tile.vertices.size());
+				tile.vertices.push_back(this->getPoint(tile.firstCellX + x, tile.firstCellY + y));
+			}
+			return uint16(vert);
+		};
+
+		// edge vertices always interpolate from the lower corner so neighbouring tiles agree
+		auto edgeVertex = [&](int32 x, int32 y, bool alongX) -> uint16
+		{
+			int32& vert = (alongX) ? tile.edgeVertsX[y * tile.cellsX + x] : tile.edgeVertsY[y * pointsX + x];
+			if (vert < 0)
+			{
+				float32 d0 = density(x, y);
+				float32 d1 = (alongX) ? density(x + 1, y) : density(x, y + 1);
+				float32 t = clamp(0.0f, 1.0f, (iso - d0) / (d1 - d0));
+
+				vec2 p0 = this->getPoint(tile.firstCellX + x, tile.firstCellY + y);
+				vec2 p1 = (alongX) ? p0 + vec2(this->cellSize, 0.0f) : p0 + vec2(0.0f, this->cellSize);
+
+				vert = int32(tile.vertices.size());
+				tile.vertices.push_back(p0 + (p1 - p0) * t);
+			}
+			return uint16(vert);
+		};
+
+		uint16 polygon[kMaxCellPolygon];
+		for (int32 y = 0; y < tile.cellsY; ++y)
+		{
+			for (int32 x = 0; x < tile.cellsX; ++x)
+			{
+				bool in0 = density(x, y) >= iso;
+				bool in1 = density(x + 1, y) >= iso;
+				bool in2 = density(x + 1, y + 1) >= iso;
+				bool in3 = density(x, y + 1) >= iso;
+
+				if (!(in0 || in1 || in2 || in3))
+					continue;
+
+				// walk the cell boundary counter-clockwise, every point lies on the square so
+				// the polygon is convex and a fan covers it (saddles resolve as connected)
+				size_t n = 0;
+				if (in0) polygon[n++] = pointVertex(x, y);
+				if (in0 != in1) polygon[n++] = edgeVertex(x, y, true);
+				if (in1) polygon[n++] = pointVertex(x + 1, y);
+				if (in1 != in2) polygon[n++] = edgeVertex(x + 1, y, false);
+				if (in2) polygon[n++] = pointVertex(x + 1, y + 1);
+				if (in2 != in3) polygon[n++] = edgeVertex(x, y + 1, true);
+				if (in3) polygon[n++] = pointVertex(x, y + 1);
+				if (in3 != in0) polygon[n++] = edgeVertex(x, y, false);
+
+				for (size_t i = 1; i + 1 < n; ++i)
+				{
+					tile.indices.push_back(polygon[0]);
+					tile.indices.push_back(polygon[i]);
+					tile.indices.push_back(polygon[i + 1]);
+				}
+			}
+		}
+	}
+}
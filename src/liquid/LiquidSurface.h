@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Box2D/Common/b2Math.h>
+
+#include "global/Values.h"
+#include "math/GLM.h"
+
+#include <vector>
+
+namespace cs
+{
+	// Turns a cloud of liquid particles into one filled iso-surface mesh.  Particles are splatted
+	// into a density field on a coarse grid and marching squares extracts the region above the
+	// iso level.  The grid is split into tiles that are sampled and meshed in parallel, each
+	// tile owns its density and vertices so there is nothing to lock.
+	class LiquidSurface
+	{
+	public:
+
+		static const int32 kTileCells = 16;		// cells per tile side
+		static const int32 kMaxGridCells = 64;	// cells per grid side, the cell size grows past this
+
+		LiquidSurface();
+
+		// positions are in Box2D units, everything else in world units
+		void build(const b2Vec2* positions, int32 count, float32 particleRadius, float32 cellSize, float32 influence, float32 isoLevel);
+
+		const std::vector<vec2>& getVertices() const { return this->vertices; }
+		const std::vector<uint16>& getIndices() const { return this->indices; }
+
+		const vec2& getBoundsMin() const { return this->boundsMin; }
+		const vec2& getBoundsMax() const { return this->boundsMax; }
+
+		// worst case of a full grid, used to size the geometry buffers
+		static size_t getMaxVertices();
+		static size_t getMaxIndices();
+
+	private:
+
+		struct Tile
+		{
+			int32 firstCellX;
+			int32 firstCellY;
+			int32 cellsX;
+			int32 cellsY;
+
+			std::vector<int32> particles;
+			std::vector<float32> density;	// (cellsX + 1) * (cellsY + 1) grid points
+
+			// vertex already emitted for a grid point / edge of this tile, -1 if none
+			std::vector<int32> pointVerts;
+			std::vector<int32> edgeVertsX;
+			std::vector<int32> edgeVertsY;
+
+			std::vector<vec2> vertices;
+			std::vector<uint16> indices;
+		};
+
+		void buildTile(Tile& tile) const;
+
+		vec2 getPoint(int32 x, int32 y) const { return this->origin + vec2(float32(x), float32(y)) * this->cellSize; }
+
+		std::vector<vec2> particlePositions;
+		std::vector<Tile> tiles;
+
+		vec2 origin;
+		float32 cellSize;
+		float32 kernelRadius;
+		float32 isoLevel;
+		int32 cellsX;
+		int32 cellsY;
+		int32 tilesX;
+		int32 tilesY;
+
+		std::vector<vec2> vertices;
+		std::vector<uint16> indices;
+		vec2 boundsMin;
+		vec2 boundsMax;
+	};
+}
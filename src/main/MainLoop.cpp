@@ -11,6 +11,7 @@
 #include "gfx/gl/OpenGL.h"
 #include "gfx/RenderInterface.h"
 #include "global/Stats.h"
+#include "global/Profiler.h"
 
 #include "ecs/comp/ComponentHash.h"
 
@@ -74,8 +75,12 @@ namespace cs
         
 		if (this->mainRenderFunc)
 		{
+			PROFILE_SCOPE("Render");
 			this->mainRenderFunc();
 		}
+
+		PROFILE_COUNTER("Draw Calls", RenderInterface::getRenderStat(RenderInterface::RenderStatDrawCall));
+		PROFILE_COUNTER("Primitives", RenderInterface::getRenderStat(RenderInterface::RenderStatPrimitives));
         // RenderInterface::getInstance()->testFrame();
 
         
@@ -92,7 +97,10 @@ namespace cs
         ms_process.start();
         
         if (this->mainProcessFunc)
+        {
+            PROFILE_SCOPE("Process");
             this->mainProcessFunc(dt);
+        }
         
         MainEntry::process_ms = (float32) ms_process.getElapsed();
     }
@@ -108,7 +116,7 @@ namespace cs
 
         // While application is running
         HighPrecisionTimer frame_timer;
-        TimerCache::getInstance()->reset();
+        PROFILE_FRAME();
         
         float32 dt = MainEntry::total_ms * MainEntry::game_speed;
         // Update
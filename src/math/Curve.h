@@ -0,0 +1,56 @@
+#pragma once
+
+#include "global/Values.h"
+#include "global/Utils.h"
+
+#include <ostream>
+
+namespace cs
+{
+	// A curve over [0, 1] sampled once into N evenly spaced points, so evaluating it in a hot loop
+	// is one indexed lerp however the curve was defined.  Slope comes from neighbouring samples and
+	// needs no extra storage.  Plain data, safe to copy byte for byte (particle buffers do).
+	template <class T, uint32 N>
+	struct BakedCurve
+	{
+		static_assert(N >= 2, "A baked curve needs at least two samples");
+
+		static const uint32 kSamples = N;
+
+		// func(float32 pct) -> T
+		template <class F>
+		void bake(const F& func)
+		{
+			const float32 kStep = 1.0f / float32(N - 1);
+			for (uint32 i = 0; i < N; ++i)
+				this->samples[i] = func(float32(i) * kStep);
+		}
+
+		T evaluate(float32 pct) const
+		{
+			float32 x = clamp<float32>(0.0f, 1.0f, pct) * float32(N - 1);
+			uint32 i = uint32(x);
+			if (i >= N - 1)
+				return this->samples[N - 1];
+
+			return lerp<T>(this->samples[i], this->samples[i + 1], x - float32(i));
+		}
+
+		// change per unit of pct across the segment holding pct
+		T derivative(float32 pct) const
+		{
+			float32 x = clamp<float32>(0.0f, 1.0f, pct) * float32(N - 1);
+			uint32 i = std::min<uint32>(uint32(x), N - 2);
+			return (this->samples[i + 1] - this->samples[i]) * float32(N - 1);
+		}
+
+		T samples[N];
+	};
+
+	template <class T, uint32 N>
+	std::ostream& operator<<(std::ostream& os, const BakedCurve<T, N>& rhs)
+	{
+		os << rhs.samples[0] << " .. " << rhs.samples[N - 1];
+		return os;
+	}
+}
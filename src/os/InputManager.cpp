@@ -2,6 +2,7 @@
 
 #include "os/InputManager.h"
 #include "os/LogManager.h"
+#include "global/FramePipeline.h"
 
 namespace cs
 {
@@ -183,6 +184,9 @@ namespace cs
 			return;
 		}
 
+		// listeners touch scene and UI state, never alongside a pipelined simulation
+		FramePipeline::waitForSimulation();
+
 		for (auto it : this->clickPriorityList)
 		{
 			ClickParams& params = states[input];
@@ -206,6 +210,8 @@ namespace cs
 		if (!this->enabled)
 			return;
 
+		FramePipeline::waitForSimulation();
+
 		for (auto it : this->keyPriorityList)
 		{
 			if (it.first(key, flags, true))
@@ -220,6 +226,8 @@ namespace cs
 		if (!this->enabled)
 			return;
 
+		FramePipeline::waitForSimulation();
+
 		for (auto it : this->keyPriorityList)
 		{
 			if (it.first(key, flags, false))
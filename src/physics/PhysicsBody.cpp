@@ -307,6 +307,8 @@ namespace cs
 		if (this->body)
 		{
 			PhysicsSystem* sys = PhysicsSystem::getInstance();
+			sys->getContactListener().removeBody(this);
+
 			b2World& world = sys->getWorld();
 			if (world.GetBodyCount() > 0)
 			{
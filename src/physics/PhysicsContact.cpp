@@ -4,6 +4,10 @@
 #include "physics/PhysicsBody.h"
 #include "liquid/LiquidGroup.h"
 #include "ecs/comp/PhysicsComponent.h"
+#include "global/TaskQueue.h"
+#include "global/Profiler.h"
+
+#include <algorithm>
 
 namespace cs
 {
@@ -61,35 +65,67 @@ namespace cs
 		}
 	}
 
-	void PhysicsContact::BeginContact(b2Contact* contact)
+	PhysicsContact::PhysicsContact()
+		: recording(false)
 	{
 
-		PhysicsBody* bodyA = reinterpret_cast<PhysicsBody*>(contact->GetFixtureA()->GetBody()->GetUserData());
-		PhysicsBody* bodyB = reinterpret_cast<PhysicsBody*>(contact->GetFixtureB()->GetBody()->GetUserData());
-		
-		PhysicsBodyCollisionPtr bodyCollisionA = bodyA->getOnBodyCollision();
-		if (bodyCollisionA.get())
+	}
+
+	void PhysicsContact::onBegin(PhysicsBody* body, PhysicsBody* other)
+	{
+		PhysicsBodyCollisionPtr& bodyCollision = body->getOnBodyCollision();
+		if (!bodyCollision.get())
+			return;
+
+		// bodies touching through more than one fixture begin once
+		PhysicsBodyCollision::CollisionPair pair((uintptr_t)body, (uintptr_t)other);
+		if (!this->history.insert(pair).second)
+			return;
+
+		if (this->recording)
 		{
-			PhysicsBodyCollision::CollisionPair pair((uintptr_t)bodyA, (uintptr_t)bodyB);
-			if (!this->history.count(pair))
-			{
-				bodyCollisionA->onCollisionBegin(bodyA, bodyB);
-				this->history.insert(pair);
-			}
+			PhysicsContactEvent evt = { PhysicsContactEventBegin, body, other, nullptr };
+			this->events.push_back(evt);
+			return;
 		}
-			
-		PhysicsBodyCollisionPtr bodyCollisionB = bodyB->getOnBodyCollision();
-		if (bodyCollisionB.get())
+		bodyCollision->onCollisionBegin(body, other);
+	}
+
+	void PhysicsContact::onEnd(PhysicsBody* body, PhysicsBody* other)
+	{
+		PhysicsBodyCollisionPtr& bodyCollision = body->getOnBodyCollision();
+		if (!bodyCollision.get())
+			return;
+
+		PhysicsBodyCollision::CollisionPair pair((uintptr_t)body, (uintptr_t)other);
+		PhysicsBodyCollision::CollisionHistory::iterator it = this->history.find(pair);
+		if (it == this->history.end())
+			return;
+
+		this->history.erase(it);
+
+		if (this->recording)
 		{
-			
-			PhysicsBodyCollision::CollisionPair pair((uintptr_t)bodyB, (uintptr_t)bodyA);
-			if (!this->history.count(pair))
-			{
-				bodyCollisionB->onCollisionBegin(bodyB, bodyA);
-				this->history.insert(pair);
-			}
+			PhysicsContactEvent evt = { PhysicsContactEventEnd, body, other, nullptr };
+			this->events.push_back(evt);
+			return;
+		}
+
+		if (body->isActive())
+		{
+			bodyCollision->onCollisionEnd(body, other);
 		}
 	}
+
+	void PhysicsContact::BeginContact(b2Contact* contact)
+	{
+
+		PhysicsBody* bodyA = reinterpret_cast<PhysicsBody*>(contact->GetFixtureA()->GetBody()->GetUserData());
+		PhysicsBody* bodyB = reinterpret_cast<PhysicsBody*>(contact->GetFixtureB()->GetBody()->GetUserData());
+		
+		this->onBegin(bodyA, bodyB);
+		this->onBegin(bodyB, bodyA);
+	}
 	
 	void PhysicsContact::EndContact(b2Contact* contact)
 	{
@@ -97,39 +133,116 @@ namespace cs
 		if (PhysicsContact::gIgnoreScriptEvents)
 		{
 			this->history.clear();
+			this->events.clear();
 			return;
 		}
 
 		PhysicsBody* bodyA = reinterpret_cast<PhysicsBody*>(contact->GetFixtureA()->GetBody()->GetUserData());
 		PhysicsBody* bodyB = reinterpret_cast<PhysicsBody*>(contact->GetFixtureB()->GetBody()->GetUserData());
 
-		PhysicsBodyCollisionPtr bodyCollisionA = bodyA->getOnBodyCollision();
-		if (bodyCollisionA.get())
+		this->onEnd(bodyA, bodyB);
+		this->onEnd(bodyB, bodyA);
+	}
+
+	void PhysicsContact::beginStep()
+	{
+		this->recording = true;
+	}
+
+	void PhysicsContact::endStep()
+	{
+		this->recording = false;
+	}
+
+	void PhysicsContact::invoke(const PhysicsContactEvent& evt)
+	{
+		if (!evt.body || !evt.other || !evt.handler)
+			return;
+
+		// an earlier handler may have swapped this body's handler out
+		if (evt.body->getOnBodyCollision().get() != evt.handler)
+			return;
+
+		if (evt.type == PhysicsContactEventBegin)
+		{
+			evt.handler->onCollisionBegin(evt.body, evt.other);
+		}
+		else if (evt.body->isActive())
+		{
+			evt.handler->onCollisionEnd(evt.body, evt.other);
+		}
+	}
+
+	void PhysicsContact::dispatch()
+	{
+		assert(!this->recording);
+		if (this->events.empty())
+			return;
+
+		if (PhysicsContact::gIgnoreScriptEvents)
+		{
+			this->events.clear();
+			return;
+		}
+
+		PROFILE_SCOPE("Physics Contacts");
+		PROFILE_COUNTER("Physics Contacts", uint32(this->events.size()));
+
+		// handlers are looked up now rather than mid step
+		this->threadSafe.clear();
+		for (uint32 i = 0; i < uint32(this->events.size()); ++i)
+		{
+			PhysicsContactEvent& evt = this->events[i];
+			evt.handler = (evt.body) ? evt.body->getOnBodyCollision().get() : nullptr;
+			if (evt.handler && evt.handler->isThreadSafe())
+				this->threadSafe.push_back(i);
+		}
+
+		if (this->threadSafe.size() > 0)
 		{
-			PhysicsBodyCollision::CollisionPair pair((uintptr_t)bodyA, (uintptr_t)bodyB);
-			PhysicsBodyCollision::CollisionHistory::iterator it = this->history.find(pair);
-			if (it != this->history.end())
+			// one run per handler keeps each handler on one thread, its events in order
+			std::vector<PhysicsContactEvent>& evts = this->events;
+			std::stable_sort(this->threadSafe.begin(), this->threadSafe.end(), [&evts](uint32 a, uint32 b)
 			{
-				if (bodyA->isActive())
-				{
-					bodyCollisionA->onCollisionEnd(bodyA, bodyB);
-				}
-				this->history.erase(it);
+				return std::less<PhysicsBodyCollision*>()(evts[a].handler, evts[b].handler);
+			});
+
+			this->runs.clear();
+			for (uint32 i = 0; i < uint32(this->threadSafe.size()); ++i)
+			{
+				if (i == 0 || evts[this->threadSafe[i]].handler != evts[this->threadSafe[i - 1]].handler)
+					this->runs.push_back(i);
 			}
+			this->runs.push_back(uint32(this->threadSafe.size()));
+
+			TaskQueue::getInstance()->parallel(uint32(this->runs.size() - 1), [this](uint32 run)
+			{
+				for (uint32 i = this->runs[run]; i < this->runs[run + 1]; ++i)
+					this->invoke(this->events[this->threadSafe[i]]);
+			});
+		}
+
+		// Scripts and other main thread handlers, in report order.  They may destroy bodies,
+		// removeBody clears those out of the events still to come.
+		for (size_t i = 0; i < this->events.size(); ++i)
+		{
+			const PhysicsContactEvent& evt = this->events[i];
+			if (evt.handler && !evt.handler->isThreadSafe())
+				this->invoke(evt);
 		}
 
-		PhysicsBodyCollisionPtr bodyCollisionB = bodyB->getOnBodyCollision();
-		if (bodyCollisionB.get())
+		this->events.clear();
+	}
+
+	void PhysicsContact::removeBody(PhysicsBody* body)
+	{
+		for (auto& it : this->events)
 		{
-			PhysicsBodyCollision::CollisionPair pair((uintptr_t)bodyB, (uintptr_t)bodyA);
-			PhysicsBodyCollision::CollisionHistory::iterator it = this->history.find(pair);
-			if (it != this->history.end())
+			if (it.body == body || it.other == body)
 			{
-				if (bodyB->isActive())
-				{
-					bodyCollisionB->onCollisionEnd(bodyB, bodyA);
-				}
-				this->history.erase(it);
+				it.body = nullptr;
+				it.other = nullptr;
+				it.handler = nullptr;
 			}
 		}
 	}
@@ -3,7 +3,8 @@
 #include "ClassDef.h"
 
 #include <list>
-#include <set>
+#include <unordered_set>
+#include <vector>
 #include <functional>
 
 #include "Box2D/Box2D.h"
@@ -18,7 +19,17 @@ namespace cs
 	public:
 
 		typedef std::pair<uintptr_t, uintptr_t> CollisionPair;
-		typedef std::set<CollisionPair> CollisionHistory;
+
+		struct CollisionPairHash
+		{
+			size_t operator()(const CollisionPair& pair) const
+			{
+				size_t hash = std::hash<uintptr_t>()(pair.first);
+				return hash ^ (std::hash<uintptr_t>()(pair.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+			}
+		};
+
+		typedef std::unordered_set<CollisionPair, CollisionPairHash> CollisionHistory;
 
 		
 		PhysicsBodyCollision() { }
@@ -27,6 +38,10 @@ namespace cs
 		virtual void onCollisionBegin(PhysicsBody* thisBody, PhysicsBody* otherBody) { }
 		virtual void onCollisionEnd(PhysicsBody* thisBody, PhysicsBody* otherBody) { }
 
+		// Thread safe handlers are called from the task queue, each handler's events in order.
+		// They may only touch state of their own and must not create or destroy bodies.
+		virtual bool isThreadSafe() const { return false; }
+
 		
 	};
 
@@ -54,12 +69,36 @@ namespace cs
 		virtual ~PhysicsLiquidContactData() { }
 	};
 
+	enum PhysicsContactEventType
+	{
+		PhysicsContactEventNone = -1,
+		PhysicsContactEventBegin,
+		PhysicsContactEventEnd,
+		//...
+		PhysicsContactEventMAX
+	};
+
+	// A body contact change, reported to body's collision handler with other
+	struct PhysicsContactEvent
+	{
+		PhysicsContactEventType type;
+		PhysicsBody* body;
+		PhysicsBody* other;
+		PhysicsBodyCollision* handler;	// resolved when dispatched
+	};
+
+	// Body contacts reported during a step are only recorded, into a flat per step list, and handed
+	// to the collision handlers by dispatch once b2World::Step has returned.  No handler (or script)
+	// runs inside the solver.  Contacts reported outside a step (bodies being destroyed) still go
+	// straight to the handlers.
 	class PhysicsContact : public b2ContactListener
 	{
 	public:
 
 		static bool gIgnoreScriptEvents;
 
+		PhysicsContact();
+
 		virtual void BeginContact(b2Contact* contact);
 		virtual void EndContact(b2Contact* contact);
 
@@ -68,7 +107,33 @@ namespace cs
 		virtual void EndContact(b2Fixture* fixture,
 			b2ParticleSystem* particleSystem, int32 index);
 
+		// Bracket b2World::Step, contacts in between are recorded
+		void beginStep();
+		void endStep();
+
+		// Hands the recorded contacts to their handlers: thread safe handlers across the task
+		// queue first, then everything else in the order the contacts were reported
+		void dispatch();
+
+		// Drops recorded contacts involving body, call before it's destroyed
+		void removeBody(PhysicsBody* body);
+
+		size_t getNumPending() const { return this->events.size(); }
+
 		PhysicsBodyCollision::CollisionHistory history;
 
+	private:
+
+		void onBegin(PhysicsBody* body, PhysicsBody* other);
+		void onEnd(PhysicsBody* body, PhysicsBody* other);
+		void invoke(const PhysicsContactEvent& evt);
+
+		bool recording;
+		std::vector<PhysicsContactEvent> events;
+
+		// reused by dispatch
+		std::vector<uint32> threadSafe;
+		std::vector<uint32> runs;
+
 	};
 }
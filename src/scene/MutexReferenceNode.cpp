@@ -62,7 +62,7 @@ namespace cs
 			sum += it->chance;
 		}
 
-		int32 choice = rand() % sum;
+		int32 choice = int32(Random::get().nextUInt(uint32(sum)));
 		int32 ctr = 0;
 		for (size_t i = 0; i < this->choices.size(); i++)
 		{
@@ -329,7 +329,7 @@ namespace cs
 		{
 			return true;
 		}
-		return (rand() % 100) < this->chanceToSpawn;
+		return int32(Random::get().nextUInt(100)) < this->chanceToSpawn;
 	}
 
 	void ReferenceNode::copyToNode()
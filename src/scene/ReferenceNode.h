@@ -9,6 +9,7 @@ namespace cs
 {
 
 	class SceneReferenceHandle;
+	class ReferencePool;
 
 	typedef std::map<std::string, PropertySetPtr> PropertySetOverrides;
 
@@ -53,6 +54,10 @@ namespace cs
 		bool computeNewChanceToSpawn();
 
 		void setLuaState(LuaStatePtr& state) { this->luaState = state; }
+
+		// set on instances spawned through a ReferencePool so they can be handed back
+		void setPool(const std::shared_ptr<ReferencePool>& p) { this->pool = p; }
+		std::shared_ptr<ReferencePool> getPool() const { return this->pool.lock(); }
 		
 	protected:
 
@@ -83,6 +88,8 @@ namespace cs
 		bool useChanceToSpawn;
 		int32 chanceToSpawn;
 
+		std::weak_ptr<ReferencePool> pool;
+
 	};
 
 #if defined(CS_WINDOWS)
@@ -0,0 +1,130 @@
+#include "PCH.h"
+
+#include "scene/ReferencePool.h"
+#include "scene/SceneData.h"
+
+#include "ecs/comp/ScriptComponent.h"
+
+namespace cs
+{
+	ReferencePool::ReferencePool(const std::string& name, SceneData* data, size_t sz)
+		: referenceName(name)
+		, sceneData(data)
+		, maxSize(sz)
+	{
+
+	}
+
+	ReferencePool::~ReferencePool()
+	{
+		this->clear();
+	}
+
+	ReferenceNodePtr ReferencePool::acquire()
+	{
+		if (this->available.size() == 0)
+		{
+			++this->stats.misses;
+			return ReferenceNodePtr();
+		}
+
+		ReferenceNodePtr node = this->available.back();
+		this->available.pop_back();
+		++this->stats.hits;
+		return node;
+	}
+
+	bool ReferencePool::release(ReferenceNodePtr& node)
+	{
+		if (!node.get())
+			return false;
+
+		this->unlink(node);
+
+		if (this->available.size() >= this->maxSize)
+		{
+			++this->stats.discarded;
+			node->destroyAll();
+			return false;
+		}
+
+		park(node.get());
+		this->available.push_back(node);
+		++this->stats.releases;
+		return true;
+	}
+
+	void ReferencePool::addWarmed(ReferenceNodePtr& node)
+	{
+		this->unlink(node);
+		park(node.get());
+		this->available.push_back(node);
+		++this->stats.warmed;
+	}
+
+	bool ReferencePool::unlink(ReferenceNodePtr& node)
+	{
+		EntityPtr parent = node->getParentEntity();
+		if (parent.get())
+		{
+			return parent->removeChildByName(node->getName());
+		}
+		return this->sceneData->removeByName(node->getName());
+	}
+
+	void ReferencePool::clear()
+	{
+		for (auto& it : this->available)
+		{
+			it->destroyAll();
+		}
+		this->available.clear();
+	}
+
+	void ReferencePool::park(Entity* entity)
+	{
+		struct local
+		{
+			static void parkEntity(Entity* e, void* data)
+			{
+				for (auto& it : e->getAllComponents())
+				{
+					it.second->setDisabled();
+				}
+				e->setEnabled(false);
+				e->resetTransform();
+			}
+		};
+
+		entity->traverse(&local::parkEntity, nullptr);
+	}
+
+	void ReferencePool::activate(Entity* entity)
+	{
+		struct local
+		{
+			static void activateEntity(Entity* e, void* data)
+			{
+				// push the initial transform through the change callbacks so physics bodies follow
+				Transform transform = e->getLocalInitialTransform();
+				e->setCurrentTransform(transform);
+				e->setEnabled(true);
+
+				for (auto& it : e->getAllComponents())
+				{
+					it.second->setEnabled();
+				}
+
+				// a fresh Lua instance so no per-spawn script state survives, Entity::reset leaves scripts alone
+				ScriptComponentPtr script = e->getComponent<ScriptComponent>();
+				if (script.get())
+				{
+					script->resetScript();
+				}
+			}
+		};
+
+		entity->traverse(&local::activateEntity, nullptr);
+		entity->reset();
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ClassDef.h"
+#include "scene/ReferenceNode.h"
+
+#include <vector>
+
+namespace cs
+{
+	class SceneData;
+
+	struct ReferencePoolStats
+	{
+		ReferencePoolStats()
+			: hits(0)
+			, misses(0)
+			, releases(0)
+			, warmed(0)
+			, discarded(0) { }
+
+		uint32 hits;		// spawns served from parked instances
+		uint32 misses;		// spawns that had to clone the reference
+		uint32 releases;	// instances returned to the pool
+		uint32 warmed;		// instances created ahead of time
+		uint32 discarded;	// releases dropped because the pool was full
+	};
+
+	// Parked, disabled instances of one .entity reference for one SceneData.  Parked nodes
+	// are out of the scene graph but keep their components registered with the scene's
+	// systems (disabled) so handing one back out is a re-link rather than a full clone.
+	CLASS_DEFINITION(ReferencePool)
+	public:
+
+		static const size_t kDefaultMaxSize = 256;
+
+		ReferencePool(const std::string& referenceName, SceneData* data, size_t maxSize = kDefaultMaxSize);
+		~ReferencePool();
+
+		const std::string& getReferenceName() const { return this->referenceName; }
+		SceneData* getSceneData() const { return this->sceneData; }
+
+		// parked instance or null on a miss, the caller links it back into the graph
+		ReferenceNodePtr acquire();
+		// unlinks and parks the node, returns false if it was dropped instead
+		bool release(ReferenceNodePtr& node);
+		void addWarmed(ReferenceNodePtr& node);
+
+		void clear();
+
+		size_t getNumAvailable() const { return this->available.size(); }
+		void setMaxSize(size_t sz) { this->maxSize = sz; }
+		size_t getMaxSize() const { return this->maxSize; }
+
+		const ReferencePoolStats& getStats() const { return this->stats; }
+		void resetStats() { this->stats = ReferencePoolStats(); }
+
+		// Reset protocol, applied to the node and all of its children
+		static void park(Entity* entity);
+		static void activate(Entity* entity);
+
+	private:
+
+		bool unlink(ReferenceNodePtr& node);
+
+		std::string referenceName;
+		SceneData* sceneData;
+		size_t maxSize;
+
+		std::vector<ReferenceNodePtr> available;
+		ReferencePoolStats stats;
+	};
+}
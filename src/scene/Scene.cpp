@@ -5,6 +5,7 @@
 #include "gfx/Shader.h"
 
 #include "os/LogManager.h"
+#include "global/EventQueue.h"
 
 #include "ecs/system/DrawableSystem.h"
 #include "ecs/system/PhysicsSystem.h"
@@ -28,6 +29,11 @@ namespace cs
 		"depth",	 // SceneRenderDepth
 	};
 
+	const StringId kShadowPassTag("Shadow");
+	const StringId kAnimationTimeUniform("animation_time");
+	const StringId kAnimationTimeVtxUniform("animation_time_vtx");
+	const StringId kAnimationPctUniform("animation_pct");
+
     Scene::SceneLock Scene::kLock;
     
 	BEGIN_META_CLASS(SceneParams)
@@ -83,6 +89,8 @@ namespace cs
     
 	Scene::Scene(SceneLock& lock, SceneParams& params)
 		: name(params.name)
+		, processTag(params.name + "_Process")
+		, mainPassTag(params.name + "_Main")
 		, active(true)
 		, listening(true)
         , animating(true)
@@ -228,36 +236,44 @@ namespace cs
 	}
 
 	void Scene::draw()
+	{
+		SceneFrame frame;
+		this->capture(frame, false);
+		this->submit(frame);
+	}
+
+	void Scene::capture(SceneFrame& frame, bool pipelined)
 	{
 		this->data->setContext();
 
 		if (this->onScriptDraw)
 			(*this->onScriptDraw.get())();
 
-		bool isSubScene = false;
-		if (this->rtt.target.get())
+		frame.isSubScene = (this->rtt.target.get() != nullptr);
+		frame.animTime = this->animTime;
+		frame.tint = this->tint;
+		frame.resolveToFront = this->resolveToFront;
+		frame.resolveViewport = this->resolveViewport;
+		frame.mainTargetCallback = this->mainTargetCallback;
+		frame.toEraseList.clear();
+		this->data->captureLights(frame.lights);
+
+		if (pipelined)
 		{
-			this->rtt.target->bind();
-			isSubScene = true;
+			frame.camera = CREATE_CLASS(Camera);
+			*frame.camera = *this->camera;
+		}
+		else
+		{
+			frame.camera = this->camera;
 		}
 
-		UniformPtr anim_time = SharedUniform::getInstance().getUniform("animation_time");
-		assert(anim_time);
-		anim_time->setValue(this->animTime);
-
-		UniformPtr anim_time_vtx = SharedUniform::getInstance().getUniform("animation_time_vtx");
-		assert(anim_time_vtx);
-		anim_time_vtx->setValue(this->animTime);
-
-		UniformPtr anim_time_pct = SharedUniform::getInstance().getUniform("animation_pct");
-		assert(anim_time_pct);
-		anim_time_pct->setValue(this->animTime - float32(int32(this->animTime)));
-
-		this->data->bindLights();
-
-		DisplayList display_list;
+		frame.displayList = std::make_shared<DisplayList>();
+		DisplayList& display_list = *frame.displayList;
 
+		bool isSubScene = frame.isSubScene;
 		bool callbackToMainPass = (!isSubScene && this->resolveToFront.get());
+		frame.callbackToMainPass = callbackToMainPass;
 		
 		// Call pre-draw flag (maybe refactored!?)
 		if (callbackToMainPass)
@@ -266,7 +282,7 @@ namespace cs
 				this->preDrawFunc(this);
 		}
 
-		PostProcessList toEraseList;
+		PostProcessList& toEraseList = frame.toEraseList;
 		if (this->preProcess.size() > 0)
 		{
 			for (PostProcessList::iterator it = this->preProcess.begin(); it != this->preProcess.end(); )
@@ -287,40 +303,39 @@ namespace cs
 
 		if (!isSubScene)
 		{
-			DisplayListPassPtr depth_pass = display_list.addPass("Shadow", RenderTraversalShadow);
+			DisplayListPassPtr depth_pass = display_list.addPass(kShadowPassTag, RenderTraversalShadow);
 			depth_pass->traversalMask.set(RenderTraversalShadow);
 			depth_pass->target = RenderTargetManager::getInstance()->getTarget(RenderTargetTypeCopyBuffer);
-			depth_pass->targetViewport = this->camera->getViewport();
+			depth_pass->targetViewport = frame.camera->getViewport();
 			depth_pass->clearColor = ColorF::Black;
 			depth_pass->clearModes = this->clearModes;
-            depth_pass->zNear = this->camera->getNear();
-            depth_pass->zFar = this->camera->getFar();
-			display_list.traversals[RenderTraversalShadow].camera = this->camera;
+            depth_pass->zNear = frame.camera->getNear();
+            depth_pass->zFar = frame.camera->getFar();
+			display_list.traversals[RenderTraversalShadow].camera = frame.camera;
 		}
 
-		display_list.traversals[RenderTraversalMain].camera = this->camera;
+		display_list.traversals[RenderTraversalMain].camera = frame.camera;
         
-        std::string passName = this->getName() + "_Main";
-		DisplayListPassPtr main_pass = display_list.addPass(passName, RenderTraversalMain);
+		DisplayListPassPtr main_pass = display_list.addPass(this->mainPassTag, RenderTraversalMain);
 		main_pass->traversalMask.set(RenderTraversalMain);
 		if (isSubScene)
 		{
 			main_pass->clearColor = this->clearColor;
 			main_pass->clearModes = this->clearModes;
 			main_pass->target = this->rtt.target;
-			main_pass->targetViewport = this->camera->getViewport();
-            main_pass->zNear = this->camera->getNear();
-            main_pass->zFar = this->camera->getFar();
+			main_pass->targetViewport = frame.camera->getViewport();
+            main_pass->zNear = frame.camera->getNear();
+            main_pass->zFar = frame.camera->getFar();
 		}
 		else if (this->resolveToFront.get())
 		{
 			main_pass->clearColor = this->clearColor;
 			main_pass->clearModes = this->clearModes;
 			main_pass->target = RenderTargetManager::getInstance()->getTarget(RenderTargetManager::kUseBackBuffer);
-			main_pass->targetViewport = this->camera->getViewport();
+			main_pass->targetViewport = frame.camera->getViewport();
 			main_pass->preCallback = this->preDrawFunc;
-            main_pass->zNear = this->camera->getNear();
-            main_pass->zFar = this->camera->getFar();
+            main_pass->zNear = frame.camera->getNear();
+            main_pass->zFar = frame.camera->getFar();
 		}
 
         if (this->systemsEnabled.test(ECSDraw))
@@ -339,39 +354,71 @@ namespace cs
 			}
 		}
 
+		if (pipelined)
+		{
+			display_list.freeze();
+		}
+	}
+
+	void Scene::submit(SceneFrame& frame)
+	{
+		assert(frame.displayList);
+
+		if (frame.isSubScene)
+		{
+			this->rtt.target->bind();
+		}
+
+		UniformPtr anim_time = SharedUniform::getInstance().getUniform(kAnimationTimeUniform);
+		assert(anim_time);
+		anim_time->setValue(frame.animTime);
+
+		UniformPtr anim_time_vtx = SharedUniform::getInstance().getUniform(kAnimationTimeVtxUniform);
+		assert(anim_time_vtx);
+		anim_time_vtx->setValue(frame.animTime);
+
+		UniformPtr anim_time_pct = SharedUniform::getInstance().getUniform(kAnimationPctUniform);
+		assert(anim_time_pct);
+		anim_time_pct->setValue(frame.animTime - float32(int32(frame.animTime)));
+
+		SceneData::bindLights(frame.lights);
+
 		DisplayListUtil::DrawParams drawParams;
-		drawParams.tint = this->tint;
+		drawParams.tint = frame.tint;
 		drawParams.scene = this;
 
 		// draw the display list!
-		display_list.draw(&drawParams);
+		frame.displayList->draw(&drawParams);
 
 		bool drawToRenderTarget = false;
-		if (this->mainTargetCallback)
+		if (frame.mainTargetCallback)
 		{
-			drawToRenderTarget = this->mainTargetCallback(this->resolveViewport);
+			drawToRenderTarget = frame.mainTargetCallback(frame.resolveViewport);
 		}
 
-		if (this->resolveToFront.get())
+		if (frame.resolveToFront.get())
 		{
 			if (!drawToRenderTarget)
 			{
 				RenderInterface::getInstance()->setDefaultFrameBuffer();
 			}
-			this->resolveToFront->draw(this->resolveViewport);
+			frame.resolveToFront->draw(frame.resolveViewport);
 		}
 
-		if (callbackToMainPass)
+		if (frame.callbackToMainPass)
 		{
 			if (this->postDrawFunc)
 				this->postDrawFunc(this);
 		}
 
-		if (!isSubScene)
+		if (!frame.isSubScene)
 		{
 			this->drawDebugImpl();
 		}
 
+		// done with, release the display list and any one shot passes it drew
+		frame.displayList = nullptr;
+		frame.toEraseList.clear();
 	}
 
 	void Scene::drawDebugImpl()
@@ -475,10 +522,7 @@ namespace cs
 
 	void Scene::process(float32 dt)
 	{
-        
-        std::string tag;
-        tag = this->getName() + "_Process";
-        RenderInterface::getInstance()->pushDebugScope(tag);
+        RenderInterface::getInstance()->pushDebugScope(this->processTag);
 		SceneTimers::iterator it = this->timers.begin();
 		while (it != this->timers.end())
 		{
@@ -514,6 +558,8 @@ namespace cs
 		float32 animateDt = dt * this->animAdjustment;
 
 		this->data->setContext();
+
+		EventQueue::getInstance()->dispatch(EventDispatchPreUpdate);
 		
 		if (this->active)
 		{
@@ -550,12 +596,17 @@ namespace cs
 			if (this->systemsEnabled.test(ECSParticle)) ParticleSystem::getInstance()->process(&systemParams);
 			if (this->systemsEnabled.test(ECSScript)) ScriptSystem::getInstance()->process(&systemParams);
 			if (this->systemsEnabled.test(ECSPhysics)) PhysicsSystem::getInstance()->process(&systemParams);
+
+			EventQueue::getInstance()->dispatch(EventDispatchPostPhysics);
+
 			if (this->systemsEnabled.test(ECSGame)) GameSystem::getInstance()->process(&systemParams);
 		}
 
 		this->setECSContext();
 
 		if (this->systemsEnabled.test(ECSAudio)) AudioSystem::getInstance()->process(&systemParams);
+
+		EventQueue::getInstance()->dispatch(EventDispatchPostUpdate);
         
 		if (this->resolveToFront.get() && this->resolveToFront->getParams().isDynamic)
 		{
@@ -40,6 +40,31 @@ namespace cs
 	};
 	extern const char* kSceneRenderFlag[];
 
+	// Everything Scene::submit reads, taken by Scene::capture.  A pipelined frame is captured while
+	// the simulation is idle and submitted while it runs the next frame, so nothing here may point
+	// back at state the simulation writes.
+	struct SceneFrame
+	{
+		SceneFrame()
+			: animTime(0.0f)
+			, tint(ColorF::White)
+			, isSubScene(false)
+			, callbackToMainPass(false)
+		{ }
+
+		std::shared_ptr<DisplayList> displayList;
+		CameraPtr camera;
+		float32 animTime;
+		LightValueList lights;
+		ColorF tint;
+		bool isSubScene;
+		bool callbackToMainPass;
+		PostProcessList toEraseList;
+		PostProcessPtr resolveToFront;
+		RectI resolveViewport;
+		std::function<bool(const RectI&)> mainTargetCallback;
+	};
+
 	CLASS_DEFINITION_REFLECT(SceneParams)
 	public:
     
@@ -150,7 +175,11 @@ namespace cs
 		bool getIsListening() const;
 		void setIsListening(bool l);
 
+		// draw() is capture then submit.  A pipelined capture snapshots the camera and freezes the
+		// display list so submit can run alongside the next process.
 		virtual void draw();
+		virtual void capture(SceneFrame& frame, bool pipelined);
+		virtual void submit(SceneFrame& frame);
 		virtual void process(float32 dt);
 		virtual void reset();
 
@@ -190,6 +219,9 @@ namespace cs
 
 		SceneRenderMask renderMask;
 
+		// Debug overlays walk the live entities while drawing, so they can't be pipelined
+		bool getHasDebugDraw() const { return this->renderMask.test(SceneRenderDebug) || this->renderMask.test(SceneRenderPhysics); }
+
 		static ColorB getSelectableColor(SelectableVolumeType type);
 
 		void setSceneSpeed(float32 speed);
@@ -226,6 +258,8 @@ namespace cs
 		friend class SceneManager;
 
 		std::string name;
+		StringId processTag;
+		StringId mainPassTag;
 		bool active;
 		bool listening;
         bool animating;
@@ -4,6 +4,7 @@
 
 #include "ecs/comp/ComponentList.h"
 #include "scene/Scene.h"
+#include "scene/SceneReference.h"
 
 namespace cs
 {
@@ -111,6 +112,52 @@ namespace cs
 		return entity;
 	}
 
+	EntityPtr SceneCreator::spawnReferenceNode(SceneCreatorPtr& params)
+	{
+		if (params->resource_name.length() <= 0 || params->name.length() <= 0)
+		{
+			log::error("Failed to specify name/resource!");
+			return EntityPtr();
+		}
+
+		ReferencePoolPtr pool = SceneReferenceCache::getInstance()->getPool(params->resource_name, params->sceneData.get());
+		ReferenceNodePtr node = pool->acquire();
+		if (!node.get())
+		{
+			EntityPtr entity = createReferenceNode(params);
+			if (entity.get())
+			{
+				std::static_pointer_cast<ReferenceNode>(entity)->setPool(pool);
+			}
+			return entity;
+		}
+
+		SceneDataPtr& sceneData = params->sceneData;
+		sceneData->setContext();
+
+		std::string name;
+		if (params->parent)
+			name = sceneData->getEmptyKey(params->name, params->parent->getChildren());
+		else
+			name = sceneData->getEmptyKey(params->name, sceneData->getEntities());
+		node->setName(name);
+
+		EntityPtr entity = std::static_pointer_cast<Entity>(node);
+		bool added = (params->parent) ? Entity::addChild(params->parent, entity) : sceneData->getEntities().add(entity, name);
+		if (!added)
+		{
+			pool->addWarmed(node);
+			return EntityPtr();
+		}
+
+		// no scene remap here, the collection add keeps the lookup current
+		entity->linkGraph(params->parent, entity);
+		ReferencePool::activate(entity.get());
+		entity->setPosition(params->position);
+
+		return entity;
+	}
+
 	EntityPtr SceneCreator::createSprite(SceneCreatorPtr& params)
 	{
 		struct local
@@ -25,6 +25,8 @@ namespace cs
 		SceneCreateComponentMask createMask;
 
 		static EntityPtr createReferenceNode(SceneCreatorPtr& params);
+		// same as createReferenceNode but reuses a parked instance from the reference's pool
+		static EntityPtr spawnReferenceNode(SceneCreatorPtr& params);
 		static EntityPtr createSprite(SceneCreatorPtr& params);
 		static EntityPtr createLight(SceneCreatorPtr& params);
 
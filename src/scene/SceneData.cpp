@@ -13,6 +13,9 @@
 #include "ecs/system/GameSystem.h"
 #include "ecs/system/AudioSystem.h"
 
+#include "scene/SceneReference.h"
+#include "gfx/RenderInterface.h"
+
 namespace cs
 {
 	
@@ -70,6 +73,7 @@ namespace cs
 	void SceneData::empty()
 	{
 		this->setContext();
+		SceneReferenceCache::getInstance()->clearPools(this);
 		for (auto it : this->entities.value_vec)
 		{
 			it->clear();
@@ -96,6 +100,7 @@ namespace cs
 	void SceneData::destroy()
 	{
         this->setContext();
+		SceneReferenceCache::getInstance()->clearPools(this);
 		for (auto& it : this->entities.value_vec)
 		{
 			it->destroyAll();
@@ -185,27 +190,73 @@ namespace cs
 		}
 	}
 
+	// Per light uniform names, formatted once instead of for every light every frame
+	struct LightUniformNames
+	{
+		LightUniformNames()
+		{
+			for (uint32 i = 0; i < RenderInterface::kMaxLightIndex; ++i)
+			{
+				std::stringstream lp;
+				lp << "light_position" << i;
+				this->position[i] = StringId(lp.str());
+
+				std::stringstream di;
+				di << "diffuse_intensity" << i;
+				this->diffuseIntensity[i] = StringId(di.str());
+
+				std::stringstream ai;
+				ai << "ambient_intensity" << i;
+				this->ambientIntensity[i] = StringId(ai.str());
+			}
+		}
+
+		StringId position[RenderInterface::kMaxLightIndex];
+		StringId diffuseIntensity[RenderInterface::kMaxLightIndex];
+		StringId ambientIntensity[RenderInterface::kMaxLightIndex];
+	};
+
 	void SceneData::bindLights()
 	{
+		LightValueList values;
+		this->captureLights(values);
+		SceneData::bindLights(values);
+	}
+
+	void SceneData::captureLights(LightValueList& values)
+	{
+		values.clear();
 		for (auto& light : this->lights)
 		{
-			std::stringstream lp;
-			lp << "light_position" << light->getIndex();
-			UniformPtr lightUniform = SharedUniform::getInstance().getUniform(lp.str());
+			LightValues value;
+			value.index = light->getIndex();
+			value.position = light->getWorldPosition();
+			value.diffuseIntensity = light->getDiffuseIntensity();
+			value.ambientIntensity = light->getAmbientIntensity();
+			values.push_back(value);
+		}
+	}
+
+	void SceneData::bindLights(const LightValueList& values)
+	{
+		static const LightUniformNames kLightUniformNames;
+
+		for (auto& light : values)
+		{
+			uint32 index = light.index;
+			assert(index < RenderInterface::kMaxLightIndex);
+
+			UniformPtr lightUniform = SharedUniform::getInstance().getUniform(kLightUniformNames.position[index]);
 			assert(lightUniform);
-			lightUniform->setValue(light->getWorldPosition());
+			lightUniform->setValue(light.position);
 
-			std::stringstream di;
-			di << "diffuse_intensity" << light->getIndex();
-			UniformPtr diffuseIntensityUniform = SharedUniform::getInstance().getUniform(di.str());
+			UniformPtr diffuseIntensityUniform = SharedUniform::getInstance().getUniform(kLightUniformNames.diffuseIntensity[index]);
 			assert(diffuseIntensityUniform);
-			diffuseIntensityUniform->setValue(light->getDiffuseIntensity());
+			diffuseIntensityUniform->setValue(light.diffuseIntensity);
 
-			std::stringstream ai;
-			ai << "ambient_intensity" << light->getIndex();
-			UniformPtr ambientIntensityUniform = SharedUniform::getInstance().getUniform(ai.str());
+			UniformPtr ambientIntensityUniform = SharedUniform::getInstance().getUniform(kLightUniformNames.ambientIntensity[index]);
 			assert(ambientIntensityUniform);
-			ambientIntensityUniform->setValue(light->getAmbientIntensity());
+			ambientIntensityUniform->setValue(light.ambientIntensity);
 		}
 	}
 }
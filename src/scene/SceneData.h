@@ -39,6 +39,18 @@ namespace cs
 
 	typedef std::shared_ptr<SceneSelected> SceneSelectedPtr;
 
+	// What bindLights uploads for one light, captured so a pipelined frame binds the lights as
+	// they were when it was built
+	struct LightValues
+	{
+		uint32 index;
+		vec3 position;
+		float32 diffuseIntensity;
+		float32 ambientIntensity;
+	};
+
+	typedef std::vector<LightValues> LightValueList;
+
 	CLASS_DEFINITION_REFLECT(SceneData)
 	
 	public:
@@ -67,6 +79,8 @@ namespace cs
 
 		LightList& getAllLights() { return this->lights; }
 		void bindLights();
+		void captureLights(LightValueList& values);
+		static void bindLights(const LightValueList& values);
 
 		virtual void setContext();
 		ECSContextPtr& getContext() { return this->ecsCxt; }
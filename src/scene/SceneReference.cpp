@@ -3,6 +3,7 @@
 #include "scene/SceneReference.h"
 #include "global/ResourceFactory.h"
 #include "ecs/ECS_Context.h"
+#include "scene/SceneCreator.h"
 
 #include "ecs/system/DrawableSystem.h"
 #include "ecs/system/PhysicsSystem.h"
@@ -73,11 +74,126 @@ namespace cs
 
 	void SceneReferenceCache::clearAllReferences()
 	{
+		this->clearAllPools();
+
 		ECSContextScope scope(this->ecsCxt);
 		ResourceFactory::getInstance()->clearResourceByType<SceneReference>();
 		this->references.clear();
 	}
 
+	ReferencePoolPtr SceneReferenceCache::getPool(const std::string& fileName, SceneData* data)
+	{
+		ReferencePoolKey key(data, fileName);
+		ReferencePoolMap::iterator it = this->pools.find(key);
+		if (it != this->pools.end())
+		{
+			return it->second;
+		}
+
+		ReferencePoolPtr pool = CREATE_CLASS(ReferencePool, fileName, data);
+		this->pools[key] = pool;
+		return pool;
+	}
+
+	uint32 SceneReferenceCache::warmPool(const std::string& fileName, SceneDataPtr& data, uint32 count)
+	{
+		if (!data.get())
+		{
+			log::error("Cannot warm pool for ", fileName, " without scene data");
+			return 0;
+		}
+
+		ReferencePoolPtr pool = this->getPool(fileName, data.get());
+		SceneCreatorPtr params = CREATE_CLASS(SceneCreator, data);
+		params->name = FileManager::stripExtension(fileName);
+		params->resource_name = fileName;
+
+		uint32 warmed = 0;
+		for (uint32 i = 0; i < count && pool->getNumAvailable() < pool->getMaxSize(); ++i)
+		{
+			EntityPtr entity = SceneCreator::createReferenceNode(params);
+			if (!entity.get())
+			{
+				break;
+			}
+
+			ReferenceNodePtr node = std::static_pointer_cast<ReferenceNode>(entity);
+			node->setPool(pool);
+			pool->addWarmed(node);
+			++warmed;
+		}
+
+		return warmed;
+	}
+
+	bool SceneReferenceCache::releaseInstance(EntityPtr& entity)
+	{
+		ReferenceNodePtr node = std::dynamic_pointer_cast<ReferenceNode>(entity);
+		ReferencePoolPtr pool = (node.get()) ? node->getPool() : ReferencePoolPtr();
+		if (!pool.get())
+		{
+			log::error("Cannot release ", (entity.get()) ? entity->getName() : "null", " - not a pooled reference instance");
+			return false;
+		}
+
+		return pool->release(node);
+	}
+
+	void SceneReferenceCache::clearPools(SceneData* data)
+	{
+		ReferencePoolMap::iterator it = this->pools.begin();
+		while (it != this->pools.end())
+		{
+			if (it->first.first == data)
+			{
+				it->second->clear();
+				it = this->pools.erase(it);
+				continue;
+			}
+			++it;
+		}
+	}
+
+	void SceneReferenceCache::clearAllPools()
+	{
+		for (auto& it : this->pools)
+		{
+			it.second->clear();
+		}
+		this->pools.clear();
+	}
+
+	ReferencePoolStats SceneReferenceCache::getTotalPoolStats() const
+	{
+		ReferencePoolStats total;
+		for (auto& it : this->pools)
+		{
+			const ReferencePoolStats& stats = it.second->getStats();
+			total.hits += stats.hits;
+			total.misses += stats.misses;
+			total.releases += stats.releases;
+			total.warmed += stats.warmed;
+			total.discarded += stats.discarded;
+		}
+		return total;
+	}
+
+	void SceneReferenceCache::printPoolStats() const
+	{
+		for (auto& it : this->pools)
+		{
+			const ReferencePool& pool = *it.second;
+			const ReferencePoolStats& stats = pool.getStats();
+			log::info("Reference pool ", pool.getReferenceName(),
+				": ", pool.getNumAvailable(), " parked, ",
+				stats.hits, " hits, ",
+				stats.misses, " misses, ",
+				stats.releases, " releases, ",
+				stats.warmed, " warmed, ",
+				stats.discarded, " discarded");
+		}
+	}
+
 	void SceneReferenceCache::addMapping(const std::string& to, const std::string& from)
 	{
 		ReferenceReplaceMap::iterator it = this->replaceMap.find(from);
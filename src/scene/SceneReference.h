@@ -5,6 +5,7 @@
 #include "global/Event.h"
 
 #include "scene/ReferenceNode.h"
+#include "scene/ReferencePool.h"
 
 namespace cs
 {
@@ -65,15 +66,28 @@ namespace cs
 		void addMapping(const std::string& to, const std::string& from);
 		void clearMapping(const std::string& from);
 
+		// Instance pools, one per reference per SceneData
+		ReferencePoolPtr getPool(const std::string& fileName, SceneData* data);
+		uint32 warmPool(const std::string& fileName, SceneDataPtr& data, uint32 count);
+		bool releaseInstance(EntityPtr& entity);
+		void clearPools(SceneData* data);
+		void clearAllPools();
+
+		ReferencePoolStats getTotalPoolStats() const;
+		void printPoolStats() const;
+
 	private:
 
 		SceneReferencePtr loadReferenceInternal(const std::string& fileName);
 
 		typedef std::map<std::string, std::string> ReferenceReplaceMap;
 		typedef std::map<std::string, SceneReferencePtr> SceneReferenceMap;
+		typedef std::pair<SceneData*, std::string> ReferencePoolKey;
+		typedef std::map<ReferencePoolKey, ReferencePoolPtr> ReferencePoolMap;
 		
 		ReferenceReplaceMap replaceMap;
 		SceneReferenceMap references;
+		ReferencePoolMap pools;
 		ECSContextPtr ecsCxt;
 	};
 
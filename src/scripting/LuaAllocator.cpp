@@ -0,0 +1,160 @@
+#include "PCH.h"
+
+#include "scripting/LuaAllocator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+namespace cs
+{
+	LuaAllocator::LuaAllocator(bool pool)
+		: usePool(pool)
+		, chunkCursor(nullptr)
+		, chunkEnd(nullptr)
+		, heapSize(0)
+		, peakHeapSize(0)
+		, pooledSize(0)
+		, allocatedBytes(0)
+	{
+		memset(this->freeLists, 0, sizeof(this->freeLists));
+	}
+
+	LuaAllocator::~LuaAllocator()
+	{
+		for (auto& chunk : this->chunks)
+		{
+			free(chunk);
+		}
+		this->chunks.clear();
+	}
+
+	void* LuaAllocator::alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+	{
+		LuaAllocator* allocator = reinterpret_cast<LuaAllocator*>(ud);
+		return allocator->reallocate(ptr, osize, nsize);
+	}
+
+	void* LuaAllocator::reallocate(void* ptr, size_t osize, size_t nsize)
+	{
+		// when ptr is null osize holds the type of object being created, not a size
+		if (!ptr)
+		{
+			osize = 0;
+		}
+
+		if (nsize == 0)
+		{
+			if (ptr)
+			{
+				this->heapSize -= osize;
+				if (this->usePool && osize <= kMaxPooledSize)
+				{
+					this->freeBlock(ptr, getSizeClass(osize));
+				}
+				else
+				{
+					free(ptr);
+				}
+			}
+			return nullptr;
+		}
+
+		this->allocatedBytes += (nsize > osize) ? (nsize - osize) : 0;
+
+		void* block = nullptr;
+		if (!this->usePool)
+		{
+			block = realloc(ptr, nsize);
+		}
+		else
+		{
+			bool wasPooled = ptr && osize <= kMaxPooledSize;
+			bool isPooled = nsize <= kMaxPooledSize;
+
+			if (wasPooled && isPooled && getSizeClass(osize) == getSizeClass(nsize))
+			{
+				block = ptr;
+			}
+			else if (!ptr || !(wasPooled || isPooled))
+			{
+				block = (isPooled) ? this->allocBlock(getSizeClass(nsize)) : realloc(ptr, nsize);
+			}
+			else
+			{
+				// moving between a pool and the system heap or between size classes
+				block = (isPooled) ? this->allocBlock(getSizeClass(nsize)) : malloc(nsize);
+				if (block)
+				{
+					memcpy(block, ptr, std::min<size_t>(osize, nsize));
+					if (wasPooled)
+						this->freeBlock(ptr, getSizeClass(osize));
+					else
+						free(ptr);
+				}
+			}
+		}
+
+		// Lua expects a failed shrink to keep the old block, a failed grow returns null
+		if (!block)
+		{
+			return nullptr;
+		}
+
+		this->heapSize += nsize;
+		this->heapSize -= osize;
+		this->peakHeapSize = std::max<size_t>(this->peakHeapSize, this->heapSize);
+		return block;
+	}
+
+	void* LuaAllocator::allocBlock(size_t sizeClass)
+	{
+		FreeBlock* head = this->freeLists[sizeClass];
+		size_t blockSize = getClassSize(sizeClass);
+		if (head)
+		{
+			this->freeLists[sizeClass] = head->next;
+			this->pooledSize -= blockSize;
+			return head;
+		}
+
+		if (this->chunkCursor + blockSize > this->chunkEnd)
+		{
+			// the tail of the old chunk is handed to the free lists so nothing is wasted
+			// (chunks and classes are both multiples of kGranularity so the tail always fits a class)
+			if (this->chunkCursor < this->chunkEnd)
+			{
+				this->freeBlock(this->chunkCursor, getSizeClass(this->chunkEnd - this->chunkCursor));
+			}
+
+			char* chunk = reinterpret_cast<char*>(malloc(kChunkSize));
+			if (!chunk)
+			{
+				return nullptr;
+			}
+
+			this->chunks.push_back(chunk);
+			this->chunkCursor = chunk;
+			this->chunkEnd = chunk + kChunkSize;
+		}
+
+		void* block = this->chunkCursor;
+		this->chunkCursor += blockSize;
+		return block;
+	}
+
+	void LuaAllocator::freeBlock(void* ptr, size_t sizeClass)
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+		block->next = this->freeLists[sizeClass];
+		this->freeLists[sizeClass] = block;
+		this->pooledSize += getClassSize(sizeClass);
+	}
+
+	size_t LuaAllocator::takeAllocatedBytes()
+	{
+		size_t bytes = this->allocatedBytes;
+		this->allocatedBytes = 0;
+		return bytes;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "global/Values.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace cs
+{
+	// lua_Alloc implementation that tracks heap size and allocation volume for EngineStats.
+	// With pooling enabled, blocks up to kMaxPooledSize come from per-size free lists so the
+	// small tables, strings and luabind userdata churned every frame never reach malloc.
+	// Not thread safe, one allocator per lua_State.
+	class LuaAllocator
+	{
+	public:
+
+		static const size_t kGranularity = 16;
+		static const size_t kMaxPooledSize = 256;
+		static const size_t kNumSizeClasses = kMaxPooledSize / kGranularity;
+		static const size_t kChunkSize = 16 * 1024;
+
+		LuaAllocator(bool usePool = false);
+		~LuaAllocator();
+
+		// matches the lua_Alloc signature, ud is the LuaAllocator
+		static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+		size_t getHeapSize() const { return this->heapSize; }
+		size_t getPeakHeapSize() const { return this->peakHeapSize; }
+		size_t getPooledSize() const { return this->pooledSize; }
+		size_t getReservedSize() const { return this->chunks.size() * kChunkSize; }
+		bool isPooled() const { return this->usePool; }
+
+		// bytes requested since the last call, used for the per-frame allocation rate
+		size_t takeAllocatedBytes();
+
+	private:
+
+		void* reallocate(void* ptr, size_t osize, size_t nsize);
+
+		void* allocBlock(size_t sizeClass);
+		void freeBlock(void* ptr, size_t sizeClass);
+
+		static inline size_t getSizeClass(size_t sz) { return (sz + kGranularity - 1) / kGranularity - 1; }
+		static inline size_t getClassSize(size_t sizeClass) { return (sizeClass + 1) * kGranularity; }
+
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		bool usePool;
+
+		FreeBlock* freeLists[kNumSizeClasses];
+		std::vector<char*> chunks;
+		char* chunkCursor;
+		char* chunkEnd;
+
+		size_t heapSize;
+		size_t peakHeapSize;
+		size_t pooledSize;
+		size_t allocatedBytes;
+	};
+}
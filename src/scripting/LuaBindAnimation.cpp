@@ -76,5 +76,12 @@ namespace cs
 	]
 	END_DEFINE_LUA_CLASS()
 
+	BEGIN_DEFINE_LUA_CLASS(TweenEngine)
+	.scope
+	[
+		def("benchmark", &TweenEngine::benchmark)
+	]
+	END_DEFINE_LUA_CLASS()
+
 
 }
\ No newline at end of file
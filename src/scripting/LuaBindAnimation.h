@@ -21,4 +21,6 @@ namespace cs
 	PROTO_LUA_CLASS(ColorBLerpAnimator);
 	PROTO_LUA_CLASS(ColorFLerpAnimator);
 
+	PROTO_LUA_CLASS(TweenEngine);
+
 }
@@ -10,6 +10,8 @@ namespace cs
 		.def("setEmitting", &ParticleEmitter::setEmitting)
 		.def("getEmitting", &ParticleEmitter::getEmitting)
 		.def("overrideVelocity", &ParticleEmitter::overrideVelocity)
+		.def("prewarm", &ParticleEmitter::prewarm)
+		.def("isPrewarming", &ParticleEmitter::isPrewarming)
 		.scope
 		[
 			def("burst", &ParticleEmitter::burst),
@@ -21,6 +21,7 @@ namespace cs
 		.def("getDiagnostics", &FontManager::getDiagnostics)
 		.def("preload", &FontManager::preload)
 		.def("setDoubleSpace", &FontManager::setDoubleSpace)
+		.def("setSDF", &FontManager::setSDF)
 		.def("getFont", &FontManager::getFont)
 		.scope
 		[
@@ -36,5 +36,8 @@ namespace cs
 		.def("getNumActiveScenes", &Context::getNumActiveScenes)
         .def("resetUI", &Context::resetUI)
 		.def("setFinalResolveShader", &Context::setFinalResolveShader)
+		.def("setPipelineThreaded", &Context::setPipelineThreaded)
+		.def("isPipelineThreaded", &Context::isPipelineThreaded)
+		.def("getFrameReport", &Context::getFrameReport)
 	END_DEFINE_LUA_CLASS()
 }
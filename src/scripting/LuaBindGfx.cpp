@@ -227,7 +227,8 @@ namespace cs
 	BEGIN_DEFINE_LUA_CLASS_SHARED(Texture)
 		.scope
 		[
-			def("preload", &Texture::preload)
+			def("preload", &Texture::preload),
+			def("cook", &Texture::cook)
 		]
 	END_DEFINE_LUA_CLASS()
 
@@ -256,11 +257,11 @@ namespace cs
 	BEGIN_DEFINE_LUA_CLASS_SHARED(ShaderHandle)
 		.def(constructor<const std::string&>())
 		.def("getName", &ShaderHandle::getName)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const double&)) &ShaderHandle::setUniformValue<double>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec2&)) &ShaderHandle::setUniformValue<vec2>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec3&)) &ShaderHandle::setUniformValue<vec3>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec4&)) &ShaderHandle::setUniformValue<vec4>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const mat4&)) &ShaderHandle::setUniformValue<mat4>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const double&)) &ShaderHandle::setUniformValue<double>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec2&)) &ShaderHandle::setUniformValue<vec2>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec3&)) &ShaderHandle::setUniformValue<vec3>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec4&)) &ShaderHandle::setUniformValue<vec4>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const mat4&)) &ShaderHandle::setUniformValue<mat4>)
 	END_DEFINE_LUA_CLASS()
 
 	BEGIN_DEFINE_LUA_ENUM(TextureChannels)
@@ -275,6 +276,17 @@ namespace cs
 		]
 	END_DEFINE_LUA_ENUM()
 
+	BEGIN_DEFINE_LUA_ENUM(TextureCompression)
+		.enum_("constants")
+		[
+			value("None", TextureCompressionNone),
+			value("BC1", TextureCompressionBC1),
+			value("BC3", TextureCompressionBC3),
+			value("ETC2RGB", TextureCompressionETC2RGB),
+			value("ETC2RGBA", TextureCompressionETC2RGBA)
+		]
+	END_DEFINE_LUA_ENUM()
+
 	BEGIN_DEFINE_LUA_ENUM(DepthComponent)
 		.enum_("constants")
 		[
@@ -294,6 +306,11 @@ namespace cs
 	BEGIN_DEFINE_LUA_CLASS_SHARED(Mesh)
 		.def("getName", &Mesh::getName)
 		.def("getShapeByName", &Mesh::getShapeByName)
+		.scope
+		[
+			def("cookCache", &Mesh::cookCache),
+			def("benchmark", &Mesh::benchmark)
+		]
 	END_DEFINE_LUA_CLASS()
 
 	BEGIN_DEFINE_LUA_ENUM(MeshMaterialType)
@@ -316,11 +333,11 @@ namespace cs
 	END_DEFINE_LUA_CLASS()
 
 	BEGIN_DEFINE_LUA_CLASS_SHARED(SharedUniform)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const double&)) &ShaderHandle::setUniformValue<double>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec2&)) &ShaderHandle::setUniformValue<vec2>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec3&)) &ShaderHandle::setUniformValue<vec3>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const vec4&)) &ShaderHandle::setUniformValue<vec4>)
-		.def("setUniformValue", (bool(ShaderHandle::*)(const std::string&, const mat4&)) &ShaderHandle::setUniformValue<mat4>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const double&)) &ShaderHandle::setUniformValue<double>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec2&)) &ShaderHandle::setUniformValue<vec2>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec3&)) &ShaderHandle::setUniformValue<vec3>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const vec4&)) &ShaderHandle::setUniformValue<vec4>)
+		.def("setUniformValue", (bool(ShaderHandle::*)(const StringId&, const mat4&)) &ShaderHandle::setUniformValue<mat4>)
 		.scope
 		[
 			def("getInstance", &SharedUniform::getInstance)
@@ -350,5 +367,14 @@ namespace cs
 		.def("setShader", &PostProcess::setShader)
 		.def("setTint", &PostProcess::setTint)
 	END_DEFINE_LUA_CLASS()
+
+	BEGIN_DEFINE_LUA_CLASS(ShaderCache)
+		.scope
+		[
+			def("beginWarmUp", &ShaderCache::beginWarmUp),
+			def("endWarmUp", &ShaderCache::endWarmUp),
+			def("writeManifest", &ShaderCache::writeManifest)
+		]
+	END_DEFINE_LUA_CLASS()
 		
 }
@@ -10,6 +10,7 @@
 #include "gfx/SplineRenderable.h"
 #include "gfx/RenderTarget.h"
 #include "gfx/PostProcess.h"
+#include "gfx/ShaderCache.h"
 
 #include "gfx/Color.h"
 
@@ -40,6 +41,7 @@ namespace cs
 	PROTO_LUA_CLASS(RenderTraversalMask);
 	PROTO_LUA_CLASS(ShaderHandle);
 	PROTO_LUA_CLASS(TextureChannels);
+	PROTO_LUA_CLASS(TextureCompression);
 	PROTO_LUA_CLASS(DepthComponent);
 	PROTO_LUA_CLASS(MeshHandle);
 	PROTO_LUA_CLASS(Mesh);
@@ -51,4 +53,5 @@ namespace cs
 	PROTO_LUA_CLASS(RenderTexture);
 	PROTO_LUA_CLASS(RenderTargetManager);
 	PROTO_LUA_CLASS(PostProcess);
+	PROTO_LUA_CLASS(ShaderCache);
 }
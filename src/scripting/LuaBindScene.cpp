@@ -56,6 +56,7 @@ namespace cs
 		.scope
 		[
 			def("createReferenceNode", &SceneCreator::createReferenceNode),
+			def("spawnReferenceNode", &SceneCreator::spawnReferenceNode),
 			def("createSprite", &SceneCreator::createSprite),
 			def("createLight", &SceneCreator::createLight)
 		]
@@ -181,6 +182,10 @@ namespace cs
 	.def("clearReference", &SceneReferenceCache::clearReference)
 	.def("clearAllReferences", &SceneReferenceCache::clearAllReferences)
 	.def("loadReference", (bool(SceneReferenceCache::*)(const std::string&)) &SceneReferenceCache::loadReference)
+	.def("warmPool", &SceneReferenceCache::warmPool)
+	.def("releaseInstance", &SceneReferenceCache::releaseInstance)
+	.def("clearAllPools", &SceneReferenceCache::clearAllPools)
+	.def("printPoolStats", &SceneReferenceCache::printPoolStats)
 
 	.scope
 	[
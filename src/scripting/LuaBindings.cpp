@@ -22,6 +22,7 @@
 
 #include "os/LogManager.h"
 #include "global/ResourceFactory.h"
+#include "global/Profiler.h"
 
 #if defined(CS_IOS)
     #include "Platform_iOS.h"
@@ -114,6 +115,43 @@ namespace cs
 			def("preloadFromFile", &ResourceFactory::preloadFromFile),
 			def("loadResource", &LuaResourceFactory::loadResource)
 		];
+
+		struct LuaProfiler
+		{
+			static void setEnabled(bool enable)
+			{
+				Profiler::getInstance()->setEnabled(enable);
+			}
+
+			static bool isEnabled()
+			{
+				return Profiler::isEnabled();
+			}
+
+			static std::string getFrameReport()
+			{
+				return Profiler::getInstance()->getFrameReport();
+			}
+
+			static void setSpikeCapture(float32 thresholdMs, const std::string& pathPrefix)
+			{
+				Profiler::getInstance()->setSpikeCapture(thresholdMs, pathPrefix);
+			}
+
+			static bool writeChromeTrace(const std::string& path)
+			{
+				return Profiler::getInstance()->writeChromeTrace(path);
+			}
+		};
+
+		module(state, "Profiler")
+		[
+			def("setEnabled", &LuaProfiler::setEnabled),
+			def("isEnabled", &LuaProfiler::isEnabled),
+			def("getFrameReport", &LuaProfiler::getFrameReport),
+			def("setSpikeCapture", &LuaProfiler::setSpikeCapture),
+			def("writeChromeTrace", &LuaProfiler::writeChromeTrace)
+		];
         
 #if defined(CS_IOS)
         struct Lua_iOS
@@ -291,6 +329,7 @@ namespace cs
 			BIND_LUA_CLASS(RenderTraversalMask),
 			BIND_LUA_CLASS(ShaderHandle),
 			BIND_LUA_CLASS(TextureChannels),
+			BIND_LUA_CLASS(TextureCompression),
 			BIND_LUA_CLASS(DepthComponent),
 			BIND_LUA_CLASS(MeshHandle),
 			BIND_LUA_CLASS(Mesh),
@@ -302,6 +341,7 @@ namespace cs
 			BIND_LUA_CLASS(RenderTexture),
 			BIND_LUA_CLASS(RenderTargetManager),
 			BIND_LUA_CLASS(PostProcess),
+			BIND_LUA_CLASS(ShaderCache),
 
 			// PHYSICS
 			BIND_LUA_CLASS(PhysicsLiquidContactData),
@@ -390,6 +430,7 @@ namespace cs
 			BIND_LUA_CLASS(Vec3LerpAnimator),
 			BIND_LUA_CLASS(ColorBLerpAnimator),
 			BIND_LUA_CLASS(ColorFLerpAnimator),
+			BIND_LUA_CLASS(TweenEngine),
 			BIND_LUA_CLASS(AnimatedValue),
 			BIND_LUA_CLASS(AnimationSize),
 			BIND_LUA_CLASS(AnimationTextureUV),
@@ -66,6 +66,24 @@ namespace cs
 		void operator=(const LuaCallback& rhs)
 		{
 			this->func = rhs.func;
+			this->validated = false;
+		}
+
+		// the type check pushes and pops the function so only pay for it until it passes once
+		bool validate()
+		{
+			if (this->validated)
+				return true;
+
+			int32 lua_type = luabind::type(this->func);
+			if (lua_type != LUA_TFUNCTION)
+			{
+				log::print(LogError, "invalid lua object - expected function, got ", kLuaTypeStr[lua_type]);
+				return false;
+			}
+
+			this->validated = true;
+			return true;
 		}
 
 		template <typename Ret, typename ...Args>
@@ -86,10 +104,8 @@ namespace cs
 		template <typename ...Args>
 		void operator()(Args...vargs)
 		{
-			int32 lua_type = luabind::type(this->func);
-			if (lua_type != LUA_TFUNCTION)
+			if (!this->validate())
 			{
-				log::print(LogError, "invalid lua object - expected function, got ", kLuaTypeStr[lua_type]);
 				return;
 			}
 
@@ -125,10 +141,8 @@ namespace cs
 
 		virtual void invoke(CallbackRetBase* ret_base = nullptr)
 		{
-			int32 lua_type = luabind::type(this->func);
-			if (lua_type != LUA_TFUNCTION)
+			if (!this->validate())
 			{
-				log::print(LogError, "invalid lua object - expected function, got ", kLuaTypeStr[lua_type]);
 				return;
 			}
 
@@ -164,6 +178,10 @@ namespace cs
 		
 		luabind::object func;
 		std::vector<luabind::object> args;
+
+	private:
+
+		bool validated = false;
 	};
 
 	typedef std::shared_ptr<LuaCallback> LuaCallbackPtr;
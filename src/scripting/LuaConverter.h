@@ -4,6 +4,7 @@
 
 #include "global/Values.h"
 #include "global/PropertySet.h"
+#include "global/StringId.h"
 #include "scripting/LuaCallback.h"
 
 namespace cs
@@ -134,4 +135,34 @@ namespace luabind
 	struct default_converter<cs::PropertySet const&>
 		: default_converter<cs::PropertySet>
 	{};
+
+	// Scripts keep passing plain strings, they are hashed on the way in
+	template<>
+	struct default_converter<cs::StringId> : native_converter_base<cs::StringId>
+	{
+		static int compute_score(lua_State* L, int index)
+		{
+			return lua_type(L, index) == LUA_TSTRING ? 0 : -1;
+		}
+
+		cs::StringId from(lua_State* L, int index)
+		{
+			return cs::StringId(lua_tostring(L, index));
+		}
+
+		void to(lua_State* L, const cs::StringId& id)
+		{
+			lua_pushstring(L, id.c_str());
+		}
+	};
+
+	template <>
+	struct default_converter<cs::StringId const>
+		: default_converter<cs::StringId>
+	{};
+
+	template <>
+	struct default_converter<cs::StringId const&>
+		: default_converter<cs::StringId>
+	{};
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "PCH.h"
+
+#include "scripting/LuaScriptDispatcher.h"
+#include "ecs/comp/ScriptComponent.h"
+
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+
+namespace cs
+{
+	// Runs inside Lua so the per-instance cost is a plain Lua call rather than a luabind
+	// dispatch, errors are caught per instance so one bad script doesn't stop the frame
+	const char* kLuaDispatchSource =
+		"local pcall = pcall\n"
+		"local tostring = tostring\n"
+		"return function(instances, functions, count, dt, profiling, times, errors, clock)\n"
+		"    if profiling then\n"
+		"        for i = 1, count do\n"
+		"            local t = clock()\n"
+		"            local ok, err = pcall(functions[i], instances[i], dt)\n"
+		"            times[i] = times[i] + (clock() - t)\n"
+		"            if not ok then errors[#errors + 1] = tostring(err) end\n"
+		"        end\n"
+		"    else\n"
+		"        for i = 1, count do\n"
+		"            local ok, err = pcall(functions[i], instances[i], dt)\n"
+		"            if not ok then errors[#errors + 1] = tostring(err) end\n"
+		"        end\n"
+		"    end\n"
+		"end\n";
+
+	static int luaDispatchClock(lua_State* L)
+	{
+		typedef std::chrono::steady_clock Clock;
+		double seconds = std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+		lua_pushnumber(L, seconds);
+		return 1;
+	}
+
+	LuaScriptDispatcher::LuaScriptDispatcher(lua_State* L)
+		: state(L)
+		, count(0)
+		, profiling(false)
+	{
+		if (luaL_loadstring(L, kLuaDispatchSource) != 0 || lua_pcall(L, 0, 1, 0) != 0)
+		{
+			log::print(LogError, "Lua: failed to build script dispatcher - ", lua_tostring(L, -1));
+			lua_pop(L, 1);
+			return;
+		}
+
+		this->dispatcher = luabind::object(luabind::from_stack(L, -1));
+		lua_pop(L, 1);
+
+		this->instances = luabind::newtable(L);
+		this->functions = luabind::newtable(L);
+		this->times = luabind::newtable(L);
+		this->errors = luabind::newtable(L);
+
+		lua_pushcfunction(L, &luaDispatchClock);
+		this->clock = luabind::object(luabind::from_stack(L, -1));
+		lua_pop(L, 1);
+	}
+
+	LuaScriptDispatcher::~LuaScriptDispatcher()
+	{
+
+	}
+
+	bool LuaScriptDispatcher::update(const ScriptList& scripts)
+	{
+		bool changed = scripts.size() != this->entries.size();
+		for (size_t i = 0; !changed && i < scripts.size(); ++i)
+		{
+			const Entry& entry = this->entries[i];
+			changed = entry.component != scripts[i] || entry.version != scripts[i]->getInstanceVersion();
+		}
+
+		if (changed)
+		{
+			this->rebuild(scripts);
+		}
+
+		return changed;
+	}
+
+	void LuaScriptDispatcher::rebuild(const ScriptList& scripts)
+	{
+		this->instances = luabind::newtable(this->state);
+		this->functions = luabind::newtable(this->state);
+		this->times = luabind::newtable(this->state);
+
+		this->entries.clear();
+		this->names.clear();
+		this->count = 0;
+
+		for (auto& it : this->profile)
+		{
+			it.second.instances = 0;
+		}
+
+		for (auto& script : scripts)
+		{
+			Entry entry = { script, script->getInstanceVersion() };
+			this->entries.push_back(entry);
+
+			luabind::object& obj = script->getInstanceObject();
+			if (!obj.is_valid())
+				continue;
+
+			luabind::object func = obj["process"];
+			if (luabind::type(func) != LUA_TFUNCTION)
+				continue;
+
+			// a C function here is the bound ScriptComponentInstance::process default which does nothing
+			func.push(this->state);
+			bool native = lua_iscfunction(this->state, -1) != 0;
+			lua_pop(this->state, 1);
+			if (native)
+				continue;
+
+			int32 idx = int32(++this->count);
+			this->instances[idx] = obj;
+			this->functions[idx] = func;
+			this->times[idx] = 0.0;
+
+			this->names.push_back(script->getScriptName());
+			this->profile[this->names.back()].instances++;
+		}
+	}
+
+	void LuaScriptDispatcher::dispatch(float32 dt)
+	{
+		if (!this->isValid() || this->count == 0)
+			return;
+
+		try
+		{
+			luabind::call_function<void>(this->dispatcher,
+				this->instances,
+				this->functions,
+				int32(this->count),
+				dt,
+				this->profiling,
+				this->times,
+				this->errors,
+				this->clock);
+		}
+		catch (luabind::error& err)
+		{
+			checkLuaError(err.state(), -1);
+		}
+
+		this->errors.push(this->state);
+		size_t numErrors = lua_rawlen(this->state, -1);
+		lua_pop(this->state, 1);
+
+		if (numErrors > 0)
+		{
+			for (int32 i = 1; i <= int32(numErrors); ++i)
+			{
+				// scripts can error() with any value, a __tostring that doesn't return a string leaves it as is
+				luabind::object err = this->errors[i];
+				if (luabind::type(err) == LUA_TSTRING)
+					log::print(LogError, "Lua:", luabind::object_cast<std::string>(err));
+				else
+					log::print(LogError, "Lua: error object of type ", lua_typename(this->state, luabind::type(err)));
+			}
+			this->errors = luabind::newtable(this->state);
+		}
+
+		if (this->profiling)
+		{
+			this->collectTimes();
+		}
+	}
+
+	void LuaScriptDispatcher::collectTimes()
+	{
+		for (size_t i = 0; i < this->count; ++i)
+		{
+			int32 idx = int32(i + 1);
+			luabind::object value = this->times[idx];
+			double elapsed = luabind::object_cast<double>(value);
+			this->times[idx] = 0.0;
+
+			ScriptProfile& entry = this->profile[this->names[i]];
+			entry.time += elapsed;
+			entry.maxTime = std::max<double>(entry.maxTime, elapsed);
+			entry.calls++;
+		}
+	}
+
+	void LuaScriptDispatcher::setProfiling(bool enabled)
+	{
+		if (this->profiling == enabled)
+			return;
+
+		this->profiling = enabled;
+		this->resetProfile();
+	}
+
+	void LuaScriptDispatcher::resetProfile()
+	{
+		for (auto& it : this->profile)
+		{
+			uint32 instances = it.second.instances;
+			it.second = ScriptProfile();
+			it.second.instances = instances;
+		}
+	}
+
+	std::string LuaScriptDispatcher::getProfileReport() const
+	{
+		typedef std::pair<std::string, ScriptProfile> ProfileEntry;
+		std::vector<ProfileEntry> sorted(this->profile.begin(), this->profile.end());
+		std::sort(sorted.begin(), sorted.end(), [](const ProfileEntry& a, const ProfileEntry& b)
+		{
+			return a.second.time > b.second.time;
+		});
+
+		std::stringstream str;
+		str << std::fixed << std::setprecision(3);
+		for (auto& it : sorted)
+		{
+			const ScriptProfile& p = it.second;
+			double avg = (p.calls > 0) ? (p.time / p.calls) : 0.0;
+			str << it.first << ": " << p.time * 1000.0 << "ms total, "
+				<< p.instances << " instances, "
+				<< p.calls << " calls, "
+				<< avg * 1000000.0 << "us avg, "
+				<< p.maxTime * 1000000.0 << "us max" << std::endl;
+		}
+		return str.str();
+	}
+}
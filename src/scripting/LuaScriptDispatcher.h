@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ClassDef.h"
+#include "scripting/LuaState.h"
+
+#include <unordered_map>
+
+namespace cs
+{
+	class ScriptComponent;
+
+	struct ScriptProfile
+	{
+		ScriptProfile()
+			: time(0.0)
+			, maxTime(0.0)
+			, calls(0)
+			, instances(0)
+		{ }
+
+		double time;		// seconds accumulated since the last reset
+		double maxTime;		// slowest single frame for this script
+		uint32 calls;
+		uint32 instances;
+	};
+
+	// Calls every scripted instance's process(dt) from a single Lua call per frame.
+	// Instances and their resolved process functions are kept in Lua tables that are
+	// only rebuilt when the set of live scripts changes.
+	CLASS_DEFINITION(LuaScriptDispatcher)
+	public:
+
+		typedef std::vector<ScriptComponent*> ScriptList;
+		typedef std::unordered_map<std::string, ScriptProfile> ScriptProfileMap;
+
+		LuaScriptDispatcher(lua_State* L);
+		~LuaScriptDispatcher();
+
+		bool isValid() const { return this->dispatcher.is_valid(); }
+		lua_State* getState() const { return this->state; }
+
+		// returns true if the packed tables had to be rebuilt
+		bool update(const ScriptList& scripts);
+		void dispatch(float32 dt);
+
+		void setProfiling(bool enabled);
+		bool isProfiling() const { return this->profiling; }
+		void resetProfile();
+
+		const ScriptProfileMap& getProfile() const { return this->profile; }
+		std::string getProfileReport() const;
+
+		size_t getNumDispatched() const { return this->count; }
+
+	private:
+
+		void rebuild(const ScriptList& scripts);
+		void collectTimes();
+
+		struct Entry
+		{
+			ScriptComponent* component;
+			uint32 version;
+		};
+
+		lua_State* state;
+		luabind::object dispatcher;
+		luabind::object instances;
+		luabind::object functions;
+		luabind::object times;
+		luabind::object errors;
+		luabind::object clock;
+
+		std::vector<Entry> entries;
+		std::vector<std::string> names;
+		size_t count;
+
+		bool profiling;
+		ScriptProfileMap profile;
+	};
+}
@@ -4,6 +4,11 @@
 #include "scripting/LuaBindings.h"
 #include "os/LogManager.h"
 #include "os/FileManager.h"
+#include "global/Timer.h"
+#include "global/Stats.h"
+#include "global/Profiler.h"
+
+#include <algorithm>
 
 namespace cs
 {
@@ -35,6 +40,17 @@ namespace cs
 		return true;
 	}
 
+	// If the heap has grown past this multiple of the size left after the last full cycle
+	// the frame's budget is scaled up so collection catches up with allocation
+	const float32 kLuaGCCatchupRatio = 2.0f;
+	const float32 kLuaGCMaxBudgetScale = 4.0f;
+
+	static int luaPanic(lua_State* L)
+	{
+		log::print(LogError, "Lua: unprotected error - ", lua_tostring(L, -1));
+		return 0;
+	}
+
 	int setLuaPath(lua_State* L, const char* path)
 	{
 		lua_getglobal(L, "package");
@@ -61,8 +77,13 @@ namespace cs
 	}
 
 	LuaState::LuaState(const std::string& luaAbsolutePath, const LuaGlobals& globals, LuaStateParams params)
+		: allocator(params.usePooledAllocator)
+		, params(params)
+		, gcCycles(0)
+		, gcBaseline(0)
 	{
-		this->state = luaL_newstate();
+		this->state = lua_newstate(&LuaAllocator::alloc, &this->allocator);
+		lua_atpanic(this->state, &luaPanic);
 
 		luaL_requiref(this->state,"io", luaopen_io, 1); // provides io.*
 		luaL_requiref(this->state, "base", luaopen_base, 1);
@@ -93,6 +114,51 @@ namespace cs
 		}
 
 		// luaopen_loadlib(this->state);
+
+		if (this->params.gcStepBudget > 0.0f)
+		{
+			// start from a clean heap and take over pacing from here on
+			lua_gc(this->state, LUA_GCCOLLECT, 0);
+			lua_gc(this->state, LUA_GCSTOP, 0);
+			this->gcBaseline = this->allocator.getHeapSize();
+		}
+	}
+
+	void LuaState::update()
+	{
+		if (this->params.gcStepBudget > 0.0f)
+		{
+			PROFILE_SCOPE("Lua GC");
+			float32 budget = this->params.gcStepBudget / 1000.0f;
+			size_t heapSize = this->allocator.getHeapSize();
+			if (this->gcBaseline > 0 && heapSize > size_t(this->gcBaseline * kLuaGCCatchupRatio))
+			{
+				float32 scale = float32(heapSize) / (this->gcBaseline * kLuaGCCatchupRatio);
+				budget *= std::min<float32>(scale, kLuaGCMaxBudgetScale);
+			}
+
+			HighPrecisionTimer timer;
+			do
+			{
+				// returns 1 when the step finished a cycle
+				if (lua_gc(this->state, LUA_GCSTEP, this->params.gcStepSize))
+				{
+					++this->gcCycles;
+					this->gcBaseline = this->allocator.getHeapSize();
+					break;
+				}
+			} while (timer.getElapsed() < budget);
+		}
+
+		EngineStats::setStat(StatTypeLuaHeapSize, int32(this->allocator.getHeapSize()));
+		EngineStats::setStat(StatTypeLuaAllocRate, int32(this->allocator.takeAllocatedBytes()));
+	}
+
+	void LuaState::collectGarbage()
+	{
+		lua_gc(this->state, LUA_GCCOLLECT, 0);
+		++this->gcCycles;
+		this->gcBaseline = this->allocator.getHeapSize();
 	}
 
 	LuaState::~LuaState()
@@ -11,6 +11,7 @@ extern "C"
 
 #include "scripting/LuaScript.h"
 #include "scripting/LuaBindings.h"
+#include "scripting/LuaAllocator.h"
 
 #define _LIBCPP_ENABLE_CXX17_REMOVED_AUTO_PTR
 
@@ -58,13 +59,30 @@ namespace cs
 	struct LuaStateParams
 	{
 		LuaStateParams()
-			: isEditor(false) { }
+			: isEditor(false)
+			, batchScriptDispatch(false)
+			, profileScripts(false)
+			, gcStepBudget(0.0f)
+			, gcStepSize(4)
+			, usePooledAllocator(false) { }
 
 		std::string entryPoint;
 		std::string path;
 
 		bool isEditor;
 
+		// ScriptSystem calls every instance's process from one Lua call per frame
+		bool batchScriptDispatch;
+		// per-script CPU time, batched dispatch only
+		bool profileScripts;
+
+		// milliseconds per frame spent in incremental collection, 0 leaves Lua's automatic GC running
+		float32 gcStepBudget;
+		// kilobytes of work per lua_gc step inside the budget
+		int32 gcStepSize;
+		// small-object free lists in front of malloc for the Lua heap
+		bool usePooledAllocator;
+
 		LuaBindInitFunctions initFuncs;
 	};
 
@@ -92,6 +110,15 @@ namespace cs
 		
 		void checkError();
 
+		const LuaStateParams& getParams() const { return this->params; }
+
+		// once per frame, runs budgeted GC steps and publishes heap stats
+		void update();
+		void collectGarbage();
+
+		const LuaAllocator& getAllocator() const { return this->allocator; }
+		uint32 getNumGCCycles() const { return this->gcCycles; }
+
 		template <typename... Args>
 		bool callFunction(const std::string funcName, Args...args)
 		{
@@ -125,7 +152,14 @@ namespace cs
 
 		friend class LuaScript;
 
+		// declared before state so it outlives lua_close
+		LuaAllocator allocator;
+
 		lua_State* state;
+		LuaStateParams params;
+
+		uint32 gcCycles;
+		size_t gcBaseline;
 
 		typedef std::unordered_map<std::string, LuaScriptPtr> LuaScriptMap;
 		LuaScriptMap scripts;
@@ -7,6 +7,7 @@
 #include "ui/widget/UIWidget.h"
 
 #include <cassert>
+#include <algorithm>
 
 namespace cs
 {
@@ -16,6 +17,7 @@ namespace cs
 		assert(this->members.find(member->getName()) == this->members.end());
 		member->setIndex(this->members.size());
 		this->members[member->getName()] = member;
+		this->resetCopyPlan();
 	}
 
 	void MetaData::copyData(void* dest, const void* src) const
@@ -80,6 +82,131 @@ namespace cs
 		this->cpFunc = fn;
 	}
 
+	void MetaData::setCopyMembers()
+	{
+		CopyFunc fn = std::bind(&MetaData::copyMembers, this, std::placeholders::_1, std::placeholders::_2);
+		this->setCopy(fn);
+		this->memberCopy = true;
+	}
+
+	const MetaCopyPlan& MetaData::getCopyPlan() const
+	{
+		if (!this->copyPlan)
+		{
+			MetaCopyPlanPtr plan = std::make_shared<MetaCopyPlan>();
+			this->buildCopyPlan(*plan, 0);
+
+			// adjacent and overlapping spans collapse into one memcpy
+			std::sort(plan->spans.begin(), plan->spans.end(), [](const MetaCopyPlan::Span& a, const MetaCopyPlan::Span& b)
+			{
+				return a.offset < b.offset;
+			});
+
+			std::vector<MetaCopyPlan::Span> merged;
+			for (auto& span : plan->spans)
+			{
+				if (merged.size() > 0 && span.offset <= merged.back().offset + merged.back().size)
+				{
+					MetaCopyPlan::Span& last = merged.back();
+					last.size = std::max<size_t>(last.size, span.offset + span.size - last.offset);
+					continue;
+				}
+				merged.push_back(span);
+			}
+			plan->spans.swap(merged);
+
+			this->copyPlan = plan;
+		}
+		return *this->copyPlan;
+	}
+
+	void MetaData::buildCopyPlan(MetaCopyPlan& plan, size_t base) const
+	{
+		static const MetaData* kStringMeta = MetaCreator<std::string>::get();
+
+		MemberList members;
+		this->getAllMembers(members);
+
+		for (auto& member : members)
+		{
+			size_t offset = base + member->getOffset();
+			const MetaData* member_metadata = member->getMetaData();
+
+			if (member->getIsPointer())
+			{
+				if (member->getIsResource())
+					plan.resources.push_back(offset);
+				else
+					plan.pointers.push_back(offset);
+			}
+			else if (member->getIsString() || member_metadata == kStringMeta)
+			{
+				plan.strings.push_back(offset);
+			}
+			else if (member_metadata->isTrivialCopy())
+			{
+				MetaCopyPlan::Span span = { offset, size_t(member_metadata->getSize()) };
+				plan.spans.push_back(span);
+			}
+			else if (member_metadata->isCopyMembers())
+			{
+				// reflected structs held by value are inlined into this plan
+				member_metadata->buildCopyPlan(plan, offset);
+			}
+			else if (member_metadata->cpFunc)
+			{
+				MetaCopyPlan::Call call = { offset, member_metadata };
+				plan.calls.push_back(call);
+			}
+		}
+	}
+
+	void MetaData::copyMembers(void* dst, void* src) const
+	{
+		const MetaCopyPlan& plan = this->getCopyPlan();
+
+		for (auto& span : plan.spans)
+		{
+			memcpy(PTR_ADD(dst, span.offset), PTR_ADD(src, span.offset), span.size);
+		}
+
+		for (auto& offset : plan.strings)
+		{
+			*reinterpret_cast<std::string*>(PTR_ADD(dst, offset)) = *reinterpret_cast<std::string*>(PTR_ADD(src, offset));
+		}
+
+		for (auto& offset : plan.resources)
+		{
+			std::shared_ptr<Serializable>* src_ptr = reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(src, offset));
+			if ((*src_ptr).get())
+			{
+				*reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(dst, offset)) = *src_ptr;
+			}
+		}
+
+		for (auto& offset : plan.pointers)
+		{
+			std::shared_ptr<Serializable>* src_ptr = reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(src, offset));
+			std::shared_ptr<Serializable>* dst_ptr = reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(dst, offset));
+
+			// dst_ptr is guaranteed to be valid - src_ptr not so much
+			if (!(*src_ptr).get())
+				continue;
+
+			// pointers are copied by the contents of the shared_ptr (since they are infact two distinct objects)
+			const MetaData* src_meta = (*src_ptr)->getMetaData();
+			(*dst_ptr) = std::shared_ptr<Serializable>(reinterpret_cast<Serializable*>(src_meta->createNew()));
+			src_meta->copy((void*)dst_ptr->get(), (void*)src_ptr->get());
+			CopyLog("Copying new ", src_meta->getName(), " at offset ", offset);
+		}
+
+		for (auto& call : plan.calls)
+		{
+			call.meta->copy(PTR_ADD(dst, call.offset), PTR_ADD(src, call.offset));
+			CopyLog("Copying member of type [", call.meta->getName(), "]");
+		}
+	}
+
 	void MetaData::setDeserializeNew(deserializeNewFunc func)
 	{
 		DeserializeNewFunc fn = std::bind(func, std::placeholders::_1, std::placeholders::_2);
@@ -17,6 +17,7 @@
 #include <functional>
 #include <unordered_map>
 #include <typeindex>
+#include <memory>
 
 // #define LOG_COPY_OP 1
 
@@ -72,6 +73,32 @@ namespace cs
 		FunctionPtr ptr;
 	};
 
+	// Flattened copy of a reflected class, built once per type from its member list.
+	// Runs of trivially copyable members (including those of nested reflected structs)
+	// are merged into single memcpy spans, everything else is grouped by how it copies.
+	struct MetaCopyPlan
+	{
+		struct Span
+		{
+			size_t offset;
+			size_t size;
+		};
+
+		struct Call
+		{
+			size_t offset;
+			const MetaData* meta;
+		};
+
+		std::vector<Span> spans;
+		std::vector<size_t> strings;
+		std::vector<size_t> resources;	// shared_ptr assigned
+		std::vector<size_t> pointers;	// cloned through the source object's metadata
+		std::vector<Call> calls;		// containers and anything else with its own copy function
+	};
+
+	typedef std::shared_ptr<MetaCopyPlan> MetaCopyPlanPtr;
+
 	class MetaData
 	{
 		
@@ -104,6 +131,8 @@ namespace cs
 			, type_index(typeid(Dummy))
 			, derived(nullptr)
 			, ignoreDerived(false)
+			, trivialCopy(false)
+			, memberCopy(false)
 		{ 
 		}
 
@@ -120,6 +149,8 @@ namespace cs
 			, type_index(typeid(Dummy))
 			, derived(nullptr)
 			, ignoreDerived(nullptr)
+			, trivialCopy(false)
+			, memberCopy(false)
 		{ 
 		}
 
@@ -164,6 +195,17 @@ namespace cs
 		void setCopy(CopyFunc& fn);
 		void setCopy(copyFunc func = nullptr);
 
+		// copy is a plain memcpy of getSize() bytes
+		void setTrivialCopy(bool trivial) { this->trivialCopy = trivial; }
+		bool isTrivialCopy() const { return this->trivialCopy; }
+
+		// copy walks the reflected members through a cached MetaCopyPlan
+		void setCopyMembers();
+		bool isCopyMembers() const { return this->memberCopy; }
+		void copyMembers(void* dest, void* src) const;
+		const MetaCopyPlan& getCopyPlan() const;
+		void resetCopyPlan() { this->copyPlan.reset(); }
+
 		uchar* createNew() const;
 		std::shared_ptr<Resource> createFromString(const std::string& name) const;
 
@@ -202,10 +244,12 @@ namespace cs
 		bool isOverrideSet(const std::string& member_name, Member::MemberFlags flag, void* vptr = nullptr) const;
 		bool isOverrideSet(const Member* member, Member::MemberFlags flag, void* vptr = nullptr) const;
 
-		void setIgnoreDerived() { this->ignoreDerived = true; }
+		void setIgnoreDerived() { this->ignoreDerived = true; this->resetCopyPlan(); }
 
 	private:
 
+		void buildCopyPlan(MetaCopyPlan& plan, size_t base) const;
+
 		bool initialized;
 
 		SerializeFunc serialFunc;
@@ -229,6 +273,11 @@ namespace cs
 		MetaData* derived;
 		bool ignoreDerived;
 
+		bool trivialCopy;
+		bool memberCopy;
+		// built on first copy, registration has finished by then
+		mutable MetaCopyPlanPtr copyPlan;
+
 		MetaFunctions metaFunctions;
 	};
 
@@ -326,55 +375,7 @@ namespace cs
 	template <class T>
 	void copyMembers(void* dst, void* src)
 	{
-		
-		const MetaData* metadata = MetaCreator<T>::get();
-		MetaData::MemberList members;
-		metadata->getAllMembers(members);
-
-		for (auto& it : members)
-		{
-			const Member* member = it;
-			size_t offset = member->getOffset();
-			const MetaData* member_metadata = member->getMetaData();
-			
-			if (member->getIsPointer())
-			{
-				std::shared_ptr<Serializable>* src_ptr = reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(src, offset));
-				std::shared_ptr<Serializable>* dst_ptr = reinterpret_cast<std::shared_ptr<Serializable>*>(PTR_ADD(dst, offset));
-				
-				// dst_ptr is guaranteed to be valid - src_ptr not so much
-				if (!(*src_ptr).get())
-					continue;
-				const MetaData* src_meta = (*src_ptr)->getMetaData();
-
-				(*dst_ptr) = std::shared_ptr<Serializable>(reinterpret_cast<Serializable*>(src_meta->createNew()));
-				if (member->getIsResource())
-				{
-					// resources can be shared_ptr assigned
-					// src_meta->copy((void*)dst_ptr, (void*)src_ptr);
-
-					*dst_ptr = *src_ptr;
-				}
-				else
-				{
-					// pointers can be copied by the contents of the shared_ptr (since they are infact two distinct objects)
-					src_meta->copy((void*)dst_ptr->get(), (void*)src_ptr->get());
-					CopyLog("Copying ", member->getName(), " with new ", src_meta->getName(), " member of type[", member_metadata->getName(), "]");
-				}
-				
-			}
-			else if (member->getIsString())
-			{
-				std::string* str_dst = (std::string*) PTR_ADD(dst, offset);
-				std::string* str_src = (std::string*) PTR_ADD(src, offset);
-				*str_dst = *str_src;
-			}
-			else
-			{
-				member_metadata->copy(PTR_ADD(dst, offset), PTR_ADD(src, offset));
-				CopyLog("Copying ", member->getName(), " member of type [", member_metadata->getName(), "]");
-			}
-		}
+		MetaCreator<T>::get()->copyMembers(dst, src);
 	}
 
 	template <class K, class V>
@@ -8,6 +8,7 @@
 #include <string>
 #include <typeindex>
 #include <typeinfo>
+#include <type_traits>
 
 #define TEXT_SERIALIZATION_TYPE text
 
@@ -106,7 +107,7 @@ class MetaData;
 		meta->setSerialize(TEXT_SERIALIZATION_TYPE::serializeMembers); \
 		meta->setDeserialize(TEXT_SERIALIZATION_TYPE::deserializeMembers); \
 		meta->setDeserializeNew(TEXT_SERIALIZATION_TYPE::deserializeMembersNew<RemQual<type_name>::type>); \
-		meta->setCopy(copyMembers<RemQual<type_name>::type>); \
+		meta->setCopyMembers(); \
 		MemberTyped<type_name>* memberPtr = nullptr;
 
 #define BEGIN_META_RESOURCE(type_name) \
@@ -133,6 +134,7 @@ class MetaData;
 		meta->setSerialize(TEXT_SERIALIZATION_TYPE::serializePrim<RemQual<type_name>::type>); \
 		meta->setDeserialize(TEXT_SERIALIZATION_TYPE::deserializePrim<RemQual<type_name>::type>); \
 		meta->setCopy(copyPrimitive<RemQual<type_name>::type>); \
+		meta->setTrivialCopy(std::is_trivially_copyable<RemQual<type_name>::type>::value); \
 	}
 
 #define DEFINE_META_PRIMITIVE_ENUM(type_name, string_values) \
@@ -6,6 +6,8 @@ namespace cs
 {
 	void UIAnimationPlayer::process(float32 dt)
 	{
+		// every lerp playing on this document in one pass, the instances below read the results
+		this->tweens.process(dt);
 
 		std::vector<uintptr_t> keysToDelete;
 		for (auto& it : this->animList)
@@ -76,6 +76,7 @@ namespace cs
 			}
 
 			assert(track != UIAnimationPlayerTrackNone);
+			anim_instance_ptr->bindTweens(&this->tweens);
 			(*it).second.animations[track].instances.push_back(anim_instance_ptr);
 		}
 
@@ -150,6 +151,8 @@ namespace cs
 
 		void addOnEndCallback(UIElementPtr& element, LuaCallbackPtr& callback);
 
+		// declared ahead of the list so it outlives the instances bound to it
+		TweenEngine tweens;
 		AnimList animList;
 	};
 }
@@ -10,9 +10,13 @@
 
 namespace cs
 {
+	const StringId kMVPUniform("mvp");
+	const StringId kElementsScope("elements");
+	const StringId kFxScope("fx");
 
 	UIDocument::UIDocument(const std::string& name)
 		: documentName(name)
+		, documentId(name)
 		, sortOrder(0)
 		, locked(false)
 		, pendingRemoval(false)
@@ -24,6 +28,9 @@ namespace cs
 		this->root->setVertexColor(ColorB::Clear);
 		this->root->setEnabled(true);
 
+		for (int32 i = 0; i < UIBatchPassMAX; ++i)
+			this->captured[i] = false;
+
 		EngineStats::incrementStat(StatTypeUIDocument);
 	}
 
@@ -86,10 +93,13 @@ namespace cs
 	void UIDocument::draw(const RectI& screen_rect, UIBatchPass pass)
 	{
         RenderInterface* rend = RenderInterface::getInstance();
-        rend->pushDebugScope(this->getName());
+        rend->pushDebugScope(this->getNameId());
         
-		// Update VB (double buffered)
-		this->batch[pass]->update(); 
+		// Update VB (double buffered), already done if this pass was captured
+		bool wasCaptured = this->captured[pass];
+		this->captured[pass] = false;
+		if (!wasCaptured)
+			this->batch[pass]->update(); 
 
 		mat4 projection = glm::ortho(
 			float32(screen_rect.pos.x), float32(screen_rect.pos.x + screen_rect.size.w),
@@ -98,22 +108,36 @@ namespace cs
 
 		mat4 mvp = projection;
 
-		cs::UniformPtr matrix = SharedUniform::getInstance().getUniform("mvp");
+		cs::UniformPtr matrix = SharedUniform::getInstance().getUniform(kMVPUniform);
 		assert(matrix);
 		matrix->setValue(mvp);
 
-        rend->pushDebugScope("elements");
+        rend->pushDebugScope(kElementsScope);
 		this->batch[pass]->draw();
         rend->popDebugScope();
         
-        rend->pushDebugScope("fx");
-		fx.draw();
+        rend->pushDebugScope(kFxScope);
+		if (wasCaptured)
+			fx.drawCaptured();
+		else
+			fx.draw();
         rend->popDebugScope();
         
         rend->popDebugScope();
         
 	}
 
+	void UIDocument::capture(UIBatchPass pass)
+	{
+		this->batch[pass]->update();
+		this->batch[pass]->freezeDraws();
+
+		if (pass == UIBatchPassMain)
+			this->fx.capture();
+
+		this->captured[pass] = true;
+	}
+
 	void UIDocument::process(float32 dt, float32& depth, RectI& screenSize, UIBatchPass pass)
 	{
 
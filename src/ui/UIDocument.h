@@ -25,12 +25,17 @@ namespace cs
 		virtual void populate() { }
 
 		virtual void draw(const RectI& screen_rect, UIBatchPass pass = UIBatchPassMain);
+
+		// Uploads the batch and fixes what the next draw of pass issues, capture the main pass first
+		virtual void capture(UIBatchPass pass = UIBatchPassMain);
+
 		virtual void process(float32 dt, float32& depth, RectI& screenSize, UIBatchPass pass = UIBatchPassMain);
 		virtual void luaProcess(float32 dt) { }
 
 		UIElementPtr& getRoot() { return this->root; }
 
 		const std::string& getName() const { return this->documentName; }
+		const StringId& getNameId() const { return this->documentId; }
 
 		size_t updateVertices(uchar* data, size_t bufferSize, VertexDeclaration& decl);
 		size_t updateIndices(uchar* data, size_t bufferSize);
@@ -79,6 +84,7 @@ namespace cs
 		void onStartRendering();
 		
 		std::string documentName;
+		StringId documentId;
 
 		const static uint32 kInitNumElements = 1000;
 		friend class UIDocumentCache;
@@ -86,6 +92,7 @@ namespace cs
 		int32 sortOrder;
 		UIElementPtr root;
 		BatchDrawPtr batch[UIBatchPassMAX];
+		bool captured[UIBatchPassMAX];
 		bool locked;
 		bool pendingRemoval;
 		bool animMode;
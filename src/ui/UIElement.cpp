@@ -14,6 +14,7 @@ namespace cs
 	UIElement::UIElement(const std::string& n)
 		: parent(nullptr)
 		, name(n)
+		, nameId(n)
 		, visible(true)
 		, enabled(true)
 		, shouldClose(false)
@@ -495,7 +496,7 @@ namespace cs
 
 					display_list.push_back(BatchDrawParams(this->drawData, numVertices));
 					BatchDrawParams& params = display_list.back();
-					params.tag = this->getName();
+					params.tag = this->getNameId();
 					params.bounds = this->screen_rect;
 					params.transform = glm::translate(vec3(0.0f, 0.0f, adj_depth));
 					params.tint = tint;
@@ -153,6 +153,7 @@ namespace cs
 		virtual ShaderHandlePtr& getShader();
 
 		const std::string& getName() const { return this->name; }
+		const StringId& getNameId() const { return this->nameId; }
 		const UIElementFlags& getFlags() { return this->flags; }
 		void setFlag(UIElementFlag flag);
 		void unsetFlag(UIElementFlag flag);
@@ -438,7 +439,7 @@ namespace cs
 		void setPostCallback(DrawCall::PostDraw callback) { this->postCallback = callback; }
 
 		template <class T>
-		void setUniformValue(std::string name, T value)
+		void setUniformValue(StringId name, T value)
 		{
 			if (this->shader)
 			{
@@ -504,6 +505,7 @@ namespace cs
 
 		UIElement* parent;
 		std::string name;
+		StringId nameId;
 		bool visible;
 		bool enabled;
 		bool shouldClose;
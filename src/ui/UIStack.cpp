@@ -5,6 +5,8 @@
 
 namespace cs
 {
+	const StringId kViewportUniform("viewport");
+
 	UIStack::~UIStack()
 	{
 		this->popAllDocuments();
@@ -12,9 +14,20 @@ namespace cs
 
 	void UIStack::draw(const RectI& screenSize, UIBatchPass pass)
 	{
-        UniformPtr viewportValue = SharedUniform::getInstance().getUniform("viewport");
+        UniformPtr viewportValue = SharedUniform::getInstance().getUniform(kViewportUniform);
         viewportValue->setValue(vec2((float32) screenSize.size.w, (float32) screenSize.size.h));
         
+		if (this->capturedMask.test(pass))
+		{
+			for (auto& it : this->captured[pass])
+			{
+				it->draw(screenSize, pass);
+			}
+			this->captured[pass].clear();
+			this->capturedMask.unset(pass);
+			return;
+		}
+
 		RenderInterface* render_interface = RenderInterface::getInstance();
 		for (auto it : this->sortedStack)
 		{
@@ -30,6 +43,30 @@ namespace cs
 		}
 	}
 
+	void UIStack::capture(UIBatchPass pass)
+	{
+		UIDocumentList& docs = this->captured[pass];
+		docs.clear();
+		for (auto it : this->sortedStack)
+		{
+			if (it->getPendingRemove())
+				continue;
+
+			docs.push_back(it);
+		}
+
+		if (this->isOverlay && this->overlay)
+		{
+			docs.push_back(this->overlay);
+		}
+
+		for (auto& it : docs)
+		{
+			it->capture(pass);
+		}
+		this->capturedMask.set(pass);
+	}
+
 	void UIStack::updateStack()
 	{
 		if (this->toRemove.size() > 0)
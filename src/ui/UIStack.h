@@ -43,6 +43,9 @@ namespace cs
 		void draw(const RectI& screenSize, UIBatchPass pass = UIBatchPassMain);
 		void process(float32 dt, RectI& screenSize);
 
+		// Fixes the documents (and what each draws) for the next draw of pass, see UIDocument::capture
+		void capture(UIBatchPass pass = UIBatchPassMain);
+
 		bool onCursor(ClickInput input, ClickParams& params);
 		void onCursorMove(const vec2& pos);
 
@@ -74,6 +77,9 @@ namespace cs
 
 		UIBatchPassMask passMask;
 
+		UIBatchPassMask capturedMask;
+		UIDocumentList captured[UIBatchPassMAX];
+
 		UIDocumentPtr overlay;
         bool isOverlay;
 
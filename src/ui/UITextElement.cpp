@@ -6,6 +6,7 @@
 namespace cs
 {
 	const std::string kDefaultFontName = "FreeSansBold.ttf";
+	const StringId kSmoothingUniform("smoothing");
 	static std::string gDebugTextBreakHere = "break_here";
 
     namespace UITextElementUtils
@@ -41,6 +42,9 @@ namespace cs
 		, textAngle(0.0f)
 		, textWrap(false)
 		, forceTextDirty(false)
+		, fontModeVersion(0)
+		, textTag(name + "_text")
+		, shadowTag(name + "_text_shadow")
 	{
 		this->init();
 	}
@@ -64,6 +68,9 @@ namespace cs
 		, textAngle(0.0f)
 		, textWrap(false)
 		, forceTextDirty(false)
+		, fontModeVersion(0)
+		, textTag(name + "_text")
+		, shadowTag(name + "_text_shadow")
 	{
 		this->init();
 	}
@@ -252,6 +259,7 @@ namespace cs
 			UITextElement::populateDrawData(this->textVerts.lines, this->textEntry.drawData, this->fontColor);
 		}
 
+		this->refreshSDFSmoothing(this->fontShader);
 		this->textEntry.drawData->shader = this->fontShader;
 		this->textEntry.drawData->texture[0] = font->getTexture(this->getScaledFontSize());
         //this->textEntry.drawData->texture[0] = RenderInterface::kDefaultTexture;
@@ -307,6 +315,7 @@ namespace cs
 				char_offset += uint16(verts.size());
 			}
 
+			this->refreshSDFSmoothing(this->fontShadowShader);
 			shadow.entry.drawData->shader = this->fontShadowShader;
 			shadow.entry.drawData->texture[0] = font->getTexture(this->getScaledFontSize());
 			shadow.entry.drawData->drawType = DrawTriangles;
@@ -351,6 +360,13 @@ namespace cs
 		if (this->text.length() < 0)
 			return;
 
+		// the font switched between bitmap and SDF since the text was laid out
+		if (this->font->getModeVersion() != this->fontModeVersion)
+		{
+			this->refreshFontShaders();
+			this->setTextDirty();
+		}
+
 		RectF bounds = this->getScreenRect(data.bounds);
 		if (this->textDirty || this->forceTextDirty)
 		{
@@ -358,21 +374,21 @@ namespace cs
 			this->refreshShadowVertices();
 		}
 
-		std::vector<std::pair<std::string, BatchDrawDataPtr>> drawInstances;
+		std::vector<std::pair<StringId, BatchDrawDataPtr>> drawInstances;
 		if (this->shadowList.size() > 0)
 		{
 			for (auto it : this->shadowList)
 			{
 				if (it.entry.tint.a > 0)
 				{
-					drawInstances.push_back({ this->getName() + "_text_shadow", it.entry.drawData });
+					drawInstances.push_back({ this->shadowTag, it.entry.drawData });
 				}
 			}
 		}
 
 		if (this->textEntry.tint.a > 0)
 		{
-			drawInstances.push_back({ this->getName() + "_text", this->textEntry.drawData });
+			drawInstances.push_back({ this->textTag, this->textEntry.drawData });
 		}
 
 		PointF pos_offset = bounds.pos;
@@ -415,6 +431,40 @@ namespace cs
 	{
 		this->textPassMask.set(UIBatchPassMain);
 		this->font = FontManager::getInstance()->getFont(kDefaultFontName);
+		this->refreshFontShaders();
+	}
+
+	void UITextElement::refreshFontShaders()
+	{
+		if (!this->font.get() || !RenderInterface::kDefaultFontShader || !RenderInterface::kDefaultFontSDFShader)
+			return;
+
+		this->fontModeVersion = this->font->getModeVersion();
+
+		// only swap the stock shaders, anything set through setFontShader is left alone
+		ShaderHandlePtr& from = (this->font->isSDF()) ? RenderInterface::kDefaultFontShader : RenderInterface::kDefaultFontSDFShader;
+		ShaderHandlePtr& to = (this->font->isSDF()) ? RenderInterface::kDefaultFontSDFShader : RenderInterface::kDefaultFontShader;
+
+		if (this->fontShader.get() && this->fontShader->getShader() == from->getShader())
+		{
+			this->fontShader = CREATE_CLASS(ShaderHandle, to);
+		}
+
+		if (this->fontShadowShader.get() && this->fontShadowShader->getShader() == from->getShader())
+		{
+			this->fontShadowShader = CREATE_CLASS(ShaderHandle, to);
+		}
+	}
+
+	void UITextElement::refreshSDFSmoothing(ShaderHandlePtr& shader)
+	{
+		if (!this->font->isSDF() || !RenderInterface::kDefaultFontSDFShader || shader->getShader() != RenderInterface::kDefaultFontSDFShader->getShader())
+			return;
+
+		// roughly half a screen pixel of the distance field's 0..1 range at the drawn size
+		float32 drawSize = std::max<float32>(1.0f, float32(this->getScaledFontSize()) * this->textScale);
+		float32 smoothing = (0.25f * Font::kSDFReferenceSize) / (Font::kSDFSpread * drawSize);
+		shader->setUniformValue<float32>(kSmoothingUniform, clamp<float32>(0.01f, 0.5f, smoothing));
 	}
 
 	void UITextElement::setText(const std::string& txt) 
@@ -474,6 +524,7 @@ namespace cs
 		if (!this->font.get() || this->font.get() != ft.get())
 		{
 			this->font = ft;
+			this->refreshFontShaders();
 			this->setTextDirty();
 		}
 	}
@@ -553,6 +604,7 @@ namespace cs
 		else
 		{
 			this->fontShader = CREATE_CLASS(ShaderHandle, RenderInterface::kDefaultFontShader);
+			this->refreshFontShaders();
 		}
 	}
 
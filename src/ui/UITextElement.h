@@ -135,6 +135,8 @@ namespace cs
 	private:
 
 		void setTextDirty();
+		void refreshFontShaders();
+		void refreshSDFSmoothing(ShaderHandlePtr& shader);
 
 		typedef std::vector<TextShadow> TextShadowList;
 		TextShadowList shadowList;
@@ -144,6 +146,10 @@ namespace cs
 		TextEntry textEntry;
 		bool textDirty;
 		bool forceTextDirty;
+		uint32 fontModeVersion;
+
+		StringId textTag;
+		StringId shadowTag;
 
 	};
 }
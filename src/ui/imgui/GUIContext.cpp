@@ -9,6 +9,8 @@
 
 namespace cs
 {
+	const StringId kMVPUniform("mvp");
+
 	Dimensions GUIContext::guiDimm;
 	
 	TextureResourcePtr GUIContext::guiFontAtlas = nullptr;
@@ -164,7 +166,7 @@ namespace cs
 
 		mat4 mvp = projection;
 
-		cs::UniformPtr matrix = SharedUniform::getInstance().getUniform("mvp");
+		cs::UniformPtr matrix = SharedUniform::getInstance().getUniform(kMVPUniform);
 		assert(matrix);
 		matrix->setValue(mvp);
 
@@ -165,6 +165,9 @@ namespace cs
 		
 		DEFINE_META_GUI_SERIALIZABLE(ParticleModuleValueColor);
 		DEFINE_META_GUI_SERIALIZABLE(ParticleModuleValueColorLerp);
+		DEFINE_META_GUI_SERIALIZABLE(ParticleKeyFrameValueColor);
+		DEFINE_META_GUI_SERIALIZABLE_VECTOR(ParticleKeyFrameColorList);
+		DEFINE_META_GUI_SERIALIZABLE(ParticleModuleValueColorKeyFrame);
 	
 
 		DEFINE_META_GUI_SERIALIZABLE(ParticleModuleValueVelocity);
@@ -23,6 +23,9 @@ namespace cs
 {
 	const static int32 kFloatPrecision = 4;
 
+	const static StringId kSelectedDirtyNotification("onSelectedDirty");
+	const static StringId kSceneDirtyNotification("onSceneDirty");
+
 	template <>
 	ColorF GUIValueColor<float32>::toVecColorF(Color<ColorChannel<float32>>* value)
 	{
@@ -86,7 +89,7 @@ namespace cs
 
 	bool GUIValue::onUpdate()
 	{
-		NotificationCenter::getInstance()->triggerNotification("onSelectedDirty");
+		NotificationCenter::getInstance()->postNotification(kSelectedDirtyNotification);
 		return this->callCallbacks(Member::MemberCallbackPost);
 	}
 
@@ -286,7 +289,7 @@ namespace cs
 
 				this->onUpdate();
 
-				NotificationCenter::getInstance()->triggerNotification("onSceneDirty");
+				NotificationCenter::getInstance()->postNotification(kSceneDirtyNotification);
 
 				ret = true;
 			}